@@ -29,6 +29,7 @@
 #include "core/include/ReadWriteMutex.h"
 #include "core/include/EventConnection.h"
 #include "core/include/EventHub.h"
+#include "core/include/Metrics.h"
 
 // Must Be Included last
 #include "control/include/Export.h"
@@ -260,7 +261,12 @@ private:
     double m_orientationThreshold;
     double m_velocityThreshold;
     double m_positionThreshold;
-    
+
+    /** Trace ID of the last state event, the parent of our thrust */
+    boost::uint64_t m_lastTraceId;
+
+    /** Microseconds between updates */
+    core::HistogramPtr m_period;
 };
     
 } // namespace control
@@ -32,6 +32,8 @@
 #include "core/include/SubsystemMaker.h"
 #include "core/include/EventHub.h"
 #include "core/include/Events.h"
+#include "core/include/EventPool.h"
+#include "core/include/BinaryLogger.h"
 
 #include "math/include/Helpers.h"
 #include "math/include/Vector3.h"
@@ -42,6 +44,8 @@ RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::control::CombineController, CombineContro
 
 // Create category for logging
 static log4cpp::Category& LOGGER(log4cpp::Category::getInstance("Controller"));
+static ram::core::BinaryLogger& BLOGGER(
+    ram::core::BinaryLogger::getInstance("Controller"));
 
 namespace ram {
 namespace control {
@@ -134,21 +138,21 @@ void CombineController::doUpdate(const double& timestep,
     translationalForceOut = inPlaneControlForce + depthControlForce;
     rotationalTorqueOut = rotControlTorque;
 
-    LOGGER.infoStream() << translationalForceOut[0] << " "
-                        << translationalForceOut[1] << " "
-                        << translationalForceOut[2] << " " 
-                        << rotationalTorqueOut[0] << " "
-                        << rotationalTorqueOut[1] << " "
-                        << rotationalTorqueOut[2];
+    RAM_CORE_BLOG_INFO(BLOGGER) << translationalForceOut[0]
+                                << translationalForceOut[1]
+                                << translationalForceOut[2]
+                                << rotationalTorqueOut[0]
+                                << rotationalTorqueOut[1]
+                                << rotationalTorqueOut[2];
 
     // publish the individual control signals
-    math::Vector3EventPtr dEvent = math::Vector3EventPtr(new math::Vector3Event());
+    math::Vector3EventPtr dEvent = core::EventPool<math::Vector3Event>::create();
     dEvent->vector3 = depthControlForce;
 
-    math::Vector3EventPtr tEvent = math::Vector3EventPtr(new math::Vector3Event());
+    math::Vector3EventPtr tEvent = core::EventPool<math::Vector3Event>::create();
     tEvent->vector3 = inPlaneControlForce;
     
-    math::Vector3EventPtr oEvent = math::Vector3EventPtr(new math::Vector3Event());
+    math::Vector3EventPtr oEvent = core::EventPool<math::Vector3Event>::create();
     oEvent->vector3 = rotControlTorque;
 
     publish(IController::DEPTH_CONTROL_SIGNAL_UPDATE, dEvent);
@@ -25,6 +25,7 @@
 #include "core/include/SubsystemMaker.h"
 #include "core/include/EventHub.h"
 #include "core/include/TimeVal.h"
+#include "core/include/Tracer.h"
 
 #include "math/include/Helpers.h"
 #include "math/include/Events.h"
@@ -64,7 +65,9 @@ ControllerBase::ControllerBase(core::EventHubPtr eventHub,
     m_depthThreshold(0.05),
     m_orientationThreshold(0.05),
     m_velocityThreshold(0.05),
-    m_positionThreshold(0.05)
+    m_positionThreshold(0.05),
+    m_lastTraceId(0),
+    m_period(core::MetricsRegistry::histogram(getName(), "periodUsec"))
 {   
     init(config, eventHub); 
 }
@@ -97,7 +100,9 @@ ControllerBase::ControllerBase(core::ConfigNode config,
     m_depthThreshold(0.05),
     m_orientationThreshold(0.05),
     m_velocityThreshold(0.05),
-    m_positionThreshold(0.05)
+    m_positionThreshold(0.05),
+    m_lastTraceId(0),
+    m_period(core::MetricsRegistry::histogram(getName(), "periodUsec"))
 {
     core::EventHubPtr eventHub = 
         core::Subsystem::getSubsystemOfType<core::EventHub>(deps);
@@ -141,6 +146,15 @@ void ControllerBase::update(double timestep)
     math::Vector3 translationalForce(0,0,0);
     math::Vector3 rotationalTorque(0,0,0);
 
+    // The thruster commands trace back to the latest state we were given
+    boost::uint64_t traceId = 0;
+    {
+        core::ReadWriteMutex::ScopedReadLock lock(m_mutex);
+        traceId = m_lastTraceId;
+    }
+    core::Tracer::ScopedContext context(traceId);
+
+    m_period->record((boost::int64_t)(timestep * 1e6));
     doUpdate(timestep, translationalForce, rotationalTorque);
 
     // Actually set motor values
@@ -403,6 +417,7 @@ void ControllerBase::publishAtPosition(const math::Vector2& position)
 void ControllerBase::atDepthUpdate(core::EventPtr event)
 {
     core::ReadWriteMutex::ScopedWriteLock lock(m_mutex);
+    m_lastTraceId = event->traceId;
     if(atDepth())
         if(!m_atDepth){
             m_atDepth = true;
@@ -417,6 +432,7 @@ void ControllerBase::atDepthUpdate(core::EventPtr event)
 void ControllerBase::atPositionUpdate(core::EventPtr event)
 {
     core::ReadWriteMutex::ScopedWriteLock lock(m_mutex);
+    m_lastTraceId = event->traceId;
     if(atPosition())
         if(!m_atPosition){
             m_atPosition = true;
@@ -431,6 +447,7 @@ void ControllerBase::atPositionUpdate(core::EventPtr event)
 void ControllerBase::atVelocityUpdate(core::EventPtr event)
 {
     core::ReadWriteMutex::ScopedWriteLock lock(m_mutex);
+    m_lastTraceId = event->traceId;
     if(atVelocity())
         if(!m_atVelocity){
             m_atVelocity = true;
@@ -445,6 +462,7 @@ void ControllerBase::atVelocityUpdate(core::EventPtr event)
 void ControllerBase::atOrientationUpdate(core::EventPtr event)
 {
     core::ReadWriteMutex::ScopedWriteLock lock(m_mutex);
+    m_lastTraceId = event->traceId;
     if(atOrientation())
         if(!m_atOrientation){
             m_atOrientation = true;
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/AllocationTracker.h
+ */
+
+#ifndef RAM_CORE_ALLOCATIONTRACKER_H_02_08_2010
+#define RAM_CORE_ALLOCATIONTRACKER_H_02_08_2010
+
+// STD Includes
+#include <cstddef>
+#include <string>
+
+// Library Includes
+#include <boost/utility.hpp>
+
+// Project Includes
+#include "core/include/Subsystem.h"
+#include "core/include/Updatable.h"
+#include "core/include/ConfigNode.h"
+#include "core/include/Atomic.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Counts heap allocations by thread and by the Updatable making them
+ *
+ *  The counting is done by the allocation hooks, which replace malloc, free
+ *  and operator new and delete.  They are in their own library,
+ *  ram_alloc_hooks, so they are opt-in: link a program against it, or start
+ *  it with LD_PRELOAD pointing at it.  Without the hooks nothing is counted.
+ *
+ *  While an AllocationTracker exists every allocation is counted against the
+ *  thread making it, and against the Updatable whose update() it is inside
+ *  of, by Subsystem name or type.  The table of both is logged to the
+ *  "AllocationTracker" category when the tracker is destroyed, and on each
+ *  update when backgrounded.  Allocations made by our own bookkeeping are not
+ *  counted.
+ *
+ *  When no tracker or guard exists each hook costs a single well predicted
+ *  branch on active().
+ */
+class RAM_EXPORT AllocationTracker : public Subsystem, public Updatable
+{
+public:
+    AllocationTracker(ConfigNode config,
+                      SubsystemList deps = SubsystemList());
+
+    /** Logs the final report */
+    virtual ~AllocationTracker();
+
+    /** Logs the report */
+    virtual void update(double timestep);
+
+    // IUpdatable methods
+    virtual void setPriority(IUpdatable::Priority priority);
+
+    virtual IUpdatable::Priority getPriority();
+
+    virtual void setAffinity(size_t affinity);
+
+    virtual int getAffinity();
+
+    virtual void background(int interval);
+
+    virtual void unbackground(bool join = false);
+
+    virtual bool backgrounded();
+
+    /** True while any AllocationTracker or NoAllocationGuard exists */
+    static bool active() { return 0 != s_active; }
+
+    /** True when the allocation hooks are in the program */
+    static bool hooksInstalled();
+
+    /** The allocations of every thread, and every Updatable, seen so far */
+    static std::string report();
+
+    /** Counts the allocations the current thread makes while it exists
+     *
+     *  When assertOnExit is true the destructor logs an error, and asserts,
+     *  if any were made, otherwise check getAllocations() before it goes out
+     *  of scope.  They
+     *  nest, each counts everything made in its scope.  Counts are only
+     *  meaningful when hooksInstalled().
+     */
+    class RAM_EXPORT NoAllocationGuard : boost::noncopyable
+    {
+    public:
+        NoAllocationGuard(bool assertOnExit = true);
+        ~NoAllocationGuard();
+
+        size_t getAllocations() const { return m_allocations; }
+
+        size_t getBytes() const { return m_bytes; }
+
+    private:
+        friend class AllocationTracker;
+
+        NoAllocationGuard* m_previous;
+        bool m_assertOnExit;
+        size_t m_allocations;
+        size_t m_bytes;
+    };
+
+    /** Counts the allocations of the thread against the Updatable
+     *
+     *  Used by Updatable around each update(), a null updatable does nothing.
+     */
+    class RAM_EXPORT UpdateScope : boost::noncopyable
+    {
+    public:
+        UpdateScope(Updatable* updatable);
+        ~UpdateScope();
+
+    private:
+        friend class AllocationTracker;
+
+        Updatable* m_updatable;
+        UpdateScope* m_previous;
+        size_t m_allocations;
+        size_t m_bytes;
+    };
+
+    /** @defgroup Hooks Called by the allocation hooks only
+     *  @{
+     */
+
+    /** Called once when the hooks are loaded */
+    static void setHooksInstalled();
+
+    /** Counts an allocation of size bytes, only call when active() */
+    static void recordAllocation(size_t size);
+
+    /** Counts a free, only call when active() */
+    static void recordFree();
+
+    /** @} */
+
+private:
+    /** The number of trackers and guards in existence */
+    static volatile AtomicWord s_active;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_ALLOCATIONTRACKER_H_02_08_2010
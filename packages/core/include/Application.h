@@ -14,6 +14,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 
 // Project Includes
 #include "core/include/Subsystem.h"
@@ -30,6 +31,16 @@ typedef std::map<std::string, SubsystemPtr> NameSubsystemMap;
 typedef NameSubsystemMap::iterator NameSubsystemMapIter;
     
 /** Handles orderly subsystem creation, and destruction
+ *
+ *  Subsystems are created a DependencyGraph level at a time.  All subsystems
+ *  in a level only depend on earlier levels, so they are made at the same
+ *  time by up to "StartupThreads" threads (default is one, which makes them
+ *  one after another).  Errors are still reported in the same order
+ *  every time.  Subsystems from makers written in python are always made by
+ *  the calling thread.  Shutdown works the same way, in reverse.
+ *
+ *  How long each subsystem took to start and stop is logged to the
+ *  "Application" category.
  */
 class RAM_EXPORT Application
 {
@@ -51,6 +62,9 @@ public:
     /** Get the name of all subsystems */
     std::vector<std::string> getSubsystemNames();
 
+    /** Seconds the subsystem took to create, zero if it does not exist */
+    double getStartupTime(std::string name);
+
     /** Starts updating non-backgrounded Subsystems in a blocking fashion
      *
      *  Every Subsystem which returns false from backgrounded(), will be
@@ -87,6 +101,18 @@ private:
     /** The order the systems are created in */
     NameList m_order;
 
+    /** The subsystems created at the same time, in order of creation */
+    std::vector<NameList> m_levels;
+
+    /** Subsystems made in python, which are shutdown by the calling thread */
+    std::set<std::string> m_pythonSubsystems;
+
+    /** Seconds each subsystem took to create */
+    std::map<std::string, double> m_startupTimes;
+
+    /** The most threads to create, or shutdown, subsystems with */
+    size_t m_threadCount;
+
     /** Records when the the subsystem was last updated */
     std::map<std::string, TimeVal> m_lastUpdate;
 };
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/AsyncDelivery.h
+ */
+
+#ifndef RAM_CORE_ASYNCDELIVERY_H_01_29_2010
+#define RAM_CORE_ASYNCDELIVERY_H_01_29_2010
+
+// STD Includes
+#include <string>
+#include <vector>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition.hpp>
+
+// Project Includes
+#include "core/include/Updatable.h"
+#include "core/include/BoundedQueue.h"
+#include "core/include/Histogram.h"
+#include "core/include/Atomic.h"
+#include "core/include/ConfigNode.h"
+#include "core/include/Event.h"
+#include "core/include/EventConnection.h"
+#include "core/include/Forward.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+class AsyncDelivery;
+typedef boost::shared_ptr<AsyncDelivery> AsyncDeliveryPtr;
+
+/** Calls an event handler from its own queue, instead of the publisher
+ *
+ *  Publishing only pushes the event onto a bounded queue, which is drained
+ *  by the chosen executor, so a slow handler never delays the publisher.
+ *  When the queue is full events are dropped by the overflow policy (the
+ *  oldest by default, so the handler sees the latest state).  Create these
+ *  through the EventHub subscribe methods which take Options.
+ *
+ *  The delay from publish to the handler call is recorded in getLag().
+ */
+class RAM_EXPORT AsyncDelivery : public Updatable
+{
+public:
+    /** What calls the handler */
+    enum Executor
+    {
+        /** A thread just for this subscriber, woken by each event */
+        THREAD_EXECUTOR,
+        /** The shared UpdatableScheduler pool, polling every interval */
+        POOL_EXECUTOR,
+        /** Nobody, the subscriber calls update() itself */
+        MANUAL_EXECUTOR
+    };
+
+    /** How to deliver the events of a subscription */
+    struct RAM_EXPORT Options
+    {
+        Options(Executor executor = THREAD_EXECUTOR,
+                size_t capacity = 256,
+                BoundedQueueBase::OverflowPolicy overflow =
+                    BoundedQueueBase::DROP_OLDEST);
+
+        /** Reads the options from config, with the defaults above
+         *
+         *  @code
+         *  executor: thread     # thread, pool, or manual
+         *  capacity: 256        # Max queued events, rounded up to a power of 2
+         *  overflow: dropOldest # block, dropNewest, or dropOldest
+         *  interval: 10         # Milliseconds between pool updates
+         *  priority: normal     # Priority of the thread or pool
+         *  affinity: -1         # Core of the thread or pool, -1 for any
+         *  @endcode
+         */
+        static Options fromConfig(ConfigNode config);
+
+        /** Converts "thread", "pool" or "manual" to an Executor */
+        static Executor stringToExecutor(std::string str);
+
+        Executor executor;
+        size_t capacity;
+        BoundedQueueBase::OverflowPolicy overflow;
+
+        /** Milliseconds between updates in the shared pool */
+        int interval;
+
+        IUpdatable::Priority priority;
+        int affinity;
+    };
+
+    typedef boost::function<void (EventPtr)> Handler;
+
+    /** Starts the executor right away */
+    AsyncDelivery(Handler handler, const Options& options = Options());
+
+    virtual ~AsyncDelivery();
+
+    /** Queues the event for the handler, this is what the publisher calls */
+    void push(EventPtr event);
+
+    /** Calls the handler with every queued event
+     *
+     *  The THREAD_EXECUTOR waits a short time for an event when none are
+     *  queued.
+     */
+    virtual void update(double timestep);
+
+    /** Stops the executor and drops queued events
+     *
+     *  Waits for a delivery in progress, including a MANUAL_EXECUTOR
+     *  update() on another thread.  Once this returns the handler is not
+     *  called again, unless it is called by the handler itself, which can
+     *  still finish.
+     */
+    void stop();
+
+    /** The number of events passed to the handler */
+    size_t getDeliveredCount() const;
+
+    /** The number of events dropped because the queue was full */
+    size_t getDroppedCount() const;
+
+    /** The number of events waiting, only a snapshot */
+    size_t getQueuedCount() const;
+
+    /** Nanoseconds from push() to the start of the handler call */
+    const Histogram& getLag() const;
+
+    const Options& getOptions() const;
+
+private:
+    /** An event and the monotonic time it was queued */
+    struct QueuedEvent
+    {
+        QueuedEvent() : queued(0) {}
+        QueuedEvent(EventPtr event_, boost::int64_t queued_) :
+            event(event_), queued(queued_) {}
+
+        EventPtr event;
+        boost::int64_t queued;
+    };
+
+    /** Calls the handler with each event in m_batch */
+    void deliverBatch();
+
+    Handler m_handler;
+
+    Options m_options;
+
+    BoundedQueue<QueuedEvent> m_queue;
+
+    /** Events taken off the queue, kept to reuse its memory */
+    std::vector<QueuedEvent> m_batch;
+
+    /** Set by stop(), checked before each handler call */
+    volatile AtomicWord m_stopped;
+
+    /** The thread in update() if any, so stop() won't wait on itself */
+    boost::thread::id m_deliveryThread;
+    boost::mutex m_deliveryMutex;
+
+    /** Signaled when update() finishes, for stop() */
+    boost::condition m_deliveryFinished;
+
+    AtomicCounter m_delivered;
+
+    Histogram m_lag;
+};
+
+/** The connection of an EventHub subscription with an AsyncDelivery
+ *
+ *  Disconnecting also stops the delivery, so the handler can be destroyed
+ *  as soon as disconnect() returns.
+ */
+class RAM_EXPORT AsyncEventConnection : public EventConnection
+{
+public:
+    AsyncEventConnection(EventConnectionPtr connection,
+                         AsyncDeliveryPtr delivery);
+
+    virtual ~AsyncEventConnection();
+
+    virtual void disconnect();
+
+    virtual bool connected();
+
+    /** The queue between the publisher and handler, for its statistics */
+    AsyncDeliveryPtr getDelivery();
+
+private:
+    EventConnectionPtr m_connection;
+    AsyncDeliveryPtr m_delivery;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_ASYNCDELIVERY_H_01_29_2010
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/Atomic.h
+ */
+
+#ifndef RAM_CORE_ATOMIC_H_01_21_2010
+#define RAM_CORE_ATOMIC_H_01_21_2010
+
+// Project Includes
+#include "core/include/Platform.h"
+
+#if RAM_COMPILER == RAM_COMPILER_MSVC
+#  include <windows.h>
+#endif
+
+namespace ram {
+namespace core {
+
+/** Machine word which can be operated on atomically */
+#if RAM_COMPILER == RAM_COMPILER_MSVC
+typedef LONG AtomicWord;
+#else
+typedef long AtomicWord;
+#endif
+
+/** Thin wrappers around the compilers atomic intrinsics
+ *
+ *  All of the read-modify-write operations are full memory barriers. load()
+ *  has acquire and store() has release semantics, use memoryBarrier() when a
+ *  store must be visible before a following load.
+ */
+namespace atomic {
+
+/** Prevents the CPU and compiler from reordering memory accesses across it */
+inline void memoryBarrier()
+{
+#if RAM_COMPILER == RAM_COMPILER_MSVC
+    MemoryBarrier();
+#else
+    __sync_synchronize();
+#endif
+}
+
+/** Adds amount to value and returns the new value */
+inline AtomicWord add(volatile AtomicWord* value, AtomicWord amount)
+{
+#if RAM_COMPILER == RAM_COMPILER_MSVC
+    return InterlockedExchangeAdd(value, amount) + amount;
+#else
+    return __sync_add_and_fetch(value, amount);
+#endif
+}
+
+/** Sets value to newValue only if it currently equals oldValue
+ *
+ *  @return true if the swap took place
+ */
+inline bool compareAndSwap(volatile AtomicWord* value, AtomicWord oldValue,
+                           AtomicWord newValue)
+{
+#if RAM_COMPILER == RAM_COMPILER_MSVC
+    return InterlockedCompareExchange(value, newValue, oldValue) == oldValue;
+#else
+    return __sync_bool_compare_and_swap(value, oldValue, newValue);
+#endif
+}
+
+/** Orders the memory accesses of a load() or store()
+ *
+ *  x86 never moves a load before an earlier load or a store before an earlier
+ *  store, so there we only have to stop the compiler from doing it.
+ */
+inline void acquireReleaseBarrier()
+{
+#if (RAM_COMPILER == RAM_COMPILER_GNUC) && \
+    (defined(__i386__) || defined(__x86_64__))
+    __asm__ __volatile__("" ::: "memory");
+#else
+    memoryBarrier();
+#endif
+}
+
+/** Reads the value, no later memory access can be moved before the read */
+inline AtomicWord load(const volatile AtomicWord* value)
+{
+    AtomicWord result = *value;
+    acquireReleaseBarrier();
+    return result;
+}
+
+/** Writes the value, no earlier memory access can be moved after the write */
+inline void store(volatile AtomicWord* value, AtomicWord newValue)
+{
+    acquireReleaseBarrier();
+    *value = newValue;
+}
+
+} // namespace atomic
+
+/** A counter which can be incremented from many threads without a lock */
+class AtomicCounter
+{
+public:
+    AtomicCounter(AtomicWord value = 0) : m_value(value) {}
+
+    /** Adds the amount to the counter and returns the new value */
+    AtomicWord increment(AtomicWord amount = 1)
+    {
+        return atomic::add(&m_value, amount);
+    }
+
+    AtomicWord get() const { return atomic::load(&m_value); }
+
+    void set(AtomicWord value) { atomic::store(&m_value, value); }
+
+private:
+    volatile AtomicWord m_value;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_ATOMIC_H_01_21_2010
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/BatchFileAppender.h
+ */
+
+#ifndef RAM_CORE_BATCHFILEAPPENDER_H_01_28_2010
+#define RAM_CORE_BATCHFILEAPPENDER_H_01_28_2010
+
+// STD Includes
+#include <cstdio>
+#include <string>
+
+// Library Includes
+#include <log4cpp/LayoutAppender.hh>
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** A file appender which writes many messages with a single write
+ *
+ *  Formatted messages are kept in memory until endBatch() is called and the
+ *  flush interval has passed, or the buffer fills up.  The ThreadedAppender
+ *  calls endBatch() after each group of messages it takes off its queue, so
+ *  a burst of logging becomes one write instead of one per message.
+ *
+ *  Messages still in memory are lost if the program crashes, so keep the
+ *  flush interval short for logs needed to debug crashes.
+ */
+class RAM_EXPORT BatchFileAppender : public log4cpp::LayoutAppender
+{
+public:
+    /** Opens the file, replacing any existing one
+     *
+     *  @param flushInterval
+     *      Minimum time between writes in seconds, zero writes at the end of
+     *      every batch
+     *  @param bufferSize
+     *      The buffer is written out when it gets this big, no matter the
+     *      flush interval
+     */
+    BatchFileAppender(const std::string& name, const std::string& fileName,
+                      double flushInterval = 0,
+                      size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+    virtual ~BatchFileAppender();
+
+    /** Writes out the buffer if the flush interval has passed */
+    void endBatch();
+
+    /** Writes out everything buffered now */
+    void flush();
+
+    double getFlushInterval() const { return m_flushInterval; }
+
+    /** Bytes of messages waiting to be written */
+    size_t getBufferedSize() const { return m_buffer.size(); }
+
+    /** The number of writes to the file so far */
+    size_t getWriteCount() const { return m_writeCount; }
+
+    /** Flushes then reopens the file, keeping what is there */
+    virtual bool reopen();
+
+    /** Flushes and closes the file */
+    virtual void close();
+
+    static const size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+protected:
+    /** Formats the event onto the end of the buffer */
+    virtual void _append(const log4cpp::LoggingEvent& event);
+
+private:
+    /** Opens the file with the fopen mode, without stdio buffering */
+    void open(const char* mode);
+
+    std::string m_fileName;
+
+    FILE* m_file;
+
+    double m_flushInterval;
+
+    size_t m_bufferSize;
+
+    /** Formatted messages waiting to be written */
+    std::string m_buffer;
+
+    /** When the buffer was last written, monotonic seconds */
+    double m_lastFlush;
+
+    size_t m_writeCount;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_BATCHFILEAPPENDER_H_01_28_2010
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/BinaryLog.h
+ */
+
+#ifndef RAM_CORE_BINARYLOG_H_01_27_2010
+#define RAM_CORE_BINARYLOG_H_01_27_2010
+
+// STD Includes
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Project Includes
+#include "core/include/Subsystem.h"
+#include "core/include/Updatable.h"
+#include "core/include/ConfigNode.h"
+#include "core/include/BinaryLogger.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** A decoded binary log record */
+struct RAM_EXPORT BinaryLogEntry
+{
+    /** Name of the BinaryLogger which made the record */
+    std::string category;
+
+    int priority;
+
+    /** Time of day the record was made, in microseconds */
+    boost::int64_t time;
+
+    /** The fields formatted by the record's format, or separated by spaces
+     *  like log4cpp streams would write them */
+    std::string message;
+};
+
+/** Writes the records of every BinaryLogger in the background
+ *
+ *  BinaryLogRecords are copied into a lock free ring owned by the logging
+ *  thread, so logging never blocks or allocates.  On each update this drains
+ *  all the rings, and appends the records in time order to "fileName"
+ *  (default "binary.log") in the log directory.  Use the DecodeBinaryLog
+ *  tool to turn the file into text.  An empty fileName turns off the file.
+ *
+ *  With "forward" set to 1, each record is also formatted and passed to the
+ *  appenders of the log4cpp category of the same name, so the normal text
+ *  logs are written as before, but by this thread.
+ *
+ *  Records are dropped, and counted, when a thread logs faster than the
+ *  rings are drained.  Logger priorities are read from the log4cpp
+ *  categories, so this should depend on the Logging subsystem.
+ */
+class RAM_EXPORT BinaryLog : public Subsystem, public Updatable
+{
+public:
+    BinaryLog(ConfigNode config, SubsystemList deps = SubsystemList());
+
+    virtual ~BinaryLog();
+
+    /** Writes out every record logged so far */
+    virtual void update(double timestep);
+
+    // IUpdatable methods
+    virtual void setPriority(IUpdatable::Priority priority);
+
+    virtual IUpdatable::Priority getPriority();
+
+    virtual void setAffinity(size_t affinity);
+
+    virtual int getAffinity();
+
+    virtual void background(int interval);
+
+    virtual void unbackground(bool join = false);
+
+    virtual bool backgrounded();
+
+    /** The number of records dropped because a ring was full */
+    static boost::int64_t getDroppedCount();
+
+    /** Copies the finished record into the calling thread's ring
+     *
+     *  @return  false, without copying, when no BinaryLog is running
+     */
+    static bool append(const char* record, size_t size);
+
+    /** Formats the record and passes it to its logger's log4cpp category */
+    static void forwardRecord(const char* record, size_t size);
+
+    /** Decodes a single record, the size is in its first four bytes
+     *
+     *  The category is left empty, the record only has the logger's id.
+     *
+     *  @return  false if the record is malformed
+     */
+    static bool decodeRecord(const char* record, size_t size,
+                             BinaryLogEntry& entry);
+
+    /** Reads the records of a binary log file
+     *
+     *  @param startTime  Set to the time the logging system started, in
+     *                    microseconds, which log4cpp's "%r" is relative to.
+     *
+     *  @return  false if the file is not a binary log, a cut off record at
+     *           the end is ignored.
+     */
+    static bool readFile(const std::string& fileName,
+                         boost::int64_t& startTime,
+                         std::vector<BinaryLogEntry>& entries);
+
+private:
+    /** Writes a record to the file, with its logger name the first time */
+    void writeRecord(const char* record, size_t size);
+
+
+    /** Protects the file, update is also called from the destructor */
+    boost::mutex m_mutex;
+
+    FILE* m_file;
+
+    bool m_forward;
+
+    /** Loggers whose names have been written to the file */
+    std::set<boost::uint16_t> m_writtenLoggers;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_BINARYLOG_H_01_27_2010
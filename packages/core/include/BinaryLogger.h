@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/BinaryLogger.h
+ */
+
+#ifndef RAM_CORE_BINARYLOGGER_H_01_27_2010
+#define RAM_CORE_BINARYLOGGER_H_01_27_2010
+
+// STD Includes
+#include <cstring>
+#include <string>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+#include <boost/utility.hpp>
+#include <log4cpp/Priority.hh>
+
+// Project Includes
+#include "core/include/Atomic.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+/** Logs to the binary logger when the priority is enabled
+ *
+ *  Use it like a log4cpp stream, each value is one field of the message:
+ *  @code
+    static ram::core::BinaryLogger& BLOGGER(
+        ram::core::BinaryLogger::getInstance("Controller"));
+
+    RAM_CORE_BLOG_INFO(BLOGGER) << force[0] << force[1] << force[2];
+ *  @endcode
+ *
+ *  Nothing after the macro is evaluated when the priority is disabled.
+ */
+#define RAM_CORE_BLOG(logger, priority) \
+    if (!(logger).isEnabledFor(priority)) ; else \
+        ram::core::BinaryLogRecord((logger), (priority))
+
+#define RAM_CORE_BLOG_DEBUG(logger) \
+    RAM_CORE_BLOG(logger, log4cpp::Priority::DEBUG)
+#define RAM_CORE_BLOG_INFO(logger) \
+    RAM_CORE_BLOG(logger, log4cpp::Priority::INFO)
+#define RAM_CORE_BLOG_WARN(logger) \
+    RAM_CORE_BLOG(logger, log4cpp::Priority::WARN)
+#define RAM_CORE_BLOG_ERROR(logger) \
+    RAM_CORE_BLOG(logger, log4cpp::Priority::ERROR)
+
+namespace ram {
+namespace core {
+
+/** The kind of each field in a binary log record */
+enum BinaryLogType
+{
+    BLOG_BOOL = 1,
+    BLOG_CHAR,
+    BLOG_INT32,
+    BLOG_UINT32,
+    BLOG_INT64,
+    BLOG_UINT64,
+    BLOG_DOUBLE,
+    BLOG_STRING,
+    BLOG_FORMAT
+};
+
+/** A named channel of the binary log, the counterpart of a log4cpp Category
+ *
+ *  The priority of each logger comes from the log4cpp category with the
+ *  same name.  When no BinaryLog is running records are formatted right
+ *  away and passed to that category, so nothing is lost, it is just slower.
+ */
+class RAM_EXPORT BinaryLogger : boost::noncopyable
+{
+public:
+    /** Finds or creates the logger, the same name gives the same logger */
+    static BinaryLogger& getInstance(const std::string& name);
+
+    /** Looks up a logger by its id, null if there is none */
+    static BinaryLogger* getById(boost::uint16_t id);
+
+    /** Sets the priority of every logger from its log4cpp category */
+    static void updatePriorities();
+
+    /** True if messages of this priority are kept, see log4cpp::Priority */
+    bool isEnabledFor(int priority) const
+    {
+        return priority <= m_priority;
+    }
+
+    /** True while a BinaryLog is collecting the records */
+    static bool hasWriter()
+    {
+        return 0 != atomic::load(&s_writers);
+    }
+
+    void setPriority(int priority) { m_priority = priority; }
+
+    int getPriority() const { return m_priority; }
+
+    const std::string& getName() const { return m_name; }
+
+    boost::uint16_t getId() const { return m_id; }
+
+private:
+    friend class BinaryLog;
+
+    BinaryLogger(const std::string& name, boost::uint16_t id);
+
+    std::string m_name;
+    boost::uint16_t m_id;
+
+    /** Lower values are more important, like log4cpp */
+    volatile int m_priority;
+
+    /** The number of running BinaryLogs */
+    static volatile AtomicWord s_writers;
+};
+
+/** One message of the binary log, handed off when destroyed
+ *
+ *  Each value is copied in with a byte giving its type, no formatting is
+ *  done.  Values which don't fit in the record are dropped.  Only create
+ *  these through the RAM_CORE_BLOG macros.
+ */
+class RAM_EXPORT BinaryLogRecord : boost::noncopyable
+{
+public:
+    /** The largest record, header included */
+    static const size_t MAX_SIZE = 512;
+
+    /** Bytes before the first field: size, logger id, priority, time */
+    static const size_t HEADER_SIZE = 16;
+
+    BinaryLogRecord(BinaryLogger& logger, int priority);
+
+    ~BinaryLogRecord();
+
+    BinaryLogRecord& operator<<(bool value)
+    {
+        char byte = value ? 1 : 0;
+        return put(BLOG_BOOL, &byte, 1);
+    }
+
+    BinaryLogRecord& operator<<(char value)
+    {
+        return put(BLOG_CHAR, &value, 1);
+    }
+
+    BinaryLogRecord& operator<<(int value)
+    {
+        boost::int32_t field = value;
+        return put(BLOG_INT32, &field, sizeof(field));
+    }
+
+    BinaryLogRecord& operator<<(unsigned int value)
+    {
+        boost::uint32_t field = value;
+        return put(BLOG_UINT32, &field, sizeof(field));
+    }
+
+    BinaryLogRecord& operator<<(long value)
+    {
+        boost::int64_t field = value;
+        return put(BLOG_INT64, &field, sizeof(field));
+    }
+
+    BinaryLogRecord& operator<<(unsigned long value)
+    {
+        boost::uint64_t field = value;
+        return put(BLOG_UINT64, &field, sizeof(field));
+    }
+
+    BinaryLogRecord& operator<<(float value)
+    {
+        return *this << (double)value;
+    }
+
+    BinaryLogRecord& operator<<(double value)
+    {
+        return put(BLOG_DOUBLE, &value, sizeof(value));
+    }
+
+    BinaryLogRecord& operator<<(const char* value)
+    {
+        return putString(BLOG_STRING, value, strlen(value));
+    }
+
+    BinaryLogRecord& operator<<(const std::string& value)
+    {
+        return putString(BLOG_STRING, value.data(), value.size());
+    }
+
+    /** Formats the fields with the printf style format when decoded
+     *
+     *  Without a format the fields are separated by spaces.  It must come
+     *  before all the fields:
+     *  @code
+    RAM_CORE_BLOG_INFO(BLOGGER).format("%3.1f %d") << current << command;
+     *  @endcode
+     */
+    BinaryLogRecord& format(const char* format)
+    {
+        return putString(BLOG_FORMAT, format, strlen(format));
+    }
+
+private:
+    BinaryLogRecord& put(char type, const void* data, size_t size)
+    {
+        if ((m_size + 1 + size) <= MAX_SIZE)
+        {
+            m_buffer[m_size] = type;
+            memcpy(m_buffer + m_size + 1, data, size);
+            m_size += 1 + size;
+        }
+        return *this;
+    }
+
+    /** Strings are their length, as two bytes, then the characters */
+    BinaryLogRecord& putString(char type, const char* data, size_t length);
+
+    size_t m_size;
+    char m_buffer[MAX_SIZE];
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_BINARYLOGGER_H_01_27_2010
@@ -26,6 +26,8 @@ public:
 
     std::vector<bool>::reference operator() (size_t x, size_t y, size_t z);
 
+    bool operator() (size_t x, size_t y, size_t z) const;
+
     size_t length();
     size_t width();
     size_t height();
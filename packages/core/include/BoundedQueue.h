@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/BoundedQueue.h
+ */
+
+#ifndef RAM_CORE_BOUNDEDQUEUE_H_01_21_2010
+#define RAM_CORE_BOUNDEDQUEUE_H_01_21_2010
+
+// STD Includes
+#include <string>
+#include <vector>
+
+// Library Includes
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/xtime.hpp>
+
+// Project Includes
+#include "core/include/IQueue.h"
+#include "core/include/ThreadedQueue.h"
+#include "core/include/Atomic.h"
+
+namespace ram {
+namespace core {
+
+/** The non-templated parts of the BoundedQueue */
+class BoundedQueueBase
+{
+public:
+    /** What push() does when the queue is full */
+    enum OverflowPolicy
+    {
+        /** Wait until the consumer makes room */
+        BLOCK,
+        /** Drop the item being pushed */
+        DROP_NEWEST,
+        /** Remove the oldest item in the queue to make room */
+        DROP_OLDEST
+    };
+
+    /** Which threads are allowed to push into the queue */
+    enum ProducerMode
+    {
+        MULTI_PRODUCER,
+        /** Only one thread ever pushes, saves an atomic operation per push */
+        SINGLE_PRODUCER
+    };
+
+    /** Converts "block", "dropNewest" or "dropOldest" to a policy
+     *
+     *  Unknown strings result in the given default.
+     */
+    static OverflowPolicy stringToPolicy(const std::string& str,
+                                         OverflowPolicy def = DROP_OLDEST)
+    {
+        if (str == "block")
+            return BLOCK;
+        else if (str == "dropNewest")
+            return DROP_NEWEST;
+        else if (str == "dropOldest")
+            return DROP_OLDEST;
+        return def;
+    }
+};
+
+/** A fixed size, lock free queue for passing data between threads
+ *
+ *  This is a drop in replacement for the ThreadedQueue for the cases where
+ *  an unbounded queue is dangerous, ie: a slow consumer of a high rate
+ *  producer.  The queue is a ring of cells each with a sequence number (the
+ *  design of Dmitry Vyukov's bounded MPMC queue) so pushing and popping are
+ *  a couple of atomic operations instead of a mutex lock.  The mutex and
+ *  conditions are only touched when a thread has to block.
+ *
+ *  When the queue is full push() follows the overflow policy given at
+ *  construction and counts what happened, see getDroppedNewest(),
+ *  getDroppedOldest() and getBlockedPushes().
+ *
+ *  @remarks
+ *  The templated object must be default constructable, copy constructable
+ *  and assignable.  Popped cells are reset to a default object so the queue
+ *  does not keep shared pointers alive.
+ */
+template <typename T>
+class BoundedQueue : public IQueue<T>, public BoundedQueueBase
+{
+public:
+    /** Creates the queue
+     *
+     *  @param capacity
+     *      The maximum number of items, rounded up to a power of two
+     *  @param policy
+     *      What to do when an item is pushed into a full queue
+     *  @param mode
+     *      Whether multiple threads will push into the queue
+     */
+    BoundedQueue(size_t capacity, OverflowPolicy policy = DROP_OLDEST,
+                 ProducerMode mode = MULTI_PRODUCER) :
+        m_buffer(0),
+        m_mask(0),
+        m_policy(policy),
+        m_singleProducer(SINGLE_PRODUCER == mode),
+        m_enqueuePos(0),
+        m_dequeuePos(0),
+        m_consumersWaiting(0),
+        m_producersWaiting(0)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+
+        m_mask = size - 1;
+        m_buffer = new Cell[size];
+        for (size_t i = 0; i < size; ++i)
+            m_buffer[i].sequence = (AtomicWord)i;
+    }
+
+    virtual ~BoundedQueue()
+    {
+        delete [] m_buffer;
+    }
+
+    /** Adds an item following the overflow policy when the queue is full
+     *
+     *  @return
+     *      false if the new item was dropped
+     */
+    virtual bool push(const T& newData)
+    {
+        if (!tryPush(newData))
+        {
+            switch (m_policy)
+            {
+                case DROP_NEWEST:
+                    m_droppedNewest.increment();
+                    return false;
+
+                case DROP_OLDEST:
+                {
+                    // The consumer can empty the queue under us, so loop
+                    T oldest;
+                    do {
+                        if (tryPop(oldest))
+                            m_droppedOldest.increment();
+                    } while (!tryPush(newData));
+                    break;
+                }
+
+                case BLOCK:
+                    m_blockedPushes.increment();
+                    waitAndPush(newData);
+                    break;
+            }
+        }
+
+        notifyConsumers();
+        return true;
+    }
+
+    virtual bool popNoWait(T& data)
+    {
+        if (!tryPop(data))
+            return false;
+
+        notifyProducers();
+        return true;
+    }
+
+    virtual T popWait()
+    {
+        T data;
+        if (!tryPop(data))
+        {
+            boost::mutex::scoped_lock lock(m_waitMutex);
+            atomic::add(&m_consumersWaiting, 1);
+            while (!tryPop(data))
+                m_itemAvailable.wait(lock);
+            atomic::add(&m_consumersWaiting, -1);
+        }
+
+        notifyProducers();
+        return data;
+    }
+
+    virtual bool popTimedWait(const boost::xtime& timeout, T& data)
+    {
+        if (!tryPop(data))
+        {
+            boost::xtime now;
+            boost::xtime_get(&now, boost::TIME_UTC);
+            boost::xtime wakeUp = details::add_xtime(now, timeout);
+
+            boost::mutex::scoped_lock lock(m_waitMutex);
+            atomic::add(&m_consumersWaiting, 1);
+            bool success = true;
+            while (success && !(success = tryPop(data)))
+                success = m_itemAvailable.timed_wait(lock, wakeUp);
+            atomic::add(&m_consumersWaiting, -1);
+
+            if (!success)
+                return false;
+        }
+
+        notifyProducers();
+        return true;
+    }
+
+    virtual size_t popAll(std::vector<T>& items)
+    {
+        size_t count = 0;
+        T data;
+        while (tryPop(data))
+        {
+            items.push_back(data);
+            ++count;
+        }
+
+        if (count)
+            notifyProducers();
+        return count;
+    }
+
+    /** The maximum number of items the queue can hold */
+    size_t capacity() const { return m_mask + 1; }
+
+    /** The number of items in the queue, only a snapshot */
+    virtual size_t size() const
+    {
+        AtomicWord size = atomic::load(&m_enqueuePos) -
+            atomic::load(&m_dequeuePos);
+        return size < 0 ? 0 : (size_t)size;
+    }
+
+    OverflowPolicy getOverflowPolicy() const { return m_policy; }
+
+    /** Items not added because the queue was full (DROP_NEWEST) */
+    size_t getDroppedNewest() const { return m_droppedNewest.get(); }
+
+    /** Items removed to make room for newer ones (DROP_OLDEST) */
+    size_t getDroppedOldest() const { return m_droppedOldest.get(); }
+
+    /** Pushes which had to wait for room (BLOCK) */
+    size_t getBlockedPushes() const { return m_blockedPushes.get(); }
+
+    /** Adds the item only if there is room, without waking up any consumer
+     *
+     *  For queues no thread ever blocks on, like a free list, this skips the
+     *  overhead of push().  The overflow policy and counts are ignored.
+     */
+    bool tryPush(const T& newData)
+    {
+        Cell* cell = 0;
+        AtomicWord pos = atomic::load(&m_enqueuePos);
+        while (true)
+        {
+            cell = &m_buffer[pos & m_mask];
+            AtomicWord diff = atomic::load(&cell->sequence) - pos;
+            if (0 == diff)
+            {
+                if (m_singleProducer)
+                {
+                    m_enqueuePos = pos + 1;
+                    break;
+                }
+                if (atomic::compareAndSwap(&m_enqueuePos, pos, pos + 1))
+                    break;
+                pos = atomic::load(&m_enqueuePos);
+            }
+            else if (diff < 0)
+            {
+                // The cell still holds the item from a lap ago, we are full
+                return false;
+            }
+            else
+            {
+                pos = atomic::load(&m_enqueuePos);
+            }
+        }
+
+        cell->data = newData;
+        atomic::store(&cell->sequence, pos + 1);
+        return true;
+    }
+
+    /** Removes an item, if any, without waking up a blocked producer */
+    bool tryPop(T& data)
+    {
+        Cell* cell = 0;
+        AtomicWord pos = atomic::load(&m_dequeuePos);
+        while (true)
+        {
+            cell = &m_buffer[pos & m_mask];
+            AtomicWord diff = atomic::load(&cell->sequence) - (pos + 1);
+            if (0 == diff)
+            {
+                // Producers can pop too (DROP_OLDEST) so this is always a CAS
+                if (atomic::compareAndSwap(&m_dequeuePos, pos, pos + 1))
+                    break;
+                pos = atomic::load(&m_dequeuePos);
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = atomic::load(&m_dequeuePos);
+            }
+        }
+
+        data = cell->data;
+        cell->data = T();
+        atomic::store(&cell->sequence, pos + (AtomicWord)m_mask + 1);
+        return true;
+    }
+
+private:
+    struct Cell
+    {
+        /** Equals the position when free, position + 1 once written */
+        volatile AtomicWord sequence;
+        T data;
+    };
+
+    /** Blocks until there is room for the data */
+    void waitAndPush(const T& newData)
+    {
+        boost::mutex::scoped_lock lock(m_waitMutex);
+        atomic::add(&m_producersWaiting, 1);
+        while (!tryPush(newData))
+            m_spaceAvailable.wait(lock);
+        atomic::add(&m_producersWaiting, -1);
+    }
+
+    /** Wakes up any consumer blocked on an empty queue */
+    void notifyConsumers()
+    {
+        // Order our write of the cell before the read of the waiter count
+        atomic::memoryBarrier();
+        if (atomic::load(&m_consumersWaiting) > 0)
+        {
+            boost::mutex::scoped_lock lock(m_waitMutex);
+            m_itemAvailable.notify_all();
+        }
+    }
+
+    /** Wakes up any producer blocked on a full queue */
+    void notifyProducers()
+    {
+        atomic::memoryBarrier();
+        if (atomic::load(&m_producersWaiting) > 0)
+        {
+            boost::mutex::scoped_lock lock(m_waitMutex);
+            m_spaceAvailable.notify_all();
+        }
+    }
+
+    Cell* m_buffer;
+    size_t m_mask;
+    OverflowPolicy m_policy;
+    bool m_singleProducer;
+
+    /** Keep the producer and consumer positions on separate cache lines */
+    char m_pad0[64];
+    volatile AtomicWord m_enqueuePos;
+    char m_pad1[64];
+    volatile AtomicWord m_dequeuePos;
+    char m_pad2[64];
+
+    /** Only used when a thread has to block */
+    boost::mutex m_waitMutex;
+    boost::condition m_itemAvailable;
+    boost::condition m_spaceAvailable;
+    volatile AtomicWord m_consumersWaiting;
+    volatile AtomicWord m_producersWaiting;
+
+    AtomicCounter m_droppedNewest;
+    AtomicCounter m_droppedOldest;
+    AtomicCounter m_blockedPushes;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_BOUNDEDQUEUE_H_01_21_2010
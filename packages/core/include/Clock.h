@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/Clock.h
+ */
+
+#ifndef RAM_CORE_CLOCK_H_02_01_2010
+#define RAM_CORE_CLOCK_H_02_01_2010
+
+// STD Includes
+#include <string>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+
+// Project Includes
+#include "core/include/Atomic.h"
+#include "core/include/TimeVal.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** The source of time for the whole process
+ *
+ *  TimeVal::monotonic(), TimeVal::timeOfDay() and TimeVal::sleep() all go
+ *  through here.  In REAL_TIME mode, the default, they use the system
+ *  clocks.  In VIRTUAL mode time stands still until advanceTo() moves it,
+ *  which is normally done by the LockstepScheduler as it runs each update,
+ *  and sleeping threads wait for the virtual time instead of the real one.
+ *
+ *  Set the mode before anything is backgrounded, the Application does this
+ *  for the root "Clock" config value ("real" or "virtual").
+ */
+class RAM_EXPORT Clock
+{
+public:
+    enum Mode
+    {
+        REAL_TIME,
+        VIRTUAL
+    };
+
+    /** Changes the mode, virtual time starts at the current real time */
+    static void setMode(Mode mode);
+
+    static Mode getMode();
+
+    static bool isVirtual()
+    {
+        return VIRTUAL == atomic::load(&s_mode);
+    }
+
+    /** Converts "real" or "virtual" to a Mode */
+    static Mode stringToMode(std::string str);
+
+    /** The time of a clock which is never set, only differences matter */
+    static TimeVal monotonic();
+
+    static TimeVal timeOfDay();
+
+    /** monotonic() in microseconds */
+    static boost::int64_t monotonicUsec();
+
+    /** Moves virtual time forward, waking threads sleeping until then
+     *
+     *  Earlier times are ignored, virtual time never goes backwards.
+     */
+    static void advanceTo(boost::int64_t usec);
+
+    /** Sleeps until monotonicUsec() reaches the given time */
+    static void sleepUntil(boost::int64_t usec);
+
+    /** Sleeps for the given number of seconds of the clock */
+    static void sleep(double seconds);
+
+    /** The earliest time a thread sleeps until in VIRTUAL mode, -1 if none */
+    static boost::int64_t getNextWakeup();
+
+    /** Waits for the threads woken by advanceTo() to sleep again
+     *
+     *  This keeps threads which sleep on the clock, like the EventPlayer, in
+     *  lockstep with the scheduled updates.  A thread which doesn't go back
+     *  to sleep is only waited on for the timeout.
+     *
+     *  @param timeout  Real seconds to wait at most
+     *  @return  false if the timeout passed first
+     */
+    static bool waitForSleepers(double timeout);
+
+    /** The system monotonic clock, no matter the mode */
+    static TimeVal realMonotonic();
+
+    /** The system time of day, no matter the mode */
+    static TimeVal realTimeOfDay();
+
+private:
+    static volatile AtomicWord s_mode;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_CLOCK_H_02_01_2010
@@ -88,6 +88,12 @@ public:
     /** Attempts to load the config from file, the extension determines the
      backend used (NOT YET!!! - see below)
 
+     The first load parses the file with python, and stores a binary
+     snapshot of the result in the config cache (see ConfigSnapshot).  Later
+     loads read the snapshot without python, until the file or any file it
+     includes changes.  Set RAM_CONFIG_CACHE_DIR to "off" to always use
+     python.
+
      @warning: This currently assume yml files and python yaml library 
     */
     static ConfigNode fromFile(std::string fileName);
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/ConfigSnapshot.h
+ */
+
+#ifndef RAM_CORE_CONFIGSNAPSHOT_H_01_26_2010
+#define RAM_CORE_CONFIGSNAPSHOT_H_01_26_2010
+
+// STD Includes
+#include <map>
+#include <string>
+#include <vector>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+#include <boost/utility.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+class ConfigSnapshot;
+typedef boost::shared_ptr<ConfigSnapshot> ConfigSnapshotPtr;
+
+/** The kinds of values a config can hold, the same as YAML */
+enum ConfigType
+{
+    CONFIG_NONE = 0,
+    CONFIG_BOOL,
+    CONFIG_INT,
+    CONFIG_DOUBLE,
+    CONFIG_STRING,
+    CONFIG_LIST,
+    CONFIG_MAP
+};
+
+/** A config tree in memory, used to create a ConfigSnapshot */
+struct RAM_EXPORT ConfigValue
+{
+    ConfigValue(ConfigType type_ = CONFIG_NONE, std::string text_ = "") :
+        type(type_), text(text_) {}
+
+    ConfigType type;
+
+    /** The value as python's str() would give it, for scalars */
+    std::string text;
+
+    /** For doubles, all digits needed to get the exact value back */
+    std::string repr;
+
+    /** The keys of a map, empty for lists */
+    std::vector<std::string> keys;
+
+    /** Elements of a list, or values of a map in the same order as keys */
+    std::vector<ConfigValue> children;
+};
+
+/** A read only config tree, stored in a compact memory mapped file
+ *
+ *  The file is a flattened tree of nodes, with all strings (keys and values)
+ *  stored once in a string table.  Each map has a hash table of its keys, so
+ *  finding a child by key or by index takes constant time, and loading the
+ *  file is just mapping it into memory.
+ *
+ *  Snapshots of YAML configs are kept in a cache directory, see
+ *  fromCache(), so they are only parsed by python the first time they are
+ *  loaded.
+ *
+ *  The tree itself can not change, instead values set() on a map node are
+ *  kept in memory along side the snapshot.
+ */
+class RAM_EXPORT ConfigSnapshot : boost::noncopyable
+{
+public:
+    /** The index of the root node */
+    static const boost::uint32_t ROOT = 0;
+
+    /** Returned when a node does not exist */
+    static const boost::uint32_t NO_NODE = 0xFFFFFFFF;
+
+    ~ConfigSnapshot();
+
+    /** Maps the snapshot file into memory
+     *
+     *  @return  The snapshot, or null if the file does not exist or is not
+     *           a valid snapshot.
+     */
+    static ConfigSnapshotPtr load(std::string fileName);
+
+    /** Writes the tree to the given file
+     *
+     *  @param sources
+     *      The files the tree came from, the snapshot is out of date once any
+     *      of them changes.
+     *
+     *  @return  False if the file could not be written.
+     */
+    static bool write(std::string fileName, const ConfigValue& root,
+                      const std::vector<std::string>& sources);
+
+    /** Where the cached snapshot of the given config file is kept
+     *
+     *  Snapshots go in the directory given by the RAM_CONFIG_CACHE_DIR
+     *  environment variable, or "ram_config_cache_<uid>" in the temporary
+     *  directory.  Returns an empty string if RAM_CONFIG_CACHE_DIR is "off".
+     */
+    static std::string getCachePath(std::string configFile);
+
+    /** Creates the directory of the cache path, only readable by us
+     *
+     *  @return  False if the directory could not be created, or is not
+     *           owned by us, or other users can write to it.  Snapshots are
+     *           neither read from nor written to such a directory.
+     */
+    static bool createCacheDir(std::string cachePath);
+
+    /** The cached snapshot of the config file, null if there is no up to date
+     *  snapshot.
+     */
+    static ConfigSnapshotPtr fromCache(std::string configFile);
+
+    /** True if none of the source files have changed since the snapshot was
+     *  written.
+     */
+    bool upToDate();
+
+    /** @defgroup Nodes Reading the tree
+     *  @{
+     */
+    ConfigType getType(boost::uint32_t node) const;
+
+    /** The value as python's str() would give it, empty for lists and maps */
+    std::string getText(boost::uint32_t node) const;
+
+    /** The exact text of a double, same as the text for everything else */
+    std::string getRepr(boost::uint32_t node) const;
+
+    /** The number of elements in a list, or keys in a map */
+    size_t getChildCount(boost::uint32_t node) const;
+
+    /** The node of the index'th element, NO_NODE if out of range */
+    boost::uint32_t getChild(boost::uint32_t node, size_t index) const;
+
+    /** The key of the index'th child of a map */
+    std::string getKey(boost::uint32_t node, size_t index) const;
+
+    /** Finds the child of a map by its key, NO_NODE if there is none */
+    boost::uint32_t findChild(boost::uint32_t node,
+                              const std::string& key) const;
+    /** @} */
+
+    /** @defgroup Overrides Values set after loading
+     *  @{
+     */
+
+    /** Sets the key of the map node to a scalar value */
+    void setOverride(boost::uint32_t node, const std::string& key,
+                     ConfigType type, const std::string& text);
+
+    /** Finds a value set on the map node, returns false if there is none */
+    bool getOverride(boost::uint32_t node, const std::string& key,
+                     ConfigType& type, std::string& text);
+
+    /** All keys set on the map node */
+    std::vector<std::string> getOverrideKeys(boost::uint32_t node);
+    /** @} */
+
+private:
+    struct Header;
+    struct Node;
+    struct Child;
+    struct String;
+    struct Source;
+    class MappedFile;
+    friend class SnapshotWriter;
+
+    ConfigSnapshot(MappedFile* file);
+
+    /** Checks all offsets and indices in the file, so reads can't go wild */
+    bool validate();
+
+    const char* getString(boost::uint32_t index) const;
+
+    MappedFile* m_file;
+
+    const Header* m_header;
+    const Node* m_nodes;
+    const Child* m_children;
+    const boost::uint32_t* m_slots;
+    const String* m_strings;
+    const char* m_data;
+    const Source* m_sources;
+
+    typedef std::pair<boost::uint32_t, std::string> OverrideKey;
+    typedef std::map<OverrideKey, std::pair<ConfigType, std::string> >
+        OverrideMap;
+
+    /** Protects m_overrides */
+    boost::mutex m_mutex;
+    OverrideMap m_overrides;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_CONFIGSNAPSHOT_H_01_26_2010
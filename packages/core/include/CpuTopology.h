@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/CpuTopology.h
+ */
+
+#ifndef RAM_CORE_CPUTOPOLOGY_H_02_07_2010
+#define RAM_CORE_CPUTOPOLOGY_H_02_07_2010
+
+// STD Includes
+#include <string>
+#include <vector>
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** A single logical CPU, as the kernel numbers them */
+struct RAM_EXPORT CpuInfo
+{
+    CpuInfo(int id_ = 0, int package_ = 0, int coreId_ = 0,
+            bool isolated_ = false) :
+        id(id_), package(package_), coreId(coreId_), isolated(isolated_)
+    {}
+
+    int id;
+
+    /** The physical package (socket) the CPU is in */
+    int package;
+
+    /** The physical core within the package, SMT siblings share it */
+    int coreId;
+
+    /** True when kept away from the scheduler with isolcpus= */
+    bool isolated;
+};
+
+/** The layout of the CPUs of the machine
+ *
+ *  Logical CPUs which are SMT siblings (hyperthreads) are grouped into
+ *  physical cores.  Cores are numbered from zero in the order of their lowest
+ *  CPU, so core numbers are only meaningful within one topology.
+ */
+class RAM_EXPORT CpuTopology
+{
+public:
+    /** A topology with no CPUs */
+    CpuTopology();
+
+    CpuTopology(const std::vector<CpuInfo>& cpus);
+
+    /** Reads the topology of the online CPUs from sysfs
+     *
+     *  @param root
+     *      Where the cpu directory of sysfs is, only changed for testing
+     *
+     *  When sysfs can't be read every CPU is assumed to be its own core.
+     */
+    static CpuTopology fromSysfs(
+        std::string root = "/sys/devices/system/cpu");
+
+    /** Parses a kernel CPU list, ie: "0-3,8,10-11" */
+    static std::vector<int> parseCpuList(const std::string& list);
+
+    /** All the CPUs, ordered by id */
+    const std::vector<CpuInfo>& getCpus() const;
+
+    /** The CPUs of each physical core, the lowest first */
+    const std::vector<std::vector<int> >& getCores() const;
+
+    /** The physical core the CPU is in, -1 if there is no such CPU */
+    int getCoreOf(int cpu) const;
+
+    /** True if any CPU of the core is isolated */
+    bool isCoreIsolated(size_t core) const;
+
+private:
+    std::vector<CpuInfo> m_cpus;
+
+    std::vector<std::vector<int> > m_cores;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_CPUTOPOLOGY_H_02_07_2010
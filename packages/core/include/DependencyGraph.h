@@ -49,6 +49,14 @@ public:
     /** The order to start the sections from the config file */
     std::vector<std::string> getOrder();
 
+    /** The order to start the sections, grouped into levels
+     *
+     *  Sections only depend on sections in earlier levels, so all sections in
+     *  a level can be started at the same time.  Within a level sections are
+     *  in the same order as getOrder().
+     */
+    std::vector<std::vector<std::string> > getLevels();
+
     /** Get the sections which the current section depends on */
     std::vector<std::string> getDependencies(std::string section);
 
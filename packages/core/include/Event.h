@@ -15,9 +15,11 @@
 
 // Library Includes
 #include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
 
 // Project Includes
 #include "core/include/Forward.h"
+#include "core/include/EventTypeName.h"
 
 // Must Be Included last
 #include "core/include/Export.h"
@@ -28,7 +30,11 @@ namespace core {
 /** Base class for information to be passed between publisher and subscriber */
 struct RAM_EXPORT Event
 {
-    typedef std::string EventType;
+    /** A type string which carries its EventTypeRegistry id */
+    typedef EventTypeName EventType;
+
+    /** Interned form of an EventType, see EventTypeRegistry */
+    typedef EventTypeRegistry::TypeId EventTypeId;
     
     Event();
     
@@ -50,6 +56,15 @@ struct RAM_EXPORT Event
      */
     double timeStamp;
 
+    /** Identifies the event in a trace, zero unless a Tracer is active */
+    boost::uint64_t traceId;
+
+    /** The traceId of the event being handled when this was published
+     *
+     *  Zero if it was published outside of any handler or trace context.
+     */
+    boost::uint64_t parentTraceId;
+
   protected:
     /** Copies all elements of the event into the given event */
     void copyInto(EventPtr inEvent);
@@ -60,6 +75,9 @@ struct RAM_EXPORT Event
 
 #define RAM_CORE_EVENT_STRINGIFY(S) #S
 #define RAM_CORE_EVENT_STR(S) RAM_CORE_EVENT_STRINGIFY(S)
+
+// Defines the event type string, which interns itself with the
+// EventTypeRegistry during static initialization so its id is stable
 #define RAM_CORE_EVENT_TYPE(_class, name) \
     const ram::core::Event::EventType _class  :: name  \
     (RAM_CORE_EVENT_STR(__LINE__) " " RAM_CORE_EVENT_STR(_class) "::" \
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/EventHandler.h
+ */
+
+#ifndef RAM_CORE_EVENTHANDLER_H_01_19_2010
+#define RAM_CORE_EVENTHANDLER_H_01_19_2010
+
+// STD Includes
+#include <typeinfo>
+#include <vector>
+
+// Library Includes
+#include <boost/utility.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Project Includes
+#include "core/include/Forward.h"
+#include "core/include/Atomic.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+class EventHandler;
+typedef boost::shared_ptr<EventHandler> EventHandlerPtr;
+
+/** A list of handlers, published as an immutable snapshot */
+typedef std::vector<EventHandlerPtr> EventHandlerList;
+typedef boost::shared_ptr<const EventHandlerList> EventHandlerListPtr;
+
+/** A single subscriber function of an EventPublisher
+ *
+ *  Publishers call handlers from an immutable snapshot of the subscriber list
+ *  without holding any locks, so a handler can still be in the middle of a
+ *  call on another thread when it is removed from the list.  This class
+ *  counts those calls so that disconnect() only returns once no thread is
+ *  (or will be) calling the handler.  A call only touches the counter, the
+ *  mutex is just for waking up a waiting disconnect().
+ */
+class RAM_EXPORT EventHandler : boost::noncopyable
+{
+public:
+    EventHandler(boost::function<void (EventPtr)> function);
+
+    /** Calls the handler function, unless the handler is disconnected */
+    void call(EventPtr event);
+
+    /** Stops all future calls and waits for current calls to finish
+     *
+     *  Calls made by the current thread are not waited on, this allows a
+     *  handler to disconnect itself from inside its own call.
+     */
+    void disconnect();
+
+    /** True until disconnect() is called */
+    bool connected();
+
+    /** Unique for the life of the process, unlike the address of handler */
+    size_t getId() { return m_id; }
+
+    /** The type of the function object, used to describe the handler */
+    const std::type_info& getFunctionType() { return m_function.target_type(); }
+
+private:
+    friend class CallGuard;
+
+    size_t m_id;
+
+    /** The function which actually handles the events */
+    boost::function<void (EventPtr)> m_function;
+
+    /** Non-zero until disconnect() is called */
+    volatile AtomicWord m_connected;
+
+    /** The number of calls currently inside the function, on all threads */
+    volatile AtomicWord m_calls;
+
+    /** Used by disconnect() to wait for the calls to finish */
+    boost::mutex m_mutex;
+
+    /** Signaled when a call finishes after disconnect() */
+    boost::condition m_callFinished;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_EVENTHANDLER_H_01_19_2010
@@ -18,6 +18,7 @@
 #include "core/include/Subsystem.h"
 #include "core/include/ConfigNode.h"
 #include "core/include/Event.h"
+#include "core/include/AsyncDelivery.h"
 
 // Must Be Included last
 #include "core/include/Export.h"
@@ -88,6 +89,35 @@ public:
     virtual EventConnectionPtr subscribeToAll(
         boost::function<void (EventPtr)> handler);
 
+    /** @defgroup Async Subscribe with delivery off the publishers thread
+     *
+     *  These are the same as the methods above, except the handler is called
+     *  by the executor given in the options, through its own bounded queue
+     *  (see AsyncDelivery).  Publishers only pay for pushing onto the queue,
+     *  so use these for slow handlers, like ones which write to disk or the
+     *  network.
+     *
+     *  The returned connection is an AsyncEventConnection, which gives
+     *  access to the queue statistics.  Once disconnect() returns the
+     *  handler will not be called again.
+     *  @{
+     */
+    EventConnectionPtr subscribe(
+        Event::EventType type,
+        EventPublisher* publisher,
+        boost::function<void (EventPtr)> handler,
+        const AsyncDelivery::Options& options);
+
+    EventConnectionPtr subscribeToType(
+        Event::EventType type,
+        boost::function<void (EventPtr)> handler,
+        const AsyncDelivery::Options& options);
+
+    EventConnectionPtr subscribeToAll(
+        boost::function<void (EventPtr)> handler,
+        const AsyncDelivery::Options& options);
+    /** @} */
+
     using EventPublisher::publish;
     
     /** Publishes and event to the hub
@@ -123,6 +153,9 @@ public:
     virtual bool backgrounded();
     
 private:
+    /** Publishes the event to all three internal publishers */
+    void publishToHandlers(Event::EventTypeId typeId, EventPtr event);
+
     /// The Publisher used for EventType subscribers
     EventPublisherBasePtr m_impType;
 
@@ -131,6 +164,9 @@ private:
 
     /// The Publisher used for subscribers to all messages
     EventPublisherBasePtr m_impAll;
+
+    /// The interned id of ALL_EVENTS, the only type m_impAll uses
+    Event::EventTypeId m_allEventsId;
 };
     
 } // namespace core
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/EventPool.h
+ */
+
+#ifndef RAM_CORE_EVENTPOOL_H_01_24_2010
+#define RAM_CORE_EVENTPOOL_H_01_24_2010
+
+// STD Includes
+#include <cstddef>
+#include <new>
+
+// Library Includes
+#include <boost/utility.hpp>
+#include <boost/shared_ptr.hpp>
+
+// Project Includes
+#include "core/include/BoundedQueue.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** A thread safe cache of fixed size blocks of memory
+ *
+ *  Freed blocks are kept on a lock free free list (a BoundedQueue) and handed
+ *  back out by allocate(), so once a program reaches its steady state no more
+ *  trips to the heap are needed.  When the free list is full, freed blocks go
+ *  back to the heap.
+ *
+ *  The free list never blocks, but a thread preempted in the middle of taking
+ *  a block holds up the list until it runs again.  In the mean time blocks
+ *  come from and go back to the heap, just as if there was no pool.
+ */
+class RAM_EXPORT BlockPool : boost::noncopyable
+{
+public:
+    /** The default number of free blocks each pool will hold on to */
+    static const size_t DEFAULT_MAX_FREE = 1024;
+
+    /** Creates a pool
+     *
+     *  @param blockSize
+     *      The size in bytes of every block
+     *  @param maxFree
+     *      The most free blocks to keep around, rounded to a power of two
+     */
+    BlockPool(size_t blockSize, size_t maxFree = DEFAULT_MAX_FREE);
+
+    /** Frees all cached blocks, blocks still in use must not be freed later */
+    ~BlockPool();
+
+    /** The shared pool for blocks of the given size
+     *
+     *  Shared pools are never destroyed, so events released during static
+     *  destruction are still safe.
+     */
+    static BlockPool* getPool(size_t blockSize);
+
+    /** Returns a free block, only going to the heap when none is available */
+    void* allocate();
+
+    /** Returns the block to the pool */
+    void deallocate(void* block);
+
+    size_t getBlockSize() const { return m_blockSize; }
+
+    /** The number of allocate() calls which had to go to the heap */
+    size_t getHeapAllocations() const { return m_heapAllocations.get(); }
+
+    /** The number of allocate() calls satisfied by a free block */
+    size_t getReuses() const { return m_reuses.get(); }
+
+private:
+    size_t m_blockSize;
+
+    BoundedQueue<void*> m_freeBlocks;
+
+    AtomicCounter m_heapAllocations;
+    AtomicCounter m_reuses;
+};
+
+/** Gives quick access to the shared BlockPool for a size known at compile
+ *  time, without the lookup in BlockPool::getPool each time.
+ */
+template<size_t Size>
+struct SizedBlockPool
+{
+    static BlockPool* get()
+    {
+        static BlockPool* pool = BlockPool::getPool(Size);
+        return pool;
+    }
+};
+
+/** Standard allocator which gets single objects from the shared BlockPools
+ *
+ *  This is given to boost::shared_ptr so its reference count blocks come from
+ *  a pool as well.  Requests for more than one object go to the heap.
+ */
+template<class T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template<class U>
+    struct rebind
+    {
+        typedef PoolAllocator<U> other;
+    };
+
+    PoolAllocator() {}
+
+    template<class U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    pointer address(reference x) const { return &x; }
+    const_pointer address(const_reference x) const { return &x; }
+
+    pointer allocate(size_type n, const void* = 0)
+    {
+        if (1 == n)
+            return static_cast<pointer>(SizedBlockPool<sizeof(T)>::get()->
+                                        allocate());
+        return static_cast<pointer>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(pointer p, size_type n)
+    {
+        if (1 == n)
+            SizedBlockPool<sizeof(T)>::get()->deallocate(p);
+        else
+            ::operator delete(p);
+    }
+
+    size_type max_size() const { return size_t(-1) / sizeof(T); }
+
+    void construct(pointer p, const T& value) { new (p) T(value); }
+
+    void destroy(pointer p) { p->~T(); }
+};
+
+template<class T, class U>
+inline bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&)
+{
+    return true;
+}
+
+template<class T, class U>
+inline bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&)
+{
+    return false;
+}
+
+/** Creates events out of pooled memory
+ *
+ *  Events published at a high rate normally cost two heap allocations each,
+ *  one for the event and one for the shared_ptr reference count.  Events
+ *  created with EventPool reuse the memory of events which have already been
+ *  released instead:
+ *
+ *  @code
+ *  math::Vector3EventPtr event = core::EventPool<math::Vector3Event>::create();
+ *  @endcode
+ *
+ *  The result is a normal shared_ptr, so nothing downstream changes.
+ */
+template<class T>
+struct EventPool
+{
+    static boost::shared_ptr<T> create()
+    {
+        void* storage = allocate();
+        T* event = 0;
+        try {
+            event = new (storage) T();
+        } catch (...) {
+            deallocate(storage);
+            throw;
+        }
+        return wrap(event);
+    }
+
+    template<class A1>
+    static boost::shared_ptr<T> create(const A1& a1)
+    {
+        void* storage = allocate();
+        T* event = 0;
+        try {
+            event = new (storage) T(a1);
+        } catch (...) {
+            deallocate(storage);
+            throw;
+        }
+        return wrap(event);
+    }
+
+    /** The pool the events themselves come from */
+    static BlockPool* getPool()
+    {
+        return SizedBlockPool<sizeof(T)>::get();
+    }
+
+private:
+    /** Destroys the event and returns its memory to the pool */
+    struct Deleter
+    {
+        void operator()(T* event) const
+        {
+            event->~T();
+            EventPool<T>::getPool()->deallocate(event);
+        }
+    };
+
+    static void* allocate() { return getPool()->allocate(); }
+
+    static void deallocate(void* storage) { getPool()->deallocate(storage); }
+
+    static boost::shared_ptr<T> wrap(T* event)
+    {
+        return boost::shared_ptr<T>(event, Deleter(), PoolAllocator<T>());
+    }
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_EVENTPOOL_H_01_24_2010
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/EventProfiler.h
+ */
+
+#ifndef RAM_CORE_EVENTPROFILER_H_01_25_2010
+#define RAM_CORE_EVENTPROFILER_H_01_25_2010
+
+// STD Includes
+#include <map>
+#include <string>
+#include <vector>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+
+// Project Includes
+#include "core/include/Subsystem.h"
+#include "core/include/Updatable.h"
+#include "core/include/ConfigNode.h"
+#include "core/include/EventHandler.h"
+#include "core/include/Histogram.h"
+#include "core/include/Instrumentation.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** The cost of a single subscriber function, all times in nanoseconds */
+struct RAM_EXPORT HandlerProfile : boost::noncopyable
+{
+    /** Describes the function, see EventProfiler::describeHandler */
+    std::string name;
+
+    /** How long each call took */
+    Histogram cost;
+};
+
+typedef boost::shared_ptr<HandlerProfile> HandlerProfilePtr;
+
+/** Everything recorded about a single event type, times in nanoseconds */
+struct RAM_EXPORT EventTypeProfile : boost::noncopyable
+{
+    Event::EventType type;
+
+    /** Time spent in EventPublisher::publish, handlers and hub included */
+    Histogram publishTime;
+
+    /** Time the EventHub took to call all of its handlers */
+    Histogram hubTime;
+
+    /** Time spent waiting in a QueuedEventHub before being published */
+    Histogram queueTime;
+
+    /** Handlers subscribed to this type, by EventHandler::getId() */
+    std::map<size_t, HandlerProfilePtr> handlers;
+};
+
+typedef boost::shared_ptr<EventTypeProfile> EventTypeProfilePtr;
+
+/** Records where the time goes when events are published
+ *
+ *  While any EventProfiler exists, the publishers record, per event type, how
+ *  long each publish took, how long every handler took, and how long events
+ *  waited in a QueuedEventHub.  Everything goes into Histograms so the tail
+ *  latencies are visible, not just the averages.
+ *
+ *  When backgrounded, every "reportInterval" seconds (default 5) a report is
+ *  written to "fileName" (default "event_profile.txt") in the log directory,
+ *  and published as a StringEvent of type REPORT.  An empty fileName turns
+ *  off the file.
+ *
+ *  When neither a profiler nor a Tracer exists each hook costs a single well
+ *  predicted branch on Instrumentation::active().  Each thread keeps the
+ *  profiles it has used, so recording only takes the profile lock the first
+ *  time a thread sees a type or handler.  A handler's profile is dropped when
+ *  it is disconnected.
+ */
+class RAM_EXPORT EventProfiler : public Subsystem, public Updatable
+{
+public:
+    /** Published with the text of each report in a StringEvent */
+    static const Event::EventType REPORT;
+
+    EventProfiler(ConfigNode config,
+                  SubsystemList deps = SubsystemList());
+
+    virtual ~EventProfiler();
+
+    /** Creates the report from all statistics recorded so far
+     *
+     *  There is a line per event type, followed by a line for each of its
+     *  handlers, slowest first.  All times are in microseconds, and rates are
+     *  since the last report.
+     */
+    std::string createReport();
+
+    /** Writes and publishes a report when the report interval has passed */
+    virtual void update(double timestep);
+
+    // IUpdatable methods
+    virtual void setPriority(IUpdatable::Priority priority);
+
+    virtual IUpdatable::Priority getPriority();
+
+    virtual void setAffinity(size_t affinity);
+
+    virtual int getAffinity();
+
+    virtual void background(int interval);
+
+    virtual void unbackground(bool join = false);
+
+    virtual bool backgrounded();
+
+    /** True while any EventProfiler exists */
+    static bool active() { return Instrumentation::profiling(); }
+
+    /** The statistics for the given type, null if none were recorded
+     *
+     *  The handler map of the profile is only safe to read once nothing is
+     *  publishing the type.
+     */
+    static EventTypeProfilePtr getProfile(const Event::EventType& type);
+
+    /** Throws away all recorded statistics */
+    static void resetProfiles();
+
+    /** Throws away the statistics of the handler, under every type
+     *
+     *  Called by EventHandler::disconnect(), so the profiles of short lived
+     *  subscriptions don't pile up.
+     */
+    static void dropHandler(size_t handlerId);
+
+    /** A readable name for the handler, based on the type of its function */
+    static std::string describeHandler(EventHandlerPtr handler);
+
+    /** Monotonic time in nanoseconds */
+    static boost::int64_t now();
+
+    /** @defgroup Hooks Called by the event system only when active()
+     *  @{
+     */
+
+    /** Calls each handler in order, recording how long each call took */
+    static void callHandlers(Event::EventTypeId typeId,
+                             const EventHandlerList& handlers,
+                             EventPtr event);
+
+    /** Records a handler call timed by someone else, like the Tracer */
+    static void recordHandler(Event::EventTypeId typeId,
+                              EventHandlerPtr handler,
+                              boost::int64_t duration);
+
+    /** Records an EventPublisher::publish which began at start */
+    static void recordPublish(Event::EventTypeId typeId,
+                              boost::int64_t start);
+
+    /** Records an EventHub::publish which began at start */
+    static void recordHubPublish(Event::EventTypeId typeId,
+                                 boost::int64_t start);
+
+    /** Records how long an event was in a QueuedEventHub
+     *
+     *  @param queueTime
+     *      When the event was queued, from now()
+     */
+    static void recordDequeued(Event::EventTypeId typeId,
+                               boost::int64_t queueTime);
+
+    /** @} */
+
+private:
+    /** Finds or creates the profile for the type
+     *
+     *  @warning  The profile mutex must be held when calling this
+     */
+    static EventTypeProfilePtr getTypeProfile(Event::EventTypeId typeId);
+
+    /** The profile for the type from the thread's cache, filled on a miss */
+    static EventTypeProfilePtr cachedTypeProfile(Event::EventTypeId typeId);
+
+    /** The profile for the handler from the thread's cache, filled on a miss
+     */
+    static HandlerProfilePtr cachedHandlerProfile(Event::EventTypeId typeId,
+                                                  EventHandlerPtr handler);
+
+    /** Seconds between reports */
+    double m_reportInterval;
+
+    /** Where reports are written, empty for no file */
+    std::string m_filePath;
+
+    /** When the last report was made */
+    boost::int64_t m_lastReport;
+
+    /** The publish count of each type at the last report, for rates */
+    std::map<Event::EventType, boost::int64_t> m_lastCounts;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_EVENTPROFILER_H_01_25_2010
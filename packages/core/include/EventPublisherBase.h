@@ -11,16 +11,23 @@
 #ifndef RAM_CORE_EVENTPUBLISHERBASE_H_11_30_2007
 #define RAM_CORE_EVENTPUBLISHERBASE_H_11_30_2007
 
+// STD Includes
+#include <cassert>
+#include <utility>
+#include <vector>
+
 // Library Includes
 #include <boost/shared_ptr.hpp>
-#include <boost/signal.hpp>
-#include <boost/ptr_container/ptr_map.hpp>
-#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/mutex.hpp>
 
 // Project Includes
-#include "core/include/ReadWriteMutex.h"
 #include "core/include/EventConnection.h"
+#include "core/include/EventHandler.h"
 #include "core/include/EventHub.h"
+#include "core/include/EventProfiler.h"
+#include "core/include/Instrumentation.h"
+#include "core/include/SnapshotPointer.h"
+#include "core/include/Tracer.h"
 #include "core/include/Forward.h"
 
 // Must Be Included last
@@ -35,6 +42,32 @@ public:
     virtual ~EventPublisherBase() {}
 };
 
+/** Key used to subscribe to events of a type from a specific publisher */
+typedef std::pair<Event::EventTypeId, EventPublisher*> TypePublisherKey;
+
+/** Returns the event type id used to index the dispatch table for a key */
+inline Event::EventTypeId dispatchIndex(Event::EventTypeId key)
+{
+    return key;
+}
+
+inline Event::EventTypeId dispatchIndex(const TypePublisherKey& key)
+{
+    return key.first;
+}
+
+/** Implements the subscribe and publish logic of EventPublisher & EventHub
+ *
+ *  Handlers are stored in a flat table indexed by the interned event type id
+ *  (see dispatchIndex), each entry holds the handful of keys subscribed to
+ *  that type.  This means a publish is an array index and a short linear
+ *  search, no strings are compared or copied.
+ *
+ *  The whole table is an immutable snapshot, subscribe and unsubscribe build
+ *  a new one and swap it in (see SnapshotPointer).  Publish takes no lock, it
+ *  only reads the table long enough to copy the handler list for its key,
+ *  then calls the handlers, so slow handlers never block other publishers.
+ */
 template<typename T>
 class EventPublisherBaseTemplate :
     public EventPublisherBase
@@ -50,7 +83,7 @@ public:
         boost::function<void (EventPtr)> handler);
     
 
-    virtual void publish(T subscribeType, Event::EventType etype,
+    virtual void publish(T subscribeType, const Event::EventType& etype,
                          EventPublisher* sender, EventPtr event);
 
     std::string getPublisherName();
@@ -62,7 +95,7 @@ protected:
     public:
         Connection(T type,
                    EventPublisherBaseTemplate<T>* publisher,
-                   boost::signals::connection connection);
+                   EventHandlerPtr handler);
     
         virtual T getType();
         
@@ -70,25 +103,47 @@ protected:
 
         virtual bool connected();
     private:
-        /** Whether or not disconnected has been called */
-        bool m_connected;
-        
         /** Type of the event */
         T m_type;
         
         /** Publisher to which the event is connection */
         EventPublisherBaseTemplate* m_publisher;
 
-        /** The underlying boost connection */
-        boost::signals::connection m_connection;
+        /** The handler we are connected to */
+        EventHandlerPtr m_handler;
     };
 
     typedef boost::shared_ptr<Connection> ConnectionPtr;
     
 private:
+    /// The handlers for a single key
+    struct Slot
+    {
+        Slot(const T& key_) : key(key_), handlers(new EventHandlerList()) {}
+
+        T key;
+
+        EventHandlerListPtr handlers;
+    };
+
+    typedef std::vector<Slot> SlotList;
+
+    /// Maps event type id -> the slots subscribed to that type
+    typedef std::vector<SlotList> SlotTable;
+    
+    /** Finds the slot for the given key, returns 0 if there is none */
+    static Slot* findSlot(SlotTable& table, const T& key);
+
+    static const Slot* findSlot(const SlotTable& table, const T& key);
+
+    /** Swaps in a copy of the table with the handlers of the key replaced
+     *
+     *  @warning  m_writeMutex must be held when calling this
+     */
+    void setHandlers(const T& key, EventHandlerListPtr handlers);
+    
     /** Remove handler from recieving particular event types */
-    void unSubscribe(T type,
-                     boost::signals::connection connection);
+    void unSubscribe(T type, EventHandlerPtr handler);
     
     // So it can call unSubscribe
     friend class Connection;
@@ -99,15 +154,11 @@ private:
     /// The hub to which all messages are puslished
     EventHubPtr m_hub;
     
-    /// Protects access to map of types->signals
-    ReadWriteMutex m_signalMapMutex;
-
-    /// Protects access to each signal (they are not thread safe)
-    boost::ptr_map<T, boost::recursive_mutex> m_signalMutexes;
+    /// Serializes subscribe and unsubscribe, publish never takes it
+    boost::mutex m_writeMutex;
 
-    typedef boost::signal<void (EventPtr)>  EventSignal;
-    /// Maps types -> signals
-    boost::ptr_map<T, EventSignal>  m_signals;
+    /// The current dispatch table, never changed once published
+    SnapshotPointer<SlotTable> m_table;
 };
 
 // ------------------------------------------------------------------------- //
@@ -118,7 +169,8 @@ template<typename T>
 EventPublisherBaseTemplate<T>::EventPublisherBaseTemplate(EventHubPtr hub,
                                                           std::string name) :
     m_name(name),
-    m_hub(hub)    
+    m_hub(hub),
+    m_table(new SlotTable())
 {
 }
     
@@ -127,15 +179,26 @@ EventConnectionPtr EventPublisherBaseTemplate<T>::subscribe(
     T type,
     boost::function<void (EventPtr)> handler)
 {
-    ReadWriteMutex::ScopedWriteLock lock(m_signalMapMutex);
+    EventHandlerPtr eventHandler(new EventHandler(handler));
+    
+    boost::mutex::scoped_lock lock(m_writeMutex);
+
+    // Publish a new snapshot with the handler added
+    EventHandlerList* handlers = new EventHandlerList();
+    const Slot* slot = findSlot(*m_table.get(), type);
+    if (slot)
+        *handlers = *slot->handlers;
+    handlers->push_back(eventHandler);
+    setHandlers(type, EventHandlerListPtr(handlers));
+    
     return EventConnectionPtr(
         new typename EventPublisherBaseTemplate<T>::Connection(type, this,
-            m_signals[type].connect(handler)));
+                                                               eventHandler));
 }
 
 template<typename T>
 void EventPublisherBaseTemplate<T>::publish(T subscribeType,
-                                            Event::EventType etype,
+                                            const Event::EventType& etype,
                                             EventPublisher* sender,
                                             EventPtr event)
 {
@@ -143,16 +206,33 @@ void EventPublisherBaseTemplate<T>::publish(T subscribeType,
     event->type = etype;
     event->sender = sender;
 
-    boost::recursive_mutex* signalMutex;
+    // Grab the current snapshot of subscribers
+    EventHandlerListPtr handlers;
     {
-        ReadWriteMutex::ScopedReadLock mapLock(m_signalMapMutex);
-        signalMutex = &m_signalMutexes[subscribeType];
+        typename SnapshotPointer<SlotTable>::ScopedRead read(m_table);
+        const Slot* slot = findSlot(*read.get(), subscribeType);
+        if (slot)
+            handlers = slot->handlers;
     }
+    
+    // Call subscribers, timing each one when tracing or profiling.  The
+    // Tracer hands its times to the EventProfiler as well.  Both record under
+    // the event's own type, even for ALL_EVENTS subscribers.
+    if (Instrumentation::active())
     {
-        boost::recursive_mutex::scoped_lock lock(*signalMutex);
-        
-        // Call subscribers
-        m_signals[subscribeType](event);
+        if (!handlers)
+            ;
+        else if (Tracer::active())
+            Tracer::callHandlers(etype.getId(), *handlers, event);
+        else
+            EventProfiler::callHandlers(etype.getId(), *handlers, event);
+    }
+    else if (handlers)
+    {
+        EventHandlerList::const_iterator iter = handlers->begin();
+        EventHandlerList::const_iterator end = handlers->end();
+        for (; iter != end; ++iter)
+            (*iter)->call(event);
     }
 
     if (m_hub)
@@ -164,29 +244,83 @@ std::string EventPublisherBaseTemplate<T>::getPublisherName()
 {
     return m_name;
 }
+
+template<typename T>
+typename EventPublisherBaseTemplate<T>::Slot*
+EventPublisherBaseTemplate<T>::findSlot(SlotTable& table, const T& key)
+{
+    Event::EventTypeId index = dispatchIndex(key);
+    if (index >= table.size())
+        return 0;
+
+    SlotList& slots = table[index];
+    for (typename SlotList::iterator iter = slots.begin();
+         iter != slots.end(); ++iter)
+    {
+        if (iter->key == key)
+            return &(*iter);
+    }
     
+    return 0;
+}
+
 template<typename T>
-void EventPublisherBaseTemplate<T>::unSubscribe(T type,
-    boost::signals::connection connection)
+const typename EventPublisherBaseTemplate<T>::Slot*
+EventPublisherBaseTemplate<T>::findSlot(const SlotTable& table, const T& key)
+{
+    return findSlot(const_cast<SlotTable&>(table), key);
+}
+
+template<typename T>
+void EventPublisherBaseTemplate<T>::setHandlers(const T& key,
+                                                EventHandlerListPtr handlers)
 {
-    boost::recursive_mutex* signalMutex;
+    SlotTable* table = new SlotTable(*m_table.get());
+
+    Slot* slot = findSlot(*table, key);
+    if (!slot)
     {
-        ReadWriteMutex::ScopedReadLock mapLock(m_signalMapMutex);
-        signalMutex = &m_signalMutexes[type];
+        // Grow the table to hold the new type if needed
+        Event::EventTypeId index = dispatchIndex(key);
+        if (index >= table->size())
+            table->resize(index + 1);
+        (*table)[index].push_back(Slot(key));
+        slot = &(*table)[index].back();
     }
+    slot->handlers = handlers;
+
+    // Waits for any publish still reading the old table
+    m_table.reset(table);
+}
     
-    boost::recursive_mutex::scoped_lock lock(*signalMutex);
-    connection.disconnect();
+template<typename T>
+void EventPublisherBaseTemplate<T>::unSubscribe(T type,
+                                                EventHandlerPtr handler)
+{
+    boost::mutex::scoped_lock lock(m_writeMutex);
+
+    const Slot* slot = findSlot(*m_table.get(), type);
+    assert(slot && "Unsubscribing from a type never subscribed to");
+
+    // Publish a new snapshot without the handler
+    EventHandlerList* handlers = new EventHandlerList();
+    handlers->reserve(slot->handlers->size());
+    EventHandlerList::const_iterator iter = slot->handlers->begin();
+    for (; iter != slot->handlers->end(); ++iter)
+    {
+        if (*iter != handler)
+            handlers->push_back(*iter);
+    }
+    setHandlers(type, EventHandlerListPtr(handlers));
 }
 
 template<typename T>
 EventPublisherBaseTemplate<T>::Connection::Connection(T type,
                    EventPublisherBaseTemplate<T>* publisher,
-                   boost::signals::connection connection) :
-    m_connected(true),
+                   EventHandlerPtr handler) :
     m_type(type),
     m_publisher(publisher),
-    m_connection(connection)
+    m_handler(handler)
 {
 }
 
@@ -199,14 +333,16 @@ T EventPublisherBaseTemplate<T>::Connection::getType()
 template<typename T>
 void EventPublisherBaseTemplate<T>::Connection::disconnect()
 {
-    m_publisher->unSubscribe(m_type, m_connection);
-    m_connected = false;
+    // Remove from future snapshots, then wait out any calls on other threads
+    // which are working from an older snapshot
+    m_publisher->unSubscribe(m_type, m_handler);
+    m_handler->disconnect();
 }
 
 template<typename T>
 bool EventPublisherBaseTemplate<T>::Connection::connected()
 {
-    return m_connected;
+    return m_handler->connected();
 }
     
 } // namespace core
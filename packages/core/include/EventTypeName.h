@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/EventTypeName.h
+ */
+
+#ifndef RAM_CORE_EVENTTYPENAME_H_02_20_2010
+#define RAM_CORE_EVENTTYPENAME_H_02_20_2010
+
+// STD Includes
+#include <string>
+
+// Project Includes
+#include "core/include/EventTypeRegistry.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** An event type string which carries its EventTypeRegistry id
+ *
+ *  The name is interned once when it is built from a string, and copies keep
+ *  the id, so the event types defined with RAM_CORE_EVENT_TYPE are hashed
+ *  only during static initialization.  Publishing and dispatching then index
+ *  by the id directly.
+ *
+ *  It is still a std::string so it compares, prints, and converts like one.
+ *  Only assign a new name to it, changing the characters in place (ie. with
+ *  append) leaves the old id behind.
+ */
+class RAM_EXPORT EventTypeName : public std::string
+{
+public:
+    /** An empty name, its id is looked up when first asked for */
+    EventTypeName();
+
+    EventTypeName(const std::string& name);
+
+    EventTypeName(const char* name);
+
+    EventTypeName& operator=(const std::string& name);
+
+    EventTypeName& operator=(const char* name);
+
+    /** The id of this type in the EventTypeRegistry */
+    EventTypeRegistry::TypeId getId() const
+    {
+        if (EventTypeRegistry::INVALID_TYPE_ID != m_id)
+            return m_id;
+        return EventTypeRegistry::intern(*this);
+    }
+
+private:
+    EventTypeRegistry::TypeId m_id;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_EVENTTYPENAME_H_02_20_2010
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/EventTypeRegistry.h
+ */
+
+#ifndef RAM_CORE_EVENTTYPEREGISTRY_H_01_12_2010
+#define RAM_CORE_EVENTTYPEREGISTRY_H_01_12_2010
+
+// STD Includes
+#include <string>
+#include <cstddef>
+
+// Project Includes
+#include "core/include/ReadWriteMutex.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Maps event type names to small, dense integer ids
+ *
+ *  Every event type defined with RAM_CORE_EVENT_TYPE is interned here during
+ *  static initialization, so the ids of the C++ event types are stable for
+ *  the life of the process.  Types created at run time (ie. from python) are
+ *  interned the first time they are subscribed to or published.  The ids are
+ *  used by the EventPublisher and EventHub to index their dispatch tables
+ *  directly, instead of searching maps keyed on the type string.
+ */
+class RAM_EXPORT EventTypeRegistry
+{
+public:
+    typedef size_t TypeId;
+
+    /** The id returned by lookup() for types which are not registered */
+    static const TypeId INVALID_TYPE_ID;
+
+    /** Returns the id of the given type, registering it if needed */
+    static TypeId intern(const std::string& name);
+
+    /** Returns the id of the given type, or INVALID_TYPE_ID if unknown */
+    static TypeId lookup(const std::string& name);
+
+    /** Returns the name the given id was registered under
+     *
+     *  @return
+     *      The event type string, or an empty string if the id is invalid.
+     */
+    static std::string getName(TypeId id);
+
+    /** The number of event types currently registered */
+    static size_t getTypeCount();
+
+private:
+    struct Table;
+
+    /** Finds the id of the type with the given name and hash
+     *
+     *  @warning  The registry mutex must be held when calling this
+     */
+    static TypeId find(Table* table, const std::string& name, size_t hash);
+
+    /** Get the mutex used to share access to the registry */
+    static ReadWriteMutex* getRegistryMutex();
+
+    /** Get the pointer to the registry */
+    static Table* getTable();
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_EVENTTYPEREGISTRY_H_01_12_2010
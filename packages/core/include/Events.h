@@ -50,6 +50,18 @@ struct IntEvent : public core::Event
 
 typedef boost::shared_ptr< IntEvent > IntEventPtr;
 
+/** A compact snapshot of the metrics, see MetricsReporter */
+struct MetricsEvent : public core::Event
+{
+    virtual EventPtr clone();
+
+    /** Full names of the metrics, in the same order as the values */
+    std::vector<std::string> names;
+    std::vector<double> values;
+};
+
+typedef boost::shared_ptr<MetricsEvent> MetricsEventPtr;
+
 } // namespace core
 } // namespace ram
 
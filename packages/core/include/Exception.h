@@ -38,6 +38,27 @@ private:
     std::string m_key;
 };
 
+class ConfigException : public std::exception
+{
+public:
+    ConfigException(std::string message) :
+        m_message(message)
+    {
+    }
+
+    virtual ~ConfigException() throw ()
+    {
+    }
+
+    virtual const char* what() const throw()
+    {
+        return m_message.c_str();
+    }
+
+private:
+    std::string m_message;
+};
+
 } // namespace core
 } // namespace ram
 
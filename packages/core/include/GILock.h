@@ -52,6 +52,23 @@ private:
     GILock m_lock;
 };
 
+/** Lets other threads use the python interpreter while in scope
+ *
+ *  The calling thread must not touch python until the release goes out of
+ *  scope.  Does nothing if python is not running, or the calling thread does
+ *  not hold the GIL, so it is safe where C++ or python could be the caller.
+ */
+class ScopedGILRelease
+{
+public:
+    ScopedGILRelease();
+
+    ~ScopedGILRelease();
+
+private:
+    PyThreadState* m_state;
+};
+
 } // namespace core
 } // namespace ram
 
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/Histogram.h
+ */
+
+#ifndef RAM_CORE_HISTOGRAM_H_01_25_2010
+#define RAM_CORE_HISTOGRAM_H_01_25_2010
+
+// STD Includes
+#include <vector>
+
+// Library Includes
+#include <boost/utility.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** A thread safe histogram of integer values with a fixed relative precision
+ *
+ *  The buckets are laid out like an HDR histogram: values below
+ *  2^SUB_BUCKET_BITS get a bucket each, and every power of two above that is
+ *  split into 2^(SUB_BUCKET_BITS - 1) equal buckets.  So every value is known
+ *  to within 1/64th (about 1.5%) while a single histogram covers nanoseconds
+ *  to minutes in a fixed 18k of memory.
+ *
+ *  Min, max, count and mean are exact.
+ */
+class RAM_EXPORT Histogram : boost::noncopyable
+{
+public:
+    /** Sets the precision, see the class description */
+    static const int SUB_BUCKET_BITS = 7;
+
+    /** Values of 2^HIGHEST_BIT or more are counted in the last bucket */
+    static const int HIGHEST_BIT = 40;
+
+    Histogram();
+
+    /** Adds a value, negative values are counted as zero */
+    void record(boost::int64_t value);
+
+    /** Removes all values */
+    void reset();
+
+    /** Adds all the values recorded in the other histogram to this one */
+    void merge(const Histogram& other);
+
+    /** The number of values recorded */
+    boost::int64_t getCount() const;
+
+    /** The smallest value recorded, zero when empty */
+    boost::int64_t getMin() const;
+
+    /** The largest value recorded, zero when empty */
+    boost::int64_t getMax() const;
+
+    /** The average of all values, zero when empty */
+    double getMean() const;
+
+    /** Returns the value which the given percent of values are at or below
+     *
+     *  @param percentile
+     *      From 0 to 100, ie: 99 for the 99th percentile
+     *
+     *  @return
+     *      The largest value in the bucket the percentile falls in, but never
+     *      more than getMax().  Zero when empty.
+     */
+    boost::int64_t getValueAtPercentile(double percentile) const;
+
+private:
+    /** The bucket the value is counted in */
+    static size_t bucketIndex(boost::int64_t value);
+
+    /** The largest value counted in the given bucket */
+    static boost::int64_t highestValue(size_t index);
+
+    /** Protects everything below */
+    mutable boost::mutex m_mutex;
+
+    std::vector<boost::int64_t> m_counts;
+
+    boost::int64_t m_count;
+    boost::int64_t m_total;
+    boost::int64_t m_min;
+    boost::int64_t m_max;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_HISTOGRAM_H_01_25_2010
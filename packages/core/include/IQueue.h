@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/IQueue.h
+ */
+
+#ifndef RAM_CORE_IQUEUE_H_01_21_2010
+#define RAM_CORE_IQUEUE_H_01_21_2010
+
+// STD Includes
+#include <vector>
+
+// Library Includes
+#include <boost/utility.hpp>
+#include <boost/thread/xtime.hpp>
+
+namespace ram {
+namespace core {
+
+/** The interface shared by the thread safe queues
+ *
+ *  This lets users of a queue pick the ThreadedQueue or the BoundedQueue at
+ *  run time (see makeQueue() in QueueFactory.h).
+ */
+template <typename T>
+class IQueue : boost::noncopyable
+{
+public:
+    virtual ~IQueue() {}
+
+    /** Adds an item to the back of the queue
+     *
+     *  @return
+     *      false if the queue was full and the item was dropped
+     */
+    virtual bool push(const T& newData) = 0;
+
+    /** Copies the next item into data if there is one
+     *
+     *  @return true if there is data, false is there isn't
+     */
+    virtual bool popNoWait(T& data) = 0;
+
+    /** Waits until an item is available and returns it */
+    virtual T popWait() = 0;
+
+    /** Waits the given relative time for an item
+     *
+     *  @return true if there is data, false is there isn't
+     */
+    virtual bool popTimedWait(const boost::xtime& timeout, T& data) = 0;
+
+    /** Appends every item currently in the queue to the given vector
+     *
+     *  This lets the consumer handle a burst of items with a single pass
+     *  through the queues synchronization.
+     *
+     *  @return
+     *      The number of items added to the vector
+     */
+    virtual size_t popAll(std::vector<T>& items) = 0;
+
+    /** The number of items in the queue, only a snapshot */
+    virtual size_t size() const = 0;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_IQUEUE_H_01_21_2010
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/Instrumentation.h
+ */
+
+#ifndef RAM_CORE_INSTRUMENTATION_H_02_22_2010
+#define RAM_CORE_INSTRUMENTATION_H_02_22_2010
+
+// Project Includes
+#include "core/include/Atomic.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Whether any EventProfiler or Tracer exists, in a single word
+ *
+ *  EventProfilers are counted in the low bits and Tracers above them, so the
+ *  publish hooks test for both with one load and one branch, and only look
+ *  at which one is running once they know something is.
+ */
+class RAM_EXPORT Instrumentation
+{
+public:
+    /** Added to the word by each EventProfiler */
+    static const AtomicWord PROFILER = 1;
+
+    /** Added to the word by each Tracer */
+    static const AtomicWord TRACER = 1 << 16;
+
+    /** True while any EventProfiler or Tracer exists */
+    static bool active() { return 0 != s_active; }
+
+    /** True while any EventProfiler exists */
+    static bool profiling() { return 0 != (s_active & (TRACER - 1)); }
+
+    /** True while any Tracer exists */
+    static bool tracing() { return s_active >= TRACER; }
+
+    /** Counts a new instrument, either PROFILER or TRACER */
+    static void add(AtomicWord instrument);
+
+    /** Stops counting an instrument, either PROFILER or TRACER */
+    static void remove(AtomicWord instrument);
+
+private:
+    /** The count of each instrument in existence */
+    static volatile AtomicWord s_active;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_INSTRUMENTATION_H_02_22_2010
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/LockstepScheduler.h
+ */
+
+#ifndef RAM_CORE_LOCKSTEPSCHEDULER_H_02_01_2010
+#define RAM_CORE_LOCKSTEPSCHEDULER_H_02_01_2010
+
+// STD Includes
+#include <map>
+#include <queue>
+#include <vector>
+
+// Library Includes
+#include <boost/utility.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+class Updatable;
+
+/** Runs every scheduled Updatable from one thread, on the virtual Clock
+ *
+ *  Under Clock::VIRTUAL, Updatables backgrounded with an interval are
+ *  scheduled here instead of getting a thread or joining the shared pool.
+ *  The driver thread takes the earliest deadline, moves the clock to it and
+ *  calls update() with the exact interval, so nothing ever waits on the real
+ *  clock and the run goes as fast as the updates allow.  Updates with the
+ *  same deadline run in the order they were first scheduled, so the same
+ *  setup gives the same sequence of updates on every run.
+ *
+ *  Threads sleeping on the Clock, like the EventPlayer, are woken at their
+ *  time in the same sequence, and the driver waits for them to sleep again
+ *  before moving on.  Threads which wait on anything else, like the
+ *  AsyncDelivery and QueuedEventHub consumers, still run freely.
+ */
+class RAM_EXPORT LockstepScheduler : boost::noncopyable
+{
+public:
+    LockstepScheduler();
+
+    /** Stops and joins the driver */
+    ~LockstepScheduler();
+
+    /** The scheduler Updatables use under the virtual clock, never
+     *  destroyed */
+    static LockstepScheduler* getInstance();
+
+    /** Starts updating the object every interval milliseconds of the clock
+     *
+     *  The first update is one interval from now.  If the object is already
+     *  scheduled this changes its interval, keeping its place in the order.
+     */
+    void schedule(Updatable* updatable, int interval);
+
+    /** Stops updating the object
+     *
+     *  @param join
+     *      Wait for an update in progress to finish, unless the update is
+     *      the one calling this.
+     */
+    void unschedule(Updatable* updatable, bool join = false);
+
+    /** True if the object is currently scheduled */
+    bool scheduled(Updatable* updatable);
+
+    /** The number of updates run so far */
+    size_t getUpdateCount();
+
+    /** Real seconds to wait for woken sleepers, 0.1 by default */
+    void setSettleTimeout(double seconds);
+
+private:
+    struct Task;
+    typedef boost::shared_ptr<Task> TaskPtr;
+    typedef std::map<Updatable*, TaskPtr> TaskMap;
+
+    /** An entry in the deadline heap */
+    struct Entry
+    {
+        Entry(boost::int64_t deadline_, size_t generation_, TaskPtr task_);
+
+        /** Earliest deadline first, then the first scheduled */
+        bool operator>(const Entry& other) const;
+
+        boost::int64_t deadline;
+        size_t generation;
+        TaskPtr task;
+    };
+
+    /** Puts the task in the heap, needs m_mutex held */
+    void queueTask(TaskPtr task, boost::int64_t deadline);
+
+    /** The body of the driver thread */
+    void driverLoop();
+
+    /** Protects everything below */
+    boost::mutex m_mutex;
+
+    /** Signaled when work is added, or we are stopping */
+    boost::condition m_workAvailable;
+
+    /** Signaled when any update finishes */
+    boost::condition m_updateFinished;
+
+    bool m_stop;
+
+    /** Started with the first task */
+    boost::thread* m_driver;
+
+    TaskMap m_tasks;
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> >
+        m_heap;
+
+    /** Given to each new task, it breaks ties between equal deadlines */
+    size_t m_nextSequence;
+
+    size_t m_updateCount;
+
+    double m_settleTimeout;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_LOCKSTEPSCHEDULER_H_02_01_2010
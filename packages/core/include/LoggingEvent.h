@@ -19,6 +19,10 @@ namespace core {
 /** Subclass of standard Log4Cpp event to allow copying */
 struct LoggingEvent : log4cpp::LoggingEvent
 {
+    /** Creates an empty event, needed to store events in a BoundedQueue */
+    inline LoggingEvent() :
+    log4cpp::LoggingEvent("", "", "", log4cpp::Priority::NOTSET) {}
+
     /** Standard Log4cpp constructor see there docs */
     inline LoggingEvent(const std::string& category,
                         const std::string& message, 
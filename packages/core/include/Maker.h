@@ -343,6 +343,16 @@ public:
         return false;
     }
     
+    /** Returns the maker newObject would use for the given parameters
+     *
+     *  Throws the same errors as newObject when there is no maker.
+     */
+    static Maker* getMaker(Param param)
+    {
+        Key key(KeyExtract::extractKey(param));
+        return MakerLookup::lookupMaker(getRegistry(), key);
+    }
+
     /** Creates a new object based on the given parameters
      *
      *  This uses the KeyExtract policy to pull the key from the parameters.
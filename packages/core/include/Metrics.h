@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/Metrics.h
+ */
+
+#ifndef RAM_CORE_METRICS_H_02_05_2010
+#define RAM_CORE_METRICS_H_02_05_2010
+
+// STD Includes
+#include <map>
+#include <string>
+#include <typeinfo>
+
+// Library Includes
+#include <boost/utility.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+
+// Project Includes
+#include "core/include/Histogram.h"
+#include "core/include/Atomic.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** A count which many threads can add to without contending
+ *
+ *  Each thread adds to its own cache line sized shard, so increment() is a
+ *  single uncontended atomic add.  get() sums the shards.
+ */
+class RAM_EXPORT Counter : boost::noncopyable
+{
+public:
+    /** The number of shards the threads are spread over */
+    static const int SHARDS = 16;
+
+    Counter();
+
+    /** Adds the amount to the count */
+    void increment(AtomicWord amount = 1);
+
+    /** The total of all increments, only a snapshot while they continue */
+    AtomicWord get() const;
+
+private:
+    static const int CACHE_LINE = 64;
+
+    /** Padded out so no two shards share a cache line */
+    struct Shard
+    {
+        volatile AtomicWord value;
+        char padding[CACHE_LINE - sizeof(AtomicWord)];
+    };
+
+    /** Room for the shards starting on a cache line, new only lines the
+     *  counter up to 8 or 16 bytes */
+    char m_storage[(SHARDS + 1) * CACHE_LINE];
+
+    /** The first cache line in m_storage */
+    Shard* m_shards;
+};
+
+typedef boost::shared_ptr<Counter> CounterPtr;
+
+/** The latest value of something, like a rate or a level
+ *
+ *  The value is either set(), or sampled from a function each time it is
+ *  read.  set() and get() never lock, but only one thread should set a given
+ *  gauge.
+ */
+class RAM_EXPORT Gauge : boost::noncopyable
+{
+public:
+    typedef boost::function<double ()> SampleFunction;
+
+    Gauge();
+
+    /** Creates a gauge which reads its value from the function */
+    Gauge(SampleFunction sample);
+
+    void set(double value);
+
+    double get() const;
+
+private:
+    /** Odd while a set() is in progress, readers retry when it changes */
+    volatile AtomicWord m_sequence;
+
+    volatile double m_value;
+
+    SampleFunction m_sample;
+};
+
+typedef boost::shared_ptr<Gauge> GaugePtr;
+
+typedef boost::shared_ptr<Histogram> HistogramPtr;
+
+/** A copy of every metric at a moment in time, by full name */
+struct RAM_EXPORT MetricsSnapshot
+{
+    std::map<std::string, AtomicWord> counters;
+    std::map<std::string, double> gauges;
+    std::map<std::string, HistogramPtr> histograms;
+};
+
+/** Every Counter, Gauge and Histogram in the process, by name
+ *
+ *  Metrics are registered under their owner, normally the name of the
+ *  Subsystem they belong to, and their full name is "owner.name".  Asking for
+ *  a name twice gives the same metric, so metrics can be shared.
+ *
+ *  The registry only holds on to metrics while someone else does.  So keep
+ *  the returned pointer, and let it go when the owner goes away.
+ */
+class RAM_EXPORT MetricsRegistry
+{
+public:
+    /** Finds or creates the counter */
+    static CounterPtr counter(const std::string& owner,
+                              const std::string& name);
+
+    /** Finds or creates the gauge */
+    static GaugePtr gauge(const std::string& owner, const std::string& name);
+
+    /** Creates a gauge which is sampled with the given function
+     *
+     *  This replaces any gauge of the same name.  The function is called with
+     *  the registry lock held, it must be quick and not use the registry.
+     */
+    static GaugePtr gauge(const std::string& owner, const std::string& name,
+                          Gauge::SampleFunction sample);
+
+    /** Finds or creates the histogram */
+    static HistogramPtr histogram(const std::string& owner,
+                                  const std::string& name);
+
+    /** Copies the current value of every metric still in use */
+    static MetricsSnapshot snapshot();
+
+    /** The unqualified name of a type, for metrics named after a class */
+    static std::string typeName(const std::type_info& type);
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_METRICS_H_02_05_2010
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/MetricsReporter.h
+ */
+
+#ifndef RAM_CORE_METRICSREPORTER_H_02_05_2010
+#define RAM_CORE_METRICSREPORTER_H_02_05_2010
+
+// STD Includes
+#include <string>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+
+// Project Includes
+#include "core/include/Subsystem.h"
+#include "core/include/Updatable.h"
+#include "core/include/ConfigNode.h"
+#include "core/include/Metrics.h"
+#include "core/include/Events.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Periodically reports everything in the MetricsRegistry
+ *
+ *  When backgrounded, every "reportInterval" seconds (default 5) a snapshot of
+ *  all metrics is appended to "fileName" (default "metrics.txt") in the log
+ *  directory.  An empty fileName turns off the file.
+ *
+ *  With "publish" set to 1 each snapshot is also published as a MetricsEvent
+ *  of type METRICS, which the NetworkPublisher can ship off the vehicle.
+ *  Histograms go into the event as their count, mean and 99th percentile.
+ */
+class RAM_EXPORT MetricsReporter : public Subsystem, public Updatable
+{
+public:
+    /** Published with each snapshot in a MetricsEvent, if enabled */
+    static const Event::EventType METRICS;
+
+    MetricsReporter(ConfigNode config,
+                    SubsystemList deps = SubsystemList());
+
+    virtual ~MetricsReporter();
+
+    /** Creates the report from a snapshot of the metrics
+     *
+     *  There is a line per metric, ordered by name.  Histograms give their
+     *  count, mean, 50th, 99th percentile and max.
+     */
+    static std::string createReport(const MetricsSnapshot& snapshot);
+
+    /** Creates the event published for the snapshot */
+    static MetricsEventPtr createEvent(const MetricsSnapshot& snapshot);
+
+    /** Takes a snapshot when the report interval has passed */
+    virtual void update(double timestep);
+
+    // IUpdatable methods
+    virtual void setPriority(IUpdatable::Priority priority);
+
+    virtual IUpdatable::Priority getPriority();
+
+    virtual void setAffinity(size_t affinity);
+
+    virtual int getAffinity();
+
+    virtual void background(int interval);
+
+    virtual void unbackground(bool join = false);
+
+    virtual bool backgrounded();
+
+private:
+    /** Seconds between reports */
+    double m_reportInterval;
+
+    /** Where reports are appended, empty for no file */
+    std::string m_filePath;
+
+    /** Whether to publish a MetricsEvent with each report */
+    bool m_publish;
+
+    /** When the last report was made, in microseconds */
+    boost::int64_t m_lastReport;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_METRICSREPORTER_H_02_05_2010
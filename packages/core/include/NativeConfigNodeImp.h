@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/NativeConfigNodeImp.h
+ */
+
+#ifndef RAM_CORE_NATIVECONFIGNODEIMP_H_01_26_2010
+#define RAM_CORE_NATIVECONFIGNODEIMP_H_01_26_2010
+
+// STD Includes
+#include <string>
+#include <ostream>
+#include <vector>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+
+// Project Includes
+#include "core/include/ConfigNode.h"
+#include "core/include/ConfigNodeImp.h"
+#include "core/include/ConfigSnapshot.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/**
+ * Implements the ConfigNodeImp on top of a ConfigSnapshot, without python
+ *
+ * Behaves like the PythonConfigNodeImp: missing keys give None nodes,
+ * containers convert to their python literal with asString, and values can
+ * only be set on map nodes.  Conversion errors throw a ConfigException.
+ */
+class RAM_EXPORT NativeConfigNodeImp : public ConfigNodeImp
+{
+public:
+    /** A node of the snapshot's tree */
+    NativeConfigNodeImp(ConfigSnapshotPtr snapshot,
+                        boost::uint32_t node = ConfigSnapshot::ROOT,
+                        std::string debugPath = "ROOT");
+
+    /** A scalar value which is not in the tree, a set() value or None */
+    NativeConfigNodeImp(ConfigSnapshotPtr snapshot, ConfigType type,
+                        std::string text, std::string debugPath);
+
+    virtual ~NativeConfigNodeImp() {};
+
+    /** Grab a section of the config like an array */
+    virtual ConfigNodeImpPtr idx(int index);
+
+    /** Grab a sub node with the same name */
+    virtual ConfigNodeImpPtr map(std::string key);
+
+    /** Convert the node to a string value */
+    virtual std::string asString();
+
+    /** Attempts conversion to string, if it fails return def */
+    virtual std::string asString(const std::string& def);
+
+    /** Convert the node to a double */
+    virtual double asDouble();
+
+    /** Attempts conversion to string, if it fails return def */
+    virtual double asDouble(const double def);
+
+    /** Convert the node to an int */
+    virtual int asInt();
+
+    /** Attempts conversion to int, if it fails return def */
+    virtual int asInt(const int def);
+
+    /** Returns the list of sub nodes of the current config node */
+    virtual NodeNameList subNodes();
+
+    /** The number of elements in an array or map node */
+    virtual size_t size();
+
+    /** Map a key to a given value */
+    virtual void set(std::string key, std::string str);
+
+    virtual void set(std::string key, int value);
+
+    /** Returns the config file in a python evalable format */
+    virtual std::string toString();
+
+    /** Dumps the config to disk as YAML
+     *
+     * @param fileName File to dump data to
+     * @param silent A silent write will never throw, even if the file can not
+     *               be written.
+     */
+    virtual void writeToFile(std::string fileName, bool silent);
+
+private:
+    ConfigType getType();
+
+    /** Writes the node's value as a python literal */
+    void writePython(std::ostream& out);
+
+    /** Writes the node's value as YAML, indented by the given amount */
+    void writeYaml(std::ostream& out, int indent);
+
+    /** The key names of a map node, the snapshot's and those set() */
+    std::vector<std::string> getKeys();
+
+    /** Throws a ConfigException for the failed conversion */
+    void conversionError(const std::string& method);
+
+    ConfigSnapshotPtr m_snapshot;
+
+    /** The node in the snapshot, ConfigSnapshot::NO_NODE when detached */
+    boost::uint32_t m_node;
+
+    /** Value of detached nodes */
+    ConfigType m_type;
+    std::string m_text;
+
+    std::string m_debugPath;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_NATIVECONFIGNODEIMP_H_01_26_2010
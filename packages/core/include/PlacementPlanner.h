@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/PlacementPlanner.h
+ */
+
+#ifndef RAM_CORE_PLACEMENTPLANNER_H_02_07_2010
+#define RAM_CORE_PLACEMENTPLANNER_H_02_07_2010
+
+// STD Includes
+#include <string>
+#include <utility>
+#include <vector>
+
+// Project Includes
+#include "core/include/CpuTopology.h"
+#include "core/include/IUpdatable.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Picks the CPU and priority of each subsystem from what kind of work it does
+ *
+ *  Subsystems give a hint instead of a raw core number, and the planner lays
+ *  them out over the physical cores of the machine:
+ *   - realtime: a physical core each, isolated cores first, then from the
+ *     highest core down.  Run at RT_NORMAL_PRIORITY.
+ *   - compute: spread over the remaining cores, one per core before doubling
+ *     up.  Run at NORMAL_PRIORITY.
+ *   - io: share the housekeeping core, the first core which isn't isolated,
+ *     so they wake up quickly without disturbing anyone.  HIGH_PRIORITY.
+ *   - background: share the housekeeping core at LOW_PRIORITY.
+ *
+ *  Only realtime subsystems are placed on isolated cores, and the others stay
+ *  off realtime cores while there is anywhere else to go.
+ */
+class RAM_EXPORT PlacementPlanner
+{
+public:
+    enum Hint
+    {
+        REALTIME,
+        COMPUTE,
+        IO,
+        BACKGROUND
+    };
+
+    /** Where a single subsystem goes */
+    struct RAM_EXPORT Placement
+    {
+        std::string name;
+        Hint hint;
+
+        /** The CPU to pin to, -1 to leave it to the OS */
+        int cpu;
+
+        IUpdatable::Priority priority;
+    };
+
+    typedef std::vector<Placement> PlacementList;
+
+    PlacementPlanner(const CpuTopology& topology);
+
+    /** Converts "realtime", "compute", "io" or "background" to a Hint */
+    static Hint stringToHint(std::string str);
+
+    static std::string hintToString(Hint hint);
+
+    /** Adds a subsystem to be placed, earlier ones get first pick */
+    void request(const std::string& name, Hint hint);
+
+    /** Places every requested subsystem */
+    PlacementList plan() const;
+
+    /** Describes each placement on a line, for the logs */
+    std::string describe(const PlacementList& placements) const;
+
+    /** A warning for each physical core shared by realtime subsystems
+     *
+     *  The placements can differ from what plan() gave, when affinities were
+     *  set by hand.
+     */
+    std::vector<std::string> findConflicts(
+        const PlacementList& placements) const;
+
+private:
+    CpuTopology m_topology;
+
+    std::vector<std::pair<std::string, Hint> > m_requests;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_PLACEMENTPLANNER_H_02_07_2010
@@ -26,6 +26,7 @@
 // Project Includes
 #include "core/include/ConfigNode.h"
 #include "core/include/ConfigNodeImp.h"
+#include "core/include/ConfigSnapshot.h"
 
 // Must Be Included last
 #include "core/include/Export.h"
@@ -99,10 +100,28 @@ public:
      *               code fails for some reason. Default is false.
      */
     virtual void writeToFile(std::string fileName, bool silent);
+
+    /** Copies the whole config into a ConfigValue, running all includes
+     *
+     * @param includes  Gets the full path of every file which was included,
+     *                  includes which already ran before this call are not
+     *                  reported.
+     */
+    ConfigValue toConfigValue(std::vector<std::string>& includes);
 private:
     /** Helper function used to make sure we have run the needed include
-        statements */
-    static void includeIfNeeded(boost::python::object pyObj);
+        statements
+        
+        @param included  If not None, a python list which gets the full path
+                         of each file included
+    */
+    static void includeIfNeeded(boost::python::object pyObj,
+                                boost::python::object included =
+                                boost::python::object());
+
+    /** Recursively converts the python object, see toConfigValue */
+    static ConfigValue buildValue(boost::python::object pyObj,
+                                  boost::python::object included);
     
     boost::python::object m_pyobj;
 
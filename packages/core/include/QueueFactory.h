@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/QueueFactory.h
+ */
+
+#ifndef RAM_CORE_QUEUEFACTORY_H_01_21_2010
+#define RAM_CORE_QUEUEFACTORY_H_01_21_2010
+
+// Project Includes
+#include "core/include/ConfigNode.h"
+#include "core/include/ThreadedQueue.h"
+#include "core/include/BoundedQueue.h"
+
+namespace ram {
+namespace core {
+
+/** Creates a queue based on the given config section
+ *
+ *  With no config, or a "capacity" of zero, you get the classic unbounded
+ *  ThreadedQueue.  Otherwise a BoundedQueue is created with the following
+ *  settings:
+ *
+ *  @code
+ *  capacity: 4096           # Max items, rounded up to a power of two
+ *  overflow: dropOldest     # block, dropNewest, or dropOldest
+ *  singleProducer: 0        # 1 if only a single thread pushes
+ *  @endcode
+ *
+ *  @return
+ *      A new queue, owned by the caller
+ */
+template <typename T>
+IQueue<T>* makeQueue(ConfigNode config)
+{
+    int capacity = config["capacity"].asInt(0);
+    if (capacity <= 0)
+        return new ThreadedQueue<T>();
+
+    BoundedQueueBase::OverflowPolicy policy =
+        BoundedQueueBase::stringToPolicy(
+            config["overflow"].asString("dropOldest"));
+    BoundedQueueBase::ProducerMode mode =
+        config["singleProducer"].asInt(0) ?
+        BoundedQueueBase::SINGLE_PRODUCER : BoundedQueueBase::MULTI_PRODUCER;
+
+    return new BoundedQueue<T>((size_t)capacity, policy, mode);
+}
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_QUEUEFACTORY_H_01_21_2010
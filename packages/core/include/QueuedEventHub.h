@@ -19,6 +19,7 @@
 #include "core/include/Event.h"
 #include "core/include/EventHub.h"
 #include "core/include/Forward.h"
+#include "core/include/Metrics.h"
 
 // Must Be Included last
 #include "core/include/Export.h"
@@ -31,6 +32,17 @@ namespace core {
  *  This class can be used to isolate the user from having its EventHandlers
  *  being called from other threads. It currently queues all events it recieves
  *  not just the ones that are currently subscribed for.
+ *
+ *  By default the queue is unbounded, a "queue" config section can give it a
+ *  fixed capacity and overflow policy (see makeQueue() for the settings).
+ *
+ *  State updates (ie: orientation, depth) can be coalesced so a consumer that
+ *  falls behind only sees the newest one, see setCoalescing().  This is set
+ *  from config with a list of types:
+ *
+ *  @code
+ *  coalesce: ["ram::estimation::IStateEstimator::ESTIMATED_DEPTH_UPDATE"]
+ *  @endcode
  */
 class RAM_EXPORT QueuedEventHub : public EventHub
 {
@@ -58,6 +70,31 @@ public:
     
     /** @copydoc QueuedEventPublisher::waitAndPublishEvents() */
     int waitAndPublishEvents();
+
+    /** Turns latest-value coalescing on or off for the given event type
+     *
+     *  While an event of a coalesced type is waiting in the queue, newer
+     *  events with the same type and sender replace it instead of being
+     *  queued behind it.  The newest value is published in the place of the
+     *  oldest one.  Events are FIFO by default; discrete events, like
+     *  DETECTOR_FOUND and DETECTOR_LOST, must stay that way.
+     */
+    void setCoalescing(const Event::EventType& type, bool coalesce = true);
+
+    /** True if the type is coalesced */
+    bool getCoalescing(const Event::EventType& type);
+
+    /** The number of events of the given type replaced by newer ones */
+    size_t getCoalescedCount(const Event::EventType& type);
+
+    /** Coalesces every type with the given name
+     *
+     *  The name is the type without the line number prefix, ie:
+     *  "ram::vehicle::IVehicle::DEPTH_UPDATE".  Types registered later, like
+     *  those of libraries loaded after the hub is made, are coalesced when
+     *  their first event is queued.
+     */
+    void setCoalescingByName(const std::string& name);
     
     /** Has the same effect as publishEvents() */
     virtual void update(double timestep);
@@ -79,6 +116,9 @@ private:
 
     /** When true we use waitAndPublish instead of Publish */
     bool m_waitUpdate;
+
+    /** Samples the number of events waiting to be published */
+    GaugePtr m_queueDepth;
 };
     
 } // namespace core
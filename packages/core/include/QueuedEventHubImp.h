@@ -10,13 +10,22 @@
 #ifndef RAM_CORE_QUEUEDEVENTHUBIMP_12_26_2007
 #define RAM_CORE_QUEUEDEVENTHUBIMP_12_26_2007
 
+// STD Includes
+#include <map>
+#include <string>
+#include <vector>
+
 // Library Includes
+#include <boost/cstdint.hpp>
 #include <boost/function.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 
 // Project Includes
-#include "core/include/ThreadedQueue.h"
+#include "core/include/IQueue.h"
 #include "core/include/Forward.h"
 #include "core/include/Event.h"
+#include "core/include/Atomic.h"
 
 namespace ram {
 namespace core {
@@ -24,8 +33,33 @@ namespace core {
 class QueuedEventHubImp
 {
 public:
-    /** Creates a new instance */ 
-    QueuedEventHubImp();
+    /** An event in the queue
+     *
+     *  The time lives here, not on the event, because the same event can be
+     *  waiting in several QueuedEventHubs at once.
+     */
+    struct QueuedEvent
+    {
+        QueuedEvent() : queueTime(0) {}
+        QueuedEvent(EventPtr event_, boost::int64_t queueTime_) :
+            event(event_), queueTime(queueTime_) {}
+
+        EventPtr event;
+
+        /** When it was queued in EventProfiler::now() units, zero when the
+         *  EventProfiler was not active */
+        boost::int64_t queueTime;
+    };
+
+    typedef IQueue<QueuedEvent> EventQueue;
+    
+    /** Creates a new instance
+     *
+     *  @param queue
+     *      The queue to store events in, the imp takes ownership.  If none
+     *      is given an unbounded ThreadedQueue is used.
+     */ 
+    QueuedEventHubImp(EventQueue* queue = 0);
 
     /** Set the function used twhich publishes use the given function */
     void setPublishFunction(boost::function<void (EventPtr)> publishFunction);
@@ -38,13 +72,105 @@ public:
 
     /** @copydoc QueuedEventPublisher::waitAndPublishEvents() */
     int waitAndPublishEvents();
+
+    /** @copydoc QueuedEventHub::setCoalescing() */
+    void setCoalescing(const Event::EventType& type, bool coalesce);
+
+    /** Coalesces every type with the given name, now and once registered
+     *
+     *  @return
+     *      True if a type already registered matched the name
+     */
+    bool setCoalescingByName(const std::string& name);
+
+    /** @copydoc QueuedEventHub::getCoalescing() */
+    bool getCoalescing(const Event::EventType& type);
+
+    /** @copydoc QueuedEventHub::getCoalescedCount() */
+    size_t getCoalescedCount(const Event::EventType& type);
+
+    /** The number of events waiting in the queue */
+    size_t getQueueDepth();
     
 private:
+    typedef std::pair<Event::EventTypeId, EventPublisher*> CoalesceKey;
+
+    /** The queue entry of a coalesced key, and the event to publish for it */
+    struct PendingEvent
+    {
+        PendingEvent(const QueuedEvent& event = QueuedEvent()) :
+            queued(event.event), newest(event) {}
+
+        /** The event which holds the key's place in the queue */
+        EventPtr queued;
+
+        /** Empty once publishPending() has published it */
+        QueuedEvent newest;
+    };
+    
+    typedef std::map<CoalesceKey, PendingEvent> PendingEventMap;
+
+    /** Returns the newest event with the same type & sender as the given one
+     *
+     *  Events without a newer one waiting are returned unchanged.  Returns an
+     *  empty pointer if a newer event is queued, or the newest event was
+     *  already published.
+     */
+    QueuedEvent takeNewest(const QueuedEvent& queued);
+
+    /** Publishes events whose place in the queue was lost */
+    int publishPending();
+
+    /** Hands a dequeued event to the publish function */
+    void publish(const QueuedEvent& queued);
+    
+    /** Must be called with m_coalesceMutex held */
+    bool isCoalesced(Event::EventTypeId typeId);
+
+    /** Coalesces the types registered since the last check which match a
+     *  name from setCoalescingByName, must be called with m_coalesceMutex
+     *  held
+     *
+     *  @return
+     *      True if any type matched
+     */
+    bool matchNewTypes();
+
+    /** Coalesces the types in [begin, end) which match one of the names,
+     *  must be called with m_coalesceMutex held */
+    bool matchTypes(const std::vector<std::string>& names,
+                    Event::EventTypeId begin, Event::EventTypeId end);
+
+    /** Updates m_coalescing, must be called with m_coalesceMutex held */
+    void updateCoalescing();
+    
+
     /** Function which events are published to */
     boost::function<void (EventPtr)> m_publishFunction;
     
     /** Thread safe queue for events */
-    ThreadedQueue<EventPtr> m_eventQueue;
+    boost::scoped_ptr<EventQueue> m_eventQueue;
+
+    /** Non-zero when any type is coalesced, lets us skip the lock when not */
+    volatile AtomicWord m_coalescing;
+
+    /** Protects all the coalescing state below */
+    boost::mutex m_coalesceMutex;
+
+    /** Indexed by type id, true when that type is coalesced */
+    std::vector<bool> m_coalescedTypes;
+
+    /** Names given to setCoalescingByName, matched against new types */
+    std::vector<std::string> m_coalescedNames;
+
+    /** The number of registered types already matched against the names */
+    size_t m_matchedTypeCount;
+
+    /** The newest event for each coalesced key which is in the queue */
+    PendingEventMap m_pendingEvents;
+
+    /** Events replaced by a newer one, indexed by type id */
+    std::vector<size_t> m_coalescedCounts;
 };
 
 } // namespace core
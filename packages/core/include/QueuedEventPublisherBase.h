@@ -22,6 +22,7 @@
 #include "core/include/EventConnection.h"
 #include "core/include/ReadWriteMutex.h"
 #include "core/include/ThreadedQueue.h"
+#include "core/include/EventTypeRegistry.h"
 
 namespace ram {
 namespace core {
@@ -43,7 +44,7 @@ public:
     virtual EventConnectionPtr subscribe(T type,
         boost::function<void (EventPtr)>  handler);
     
-    virtual void publish(T subscribeType, Event::EventType etype,
+    virtual void publish(T subscribeType, const Event::EventType& etype,
                          EventPublisher* sender,
                          EventPtr event);
 
@@ -156,7 +157,7 @@ EventConnectionPtr QueuedEventPublisherBaseTemplate<T>::subscribe(
     {
         // Subscribe to parent
         externalConnection =
-            m_parent->subscribe(type,
+            m_parent->subscribe(EventTypeRegistry::getName(type),
                 boost::bind(&QueuedEventPublisherBaseTemplate<T>::queueEvent,
                             this, _1));
         m_connectionTypes[type] = std::make_pair(1, externalConnection);
@@ -183,7 +184,7 @@ EventConnectionPtr QueuedEventPublisherBaseTemplate<T>::subscribe(
 
 template<typename T>
 void QueuedEventPublisherBaseTemplate<T>::publish(T subscribeType,
-                                                  Event::EventType etype,
+                                                  const Event::EventType& etype,
                                                   EventPublisher* sender,
                                                   EventPtr event)
 {
@@ -200,10 +201,11 @@ int QueuedEventPublisherBaseTemplate<T>::publishEvents()
     int published = 0;
     while(m_eventQueue.popNoWait(event))
     {
-        EventPublisherBaseTemplate<T>::publish(event->type,
-                                               event->type,
-                                               event->sender,
-                                               event);
+        EventPublisherBaseTemplate<T>::publish(
+            event->type.getId(),
+            event->type,
+            event->sender,
+            event);
         published++;
     }
     return published;
@@ -214,10 +216,11 @@ int QueuedEventPublisherBaseTemplate<T>::waitAndPublishEvents()
 {
     // Wait for events and publish the new event
     EventPtr event = m_eventQueue.popWait();
-    EventPublisherBaseTemplate<T>::publish(event->type,
-                                           event->type,
-                                           event->sender,
-                                           event);
+    EventPublisherBaseTemplate<T>::publish(
+        event->type.getId(),
+        event->type,
+        event->sender,
+        event);
     
     return 1 + publishEvents();
 }
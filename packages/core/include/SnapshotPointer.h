@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/SnapshotPointer.h
+ */
+
+#ifndef RAM_CORE_SNAPSHOTPOINTER_H_02_21_2010
+#define RAM_CORE_SNAPSHOTPOINTER_H_02_21_2010
+
+// Library Includes
+#include <boost/utility.hpp>
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/Atomic.h"
+
+namespace ram {
+namespace core {
+
+/** Owns an immutable value which readers get at without taking a lock
+ *
+ *  Readers announce themselves on one of two counters, load the pointer, and
+ *  leave when they are done with the value.  A writer swaps in the new value,
+ *  then flips readers over to the other counter and waits for the old one to
+ *  drain, twice, before deleting the old value.  Flipping means the writer
+ *  only waits on readers already in progress, a steady stream of new readers
+ *  can't hold it up.
+ *
+ *  Reading is two atomic adds and a load, so it is meant for values which are
+ *  read far more often than they are replaced.  Readers should only hold the
+ *  value long enough to copy what they need out of it.
+ */
+template<typename T>
+class SnapshotPointer : boost::noncopyable
+{
+public:
+    /** Takes ownership of the value */
+    SnapshotPointer(T* value);
+
+    ~SnapshotPointer();
+
+    /** Keeps the current value alive for the life of the lock */
+    class ScopedRead : boost::noncopyable
+    {
+    public:
+        ScopedRead(const SnapshotPointer<T>& pointer);
+
+        ~ScopedRead();
+
+        const T* get() const { return m_value; }
+
+    private:
+        volatile AtomicWord* m_readers;
+        const T* m_value;
+    };
+
+    /** The current value
+     *
+     *  @warning  Only for writers, the value is not protected from reset()
+     */
+    const T* get() const;
+
+    /** Replaces the value, deleting the old one once no reader is using it
+     *
+     *  @warning  Writers must be serialized by the caller, and a thread must
+     *            not call this while it holds a ScopedRead.
+     */
+    void reset(T* value);
+
+private:
+    /** Waits for the readers on the current counter after moving new
+     *  readers to the other one */
+    void waitForReaders();
+
+    volatile AtomicWord m_value;
+
+    /** Picks the counter new readers use, only changed by writers */
+    volatile AtomicWord m_epoch;
+
+    /** The number of readers which started on each counter */
+    mutable volatile AtomicWord m_readers[2];
+};
+
+// ------------------------------------------------------------------------- //
+//             T E M P L A T E   I M P L E M E N T A T I O N                 //
+// ------------------------------------------------------------------------- //
+
+template<typename T>
+SnapshotPointer<T>::SnapshotPointer(T* value) :
+    m_value((AtomicWord)value),
+    m_epoch(0)
+{
+    m_readers[0] = 0;
+    m_readers[1] = 0;
+}
+
+template<typename T>
+SnapshotPointer<T>::~SnapshotPointer()
+{
+    delete (T*)m_value;
+}
+
+template<typename T>
+SnapshotPointer<T>::ScopedRead::ScopedRead(const SnapshotPointer<T>& pointer) :
+    m_readers(&pointer.m_readers[atomic::load(&pointer.m_epoch) & 1]),
+    m_value(0)
+{
+    // The add is a full barrier, so the writer either sees us on the counter
+    // or we see its new value
+    atomic::add(m_readers, 1);
+    m_value = (const T*)atomic::load(&pointer.m_value);
+}
+
+template<typename T>
+SnapshotPointer<T>::ScopedRead::~ScopedRead()
+{
+    atomic::add(m_readers, -1);
+}
+
+template<typename T>
+const T* SnapshotPointer<T>::get() const
+{
+    return (const T*)atomic::load(&m_value);
+}
+
+template<typename T>
+void SnapshotPointer<T>::reset(T* value)
+{
+    T* old = (T*)m_value;
+    atomic::store(&m_value, (AtomicWord)value);
+    atomic::memoryBarrier();
+
+    // A reader could have picked its counter before the last flip but not
+    // yet added itself, so both counters have to drain
+    waitForReaders();
+    waitForReaders();
+
+    delete old;
+}
+
+template<typename T>
+void SnapshotPointer<T>::waitForReaders()
+{
+    AtomicWord epoch = atomic::load(&m_epoch);
+    atomic::store(&m_epoch, epoch + 1);
+    atomic::memoryBarrier();
+
+    volatile AtomicWord* readers = &m_readers[epoch & 1];
+    while (0 != atomic::load(readers))
+        boost::this_thread::yield();
+}
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_SNAPSHOTPOINTER_H_02_21_2010
@@ -12,27 +12,49 @@
 
 // STD Includes
 #include <string>
+#include <vector>
 
 // Library Includes
 #include <log4cpp/Appender.hh>
+#include <boost/scoped_ptr.hpp>
 
 // Project Includes
 #include "core/include/Updatable.h"
-#include "core/include/ThreadedQueue.h"
+#include "core/include/IQueue.h"
 #include "core/include/LoggingEvent.h"
+#include "core/include/Atomic.h"
 
 namespace ram {
 namespace core {
 
+class BatchFileAppender;
+
 /** A logger which logs all data in a background thread
  *
  *  Use of this Appender allows logging without stalling the thread doing the
  *  logging.  It uses the decorator pattern.
+ *
+ *  Each update takes every queued event off at once and passes them to the
+ *  wrapped appender.  When that is a BatchFileAppender it is told when the
+ *  batch is done, so the whole batch goes to the file in one write.  Events
+ *  which don't fit in a bounded queue are counted, and a "% Dropped N log
+ *  messages" line is written in their place.
  */
 class ThreadedAppender : public log4cpp::Appender, public Updatable
 {
 public:
-    ThreadedAppender(log4cpp::Appender* appender);
+    /** Wraps the given appender
+     *
+     *  @param appender
+     *      The appender to write events to in the background, we take
+     *      ownership of it
+     *  @param queue
+     *      Holds events until they are written, we take ownership.  If none is
+     *      given a BoundedQueue of DEFAULT_CAPACITY which drops new events
+     *      when full is used.
+     */
+    ThreadedAppender(log4cpp::Appender* appender,
+                     IQueue<LoggingEvent>* queue = 0);
     virtual ~ThreadedAppender();
 
     /** Waits for logging events and writes to files as possible*/        
@@ -40,6 +62,9 @@ public:
 
     /** Gets the appender we are wraping */
     log4cpp::Appender* wrappedAppender();
+
+    /** The number of events lost because the queue was full */
+    size_t getDroppedCount();
     
     /** Queues up logging event */
     virtual void doAppend(const log4cpp::LoggingEvent &event);
@@ -55,13 +80,31 @@ public:
     virtual log4cpp::Priority::Value getThreshold();
     virtual void setFilter(log4cpp::Filter *filter);
     virtual log4cpp::Filter* getFilter();
+
+    /** Size of the default queue */
+    static const size_t DEFAULT_CAPACITY = 8192;
     
 private:
+    /** Writes out the events, and notes any dropped since the last batch */
+    void appendBatch();
+
     /** Queues up log events to be written to the file */
-    ThreadedQueue<LoggingEvent> m_logEvents;
+    boost::scoped_ptr<IQueue<LoggingEvent> > m_logEvents;
 
     /** The appender we are wrapper*/
     log4cpp::Appender* m_appender;
+
+    /** The wrapped appender if it can write batches, otherwise null */
+    BatchFileAppender* m_batchAppender;
+
+    /** Events taken off the queue, kept to reuse its memory */
+    std::vector<LoggingEvent> m_batch;
+
+    /** Events the queue refused */
+    AtomicCounter m_dropped;
+
+    /** Dropped events already noted in the log */
+    size_t m_reportedDropped;
 };
 
 } // namespace core
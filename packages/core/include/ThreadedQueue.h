@@ -19,6 +19,7 @@
 
 // STD Includes
 #include <queue>
+#include <vector>
 
 // Library Includes
 #include <boost/utility.hpp>
@@ -26,6 +27,9 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/xtime.hpp>
 
+// Project Includes
+#include "core/include/IQueue.h"
+
 namespace ram {
 namespace core {
 
@@ -70,14 +74,16 @@ namespace details {
     @endcode
  */    
 template <typename T>
-class ThreadedQueue : boost::noncopyable
+class ThreadedQueue : public IQueue<T>
 {
 public:
-    void push(const T& newData)
+    /** Adds the item to the queue, the queue is unbounded so never fails */
+    virtual bool push(const T& newData)
     {
         boost::mutex::scoped_lock lock(m_monitorMutex);
         m_queue.push(newData);
         m_itemAvailable.notify_one();
+        return true;
     }
 
     /** Copies data into given parameter if there is data
@@ -88,7 +94,7 @@ public:
         
         @return true if there is data, false is there isn't
     */
-    bool popNoWait(T& data)
+    virtual bool popNoWait(T& data)
     {
         boost::mutex::scoped_lock lock(m_monitorMutex);
 
@@ -105,7 +111,7 @@ public:
     }
     
     /** Waits until new data is queue and returns that item when its added */
-    T popWait()
+    virtual T popWait()
     {
         boost::mutex::scoped_lock lock(m_monitorMutex);
 
@@ -131,7 +137,7 @@ public:
         
         @return true if there is data, false is there isn't
     */
-    bool popTimedWait(const boost::xtime &timeout, T& data)
+    virtual bool popTimedWait(const boost::xtime &timeout, T& data)
     {
         boost::mutex::scoped_lock lock(m_monitorMutex);
         bool success = true;
@@ -157,10 +163,32 @@ public:
         return false;
     }
 
+    /** Moves every item in the queue onto the back of the given vector */
+    virtual size_t popAll(std::vector<T>& items)
+    {
+        boost::mutex::scoped_lock lock(m_monitorMutex);
+
+        size_t count = m_queue.size();
+        while (!m_queue.empty())
+        {
+            items.push_back(m_queue.front());
+            m_queue.pop();
+        }
+
+        return count;
+    }
+
+    /** The number of items in the queue, only a snapshot */
+    virtual size_t size() const
+    {
+        boost::mutex::scoped_lock lock(m_monitorMutex);
+        return m_queue.size();
+    }
+
 private:
     std::queue<T> m_queue;
 
-    boost::mutex m_monitorMutex;
+    mutable boost::mutex m_monitorMutex;
     boost::condition m_itemAvailable;
 };
     
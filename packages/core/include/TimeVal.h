@@ -98,6 +98,12 @@ public:
 
         static TimeVal timeOfDay();
         /// Return the current time of day as timeval
+
+        static TimeVal monotonic();
+        ///< Return the time of a clock which is never set (CLOCK_MONOTONIC).
+        ///< It is unaffected by changes to the time of day, so it should be
+        ///< used to measure intervals.  Only differences between two values
+        ///< are meaningful.
     
         void now();
         ///< Sets the time to hold the current time
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/TimerManager.h
+ */
+
+#ifndef RAM_CORE_TIMERMANAGER_H_01_30_2010
+#define RAM_CORE_TIMERMANAGER_H_01_30_2010
+
+// STD Includes
+#include <vector>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+
+// Project Includes
+#include "core/include/Subsystem.h"
+#include "core/include/Updatable.h"
+#include "core/include/ConfigNode.h"
+#include "core/include/TimingWheel.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+class TimerManager;
+typedef boost::shared_ptr<TimerManager> TimerManagerPtr;
+
+/** Publishes events after a delay, or every period, from a single thread
+ *
+ *  All the timers live in one TimingWheel, driven by a background thread
+ *  the manager starts itself, so a timer costs a little memory instead of a
+ *  thread.  Events are published with this subsystem as the sender unless
+ *  another publisher is given, and it needs an EventHub so the events reach
+ *  the rest of the system.
+ *
+ *  The config takes the tick length in milliseconds, which timers are
+ *  rounded up to:
+ *  @code
+ *  TimerManager:
+ *      type: CoreTimerManager
+ *      depends_on: ["EventHub"]
+ *      resolution: 1
+ *  @endcode
+ */
+class RAM_EXPORT TimerManager : public Subsystem, public Updatable
+{
+public:
+    TimerManager(ConfigNode config, SubsystemList deps = SubsystemList());
+
+    virtual ~TimerManager();
+
+    /** Starts a timer which publishes the event type after the delay
+     *
+     *  @param seconds
+     *      The time until the event, and between events when repeating
+     *  @param repeat
+     *      Keep publishing every period until canceled
+     *  @param publisher
+     *      Publishes the event instead of this manager, it must outlive the
+     *      timer or the manager
+     *
+     *  @return  The handle to cancel the timer with
+     */
+    TimerPtr newTimer(Event::EventType eventType, double seconds,
+                      bool repeat = false, EventPublisher* publisher = 0);
+
+    /** The number of timers waiting, including canceled ones not yet
+     *  cleaned up */
+    size_t getTimerCount();
+
+    /** The length of a tick in seconds */
+    double getResolution() const;
+
+    /** Publishes the events of every timer which is due
+     *
+     *  Then waits until the next timer is due, a new timer is added, or
+     *  100ms pass, so the background thread doesn't spin.
+     */
+    virtual void update(double timestep);
+
+    // IUpdatable methods
+    virtual void setPriority(IUpdatable::Priority priority);
+
+    virtual IUpdatable::Priority getPriority();
+
+    virtual void setAffinity(size_t affinity);
+
+    virtual int getAffinity();
+
+    virtual void background(int interval = -1);
+
+    virtual void unbackground(bool join = false);
+
+    virtual bool backgrounded();
+
+private:
+    /** The tick the current time falls in */
+    boost::int64_t currentTick();
+
+    /** Nanoseconds per tick */
+    boost::int64_t m_tickLength;
+
+    /** Monotonic time of tick zero, in nanoseconds */
+    boost::int64_t m_startTime;
+
+    /** Protects the wheel and m_stopping */
+    boost::mutex m_mutex;
+
+    /** Signaled when a timer is added, or the thread should stop */
+    boost::condition m_wakeup;
+
+    TimingWheel m_wheel;
+
+    /** Timers taken off the wheel, kept to reuse its memory */
+    std::vector<TimerPtr> m_expired;
+
+    /** Set while unbackground() waits, so update() returns right away */
+    bool m_stopping;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_TIMERMANAGER_H_01_30_2010
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/TimingWheel.h
+ */
+
+#ifndef RAM_CORE_TIMINGWHEEL_H_01_30_2010
+#define RAM_CORE_TIMINGWHEEL_H_01_30_2010
+
+// STD Includes
+#include <list>
+#include <vector>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+
+// Project Includes
+#include "core/include/Atomic.h"
+#include "core/include/Event.h"
+#include "core/include/Forward.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+class Timer;
+typedef boost::shared_ptr<Timer> TimerPtr;
+
+/** A handle to a timer scheduled with the TimerManager
+ *
+ *  Only the TimerManager creates these, keep the handle to cancel the timer.
+ *  Dropping the handle does not cancel it.
+ */
+class RAM_EXPORT Timer : boost::noncopyable
+{
+public:
+    /** Stops the timer from publishing again
+     *
+     *  An event already being published when this is called can still
+     *  arrive, just like the old threaded python timers.  Safe to call from
+     *  any thread, and more than once.
+     */
+    void cancel();
+
+    /** True until canceled, or a one shot timer has fired */
+    bool active() const;
+
+    /** The number of times the timer has published its event */
+    int getFireCount() const;
+
+    Event::EventType getEventType() const { return m_eventType; }
+
+    /** Seconds between each event */
+    double getPeriod() const { return m_period; }
+
+    bool getRepeat() const { return m_repeat; }
+
+private:
+    friend class TimingWheel;
+    friend class TimerManager;
+
+    Timer(Event::EventType eventType, EventPublisher* publisher,
+          double period, boost::int64_t periodTicks, bool repeat);
+
+    Event::EventType m_eventType;
+
+    /** Publishes the event, not owned */
+    EventPublisher* m_publisher;
+
+    double m_period;
+
+    boost::int64_t m_periodTicks;
+
+    bool m_repeat;
+
+    /** The tick the timer fires on, only touched under the wheel's lock */
+    boost::int64_t m_expires;
+
+    volatile AtomicWord m_active;
+
+    AtomicCounter m_fired;
+};
+
+/** A hierarchical timing wheel, in the style of the Linux kernel timers
+ *
+ *  Time is counted in whole ticks.  The first level has a slot for each of
+ *  the next 256 ticks, each further level has 64 slots which each span all
+ *  the slots of the level below.  Adding and canceling a timer are constant
+ *  time, and timers only move down a level once each time the level below
+ *  wraps around, so the cost of a tick doesn't grow with the number of
+ *  timers.  Timers further out than the last level are parked at its end
+ *  and put back when they come around.
+ *
+ *  This is only the data structure, it is not thread safe.  Canceled timers
+ *  stay in their slot until it comes up, where they are dropped.
+ */
+class RAM_EXPORT TimingWheel : boost::noncopyable
+{
+public:
+    /** Starts the wheel so the first tick processed is the given one */
+    TimingWheel(boost::int64_t startTick = 0);
+
+    /** Schedules the timer for its expire tick
+     *
+     *  Ticks which have already been processed are treated as the next one.
+     */
+    void add(TimerPtr timer, boost::int64_t expires);
+
+    /** Processes every tick before the given one
+     *
+     *  Timers which expire are appended to the list in expire order, and
+     *  removed from the wheel.  Canceled timers are dropped.
+     */
+    void advance(boost::int64_t tick, std::vector<TimerPtr>& expired);
+
+    /** The next tick advance() will process */
+    boost::int64_t getTick() const { return m_tick; }
+
+    /** The earliest tick anything can expire on, -1 when empty
+     *
+     *  This can be earlier than the real next timer, when the timers are
+     *  further out than the first level it gives when they next move down.
+     */
+    boost::int64_t getNextTick() const;
+
+    /** The number of timers in the wheel, including canceled ones */
+    size_t size() const { return m_size; }
+
+    static const int LEVELS = 4;
+    static const int ROOT_BITS = 8;
+    static const int LEVEL_BITS = 6;
+    static const int ROOT_SLOTS = 1 << ROOT_BITS;
+    static const int LEVEL_SLOTS = 1 << LEVEL_BITS;
+
+    /** The most ticks ahead a timer can be placed directly */
+    static const boost::int64_t MAX_TICKS =
+        (boost::int64_t)1 << (ROOT_BITS + (LEVELS - 1) * LEVEL_BITS);
+
+private:
+    typedef std::list<TimerPtr> Slot;
+
+    /** Moves the timers of a slot on the given level to the lower levels
+     *
+     *  @return  The index of the slot
+     */
+    int cascade(int level);
+
+    /** The first bit of the tick that indexes the slots of a level */
+    static int levelShift(int level);
+
+    /** The next tick to process */
+    boost::int64_t m_tick;
+
+    size_t m_size;
+
+    /** ROOT_SLOTS slots for the first level, LEVEL_SLOTS for the rest */
+    std::vector<Slot> m_levels[LEVELS];
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_TIMINGWHEEL_H_01_30_2010
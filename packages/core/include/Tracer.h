@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/Tracer.h
+ */
+
+#ifndef RAM_CORE_TRACER_H_02_03_2010
+#define RAM_CORE_TRACER_H_02_03_2010
+
+// STD Includes
+#include <fstream>
+#include <string>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+#include <boost/utility.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Project Includes
+#include "core/include/Subsystem.h"
+#include "core/include/Updatable.h"
+#include "core/include/ConfigNode.h"
+#include "core/include/EventHandler.h"
+#include "core/include/Instrumentation.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Records the causal path of events as a Chrome trace
+ *
+ *  While a Tracer exists every published event gets a trace ID, and as its
+ *  parent the ID of the event whose handler was running when it was
+ *  published.  So a chain like camera frame -> detector -> estimator ->
+ *  controller -> thrusters can be followed from end to end, across threads
+ *  and queues.  Code which hands work between threads without an event, like
+ *  a Camera to its Recorder, carries the ID along with a ScopedContext.
+ *
+ *  Spans are recorded for every EventPublisher and EventHub publish, every
+ *  handler call and every Updatable::update.  On each update, and when
+ *  destroyed, they are written to "fileName" (default "trace.json") in the
+ *  log directory in the Chrome trace event format, which chrome://tracing and
+ *  Perfetto load.  Flow arrows connect a publish to the handlers of its
+ *  event.  Each thread buffers its spans in its own ring, without locking,
+ *  and span names are looked up once per thread.  At most 8192 spans per
+ *  thread are buffered between writes, the rest are dropped and counted.
+ *
+ *  Only one Tracer should exist at a time.  When neither a Tracer nor an
+ *  EventProfiler exists each hook costs a single well predicted branch on
+ *  Instrumentation::active().  While tracing, each handler call is timed
+ *  once for both the trace and any EventProfiler.
+ */
+class RAM_EXPORT Tracer : public Subsystem, public Updatable
+{
+public:
+    Tracer(ConfigNode config, SubsystemList deps = SubsystemList());
+
+    /** Writes out what is left, and closes the trace */
+    virtual ~Tracer();
+
+    /** Writes all spans recorded since the last write to the file */
+    void flush();
+
+    /** The number of spans thrown away since the Tracer was created */
+    size_t getDroppedCount();
+
+    /** Calls flush() */
+    virtual void update(double timestep);
+
+    // IUpdatable methods
+    virtual void setPriority(IUpdatable::Priority priority);
+
+    virtual IUpdatable::Priority getPriority();
+
+    virtual void setAffinity(size_t affinity);
+
+    virtual int getAffinity();
+
+    virtual void background(int interval);
+
+    virtual void unbackground(bool join = false);
+
+    virtual bool backgrounded();
+
+    /** True while any Tracer exists */
+    static bool active() { return Instrumentation::tracing(); }
+
+    /** The trace ID events published on this thread get as their parent */
+    static boost::uint64_t currentContext();
+
+    /** Sets the current context of the thread, until it goes out of scope
+     *
+     *  A zero ID is ignored, the current context is kept.
+     */
+    class RAM_EXPORT ScopedContext : boost::noncopyable
+    {
+    public:
+        ScopedContext(boost::uint64_t traceId);
+        ~ScopedContext();
+
+    private:
+        boost::uint64_t m_previous;
+        bool m_set;
+    };
+
+    /** @defgroup Hooks Called by the event system only when active()
+     *  @{
+     */
+
+    /** Gives the event its trace and parent ID, if it doesn't have them */
+    static void startTrace(EventPtr event);
+
+    /** Records an EventPublisher::publish which began at start */
+    static void recordPublish(EventPtr event, boost::int64_t start);
+
+    /** Records an EventHub::publish which began at start */
+    static void recordHubPublish(EventPtr event, boost::int64_t start);
+
+    /** Calls each handler with the event as the context, recording each
+     *
+     *  The calls are also recorded under typeId by the EventProfiler, when
+     *  it is active.
+     */
+    static void callHandlers(Event::EventTypeId typeId,
+                             const EventHandlerList& handlers,
+                             EventPtr event);
+
+    /** Records an Updatable::update which began at start */
+    static void recordUpdate(Updatable* updatable, boost::int64_t start);
+
+    /** @} */
+
+private:
+    /** The dropped count of all Tracers when this one was created */
+    boost::int64_t m_droppedAtStart;
+
+    /** Protects the file */
+    boost::mutex m_fileMutex;
+
+    std::ofstream m_file;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_TRACER_H_02_03_2010
@@ -10,8 +10,12 @@
 #ifndef RAM_CORE_UPDATABLE_06_11_2006
 #define RAM_CORE_UPDATABLE_06_11_2006
 
+// STD Includes
+#include <string>
+
 // Library Includes
 #include <boost/utility.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/thread/mutex.hpp>
 
 // Forward declare boost::thread
@@ -21,6 +25,7 @@ namespace boost { class thread; }
 #include "core/include/IUpdatable.h"
 #include "core/include/CountDownLatch.h"
 #include "core/include/EventPublisher.h"
+#include "core/include/UpdatableStats.h"
 
 // Must Be Included last
 #include "core/include/Export.h"
@@ -28,17 +33,112 @@ namespace boost { class thread; }
 namespace ram {
 namespace core {
 
+class UpdatableScheduler;
+class LockstepScheduler;
+
 /** Represents and object which can be updated, asyncronously or sequentially.
  *
  *  All you have to do to use it is subclass and implement the update() method,
  *  will be called the given interval in a background thread.
+ *
+ *  By default each backgrounded object gets its own thread.  In SHARED_POOL
+ *  mode the update is instead run by the worker pool of the process wide
+ *  UpdatableScheduler, which is shared with every other pooled object of the
+ *  same priority and affinity.
+ *
+ *  Updates are timed against absolute deadlines on the monotonic clock, so
+ *  they neither drift nor jump with changes to the time of day.  Under the
+ *  virtual Clock, objects backgrounded with an interval are all run by the
+ *  LockstepScheduler instead, whatever their thread mode.  Timing
+ *  statistics are available from getStats(), and are published once a
+ *  second as an UpdatableStatsEvent of type STATS.
  */
 class RAM_EXPORT Updatable : public IUpdatable, boost::noncopyable
 {
 public:
+    /** Determines what thread runs a backgrounded update */
+    enum ThreadMode
+    {
+        /** A background thread just for this object */
+        DEDICATED_THREAD,
+        /** A worker of the shared UpdatableScheduler
+         *
+         *  Objects whose update() blocks for long periods, or which run all
+         *  out (interval < 0), tie up a whole worker and should not use this.
+         */
+        SHARED_POOL
+    };
+    
+    /** What to do when an update runs past the start of the next one */
+    enum OverrunPolicy
+    {
+        /** Drop the missed updates and stay on the original schedule */
+        SKIP_MISSED,
+        /** Run the missed updates back to back (at most MAX_CATCH_UP) */
+        CATCH_UP
+    };
+
+    /** The most missed updates run under the CATCH_UP policy */
+    static const int MAX_CATCH_UP = 10;
+
+    /** Published once a second with an UpdatableStatsEvent */
+    static const ram::core::Event::EventType STATS;
+    
     Updatable(EventPublisher *publisher = NULL);
     virtual ~Updatable();
 
+    /** Sets the thread mode, which cannot be changed while backgrounded */
+    void setThreadMode(ThreadMode mode);
+
+    ThreadMode getThreadMode();
+
+    /** Converts "thread" or "pool" to a ThreadMode */
+    static ThreadMode stringToThreadMode(std::string str);
+
+    /** Sets the overrun policy of the dedicated thread
+     *
+     *  The SHARED_POOL always skips missed updates.
+     */
+    void setOverrunPolicy(OverrunPolicy policy);
+
+    OverrunPolicy getOverrunPolicy();
+
+    /** Converts "skip" or "catchup" to an OverrunPolicy */
+    static OverrunPolicy stringToOverrunPolicy(std::string str);
+
+    /** Returns a copy of the current timing statistics */
+    UpdatableStats getStats();
+
+    /** Zeros the timing statistics */
+    void resetStats();
+
+    /** Unique for the life of the process, unlike the address */
+    size_t getUpdatableId() { return m_updatableId; }
+
+    /** The name used in traces and reports, the Subsystem name or the type
+     *
+     *  Worked out on the first call, since the type isn't known in the
+     *  constructor.  Tools which need it on every update should cache it by
+     *  getUpdatableId().
+     */
+    std::string getUpdatableName();
+
+    /** Sets the priority of the calling thread */
+    static void setCurrentThreadPriority(Priority priority);
+
+    /** Sets the calling thread to run only on the given core */
+    static void setCurrentThreadAffinity(int core);
+
+    /** The number of online CPUs */
+    static size_t getCPUCount();
+
+    /** True if the CPU is online, and so threads can be pinned to it
+     *
+     *  CPU numbers need not be contiguous, and isolated CPUs count even
+     *  though the process doesn't start out allowed on them.
+     */
+    static bool isCPUOnline(int cpu);
+
     virtual void setPriority(Priority priority);
 
     virtual Priority getPriority();
@@ -66,6 +166,33 @@ protected:
     virtual void waitForUpdate(long microseconds);
     
 private:
+    friend class UpdatableScheduler;
+    friend class LockstepScheduler;
+    
+    /** Called by the UpdatableScheduler to run an update in SHARED_POOL mode
+     *
+     *  This calls update(), records its statistics and publishes the
+     *  profiling events.
+     *
+     *  @param latency
+     *      How late, in seconds, the update started
+     */
+    void scheduledUpdate(double timestep, double latency);
+
+    /** Calls update(), recording a span of it when a Tracer is active */
+    void callUpdate(double timestep);
+
+    /** Records the statistics of an update, and publishes them if needed
+     *
+     *  All values are in seconds, see UpdatableStats::record.
+     */
+    void recordUpdate(int interval, double period, double duration,
+                      double latency);
+
+    /** Sleeps until the given monotonic time, in microseconds */
+    void waitUntil(boost::int64_t deadline);
+    
+
     /** Simple message to talk to background thread */
     enum StateChange {
         PRIORITY = 1,
@@ -79,7 +206,7 @@ private:
      *
      *  Determines the proper thread priorities, and CPU count.
      */
-    void initThreadingSettings();
+    static void initThreadingSettings();
 
     /** Sets the priority of the running thread */
     void setThreadPriority();
@@ -103,6 +230,14 @@ private:
     /** The core which background thread will run on */
     int m_affinity;
 
+    /** Whether we update in our own thread or in the shared pool */
+    ThreadMode m_threadMode;
+
+    /** True while the LockstepScheduler runs our updates */
+    bool m_lockstep;
+
+    OverrunPolicy m_overrunPolicy;
+
     /** If the above settings have been changed */
     int m_settingChange;
     
@@ -117,6 +252,20 @@ private:
     /** The publisher to use for profiling updates */
     EventPublisher *m_publisher;
     unsigned int m_profileCount;
+
+    /** Monotonic time, in seconds, of the last profile event */
+    double m_lastProfile;
+
+    /** Protects the statistics */
+    boost::mutex m_statsMutex;
+
+    UpdatableStats m_stats;
+
+    size_t m_updatableId;
+
+    /** Empty until getUpdatableName() is first called, under the stats mutex
+     */
+    std::string m_updatableName;
 };
 
 } // namespace core
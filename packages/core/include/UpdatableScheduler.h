@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/UpdatableScheduler.h
+ */
+
+#ifndef RAM_CORE_UPDATABLESCHEDULER_H_01_22_2010
+#define RAM_CORE_UPDATABLESCHEDULER_H_01_22_2010
+
+// STD Includes
+#include <map>
+#include <utility>
+
+// Library Includes
+#include <boost/utility.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Project Includes
+#include "core/include/IUpdatable.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+class Updatable;
+
+/** Runs the updates of many Updatables on a small set of worker threads
+ *
+ *  Each backgrounded Updatable normally has its own thread, which leaves a
+ *  process with dozens of mostly idle threads.  The scheduler instead keeps a
+ *  heap of the absolute deadline for each object's next update, and a pool of
+ *  workers which sleep until the earliest deadline and call update() on it.
+ *
+ *  There is one pool for each (priority, affinity) pair in use, so objects
+ *  never run on a thread with a different priority or core than they ask
+ *  for.  Pools for a specific core have a single worker, all others have one
+ *  worker per core.
+ *
+ *  An object is never updated by two workers at once.  When an update takes
+ *  longer than the interval, the missed updates are skipped and the next one
+ *  is run as soon as possible.
+ */
+class RAM_EXPORT UpdatableScheduler : boost::noncopyable
+{
+public:
+    /** Creates a scheduler
+     *
+     *  @param threadsPerPool
+     *      The number of workers in pools not bound to a core, zero means
+     *      one per core.
+     */
+    UpdatableScheduler(size_t threadsPerPool = 0);
+
+    /** Stops and joins all workers */
+    ~UpdatableScheduler();
+
+    /** The scheduler used by Updatables in SHARED_POOL mode
+     *
+     *  It is never destroyed, so Updatables can use it from any destructor.
+     */
+    static UpdatableScheduler* getInstance();
+
+    /** Starts updating the given object every interval milliseconds
+     *
+     *  If the object is already scheduled this changes its interval, and
+     *  moves it to the pool for the given priority and affinity.  Intervals
+     *  less than one update as often as possible.
+     */
+    void schedule(Updatable* updatable, int interval,
+                  IUpdatable::Priority priority, int affinity = -1);
+
+    /** Stops updating the given object
+     *
+     *  @param join
+     *      Wait for an update in progress on another thread to finish.  An
+     *      update calling this on its own object is not waited on.
+     */
+    void unschedule(Updatable* updatable, bool join = false);
+
+    /** True if the object is currently scheduled */
+    bool scheduled(Updatable* updatable);
+
+    /** The number of pools created so far */
+    size_t getPoolCount();
+
+    /** The total number of worker threads in all pools */
+    size_t getThreadCount();
+
+private:
+    struct Task;
+    struct Pool;
+    typedef boost::shared_ptr<Task> TaskPtr;
+    typedef std::pair<int, int> PoolKey;
+    typedef std::map<PoolKey, Pool*> PoolMap;
+    typedef std::map<Updatable*, TaskPtr> TaskMap;
+
+    /** Finds or creates the pool, must be called with m_mutex held */
+    Pool* getPool(IUpdatable::Priority priority, int affinity);
+
+    /** Puts the task into the heap of its pool, needs m_mutex held */
+    void queueTask(TaskPtr task, boost::int64_t deadline);
+
+    /** The body of every worker thread */
+    void workerLoop(Pool* pool);
+
+    /** Protects all tasks and pools */
+    boost::mutex m_mutex;
+
+    /** Signaled when any update finishes */
+    boost::condition m_updateFinished;
+
+    size_t m_threadsPerPool;
+
+    /** Set when the workers should exit */
+    bool m_stop;
+
+    PoolMap m_pools;
+
+    TaskMap m_tasks;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_UPDATABLESCHEDULER_H_01_22_2010
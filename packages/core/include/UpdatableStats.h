@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/UpdatableStats.h
+ */
+
+#ifndef RAM_CORE_UPDATABLESTATS_H_01_23_2010
+#define RAM_CORE_UPDATABLESTATS_H_01_23_2010
+
+// Library Includes
+#include <boost/shared_ptr.hpp>
+
+// Project Includes
+#include "core/include/Event.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Timing statistics of a backgrounded Updatable
+ *
+ *  All times are in seconds.  Jitter is the difference between the actual
+ *  time between the start of two updates and the requested interval.
+ */
+struct RAM_EXPORT UpdatableStats
+{
+    /** The number of buckets in the jitter histogram */
+    static const int JITTER_BUCKETS = 8;
+
+    /** The upper bound of each jitter bucket, the last one has no bound */
+    static const double JITTER_LIMITS[JITTER_BUCKETS - 1];
+
+    UpdatableStats();
+
+    /** Records the timing of a single update
+     *
+     *  @param interval
+     *      The requested time between updates, zero or less for none
+     *  @param period
+     *      The time since the last update started, zero for the first
+     *  @param duration
+     *      How long update() ran
+     *  @param latency
+     *      How late the update started compared to its deadline
+     */
+    void record(double interval, double period, double duration,
+                double latency);
+
+    /** Zeros all statistics */
+    void reset();
+
+    /** The number of updates recorded */
+    unsigned long updates;
+
+    /** Updates which finished after the next one should have started */
+    unsigned long overruns;
+
+    double lastDuration;
+    double meanDuration;
+    double maxDuration;
+
+    /** The latest an update has started */
+    double maxLatency;
+
+    /** Count of updates in each bucket, see JITTER_LIMITS */
+    unsigned long jitter[JITTER_BUCKETS];
+};
+
+/** Published periodically by Updatables with their current statistics */
+struct RAM_EXPORT UpdatableStatsEvent : public Event
+{
+    UpdatableStats stats;
+
+    virtual EventPtr clone();
+};
+
+typedef boost::shared_ptr<UpdatableStatsEvent> UpdatableStatsEventPtr;
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_UPDATABLESTATS_H_01_23_2010
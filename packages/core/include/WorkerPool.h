@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/include/WorkerPool.h
+ */
+
+#ifndef RAM_CORE_WORKERPOOL_H_02_11_2010
+#define RAM_CORE_WORKERPOOL_H_02_11_2010
+
+// STD Includes
+#include <deque>
+
+// Library Includes
+#include <boost/utility.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/thread.hpp>
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** A fixed set of threads which run tasks in the order they are submitted
+ *
+ *  For splitting up work which has to be done before moving on, like running
+ *  every detector on a frame.  Give each task a CountDownLatch to count down
+ *  when it is done, and await() the latch.
+ */
+class RAM_EXPORT WorkerPool : boost::noncopyable
+{
+public:
+    typedef boost::function<void ()> Task;
+
+    /** Starts the threads
+     *
+     *  @param threads
+     *      The number of threads, zero for one per CPU
+     */
+    WorkerPool(size_t threads = 0);
+
+    /** Runs the tasks already submitted, then stops the threads */
+    ~WorkerPool();
+
+    /** Queues the task to be run by the next free thread */
+    void submit(Task task);
+
+    size_t getThreadCount() const { return m_threadCount; }
+
+private:
+    /** Runs tasks until it gets an empty one */
+    void run();
+
+    size_t m_threadCount;
+
+    /** Protects m_tasks */
+    boost::mutex m_mutex;
+
+    /** Signaled when a task is submitted */
+    boost::condition m_taskAvailable;
+
+    std::deque<Task> m_tasks;
+
+    boost::thread_group m_threads;
+};
+
+typedef boost::shared_ptr<WorkerPool> WorkerPoolPtr;
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_WORKERPOOL_H_02_11_2010
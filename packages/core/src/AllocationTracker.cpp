@@ -0,0 +1,416 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/AllocationTracker.cpp
+ */
+
+// STD Includes
+#include <cassert>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+// Library Includes
+#include <log4cpp/Category.hh>
+
+// Project Includes
+#include "core/include/AllocationTracker.h"
+#include "core/include/SubsystemMaker.h"
+
+// System Includes
+#ifdef RAM_LINUX
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+// Register into the maker subsystem
+RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::core::AllocationTracker,
+                                  AllocationTracker);
+
+// Create category for logging
+static log4cpp::Category& LOGGER(
+    log4cpp::Category::getInstance("AllocationTracker"));
+
+// Compiler thread locals, the hooks can't use boost::thread_specific_ptr
+// because it allocates.  Initial exec keeps glibc from allocating them lazily.
+#if defined(__GNUC__)
+#  define RAM_THREAD_LOCAL __thread __attribute__((tls_model("initial-exec")))
+#else
+#  define RAM_THREAD_LOCAL __declspec(thread)
+#endif
+
+namespace ram {
+namespace core {
+
+volatile AtomicWord AllocationTracker::s_active = 0;
+
+static volatile AtomicWord s_hooksInstalled = 0;
+
+/** The counts of the updates of an Updatable on one thread, only written by
+ *  that thread
+ */
+struct UpdateAllocations
+{
+    /** Subsystem name or type, worked out once per thread */
+    std::string name;
+    volatile AtomicWord updates;
+    volatile AtomicWord allocations;
+    volatile AtomicWord bytes;
+
+    /** Kept in a list per thread which is only ever pushed on to */
+    UpdateAllocations* next;
+};
+
+/** The counts of a single thread, only written by that thread */
+struct ThreadAllocations
+{
+    long thread;
+    volatile AtomicWord allocations;
+    volatile AtomicWord bytes;
+    volatile AtomicWord frees;
+
+    /** The name of the last Updatable to update on the thread */
+    const std::string* volatile owner;
+
+    /** Head of the list of the counts of each Updatable, a
+     *  UpdateAllocations*
+     */
+    volatile AtomicWord updates;
+
+    /** Finds the counts by Updatable id, only used by the thread itself */
+    std::map<size_t, UpdateAllocations*> byUpdatable;
+
+    /** Threads are kept in a list which is only ever pushed on to */
+    ThreadAllocations* next;
+};
+
+/** Head of the list of every thread seen, a ThreadAllocations* */
+static volatile AtomicWord s_threads = 0;
+
+#ifndef RAM_LINUX
+static AtomicCounter s_nextThread;
+#endif
+
+static RAM_THREAD_LOCAL ThreadAllocations* t_thread = 0;
+static RAM_THREAD_LOCAL AllocationTracker::UpdateScope* t_scope = 0;
+static RAM_THREAD_LOCAL AllocationTracker::NoAllocationGuard* t_guard = 0;
+
+/** True while our own bookkeeping runs, so it isn't counted */
+static RAM_THREAD_LOCAL bool t_paused = false;
+
+/** Stops counting on this thread until it goes out of scope */
+class ScopedPause
+{
+public:
+    ScopedPause() : m_previous(t_paused) { t_paused = true; }
+    ~ScopedPause() { t_paused = m_previous; }
+
+private:
+    bool m_previous;
+};
+
+/** Creates the counts for the calling thread, and adds them to the list */
+static ThreadAllocations* registerThread()
+{
+    ScopedPause pause;
+
+    ThreadAllocations* thread = new ThreadAllocations();
+#ifdef RAM_LINUX
+    // The kernel ID, so it matches up with top and gdb
+    thread->thread = syscall(SYS_gettid);
+#else
+    thread->thread = s_nextThread.increment();
+#endif
+    thread->allocations = 0;
+    thread->bytes = 0;
+    thread->frees = 0;
+    thread->owner = 0;
+    thread->updates = 0;
+
+    AtomicWord head;
+    do
+    {
+        head = atomic::load(&s_threads);
+        thread->next = (ThreadAllocations*)head;
+    } while (!atomic::compareAndSwap(&s_threads, head, (AtomicWord)thread));
+
+    t_thread = thread;
+    return thread;
+}
+
+/** The counts of the Updatable on the calling thread, created on first use */
+static UpdateAllocations* threadUpdates(ThreadAllocations* thread,
+                                        Updatable* updatable)
+{
+    size_t id = updatable->getUpdatableId();
+    std::map<size_t, UpdateAllocations*>::iterator iter =
+        thread->byUpdatable.find(id);
+    if (thread->byUpdatable.end() != iter)
+        return iter->second;
+
+    ScopedPause pause;
+    UpdateAllocations* counts = new UpdateAllocations();
+    counts->name = updatable->getUpdatableName();
+    counts->updates = 0;
+    counts->allocations = 0;
+    counts->bytes = 0;
+    counts->next = (UpdateAllocations*)atomic::load(&thread->updates);
+    thread->byUpdatable[id] = counts;
+
+    // Published last, so report() only sees it complete
+    atomic::store(&thread->updates, (AtomicWord)counts);
+    return counts;
+}
+
+/** Most allocations first */
+template <typename T>
+static bool moreAllocations(const std::pair<size_t, T>& a,
+                            const std::pair<size_t, T>& b)
+{
+    return a.first > b.first;
+}
+
+AllocationTracker::AllocationTracker(ConfigNode config, SubsystemList deps) :
+    Subsystem(config["name"].asString("AllocationTracker"), deps),
+    Updatable(this)
+{
+    if (!hooksInstalled())
+    {
+        LOGGER.warnStream() << "Allocation hooks not installed, nothing will "
+                            << "be counted.  Link to, or LD_PRELOAD, "
+                            << "ram_alloc_hooks";
+    }
+
+    atomic::add(&s_active, 1);
+}
+
+AllocationTracker::~AllocationTracker()
+{
+    unbackground(true);
+    update(0);
+    atomic::add(&s_active, -1);
+}
+
+void AllocationTracker::update(double)
+{
+    std::stringstream ss(report());
+    std::string line;
+    while (std::getline(ss, line))
+        LOGGER.infoStream() << line;
+}
+
+void AllocationTracker::setPriority(IUpdatable::Priority priority)
+{
+    Updatable::setPriority(priority);
+}
+
+IUpdatable::Priority AllocationTracker::getPriority()
+{
+    return Updatable::getPriority();
+}
+
+void AllocationTracker::setAffinity(size_t affinity)
+{
+    Updatable::setAffinity(affinity);
+}
+
+int AllocationTracker::getAffinity()
+{
+    return Updatable::getAffinity();
+}
+
+void AllocationTracker::background(int interval)
+{
+    Updatable::background(interval);
+}
+
+void AllocationTracker::unbackground(bool join)
+{
+    Updatable::unbackground(join);
+}
+
+bool AllocationTracker::backgrounded()
+{
+    return Updatable::backgrounded();
+}
+
+bool AllocationTracker::hooksInstalled()
+{
+    return 0 != atomic::load(&s_hooksInstalled);
+}
+
+std::string AllocationTracker::report()
+{
+    ScopedPause pause;
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+
+    typedef std::pair<size_t, ThreadAllocations*> ThreadEntry;
+    std::vector<ThreadEntry> threads;
+    for (ThreadAllocations* thread =
+             (ThreadAllocations*)atomic::load(&s_threads);
+         thread; thread = thread->next)
+    {
+        threads.push_back(ThreadEntry(atomic::load(&thread->allocations),
+                                      thread));
+    }
+    std::stable_sort(threads.begin(), threads.end(),
+                     moreAllocations<ThreadAllocations*>);
+
+    ss << "Allocations by thread:" << std::endl;
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        ThreadAllocations* thread = threads[i].second;
+        ss << "  thread " << thread->thread;
+        const std::string* owner = thread->owner;
+        if (owner)
+            ss << " (" << *owner << ")";
+        ss << ": " << threads[i].first << " allocations, "
+           << atomic::load(&thread->bytes) << " bytes, "
+           << atomic::load(&thread->frees) << " frees" << std::endl;
+    }
+
+    // Sum the counts of each thread, an Updatable can move between threads
+    typedef std::map<std::string, std::vector<size_t> > UpdateTotals;
+    UpdateTotals updates;
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        for (UpdateAllocations* counts = (UpdateAllocations*)atomic::load(
+                 &threads[i].second->updates);
+             counts; counts = counts->next)
+        {
+            std::vector<size_t>& totals = updates[counts->name];
+            totals.resize(3, 0);
+            totals[0] += atomic::load(&counts->updates);
+            totals[1] += atomic::load(&counts->allocations);
+            totals[2] += atomic::load(&counts->bytes);
+        }
+    }
+
+    typedef std::pair<size_t, std::string> UpdateEntry;
+    std::vector<UpdateEntry> names;
+    for (UpdateTotals::iterator iter = updates.begin();
+         iter != updates.end(); ++iter)
+    {
+        names.push_back(UpdateEntry(iter->second[1], iter->first));
+    }
+    std::stable_sort(names.begin(), names.end(), moreAllocations<std::string>);
+
+    ss << "Allocations by update:" << std::endl;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        const std::vector<size_t>& totals = updates[names[i].second];
+        ss << "  " << names[i].second << ": " << totals[0]
+           << " updates, " << totals[1] << " allocations ("
+           << totals[1] / (double)totals[0]
+           << " per update), " << totals[2] << " bytes" << std::endl;
+    }
+
+    return ss.str();
+}
+
+AllocationTracker::NoAllocationGuard::NoAllocationGuard(bool assertOnExit) :
+    m_previous(t_guard),
+    m_assertOnExit(assertOnExit),
+    m_allocations(0),
+    m_bytes(0)
+{
+    t_guard = this;
+    atomic::add(&s_active, 1);
+}
+
+AllocationTracker::NoAllocationGuard::~NoAllocationGuard()
+{
+    atomic::add(&s_active, -1);
+    t_guard = m_previous;
+
+    // Logged as well, so release builds still hear about it
+    if (m_assertOnExit && (0 != m_allocations))
+    {
+        ScopedPause pause;
+        LOGGER.errorStream() << m_allocations << " allocations, "
+                             << m_bytes << " bytes, inside a "
+                             << "NoAllocationGuard";
+        assert(false && "Allocated inside a NoAllocationGuard");
+    }
+}
+
+AllocationTracker::UpdateScope::UpdateScope(Updatable* updatable) :
+    m_updatable(updatable),
+    m_previous(0),
+    m_allocations(0),
+    m_bytes(0)
+{
+    if (m_updatable)
+    {
+        m_previous = t_scope;
+        t_scope = this;
+    }
+}
+
+AllocationTracker::UpdateScope::~UpdateScope()
+{
+    if (!m_updatable)
+        return;
+
+    t_scope = m_previous;
+
+    // Only this thread writes its counts, so no lock is needed
+    ThreadAllocations* thread = t_thread;
+    if (!thread)
+        thread = registerThread();
+    UpdateAllocations* counts = threadUpdates(thread, m_updatable);
+    counts->updates++;
+    counts->allocations += m_allocations;
+    counts->bytes += m_bytes;
+    thread->owner = &counts->name;
+}
+
+void AllocationTracker::setHooksInstalled()
+{
+    atomic::store(&s_hooksInstalled, 1);
+}
+
+void AllocationTracker::recordAllocation(size_t size)
+{
+    if (t_paused)
+        return;
+
+    ThreadAllocations* thread = t_thread;
+    if (!thread)
+        thread = registerThread();
+    thread->allocations++;
+    thread->bytes += size;
+
+    if (t_scope)
+    {
+        t_scope->m_allocations++;
+        t_scope->m_bytes += size;
+    }
+
+    for (NoAllocationGuard* guard = t_guard; guard; guard = guard->m_previous)
+    {
+        guard->m_allocations++;
+        guard->m_bytes += size;
+    }
+}
+
+void AllocationTracker::recordFree()
+{
+    if (t_paused)
+        return;
+
+    ThreadAllocations* thread = t_thread;
+    if (!thread)
+        thread = registerThread();
+    thread->frees++;
+}
+
+} // namespace core
+} // namespace ram
@@ -13,6 +13,7 @@
 #endif 
  
 // STD Includes
+#include <algorithm>
 #include <cassert>
 #include <utility>
 #include <set>
@@ -23,15 +24,26 @@
 // Library Includes
 #include <boost/foreach.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <log4cpp/Category.hh>
 
 // Project Includes
 #include "core/include/Application.h"
+#include "core/include/Clock.h"
 #include "core/include/ConfigNode.h"
 #include "core/include/Exception.h"
 #include "core/include/Logging.h"
 #include "core/include/SubsystemMaker.h"
 #include "core/include/DependencyGraph.h"
 #include "core/include/Feature.h"
+#include "core/include/Updatable.h"
+#include "core/include/GILock.h"
+#include "core/include/CpuTopology.h"
+#include "core/include/PlacementPlanner.h"
 
 #ifdef RAM_WITH_WRAPPERS
 #include <iostream>
@@ -50,11 +62,126 @@
 #define PYTHON_ERROR_CATCH(message)
 #endif
 
+// Create category for logging
+static log4cpp::Category& LOGGER(log4cpp::Category::getInstance("Application"));
+
 namespace ram {
 namespace core {
-    
+
+/** A subsystem to be made, and the results of trying to make it */
+struct StartupTask
+{
+    StartupTask(std::string name_, ConfigNode config_, SubsystemList deps_) :
+        name(name_),
+        config(config_),
+        deps(deps_),
+        seconds(0),
+        pythonError(false)
+    {}
+
+    std::string name;
+    ConfigNode config;
+    SubsystemList deps;
+
+    SubsystemPtr subsystem;
+    double seconds;
+
+    /** Set when the subsystem could not be made */
+    std::string makerError;
+    bool pythonError;
+    boost::exception_ptr error;
+};
+
+typedef boost::shared_ptr<StartupTask> StartupTaskPtr;
+
+/** Makes the subsystem, recording any errors instead of throwing them */
+static void constructSubsystem(StartupTaskPtr task)
+{
+    TimeVal start(TimeVal::monotonic());
+    try {
+        task->subsystem = SubsystemMaker::newObject(
+            std::make_pair(task->config, task->deps));
+    } catch (core::MakerNotFoundException& ex) {
+        task->makerError = ex.what();
+    } catch (boost::python::error_already_set&) {
+        task->pythonError = true;
+    } catch (...) {
+        task->error = boost::current_exception();
+    }
+    task->seconds = (TimeVal::monotonic() - start).get_double();
+}
+
+/** Shuts down the subsystem, dropping our reference to it */
+static void destroySubsystem(SubsystemPtr* subsystem, double* seconds)
+{
+    TimeVal start(TimeVal::monotonic());
+    (*subsystem)->unbackground(true);
+    subsystem->reset();
+    *seconds = (TimeVal::monotonic() - start).get_double();
+}
+
+/** Subsystems made by makers written in python must be made, and destroyed,
+ *  by a thread holding the GIL.
+ */
+static bool isPythonMaker(ConfigNode config, SubsystemList deps)
+{
+    SubsystemMaker* maker =
+        SubsystemMaker::getMaker(std::make_pair(config, deps));
+    return 0 != dynamic_cast<boost::python::detail::wrapper_base*>(maker);
+}
+
+/** Pulls jobs off the list until there are none left */
+static void jobLoop(std::vector<boost::function<void ()> >* jobs,
+                    size_t* nextJob, boost::mutex* mutex)
+{
+    while (true)
+    {
+        size_t job = 0;
+        {
+            boost::mutex::scoped_lock lock(*mutex);
+            if (*nextJob >= jobs->size())
+                return;
+            job = (*nextJob)++;
+        }
+        (*jobs)[job]();
+    }
+}
+
+/** Runs the jobs with up to threadCount threads, the calling thread included
+ *
+ *  The calling thread lets go of the GIL while it waits, so the jobs must not
+ *  need python unless they take the GIL themselves.
+ */
+static void runJobs(std::vector<boost::function<void ()> >& jobs,
+                    size_t threadCount)
+{
+    if (jobs.empty())
+        return;
+
+    ScopedGILRelease release;
+    size_t nextJob = 0;
+    boost::mutex mutex;
+
+    std::vector<boost::thread*> threads;
+    size_t extraThreads = std::min(threadCount, jobs.size()) - 1;
+    for (size_t i = 0; i < extraThreads; ++i)
+    {
+        threads.push_back(new boost::thread(
+            boost::bind(&jobLoop, &jobs, &nextJob, &mutex)));
+    }
+
+    jobLoop(&jobs, &nextJob, &mutex);
+
+    BOOST_FOREACH(boost::thread* thread, threads)
+    {
+        thread->join();
+        delete thread;
+    }
+}
+
 Application::Application(std::string configPath) :
-    m_running(false)
+    m_running(false),
+    m_threadCount(1)
 {
     boost::filesystem::path path(configPath);
     ConfigNode rootCfg = core::ConfigNode::fromFile(path.string());
@@ -66,70 +193,124 @@ Application::Application(std::string configPath) :
         mode = "warning";
     }
 
+    // Run on the system clock, or on a virtual one stepped in lockstep with
+    // the updates.  This must be set before anything is backgrounded.
+    Clock::setMode(Clock::stringToMode(rootCfg["Clock"].asString("real")));
+
+    // Whether subsystems get their own thread, or share the scheduler's pool
+    std::string threadMode = rootCfg["ThreadMode"].asString("thread");
+
+    // How many threads make subsystems at once, by default one after another
+    int startupThreads = rootCfg["StartupThreads"].asInt(1);
+    if (startupThreads > 0)
+        m_threadCount = startupThreads;
+
     if (rootCfg.exists("Subsystems"))
     {
         ConfigNode sysConfig(rootCfg["Subsystems"]);
 
         // Properly fills m_order, and m_subsystemDeps
         DependencyGraph depGraph(sysConfig);
-        m_order = depGraph.getOrder();
+        std::vector<NameList> levels = depGraph.getLevels();
 
         std::vector<std::string> badSubsystemNames;
         std::set<std::string> invalidSystems;
         
-        // Create all the subsystems
-        BOOST_FOREACH(std::string subsystemName, m_order)
+        // Create all the subsystems, a level at a time
+        BOOST_FOREACH(NameList& level, levels)
         {
-            // Skip "creationMode"
-            if (subsystemName == "creationMode") {
-                continue;
-            }
+            std::vector<StartupTaskPtr> tasks;
+            std::vector<StartupTaskPtr> pythonTasks;
+            std::vector<boost::function<void ()> > jobs;
 
-            // If the subsystem has no configuration section, ignore it
-            if (!sysConfig.exists(subsystemName)) {
-                badSubsystemNames.push_back(subsystemName);
-                continue;
-            }
-
-            // Set 'name' properly in the config
-            ConfigNode config(sysConfig[subsystemName]);
-            config.set("name", subsystemName);
-        
-            // Build list of dependencies
-            SubsystemList deps;
-            NameList depNames = depGraph.getDependencies(subsystemName);
-            bool abort = false;
-            BOOST_FOREACH(std::string depName, depNames)
+            BOOST_FOREACH(std::string subsystemName, level)
             {
-                if (!hasSubsystem(depName) ||
-                    invalidSystems.count(depName) == 1) {
-                    // The dependencies have not been satisfied
-                    abort = true;
-                    break;
+                // Skip "creationMode"
+                if (subsystemName == "creationMode") {
+                    continue;
                 }
-                deps.push_back(getSubsystem(depName));
-            }
 
-            if (abort) {
-                // The dependencies were not satisfied
-                // do not make this subsystem
-                // Remove from the order
-                badSubsystemNames.push_back(subsystemName);
-                continue;
+                // If the subsystem has no configuration section, ignore it
+                if (!sysConfig.exists(subsystemName)) {
+                    badSubsystemNames.push_back(subsystemName);
+                    continue;
+                }
+
+                // Set 'name' properly in the config
+                ConfigNode config(sysConfig[subsystemName]);
+                config.set("name", subsystemName);
+
+                // Build list of dependencies
+                SubsystemList deps;
+                NameList depNames = depGraph.getDependencies(subsystemName);
+                bool abort = false;
+                BOOST_FOREACH(std::string depName, depNames)
+                {
+                    if (!hasSubsystem(depName) ||
+                        invalidSystems.count(depName) == 1) {
+                        // The dependencies have not been satisfied
+                        abort = true;
+                        break;
+                    }
+                    deps.push_back(getSubsystem(depName));
+                }
+
+                if (abort) {
+                    // The dependencies were not satisfied
+                    // do not make this subsystem
+                    // Remove from the order
+                    badSubsystemNames.push_back(subsystemName);
+                    continue;
+                }
+
+                StartupTaskPtr task(
+                    new StartupTask(subsystemName, config, deps));
+                PYTHON_ERROR_TRY {
+                    try {
+                        if (isPythonMaker(config, deps)) {
+                            m_pythonSubsystems.insert(subsystemName);
+                            pythonTasks.push_back(task);
+                        } else {
+                            jobs.push_back(
+                                boost::bind(&constructSubsystem, task));
+                        }
+                        tasks.push_back(task);
+                    } catch (core::MakerNotFoundException& ex) {
+                        std::cout << ex.what() << " - "
+                                  << subsystemName << std::endl;
+                        invalidSystems.insert(subsystemName);
+                    }
+                } PYTHON_ERROR_CATCH("Subsystem construction");
             }
 
-            // Create out new subsystem and store it
-            PYTHON_ERROR_TRY {
-                try {
-                    SubsystemPtr subsystem(SubsystemMaker::newObject(
-                                               std::make_pair(config, deps) ));
-                    m_subsystems[subsystemName] = subsystem;
-                } catch (core::MakerNotFoundException& ex) {
-                    std::cout << ex.what() << " - "
-                              << subsystemName << std::endl;
-                    invalidSystems.insert(subsystemName);
+            // Create our new subsystems, the python ones in this thread
+            BOOST_FOREACH(StartupTaskPtr task, pythonTasks)
+                constructSubsystem(task);
+            runJobs(jobs, m_threadCount);
+
+            // Store them, handling errors in order so the same subsystem is
+            // always blamed
+            BOOST_FOREACH(StartupTaskPtr task, tasks)
+            {
+                if (!task->makerError.empty()) {
+                    std::cout << task->makerError << " - "
+                              << task->name << std::endl;
+                    invalidSystems.insert(task->name);
+                    continue;
                 }
-            } PYTHON_ERROR_CATCH("Subsystem construction");
+
+                PYTHON_ERROR_TRY {
+                    if (task->pythonError)
+                        throw boost::python::error_already_set();
+                } PYTHON_ERROR_CATCH("Subsystem construction");
+
+                if (task->error)
+                    boost::rethrow_exception(task->error);
+
+                m_subsystems[task->name] = task->subsystem;
+                m_startupTimes[task->name] = task->seconds;
+                m_order.push_back(task->name);
+            }
         }
         
         // Add invalid systems to the bad subsystems
@@ -157,12 +338,81 @@ Application::Application(std::string configPath) :
         }
         assert(!earlyTermination && "Dependencies are missing");
 
+        // Record the levels of the subsystems that were made, for shutdown
+        BOOST_FOREACH(NameList& level, levels)
+        {
+            NameList made;
+            BOOST_FOREACH(std::string name, level)
+            {
+                if (hasSubsystem(name))
+                    made.push_back(name);
+            }
+            if (!made.empty())
+                m_levels.push_back(made);
+        }
+
+        // Logged now that the Logging subsystem is up
+        BOOST_FOREACH(std::string name, m_order)
+        {
+            LOGGER.infoStream() << "Started " << name << " in "
+                                << m_startupTimes[name] << " s";
+        }
+
+        // Subsystems with a placement hint have their CPU and priority
+        // picked for them from the topology of the machine
+        PlacementPlanner planner(CpuTopology::fromSysfs());
+        BOOST_FOREACH(std::string name, m_order)
+        {
+            ConfigNode cfg(sysConfig[name]);
+            if (cfg.exists("placement"))
+            {
+                planner.request(name, PlacementPlanner::stringToHint(
+                                    cfg["placement"].asString()));
+            }
+        }
+        PlacementPlanner::PlacementList placements = planner.plan();
+        std::map<std::string, PlacementPlanner::Placement*> placementMap;
+        BOOST_FOREACH(PlacementPlanner::Placement& placement, placements)
+        {
+            // Updatable can only pin to online CPUs, isolated ones included
+            if ((Updatable::getCPUCount() < 2) ||
+                !Updatable::isCPUOnline(placement.cpu))
+            {
+                placement.cpu = -1;
+            }
+            placementMap[placement.name] = &placement;
+        }
+
         // Not sure if this is the right place for this or not
         // maybe another function, maybe a scheduler?
         BOOST_FOREACH(std::string name, m_order)
         {
             PYTHON_ERROR_TRY {
                 ConfigNode cfg(sysConfig[name]);
+
+                // Only subsystems which are Updatables, and did not already
+                // background themselves, can use the pool
+                Updatable* updatable =
+                    dynamic_cast<Updatable*>(m_subsystems[name].get());
+                std::string mode(cfg["thread_mode"].asString(threadMode));
+                if (updatable && !updatable->backgrounded())
+                {
+                    updatable->setThreadMode(
+                        Updatable::stringToThreadMode(mode));
+                }
+                else if (cfg.exists("thread_mode"))
+                {
+                    std::cout << "WARNING: " << name << " does not support "
+                              << "thread_mode" << std::endl;
+                }
+
+                if (updatable && cfg.exists("overrun_policy"))
+                {
+                    updatable->setOverrunPolicy(
+                        Updatable::stringToOverrunPolicy(
+                            cfg["overrun_policy"].asString()));
+                }
+                
                 if (cfg.exists("update_interval"))
                 {
                     int updateInterval = cfg["update_interval"].asInt();
@@ -180,8 +430,37 @@ Application::Application(std::string configPath) :
                 {
                     m_subsystems[name]->setAffinity(cfg["affinity"].asInt());
                 }
+
+                // The planned settings, unless they were given by hand
+                if (placementMap.count(name))
+                {
+                    PlacementPlanner::Placement* placement =
+                        placementMap[name];
+                    if (!cfg.exists("priority"))
+                        m_subsystems[name]->setPriority(placement->priority);
+                    else
+                        placement->priority = IUpdatable::stringToPriority(
+                            cfg["priority"].asString());
+
+                    if (cfg.exists("affinity"))
+                        placement->cpu = cfg["affinity"].asInt();
+                    else if (placement->cpu >= 0)
+                        m_subsystems[name]->setAffinity(placement->cpu);
+                }
             } PYTHON_ERROR_CATCH("Subsystem setup");
         } // foreach name in order
+
+        if (!placements.empty())
+        {
+            LOGGER.infoStream() << "Placement (name hint cpu core priority):\n"
+                                << planner.describe(placements);
+            BOOST_FOREACH(std::string warning,
+                          planner.findConflicts(placements))
+            {
+                LOGGER.warnStream() << warning;
+                std::cout << "WARNING: " << warning << std::endl;
+            }
+        }
     } // if subsystem section of config exists
     
     // Write out the yaml config file in its current state
@@ -191,18 +470,43 @@ Application::Application(std::string configPath) :
 
 Application::~Application()
 {
-    PYTHON_ERROR_TRY {
-        // Go through subsystems in the reverse order of construction and
-        // shut them down
-        for (int i = (((int)m_order.size()) - 1); i >= 0; --i)
+    // Go through the levels in the reverse order of construction and shut
+    // them down, a level at a time
+    for (int i = (((int)m_levels.size()) - 1); i >= 0; --i)
+    {
+        NameList& level = m_levels[i];
+        std::vector<SubsystemPtr> subsystems;
+        std::vector<double> seconds(level.size(), 0);
+        BOOST_FOREACH(std::string name, level)
         {
-            std::string name(m_order[i]);
-            SubsystemPtr subsystem = m_subsystems[name];
-            subsystem->unbackground(true);
-            
+            subsystems.push_back(m_subsystems[name]);
             m_subsystems.erase(name);
         }
-    } PYTHON_ERROR_CATCH("Subsystem cleanup");
+
+        // Subsystems from python makers need the GIL, which we hold
+        std::vector<boost::function<void ()> > jobs;
+        for (size_t j = 0; j < level.size(); ++j)
+        {
+            if (m_pythonSubsystems.count(level[j]))
+            {
+                PYTHON_ERROR_TRY {
+                    destroySubsystem(&subsystems[j], &seconds[j]);
+                } PYTHON_ERROR_CATCH("Subsystem cleanup");
+            }
+            else
+            {
+                jobs.push_back(boost::bind(&destroySubsystem, &subsystems[j],
+                                           &seconds[j]));
+            }
+        }
+        runJobs(jobs, m_threadCount);
+
+        for (size_t j = 0; j < level.size(); ++j)
+        {
+            LOGGER.infoStream() << "Stopped " << level[j] << " in "
+                                << seconds[j] << " s";
+        }
+    }
 }
 
 void Application::remove_from_order(std::string name)
@@ -237,6 +541,14 @@ std::vector<std::string> Application::getSubsystemNames()
     return m_order;
 }
 
+double Application::getStartupTime(std::string name)
+{
+    std::map<std::string, double>::iterator iter = m_startupTimes.find(name);
+    if (m_startupTimes.end() != iter)
+        return iter->second;
+    return 0;
+}
+
 void Application::mainLoop(bool singleSubsystem)
 {
     m_running = true;
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/AsyncDelivery.cpp
+ */
+
+// STD Includes
+#include <cassert>
+
+// Library Includes
+#include <boost/algorithm/string.hpp>
+
+// Project Includes
+#include "core/include/AsyncDelivery.h"
+#include "core/include/EventProfiler.h"
+
+namespace ram {
+namespace core {
+
+AsyncDelivery::Options::Options(Executor executor_, size_t capacity_,
+                                BoundedQueueBase::OverflowPolicy overflow_) :
+    executor(executor_),
+    capacity(capacity_),
+    overflow(overflow_),
+    interval(10),
+    priority(IUpdatable::NORMAL_PRIORITY),
+    affinity(-1)
+{
+}
+
+AsyncDelivery::Options AsyncDelivery::Options::fromConfig(ConfigNode config)
+{
+    Options options;
+    options.executor = stringToExecutor(
+        config["executor"].asString("thread"));
+    options.capacity = (size_t)config["capacity"].asInt(256);
+    options.overflow = BoundedQueueBase::stringToPolicy(
+        config["overflow"].asString("dropOldest"));
+    options.interval = config["interval"].asInt(10);
+    options.priority = IUpdatable::stringToPriority(
+        config["priority"].asString("normal"));
+    options.affinity = config["affinity"].asInt(-1);
+    return options;
+}
+
+AsyncDelivery::Executor AsyncDelivery::Options::stringToExecutor(
+    std::string str)
+{
+    boost::algorithm::to_lower(str);
+    assert((str == "thread" || str == "pool" || str == "manual") &&
+           "Invalid executor");
+
+    if (str == "pool")
+        return POOL_EXECUTOR;
+    else if (str == "manual")
+        return MANUAL_EXECUTOR;
+    return THREAD_EXECUTOR;
+}
+
+AsyncDelivery::AsyncDelivery(Handler handler, const Options& options) :
+    m_handler(handler),
+    m_options(options),
+    m_queue(options.capacity, options.overflow),
+    m_stopped(0)
+{
+    if (MANUAL_EXECUTOR == m_options.executor)
+        return;
+
+    setPriority(m_options.priority);
+    if (m_options.affinity >= 0)
+        setAffinity((size_t)m_options.affinity);
+
+    if (POOL_EXECUTOR == m_options.executor)
+    {
+        setThreadMode(Updatable::SHARED_POOL);
+        background(m_options.interval);
+    }
+    else
+    {
+        // Runs all out, update() waits for events
+        background(-1);
+    }
+}
+
+AsyncDelivery::~AsyncDelivery()
+{
+    stop();
+}
+
+void AsyncDelivery::push(EventPtr event)
+{
+    if (!atomic::load(&m_stopped))
+        m_queue.push(QueuedEvent(event, EventProfiler::now()));
+}
+
+void AsyncDelivery::update(double)
+{
+    {
+        boost::mutex::scoped_lock lock(m_deliveryMutex);
+        m_deliveryThread = boost::this_thread::get_id();
+    }
+
+    m_queue.popAll(m_batch);
+
+    // Only our own thread can afford to block
+    if (m_batch.empty() && (THREAD_EXECUTOR == m_options.executor))
+    {
+        QueuedEvent queued;
+        boost::xtime wait = {0, 100000000}; // 100 milliseconds
+        if (m_queue.popTimedWait(wait, queued))
+            m_batch.push_back(queued);
+    }
+
+    deliverBatch();
+
+    boost::mutex::scoped_lock lock(m_deliveryMutex);
+    m_deliveryThread = boost::thread::id();
+    m_deliveryFinished.notify_all();
+}
+
+void AsyncDelivery::stop()
+{
+    atomic::store(&m_stopped, 1);
+
+    // A handler stopping its own delivery can't wait for itself to finish
+    boost::thread::id self = boost::this_thread::get_id();
+    bool inHandler = false;
+    {
+        boost::mutex::scoped_lock lock(m_deliveryMutex);
+        inHandler = (m_deliveryThread == self);
+    }
+
+    if (MANUAL_EXECUTOR != m_options.executor)
+        unbackground(!inHandler);
+
+    // A manual update() on another thread can still be in the handler
+    boost::mutex::scoped_lock lock(m_deliveryMutex);
+    while ((boost::thread::id() != m_deliveryThread) &&
+           (self != m_deliveryThread))
+    {
+        m_deliveryFinished.wait(lock);
+    }
+}
+
+size_t AsyncDelivery::getDeliveredCount() const
+{
+    return (size_t)m_delivered.get();
+}
+
+size_t AsyncDelivery::getDroppedCount() const
+{
+    return m_queue.getDroppedNewest() + m_queue.getDroppedOldest();
+}
+
+size_t AsyncDelivery::getQueuedCount() const
+{
+    return m_queue.size();
+}
+
+const Histogram& AsyncDelivery::getLag() const
+{
+    return m_lag;
+}
+
+const AsyncDelivery::Options& AsyncDelivery::getOptions() const
+{
+    return m_options;
+}
+
+void AsyncDelivery::deliverBatch()
+{
+    for (size_t i = 0; i < m_batch.size(); ++i)
+    {
+        if (atomic::load(&m_stopped))
+            break;
+
+        m_lag.record(EventProfiler::now() - m_batch[i].queued);
+        m_handler(m_batch[i].event);
+        m_delivered.increment();
+    }
+
+    // Don't hold on to the events
+    m_batch.clear();
+}
+
+AsyncEventConnection::AsyncEventConnection(EventConnectionPtr connection,
+                                           AsyncDeliveryPtr delivery) :
+    m_connection(connection),
+    m_delivery(delivery)
+{
+}
+
+AsyncEventConnection::~AsyncEventConnection()
+{
+}
+
+void AsyncEventConnection::disconnect()
+{
+    // Stop new events first, then the ones already queued
+    m_connection->disconnect();
+    m_delivery->stop();
+}
+
+bool AsyncEventConnection::connected()
+{
+    return m_connection->connected();
+}
+
+AsyncDeliveryPtr AsyncEventConnection::getDelivery()
+{
+    return m_delivery;
+}
+
+} // namespace core
+} // namespace ram
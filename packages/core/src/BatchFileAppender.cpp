@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/BatchFileAppender.cpp
+ */
+
+// Library Includes
+#include <log4cpp/Layout.hh>
+
+// Project Includes
+#include "core/include/BatchFileAppender.h"
+#include "core/include/TimeVal.h"
+
+namespace ram {
+namespace core {
+
+const size_t BatchFileAppender::DEFAULT_BUFFER_SIZE;
+
+BatchFileAppender::BatchFileAppender(const std::string& name,
+                                     const std::string& fileName,
+                                     double flushInterval,
+                                     size_t bufferSize) :
+    log4cpp::LayoutAppender(name),
+    m_fileName(fileName),
+    m_file(0),
+    m_flushInterval(flushInterval),
+    m_bufferSize(bufferSize),
+    m_lastFlush(TimeVal::monotonic().get_double()),
+    m_writeCount(0)
+{
+    m_buffer.reserve(m_bufferSize);
+    open("w");
+}
+
+BatchFileAppender::~BatchFileAppender()
+{
+    close();
+}
+
+void BatchFileAppender::endBatch()
+{
+    if (m_buffer.empty())
+        return;
+
+    double now = TimeVal::monotonic().get_double();
+    if ((now - m_lastFlush) >= m_flushInterval)
+        flush();
+}
+
+void BatchFileAppender::flush()
+{
+    m_lastFlush = TimeVal::monotonic().get_double();
+    if (m_buffer.empty() || !m_file)
+        return;
+
+    // The file is unbuffered so this is a single write
+    fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+    m_buffer.clear();
+    ++m_writeCount;
+}
+
+bool BatchFileAppender::reopen()
+{
+    close();
+    open("a");
+    return 0 != m_file;
+}
+
+void BatchFileAppender::close()
+{
+    flush();
+    if (m_file)
+    {
+        fclose(m_file);
+        m_file = 0;
+    }
+}
+
+void BatchFileAppender::open(const char* mode)
+{
+    m_file = fopen(m_fileName.c_str(), mode);
+
+    // We do our own buffering
+    if (m_file)
+        setvbuf(m_file, 0, _IONBF, 0);
+}
+
+void BatchFileAppender::_append(const log4cpp::LoggingEvent& event)
+{
+    m_buffer += _getLayout().format(event);
+    if (m_buffer.size() >= m_bufferSize)
+        flush();
+}
+
+} // namespace core
+} // namespace ram
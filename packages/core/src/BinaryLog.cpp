@@ -0,0 +1,845 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/BinaryLog.cpp
+ */
+
+// STD Includes
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+// Library Includes
+#include <boost/foreach.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include <log4cpp/Category.hh>
+#include <log4cpp/LoggingEvent.hh>
+#include <log4cpp/TimeStamp.hh>
+
+// Project Includes
+#include "core/include/BinaryLog.h"
+#include "core/include/SubsystemMaker.h"
+#include "core/include/Logging.h"
+#include "core/include/TimeVal.h"
+
+// Register the writer in the subsystem maker system
+RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::core::BinaryLog, BinaryLog);
+
+namespace ram {
+namespace core {
+
+/** Start of every binary log file, the last character is the version */
+static const char MAGIC[8] = {'R', 'A', 'M', 'B', 'L', 'O', 'G', '1'};
+
+/** Each entry in the file starts with one of these bytes */
+enum FileEntry
+{
+    ENTRY_LOGGER = 1, // Logger id, name length, name
+    ENTRY_RECORD = 2  // The record exactly as logged
+};
+
+/** Bytes of log each thread can buffer, must be a power of two */
+static const size_t RING_SIZE = 1 << 16;
+
+volatile AtomicWord BinaryLogger::s_writers = 0;
+
+// ------------------------------------------------------------------------ //
+//                           L O G G E R S                                  //
+// ------------------------------------------------------------------------ //
+
+struct LoggerRegistry
+{
+    boost::mutex mutex;
+    std::map<std::string, BinaryLogger*> byName;
+    std::vector<BinaryLogger*> byId;
+};
+
+static LoggerRegistry& loggers()
+{
+    static LoggerRegistry registry;
+    return registry;
+}
+
+BinaryLogger::BinaryLogger(const std::string& name, boost::uint16_t id) :
+    m_name(name),
+    m_id(id),
+    m_priority(log4cpp::Category::getInstance(name).getChainedPriority())
+{
+}
+
+BinaryLogger& BinaryLogger::getInstance(const std::string& name)
+{
+    LoggerRegistry& registry = loggers();
+    boost::mutex::scoped_lock lock(registry.mutex);
+
+    BinaryLogger*& logger = registry.byName[name];
+    if (!logger)
+    {
+        logger = new BinaryLogger(name, (boost::uint16_t)registry.byId.size());
+        registry.byId.push_back(logger);
+    }
+    return *logger;
+}
+
+BinaryLogger* BinaryLogger::getById(boost::uint16_t id)
+{
+    LoggerRegistry& registry = loggers();
+    boost::mutex::scoped_lock lock(registry.mutex);
+    if (id < registry.byId.size())
+        return registry.byId[id];
+    return 0;
+}
+
+void BinaryLogger::updatePriorities()
+{
+    LoggerRegistry& registry = loggers();
+    boost::mutex::scoped_lock lock(registry.mutex);
+    BOOST_FOREACH(BinaryLogger* logger, registry.byId)
+    {
+        log4cpp::Category& category =
+            log4cpp::Category::getInstance(logger->m_name);
+        logger->setPriority(category.getChainedPriority());
+    }
+}
+
+// ------------------------------------------------------------------------ //
+//                           R E C O R D S                                  //
+// ------------------------------------------------------------------------ //
+
+const size_t BinaryLogRecord::MAX_SIZE;
+const size_t BinaryLogRecord::HEADER_SIZE;
+
+BinaryLogRecord::BinaryLogRecord(BinaryLogger& logger, int priority) :
+    m_size(HEADER_SIZE)
+{
+    TimeVal now(TimeVal::timeOfDay());
+    boost::uint16_t id = logger.getId();
+    boost::uint16_t level = (boost::uint16_t)priority;
+    boost::int64_t time = ((boost::int64_t)now.seconds()) * 1000000 +
+        now.microseconds();
+
+    memcpy(m_buffer + 4, &id, 2);
+    memcpy(m_buffer + 6, &level, 2);
+    memcpy(m_buffer + 8, &time, 8);
+}
+
+BinaryLogRecord::~BinaryLogRecord()
+{
+    boost::uint32_t size = (boost::uint32_t)m_size;
+    memcpy(m_buffer, &size, 4);
+
+    if (!BinaryLog::append(m_buffer, m_size))
+        BinaryLog::forwardRecord(m_buffer, m_size);
+}
+
+BinaryLogRecord& BinaryLogRecord::putString(char type, const char* data,
+                                            size_t length)
+{
+    if ((m_size + 3) > MAX_SIZE)
+        return *this;
+
+    // Cut the string short to fit
+    length = std::min(length, MAX_SIZE - m_size - 3);
+    boost::uint16_t fieldLength = (boost::uint16_t)length;
+
+    m_buffer[m_size] = type;
+    memcpy(m_buffer + m_size + 1, &fieldLength, 2);
+    memcpy(m_buffer + m_size + 3, data, length);
+    m_size += 3 + length;
+    return *this;
+}
+
+// ------------------------------------------------------------------------ //
+//                             R I N G S                                    //
+// ------------------------------------------------------------------------ //
+
+/** Single producer, single consumer byte queue
+ *
+ *  The head and tail only ever grow, their difference is the number of
+ *  bytes in the ring.  Only the owning thread writes, and only a BinaryLog
+ *  holding the ring list mutex reads.
+ */
+struct LogRing
+{
+    LogRing() : head(0), tail(0), dropped(0), orphaned(0), writing(0) {}
+
+    void write(const char* data, size_t size)
+    {
+        unsigned long start = (unsigned long)head;
+        unsigned long used = start - (unsigned long)atomic::load(&tail);
+        if ((RING_SIZE - used) < size)
+        {
+            atomic::add(&dropped, 1);
+            return;
+        }
+
+        size_t offset = start & (RING_SIZE - 1);
+        size_t first = std::min(size, RING_SIZE - offset);
+        memcpy(buffer + offset, data, first);
+        memcpy(buffer, data + first, size - first);
+        atomic::store(&head, (AtomicWord)(start + size));
+    }
+
+    /** Appends everything in the ring to the given buffer */
+    void read(std::vector<char>& out)
+    {
+        unsigned long end = (unsigned long)atomic::load(&head);
+        unsigned long start = (unsigned long)tail;
+        size_t size = end - start;
+        if (0 == size)
+            return;
+
+        size_t offset = start & (RING_SIZE - 1);
+        size_t first = std::min(size, RING_SIZE - offset);
+        out.insert(out.end(), buffer + offset, buffer + offset + first);
+        out.insert(out.end(), buffer, buffer + (size - first));
+        atomic::store(&tail, (AtomicWord)end);
+    }
+
+    volatile AtomicWord head;
+    volatile AtomicWord tail;
+
+    /** Records which did not fit */
+    volatile AtomicWord dropped;
+
+    /** Set when the owning thread exits */
+    volatile AtomicWord orphaned;
+
+    /** Set while the owning thread is between checking for a BinaryLog and
+     *  finishing its write */
+    volatile AtomicWord writing;
+
+    char buffer[RING_SIZE];
+};
+
+struct RingList
+{
+    RingList() : deletedDropped(0) {}
+
+    /** Held while reading the rings and changing the list */
+    boost::mutex mutex;
+    std::vector<LogRing*> rings;
+
+    /** Dropped records of rings which have been deleted */
+    boost::int64_t deletedDropped;
+};
+
+/** Never destroyed, threads can exit after the statics are gone */
+static RingList& ringList()
+{
+    static RingList* list = new RingList();
+    return *list;
+}
+
+/** Called when the owning thread exits
+ *
+ *  While a BinaryLog is running it frees the ring once it has drained it.
+ *  Without one the ring is freed here, unless the last BinaryLog has yet to
+ *  make its final drain of it.
+ */
+static void orphanRing(LogRing* ring)
+{
+    RingList& list = ringList();
+    boost::mutex::scoped_lock lock(list.mutex);
+    atomic::store(&ring->orphaned, 1);
+
+    bool empty = (atomic::load(&ring->head) == atomic::load(&ring->tail));
+    if (!BinaryLogger::hasWriter() && empty)
+    {
+        list.rings.erase(std::remove(list.rings.begin(), list.rings.end(),
+                                     ring), list.rings.end());
+        list.deletedDropped += atomic::load(&ring->dropped);
+        delete ring;
+    }
+}
+
+/** Never destroyed, threads can exit after the statics are gone */
+static boost::thread_specific_ptr<LogRing>& threadRing()
+{
+    static boost::thread_specific_ptr<LogRing>* ring =
+        new boost::thread_specific_ptr<LogRing>(&orphanRing);
+    return *ring;
+}
+
+bool BinaryLog::append(const char* record, size_t size)
+{
+    if (!BinaryLogger::hasWriter())
+        return false;
+
+    LogRing* ring = threadRing().get();
+    if (!ring)
+    {
+        ring = new LogRing();
+        threadRing().reset(ring);
+
+        RingList& list = ringList();
+        boost::mutex::scoped_lock lock(list.mutex);
+        list.rings.push_back(ring);
+    }
+
+    // Check again once marked as writing, so the last BinaryLog either waits
+    // for this write before its final drain, or we see it is gone
+    atomic::store(&ring->writing, 1);
+    atomic::memoryBarrier();
+    bool written = BinaryLogger::hasWriter();
+    if (written)
+        ring->write(record, size);
+    atomic::store(&ring->writing, 0);
+    return written;
+}
+
+boost::int64_t BinaryLog::getDroppedCount()
+{
+    RingList& list = ringList();
+    boost::mutex::scoped_lock lock(list.mutex);
+    boost::int64_t dropped = list.deletedDropped;
+    BOOST_FOREACH(LogRing* ring, list.rings)
+        dropped += atomic::load(&ring->dropped);
+    return dropped;
+}
+
+// ------------------------------------------------------------------------ //
+//                            W R I T E R                                   //
+// ------------------------------------------------------------------------ //
+
+BinaryLog::BinaryLog(ConfigNode config, SubsystemList deps) :
+    Subsystem(config["name"].asString("BinaryLog"), deps),
+    Updatable(this),
+    m_file(0),
+    m_forward(0 != config["forward"].asInt(0))
+{
+    std::string fileName = config["fileName"].asString("binary.log");
+    if (!fileName.empty())
+    {
+        std::string path((Logging::getLogDir() / fileName).string());
+        m_file = fopen(path.c_str(), "wb");
+    }
+
+    if (m_file)
+    {
+        // Times in text logs are relative to when log4cpp started
+        const log4cpp::TimeStamp& start = log4cpp::TimeStamp::getStartTime();
+        boost::int64_t startTime = ((boost::int64_t)start.getSeconds()) *
+            1000000 + start.getMicroSeconds();
+        fwrite(MAGIC, sizeof(MAGIC), 1, m_file);
+        fwrite(&startTime, sizeof(startTime), 1, m_file);
+    }
+
+    BinaryLogger::updatePriorities();
+    atomic::add(&BinaryLogger::s_writers, 1);
+}
+
+BinaryLog::~BinaryLog()
+{
+    unbackground(true);
+
+    // Once the last BinaryLog is gone no new records go into the rings, wait
+    // out the writes already underway so the final drain gets them
+    if (0 == atomic::add(&BinaryLogger::s_writers, -1))
+    {
+        RingList& list = ringList();
+        boost::mutex::scoped_lock lock(list.mutex);
+        BOOST_FOREACH(LogRing* ring, list.rings)
+        {
+            while (0 != atomic::load(&ring->writing))
+                boost::this_thread::yield();
+        }
+    }
+
+    // Write out what is left, rings of live threads are kept for the next
+    // BinaryLog and freed when their thread exits
+    update(0);
+    if (m_file)
+        fclose(m_file);
+}
+
+/** Orders records by the time they were made */
+static bool earlierRecord(const char* a, const char* b)
+{
+    boost::int64_t timeA;
+    boost::int64_t timeB;
+    memcpy(&timeA, a + 8, 8);
+    memcpy(&timeB, b + 8, 8);
+    return timeA < timeB;
+}
+
+void BinaryLog::update(double)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    std::vector<char> data;
+    {
+        RingList& list = ringList();
+        boost::mutex::scoped_lock listLock(list.mutex);
+
+        std::vector<LogRing*> active;
+        BOOST_FOREACH(LogRing* ring, list.rings)
+        {
+            // Check first, so the thread made its last write before we read
+            bool orphaned = (0 != atomic::load(&ring->orphaned));
+            ring->read(data);
+            if (orphaned)
+            {
+                list.deletedDropped += atomic::load(&ring->dropped);
+                delete ring;
+            }
+            else
+            {
+                active.push_back(ring);
+            }
+        }
+        list.rings.swap(active);
+    }
+
+    if (data.empty())
+        return;
+
+    // Each thread's records are in order, merge them all by time
+    std::vector<const char*> records;
+    size_t offset = 0;
+    while ((offset + BinaryLogRecord::HEADER_SIZE) <= data.size())
+    {
+        boost::uint32_t size;
+        memcpy(&size, &data[offset], 4);
+        records.push_back(&data[offset]);
+        offset += size;
+    }
+    std::stable_sort(records.begin(), records.end(), earlierRecord);
+
+    BOOST_FOREACH(const char* record, records)
+    {
+        boost::uint32_t size;
+        memcpy(&size, record, 4);
+        if (m_file)
+            writeRecord(record, size);
+        if (m_forward)
+            forwardRecord(record, size);
+    }
+
+    if (m_file)
+        fflush(m_file);
+}
+
+void BinaryLog::setPriority(IUpdatable::Priority priority)
+{
+    Updatable::setPriority(priority);
+}
+
+IUpdatable::Priority BinaryLog::getPriority()
+{
+    return Updatable::getPriority();
+}
+
+void BinaryLog::setAffinity(size_t affinity)
+{
+    Updatable::setAffinity(affinity);
+}
+
+int BinaryLog::getAffinity()
+{
+    return Updatable::getAffinity();
+}
+
+void BinaryLog::background(int interval)
+{
+    Updatable::background(interval);
+}
+
+void BinaryLog::unbackground(bool join)
+{
+    Updatable::unbackground(join);
+}
+
+bool BinaryLog::backgrounded()
+{
+    return Updatable::backgrounded();
+}
+
+void BinaryLog::writeRecord(const char* record, size_t size)
+{
+    boost::uint16_t id;
+    memcpy(&id, record + 4, 2);
+
+    if (m_writtenLoggers.end() == m_writtenLoggers.find(id))
+    {
+        BinaryLogger* logger = BinaryLogger::getById(id);
+        std::string name(logger ? logger->getName() : "Unknown");
+        boost::uint16_t length = (boost::uint16_t)name.size();
+
+        fputc(ENTRY_LOGGER, m_file);
+        fwrite(&id, 2, 1, m_file);
+        fwrite(&length, 2, 1, m_file);
+        fwrite(name.data(), 1, length, m_file);
+        m_writtenLoggers.insert(id);
+    }
+
+    fputc(ENTRY_RECORD, m_file);
+    fwrite(record, 1, size, m_file);
+}
+
+void BinaryLog::forwardRecord(const char* record, size_t size)
+{
+    boost::uint16_t id;
+    memcpy(&id, record + 4, 2);
+    BinaryLogger* logger = BinaryLogger::getById(id);
+
+    BinaryLogEntry entry;
+    if (!logger || !decodeRecord(record, size, entry))
+        return;
+
+    log4cpp::Category& category =
+        log4cpp::Category::getInstance(logger->getName());
+    log4cpp::LoggingEvent event(category.getName(), entry.message, "",
+                                entry.priority);
+
+    // Keep the time it was logged, not the time it was written
+    event.timeStamp = log4cpp::TimeStamp(
+        (unsigned int)(entry.time / 1000000),
+        (unsigned int)(entry.time % 1000000));
+    category.callAppenders(event);
+}
+
+/** Reads a value from the record, advancing the offset */
+template<class T>
+static bool readField(const char* record, size_t size, size_t& offset,
+                      T& value)
+{
+    if ((offset + sizeof(T)) > size)
+        return false;
+    memcpy(&value, record + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+/** A decoded field, with its value in the member matching its type */
+struct LogField
+{
+    LogField() : type(0), integer(0), unsignedInteger(0), real(0) {}
+
+    /** The value as log4cpp streams would write it */
+    std::string text() const
+    {
+        std::stringstream ss;
+        switch (type)
+        {
+            case BLOG_BOOL: ss << (0 != integer); break;
+            case BLOG_CHAR: ss << (char)integer; break;
+            case BLOG_INT32:
+            case BLOG_INT64: ss << integer; break;
+            case BLOG_UINT32:
+            case BLOG_UINT64: ss << unsignedInteger; break;
+            case BLOG_DOUBLE: ss << real; break;
+            default: ss << string;
+        }
+        return ss.str();
+    }
+
+    long long asInteger() const
+    {
+        if ((BLOG_UINT32 == type) || (BLOG_UINT64 == type))
+            return (long long)unsignedInteger;
+        if (BLOG_DOUBLE == type)
+            return (long long)real;
+        return integer;
+    }
+
+    double asDouble() const
+    {
+        if ((BLOG_UINT32 == type) || (BLOG_UINT64 == type))
+            return (double)unsignedInteger;
+        if (BLOG_DOUBLE == type)
+            return real;
+        return (double)integer;
+    }
+
+    char type;
+    boost::int64_t integer;
+    boost::uint64_t unsignedInteger;
+    double real;
+    std::string string;
+};
+
+/** Reads the next field of the record, false if it is malformed */
+static bool readLogField(const char* record, size_t size, size_t& offset,
+                         LogField& field)
+{
+    field.type = record[offset++];
+    switch (field.type)
+    {
+        case BLOG_BOOL:
+        case BLOG_CHAR:
+        {
+            char value = 0;
+            if (!readField(record, size, offset, value))
+                return false;
+            field.integer = value;
+            return true;
+        }
+
+        case BLOG_INT32:
+        {
+            boost::int32_t value = 0;
+            if (!readField(record, size, offset, value))
+                return false;
+            field.integer = value;
+            return true;
+        }
+
+        case BLOG_UINT32:
+        {
+            boost::uint32_t value = 0;
+            if (!readField(record, size, offset, value))
+                return false;
+            field.unsignedInteger = value;
+            return true;
+        }
+
+        case BLOG_INT64:
+            return readField(record, size, offset, field.integer);
+
+        case BLOG_UINT64:
+            return readField(record, size, offset, field.unsignedInteger);
+
+        case BLOG_DOUBLE:
+            return readField(record, size, offset, field.real);
+
+        case BLOG_STRING:
+        case BLOG_FORMAT:
+        {
+            boost::uint16_t length = 0;
+            if (!readField(record, size, offset, length) ||
+                ((offset + length) > size))
+            {
+                return false;
+            }
+            field.string.assign(record + offset, length);
+            offset += length;
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+/** Formats a single field with a printf conversion like "%3.1f"
+ *
+ *  Only flags, a width and a precision of at most two digits each, and the
+ *  standard conversions are supported, anything else is written as is.
+ */
+static std::string formatField(const std::string& spec, char conversion,
+                               const LogField& field)
+{
+    // Checks the spec, so the result always fits in the buffer
+    size_t i = 1;
+    while ((i < spec.size()) && strchr("-+ #0", spec[i]))
+        ++i;
+    size_t digits = 0;
+    while ((i < spec.size()) && isdigit((unsigned char)spec[i]))
+        ++i, ++digits;
+    bool valid = (digits <= 2);
+    if ((i < spec.size()) && ('.' == spec[i]))
+    {
+        ++i;
+        digits = 0;
+        while ((i < spec.size()) && isdigit((unsigned char)spec[i]))
+            ++i, ++digits;
+        valid = valid && (digits <= 2);
+    }
+    if (!valid || (i != spec.size()))
+        return spec + conversion;
+
+    char buffer[512];
+    switch (conversion)
+    {
+        case 'd':
+        case 'i':
+            sprintf(buffer, (spec + "lld").c_str(), field.asInteger());
+            break;
+
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            sprintf(buffer, (spec + "ll" + conversion).c_str(),
+                    (unsigned long long)field.asInteger());
+            break;
+
+        case 'c':
+            sprintf(buffer, (spec + "c").c_str(), (int)field.asInteger());
+            break;
+
+        case 's':
+            return field.text();
+
+        default:
+            sprintf(buffer, (spec + conversion).c_str(), field.asDouble());
+    }
+    return buffer;
+}
+
+/** Fills in a printf style format with the fields */
+static std::string applyFormat(const std::string& format,
+                               const std::vector<LogField>& fields)
+{
+    std::string result;
+    size_t next = 0;
+    size_t i = 0;
+    while (i < format.size())
+    {
+        if ('%' != format[i])
+        {
+            result += format[i++];
+            continue;
+        }
+        if (((i + 1) < format.size()) && ('%' == format[i + 1]))
+        {
+            result += '%';
+            i += 2;
+            continue;
+        }
+
+        size_t end = format.find_first_of("diouxXeEfFgGcs", i + 1);
+        if ((std::string::npos == end) || (next >= fields.size()))
+        {
+            result += format.substr(i);
+            break;
+        }
+
+        // Length modifiers don't matter, we know the real type
+        std::string spec;
+        for (size_t j = i; j < end; ++j)
+        {
+            if (!strchr("hlLqjzt", format[j]))
+                spec += format[j];
+        }
+
+        result += formatField(spec, format[end], fields[next++]);
+        i = end + 1;
+    }
+    return result;
+}
+
+bool BinaryLog::decodeRecord(const char* record, size_t size,
+                             BinaryLogEntry& entry)
+{
+    if (size < BinaryLogRecord::HEADER_SIZE)
+        return false;
+
+    boost::uint32_t recordSize;
+    memcpy(&recordSize, record, 4);
+    if (recordSize != size)
+        return false;
+
+    boost::uint16_t priority;
+    memcpy(&priority, record + 6, 2);
+    memcpy(&entry.time, record + 8, 8);
+    entry.priority = priority;
+
+    std::vector<LogField> fields;
+    size_t offset = BinaryLogRecord::HEADER_SIZE;
+    while (offset < size)
+    {
+        fields.push_back(LogField());
+        if (!readLogField(record, size, offset, fields.back()))
+            return false;
+    }
+
+    if (!fields.empty() && (BLOG_FORMAT == fields[0].type))
+    {
+        std::string format(fields[0].string);
+        fields.erase(fields.begin());
+        entry.message = applyFormat(format, fields);
+        return true;
+    }
+
+    // Fields are separated by spaces, like the old stream based messages
+    entry.message.clear();
+    for (size_t i = 0; i < fields.size(); ++i)
+    {
+        if (i > 0)
+            entry.message += " ";
+        entry.message += fields[i].text();
+    }
+    return true;
+}
+
+bool BinaryLog::readFile(const std::string& fileName,
+                         boost::int64_t& startTime,
+                         std::vector<BinaryLogEntry>& entries)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+        return false;
+
+    char magic[sizeof(MAGIC)];
+    if ((1 != fread(magic, sizeof(magic), 1, file)) ||
+        (0 != memcmp(magic, MAGIC, sizeof(MAGIC))) ||
+        (1 != fread(&startTime, sizeof(startTime), 1, file)))
+    {
+        fclose(file);
+        return false;
+    }
+
+    std::map<boost::uint16_t, std::string> names;
+    char record[BinaryLogRecord::MAX_SIZE];
+    int kind;
+    while (EOF != (kind = fgetc(file)))
+    {
+        if (ENTRY_LOGGER == kind)
+        {
+            boost::uint16_t id;
+            boost::uint16_t length;
+            if ((1 != fread(&id, 2, 1, file)) ||
+                (1 != fread(&length, 2, 1, file)))
+            {
+                break;
+            }
+
+            std::string name(length, ' ');
+            if (length && (1 != fread(&name[0], length, 1, file)))
+                break;
+            names[id] = name;
+        }
+        else if (ENTRY_RECORD == kind)
+        {
+            boost::uint32_t size;
+            if ((1 != fread(&size, 4, 1, file)) ||
+                (size < BinaryLogRecord::HEADER_SIZE) ||
+                (size > BinaryLogRecord::MAX_SIZE) ||
+                (1 != fread(record + 4, size - 4, 1, file)))
+            {
+                break;
+            }
+            memcpy(record, &size, 4);
+
+            BinaryLogEntry entry;
+            if (!decodeRecord(record, size, entry))
+                continue;
+
+            boost::uint16_t id;
+            memcpy(&id, record + 4, 2);
+            std::map<boost::uint16_t, std::string>::iterator name =
+                names.find(id);
+            entry.category = (names.end() != name) ? name->second : "Unknown";
+            entries.push_back(entry);
+        }
+        else
+        {
+            // Corrupt, nothing after this can be trusted
+            break;
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+} // namespace core
+} // namespace ram
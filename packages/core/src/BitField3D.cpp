@@ -27,9 +27,17 @@ BitField3D::BitField3D(size_t length, size_t width, size_t height)
 std::vector<bool>::reference BitField3D::operator() (
     size_t x, size_t y, size_t z)
 {
-    assert(x >= 0 || x < m_length);
-    assert(y >= 0 || y < m_width);
-    assert(z >= 0 || z < m_height);
+    assert(x < m_length);
+    assert(y < m_width);
+    assert(z < m_height);
+    return m_bitfield[m_length*m_width*z+m_length*y+x];
+}
+
+bool BitField3D::operator() (size_t x, size_t y, size_t z) const
+{
+    assert(x < m_length);
+    assert(y < m_width);
+    assert(z < m_height);
     return m_bitfield[m_length*m_width*z+m_length*y+x];
 }
 
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/Clock.cpp
+ */
+
+// STD Includes
+#include <cassert>
+#include <set>
+#include <time.h>
+
+// Library Includes
+#include <boost/algorithm/string.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/thread/xtime.hpp>
+
+// Project Includes
+#include "core/include/Clock.h"
+
+#ifdef RAM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h> // For Sleep()
+#endif // RAM_WINDOWS
+
+namespace ram {
+namespace core {
+
+typedef boost::int64_t Usec;
+
+volatile AtomicWord Clock::s_mode = Clock::REAL_TIME;
+
+static Usec toUsec(const TimeVal& time)
+{
+    return ((Usec)time.seconds()) * USEC_PER_SEC + time.microseconds();
+}
+
+static TimeVal fromUsec(Usec usec)
+{
+    return TimeVal((long)(usec / USEC_PER_SEC), (long)(usec % USEC_PER_SEC));
+}
+
+/** The state of the virtual clock */
+struct VirtualTime
+{
+    VirtualTime() : now(0), dayOffset(0), running(0) {}
+
+    boost::mutex mutex;
+
+    /** Signaled when the time moves, or the mode changes */
+    boost::condition advanced;
+
+    /** Signaled when a woken thread sleeps again, or exits */
+    boost::condition settled;
+
+    /** The current virtual monotonic time */
+    Usec now;
+
+    /** Added to now to get the time of day */
+    Usec dayOffset;
+
+    /** When each sleeping thread wakes up */
+    std::multiset<Usec> sleepers;
+
+    /** Threads woken by advanceTo() which haven't slept again */
+    int running;
+};
+
+/** Never destroyed, threads can exit after the statics are gone */
+static VirtualTime& virtualTime()
+{
+    static VirtualTime* time = new VirtualTime();
+    return *time;
+}
+
+/** Marks the thread as running, until it sleeps again or exits */
+static void threadExited(bool* woken)
+{
+    if (*woken)
+    {
+        VirtualTime& vt = virtualTime();
+        boost::mutex::scoped_lock lock(vt.mutex);
+        vt.running--;
+        vt.settled.notify_all();
+    }
+    delete woken;
+}
+
+static boost::thread_specific_ptr<bool> s_woken(threadExited);
+
+/** Sleeps the real clock */
+static void realSleep(double seconds)
+{
+    if (seconds <= 0)
+        return;
+
+#ifdef RAM_POSIX
+    TimeVal duration(seconds);
+    struct timespec sleep = {0, 0};
+    struct timespec act_sleep = {0, 0};
+
+    sleep.tv_sec = duration.seconds();
+    sleep.tv_nsec = duration.microseconds() * 1000;
+
+    nanosleep(&sleep, &act_sleep);
+#else
+    Sleep((DWORD)(seconds * 1000));
+#endif
+}
+
+void Clock::setMode(Mode mode)
+{
+    VirtualTime& vt = virtualTime();
+    boost::mutex::scoped_lock lock(vt.mutex);
+
+    if (VIRTUAL == mode && !isVirtual())
+    {
+        vt.now = toUsec(realMonotonic());
+        vt.dayOffset = toUsec(realTimeOfDay()) - vt.now;
+    }
+    atomic::store(&s_mode, mode);
+
+    // Sleepers fall back to the real clock
+    vt.advanced.notify_all();
+}
+
+Clock::Mode Clock::getMode()
+{
+    return (Mode)atomic::load(&s_mode);
+}
+
+Clock::Mode Clock::stringToMode(std::string str)
+{
+    boost::algorithm::to_lower(str);
+    assert((str == "real" || str == "virtual") && "Invalid clock mode");
+
+    if (str == "virtual")
+        return VIRTUAL;
+    return REAL_TIME;
+}
+
+TimeVal Clock::monotonic()
+{
+    if (!isVirtual())
+        return realMonotonic();
+    return fromUsec(monotonicUsec());
+}
+
+TimeVal Clock::timeOfDay()
+{
+    if (!isVirtual())
+        return realTimeOfDay();
+
+    VirtualTime& vt = virtualTime();
+    boost::mutex::scoped_lock lock(vt.mutex);
+    return fromUsec(vt.now + vt.dayOffset);
+}
+
+boost::int64_t Clock::monotonicUsec()
+{
+    if (!isVirtual())
+        return toUsec(realMonotonic());
+
+    VirtualTime& vt = virtualTime();
+    boost::mutex::scoped_lock lock(vt.mutex);
+    return vt.now;
+}
+
+void Clock::advanceTo(boost::int64_t usec)
+{
+    VirtualTime& vt = virtualTime();
+    boost::mutex::scoped_lock lock(vt.mutex);
+    if (usec <= vt.now)
+        return;
+    vt.now = usec;
+
+    // Everyone due is running until they sleep again
+    std::multiset<Usec>::iterator end = vt.sleepers.upper_bound(usec);
+    for (std::multiset<Usec>::iterator iter = vt.sleepers.begin();
+         iter != end; ++iter)
+    {
+        vt.running++;
+    }
+    vt.sleepers.erase(vt.sleepers.begin(), end);
+    vt.advanced.notify_all();
+}
+
+void Clock::sleepUntil(boost::int64_t usec)
+{
+    if (!isVirtual())
+    {
+        realSleep((usec - monotonicUsec()) / (double)USEC_PER_SEC);
+        return;
+    }
+
+    VirtualTime& vt = virtualTime();
+    boost::mutex::scoped_lock lock(vt.mutex);
+
+    // We were woken by the clock, and now we are done
+    if (s_woken.get() && *s_woken)
+    {
+        *s_woken = false;
+        vt.running--;
+        vt.settled.notify_all();
+    }
+
+    if (usec <= vt.now)
+        return;
+
+    vt.sleepers.insert(usec);
+    while (isVirtual() && (vt.now < usec))
+        vt.advanced.wait(lock);
+
+    if (vt.now >= usec)
+    {
+        // advanceTo() took us off the list, and counted us as running
+        if (!s_woken.get())
+            s_woken.reset(new bool(false));
+        *s_woken = true;
+    }
+    else
+    {
+        // Back to real time, finish the sleep on the real clock
+        vt.sleepers.erase(vt.sleepers.find(usec));
+        Usec remaining = usec - vt.now;
+        lock.unlock();
+        realSleep(remaining / (double)USEC_PER_SEC);
+    }
+}
+
+void Clock::sleep(double seconds)
+{
+    if (!isVirtual())
+        realSleep(seconds);
+    else
+        sleepUntil(monotonicUsec() + (Usec)(seconds * USEC_PER_SEC));
+}
+
+boost::int64_t Clock::getNextWakeup()
+{
+    VirtualTime& vt = virtualTime();
+    boost::mutex::scoped_lock lock(vt.mutex);
+    if (vt.sleepers.empty())
+        return -1;
+    return *vt.sleepers.begin();
+}
+
+bool Clock::waitForSleepers(double timeout)
+{
+    VirtualTime& vt = virtualTime();
+    boost::mutex::scoped_lock lock(vt.mutex);
+
+    TimeVal wakeUp(realTimeOfDay() + TimeVal(timeout));
+    boost::xtime xt;
+    xt.sec = (boost::xtime::xtime_sec_t)wakeUp.seconds();
+    xt.nsec = (boost::xtime::xtime_nsec_t)wakeUp.microseconds() * 1000;
+
+    while (vt.running > 0)
+    {
+        if (!vt.settled.timed_wait(lock, xt))
+            return 0 == vt.running;
+    }
+    return true;
+}
+
+// realMonotonic() and realTimeOfDay() are in TimeVal.cpp, with the windows
+// gettimeofday
+
+} // namespace core
+} // namespace ram
@@ -14,6 +14,8 @@
 #include "core/include/ConfigNode.h"
 #include "core/include/ConfigNodeImp.h"
 #include "core/include/PythonConfigNodeImp.h"
+#include "core/include/NativeConfigNodeImp.h"
+#include "core/include/ConfigSnapshot.h"
 
 namespace ram {
 namespace core {
@@ -108,11 +110,49 @@ std::string ConfigNode::toString()
     return m_impl->toString();
 }
 
+/** Saves a snapshot of the freshly parsed config in the cache
+ *
+ *  @return  A native node on the new snapshot, or the given node when the
+ *           snapshot could not be written.
+ */
+static ConfigNodeImpPtr cacheSnapshot(std::string configPath,
+                                      ConfigNodeImpPtr imp)
+{
+    namespace bf = boost::filesystem;
+
+    std::string cachePath(ConfigSnapshot::getCachePath(configPath));
+    if (cachePath.empty())
+        return imp;
+
+    if (!ConfigSnapshot::createCacheDir(cachePath))
+        return imp;
+
+    std::vector<std::string> sources;
+    sources.push_back(bf::system_complete(bf::path(configPath)).string());
+    ConfigValue root = static_cast<PythonConfigNodeImp*>(imp.get())->
+        toConfigValue(sources);
+
+    ConfigSnapshotPtr snapshot;
+    if (ConfigSnapshot::write(cachePath, root, sources))
+        snapshot = ConfigSnapshot::load(cachePath);
+    if (!snapshot)
+        return imp;
+    return ConfigNodeImpPtr(new NativeConfigNodeImp(snapshot));
+}
+
 ConfigNode ConfigNode::fromFile(std::string configPath)
 {
     boost::filesystem::path path(configPath);
     if (path.extension() == ".yml" || path.extension() == ".sml") {
-        return ConfigNode(PythonConfigNodeImp::fromYamlFile(path.string()));
+        // Only parse with python when the cached snapshot is out of date
+        ConfigSnapshotPtr snapshot =
+            ConfigSnapshot::fromCache(path.string());
+        if (snapshot)
+            return ConfigNode(ConfigNodeImpPtr(
+                new NativeConfigNodeImp(snapshot)));
+
+        return ConfigNode(cacheSnapshot(
+            path.string(), PythonConfigNodeImp::fromYamlFile(path.string())));
     } else {
         assert(false && "Invalid configuration type!");
     }
@@ -0,0 +1,796 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/ConfigSnapshot.cpp
+ */
+
+// STD Includes
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef RAM_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Library Includes
+#include <boost/foreach.hpp>
+#include <boost/filesystem.hpp>
+
+// Project Includes
+#include "core/include/ConfigSnapshot.h"
+
+namespace bf = boost::filesystem;
+
+namespace ram {
+namespace core {
+
+typedef boost::uint32_t uint32;
+
+/** Marks the file type, the last two characters are the format version */
+static const char MAGIC[8] = {'R', 'A', 'M', 'C', 'F', 'G', '0', '2'};
+
+/** Written in native byte order, so files from other machines are rejected */
+static const uint32 BYTE_ORDER_MARK = 0x01020304;
+
+static const uint32 NO_STRING = 0xFFFFFFFF;
+
+struct ConfigSnapshot::Header
+{
+    char magic[8];
+    uint32 byteOrder;
+    uint32 fileSize;
+
+    uint32 nodeOffset;
+    uint32 nodeCount;
+    uint32 childOffset;
+    uint32 childCount;
+    uint32 slotOffset;
+    uint32 slotCount;
+    uint32 stringOffset;
+    uint32 stringCount;
+    uint32 dataOffset;
+    uint32 dataSize;
+    uint32 sourceOffset;
+    uint32 sourceCount;
+};
+
+struct ConfigSnapshot::Node
+{
+    uint32 type;
+    uint32 text;
+    uint32 repr;
+
+    /** Children are in m_children[firstChild, firstChild + childCount) */
+    uint32 firstChild;
+    uint32 childCount;
+
+    /** Hash slots of a map, slotCount is zero or a power of two */
+    uint32 firstSlot;
+    uint32 slotCount;
+};
+
+struct ConfigSnapshot::Child
+{
+    /** String index of the key, NO_STRING for list elements */
+    uint32 key;
+    uint32 node;
+};
+
+struct ConfigSnapshot::String
+{
+    uint32 offset;
+    uint32 length;
+    uint32 hash;
+};
+
+struct ConfigSnapshot::Source
+{
+    uint32 path;
+    uint32 mtimeLow;
+    uint32 mtimeHigh;
+    uint32 sizeLow;
+    uint32 sizeHigh;
+    uint32 inodeLow;
+    uint32 inodeHigh;
+};
+
+/** A read only view of a whole file
+ *
+ *  Memory mapped where possible, otherwise the file is read into memory.
+ */
+class ConfigSnapshot::MappedFile : boost::noncopyable
+{
+public:
+    MappedFile() : m_data(0), m_size(0) {}
+
+    ~MappedFile()
+    {
+#ifdef RAM_POSIX
+        if (m_data)
+            munmap(const_cast<char*>(m_data), m_size);
+#endif
+    }
+
+    bool open(const std::string& fileName)
+    {
+#ifdef RAM_POSIX
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        if ((0 != fstat(fd, &info)) || (0 == info.st_size))
+        {
+            close(fd);
+            return false;
+        }
+
+        void* data = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (MAP_FAILED == data)
+            return false;
+
+        m_data = static_cast<const char*>(data);
+        m_size = info.st_size;
+        return true;
+#else
+        std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+        if (!file)
+            return false;
+
+        m_buffer.assign(std::istreambuf_iterator<char>(file),
+                        std::istreambuf_iterator<char>());
+        if (m_buffer.empty())
+            return false;
+
+        m_data = &m_buffer[0];
+        m_size = m_buffer.size();
+        return true;
+#endif
+    }
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char* m_data;
+    size_t m_size;
+#ifndef RAM_POSIX
+    std::vector<char> m_buffer;
+#endif
+};
+
+/** FNV-1a, used for the key hash tables */
+static uint32 hashString(const std::string& str)
+{
+    uint32 hash = 2166136261u;
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/** Marks the version of a source file */
+struct FileVersion
+{
+    FileVersion() : mtime(0), size(0), inode(0) {}
+
+    /** Modification time in nanoseconds, where the platform has them */
+    boost::int64_t mtime;
+    boost::int64_t size;
+
+    /** Changes when an editor saves by writing a new file and renaming it */
+    boost::int64_t inode;
+};
+
+/** Splits the value into the two words of the snapshot format */
+static void pushWords(std::vector<uint32>& words, boost::int64_t value)
+{
+    words.push_back((uint32)(value & 0xFFFFFFFF));
+    words.push_back((uint32)(value >> 32));
+}
+
+static boost::int64_t joinWords(uint32 low, uint32 high)
+{
+    return ((boost::int64_t)high << 32) | low;
+}
+
+static bool getFileVersion(const std::string& fileName, FileVersion& version)
+{
+#ifdef RAM_POSIX
+    struct stat info;
+    if (0 != stat(fileName.c_str(), &info))
+        return false;
+
+    version.mtime = (boost::int64_t)info.st_mtime * 1000000000;
+#  if defined(RAM_LINUX)
+    version.mtime += info.st_mtim.tv_nsec;
+#  elif defined(RAM_DARWIN)
+    version.mtime += info.st_mtimespec.tv_nsec;
+#  endif
+    version.size = (boost::int64_t)info.st_size;
+    version.inode = (boost::int64_t)info.st_ino;
+    return true;
+#else
+    try {
+        bf::path path(fileName);
+        if (!bf::exists(path))
+            return false;
+        version.mtime = (boost::int64_t)bf::last_write_time(path);
+        version.size = (boost::int64_t)bf::file_size(path);
+        return true;
+    } catch (bf::filesystem_error&) {
+        return false;
+    }
+#endif
+}
+
+/** True if the directory can hold cached snapshots without another user
+ *  being able to swap in their own
+ */
+static bool safeCacheDir(const bf::path& dir)
+{
+#ifdef RAM_POSIX
+    struct stat info;
+    if (0 != lstat(dir.string().c_str(), &info))
+        return false;
+    return S_ISDIR(info.st_mode) && (geteuid() == info.st_uid) &&
+        (0 == (info.st_mode & (S_IWGRP | S_IWOTH)));
+#else
+    return bf::is_directory(dir);
+#endif
+}
+
+/** Builds up the sections of a snapshot file in memory */
+class SnapshotWriter
+{
+public:
+    typedef ConfigSnapshot::Header Header;
+
+    uint32 addString(const std::string& str)
+    {
+        std::map<std::string, uint32>::iterator iter = m_stringIndex.find(str);
+        if (m_stringIndex.end() != iter)
+            return iter->second;
+
+        uint32 words[3] = {(uint32)m_data.size(), (uint32)str.size(),
+                           hashString(str)};
+        m_strings.insert(m_strings.end(), words, words + 3);
+        m_data.insert(m_data.end(), str.begin(), str.end());
+        m_data.push_back('\0');
+
+        uint32 index = (uint32)(m_strings.size() / 3 - 1);
+        m_stringIndex[str] = index;
+        return index;
+    }
+
+    /** Adds the value and all its children, returns its node index */
+    uint32 addNode(const ConfigValue& value)
+    {
+        uint32 index = (uint32)(m_nodes.size() / NODE_WORDS);
+        m_nodes.resize(m_nodes.size() + NODE_WORDS, 0);
+
+        uint32 text = NO_STRING;
+        uint32 repr = NO_STRING;
+        if ((CONFIG_LIST != value.type) && (CONFIG_MAP != value.type))
+        {
+            text = addString(value.text);
+            repr = text;
+            if (!value.repr.empty())
+                repr = addString(value.repr);
+        }
+
+        // Children go in one contiguous block, filled in after they are added
+        uint32 childCount = (uint32)value.children.size();
+        uint32 firstChild = (uint32)(m_children.size() / 2);
+        m_children.resize(m_children.size() + childCount * 2, NO_STRING);
+
+        uint32 slotCount = 0;
+        uint32 firstSlot = (uint32)m_slots.size();
+        if (CONFIG_MAP == value.type)
+        {
+            // Keep the table at most half full so probes stay short
+            slotCount = 1;
+            while (slotCount < childCount * 2)
+                slotCount *= 2;
+            m_slots.resize(m_slots.size() + slotCount, 0);
+        }
+
+        for (uint32 i = 0; i < childCount; ++i)
+        {
+            uint32 key = NO_STRING;
+            if (CONFIG_MAP == value.type)
+            {
+                key = addString(value.keys[i]);
+                uint32 slot = hashString(value.keys[i]) & (slotCount - 1);
+                while (0 != m_slots[firstSlot + slot])
+                    slot = (slot + 1) & (slotCount - 1);
+                m_slots[firstSlot + slot] = i + 1;
+            }
+
+            uint32 child = addNode(value.children[i]);
+            m_children[(firstChild + i) * 2] = key;
+            m_children[(firstChild + i) * 2 + 1] = child;
+        }
+
+        uint32* node = &m_nodes[index * NODE_WORDS];
+        node[0] = value.type;
+        node[1] = text;
+        node[2] = repr;
+        node[3] = firstChild;
+        node[4] = childCount;
+        node[5] = firstSlot;
+        node[6] = slotCount;
+        return index;
+    }
+
+    void addSource(const std::string& fileName)
+    {
+        FileVersion version;
+        getFileVersion(fileName, version);
+
+        m_sources.push_back(addString(fileName));
+        pushWords(m_sources, version.mtime);
+        pushWords(m_sources, version.size);
+        pushWords(m_sources, version.inode);
+    }
+
+    bool write(const std::string& fileName)
+    {
+        Header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.byteOrder = BYTE_ORDER_MARK;
+
+        // Every section is made of 32 bit words, except the string data
+        // which goes last, so everything stays aligned
+        uint32 offset = sizeof(Header);
+        header.nodeOffset = offset;
+        header.nodeCount = (uint32)(m_nodes.size() / NODE_WORDS);
+        offset += m_nodes.size() * 4;
+        header.childOffset = offset;
+        header.childCount = (uint32)(m_children.size() / 2);
+        offset += m_children.size() * 4;
+        header.slotOffset = offset;
+        header.slotCount = (uint32)m_slots.size();
+        offset += m_slots.size() * 4;
+        header.stringOffset = offset;
+        header.stringCount = (uint32)(m_strings.size() / 3);
+        offset += m_strings.size() * 4;
+        header.sourceOffset = offset;
+        header.sourceCount = (uint32)(m_sources.size() / SOURCE_WORDS);
+        offset += m_sources.size() * 4;
+        header.dataOffset = offset;
+        header.dataSize = (uint32)m_data.size();
+        offset += m_data.size();
+        header.fileSize = offset;
+
+        FILE* file = fopen(fileName.c_str(), "wb");
+        if (!file)
+            return false;
+
+        bool ok = (1 == fwrite(&header, sizeof(header), 1, file)) &&
+            writeWords(file, m_nodes) && writeWords(file, m_children) &&
+            writeWords(file, m_slots) && writeWords(file, m_strings) &&
+            writeWords(file, m_sources) &&
+            (m_data.size() == fwrite(&m_data[0], 1, m_data.size(), file));
+        ok = (0 == fclose(file)) && ok;
+        return ok;
+    }
+
+private:
+    static const size_t NODE_WORDS = sizeof(ConfigSnapshot::Node) / 4;
+    static const size_t SOURCE_WORDS = sizeof(ConfigSnapshot::Source) / 4;
+
+    static bool writeWords(FILE* file, const std::vector<uint32>& words)
+    {
+        if (words.empty())
+            return true;
+        return words.size() == fwrite(&words[0], 4, words.size(), file);
+    }
+
+    std::vector<uint32> m_nodes;
+    std::vector<uint32> m_children;
+    std::vector<uint32> m_slots;
+    std::vector<uint32> m_strings;
+    std::vector<uint32> m_sources;
+    std::vector<char> m_data;
+    std::map<std::string, uint32> m_stringIndex;
+};
+
+const boost::uint32_t ConfigSnapshot::ROOT;
+const boost::uint32_t ConfigSnapshot::NO_NODE;
+
+ConfigSnapshot::ConfigSnapshot(MappedFile* file) :
+    m_file(file),
+    m_header(reinterpret_cast<const Header*>(file->data())),
+    m_nodes(0),
+    m_children(0),
+    m_slots(0),
+    m_strings(0),
+    m_data(0),
+    m_sources(0)
+{
+}
+
+ConfigSnapshot::~ConfigSnapshot()
+{
+    delete m_file;
+}
+
+ConfigSnapshotPtr ConfigSnapshot::load(std::string fileName)
+{
+    MappedFile* file = new MappedFile();
+    if (!file->open(fileName) || (file->size() < sizeof(Header)))
+    {
+        delete file;
+        return ConfigSnapshotPtr();
+    }
+
+    ConfigSnapshotPtr snapshot(new ConfigSnapshot(file));
+    if (!snapshot->validate())
+        return ConfigSnapshotPtr();
+    return snapshot;
+}
+
+bool ConfigSnapshot::write(std::string fileName, const ConfigValue& root,
+                           const std::vector<std::string>& sources)
+{
+    SnapshotWriter writer;
+    writer.addNode(root);
+    BOOST_FOREACH(std::string source, sources)
+        writer.addSource(source);
+
+    // Write to the side and move it into place, so another process never
+    // sees half a file
+    std::stringstream ss;
+#ifdef RAM_POSIX
+    ss << fileName << "." << getpid() << ".tmp";
+#else
+    ss << fileName << "." << rand() << ".tmp";
+#endif
+    std::string tempName(ss.str());
+    if (!writer.write(tempName))
+    {
+        std::remove(tempName.c_str());
+        return false;
+    }
+
+#ifndef RAM_POSIX
+    // Only POSIX rename replaces an existing file
+    std::remove(fileName.c_str());
+#endif
+    if (0 != std::rename(tempName.c_str(), fileName.c_str()))
+    {
+        std::remove(tempName.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::string ConfigSnapshot::getCachePath(std::string configFile)
+{
+    bf::path cacheDir;
+    const char* cacheDirEnv = getenv("RAM_CONFIG_CACHE_DIR");
+    if (cacheDirEnv)
+    {
+        if (std::string("off") == cacheDirEnv)
+            return "";
+        cacheDir = bf::path(cacheDirEnv);
+    }
+    else
+    {
+        const char* temp = getenv("TMPDIR");
+        if (!temp)
+            temp = getenv("TEMP");
+        if (!temp)
+            temp = "/tmp";
+
+        // The temporary directory is shared, so every user gets their own
+        std::stringstream ss;
+        ss << "ram_config_cache";
+#ifdef RAM_POSIX
+        ss << "_" << geteuid();
+#endif
+        cacheDir = bf::path(temp) / ss.str();
+    }
+
+    // Flatten the full path into a file name, so every config gets its own
+    std::string name(bf::system_complete(bf::path(configFile)).string());
+    for (size_t i = 0; i < name.size(); ++i)
+    {
+        if (('/' == name[i]) || ('\\' == name[i]) || (':' == name[i]))
+            name[i] = '_';
+    }
+    return (cacheDir / (name + ".bin")).string();
+}
+
+bool ConfigSnapshot::createCacheDir(std::string cachePath)
+{
+    bf::path dir(bf::path(cachePath).parent_path());
+#ifdef RAM_POSIX
+    // Only the last directory is ours to create with the right permissions
+    try {
+        if (!dir.parent_path().empty())
+            bf::create_directories(dir.parent_path());
+    } catch (bf::filesystem_error&) {
+        return false;
+    }
+    mkdir(dir.string().c_str(), 0700);
+#else
+    try {
+        bf::create_directories(dir);
+    } catch (bf::filesystem_error&) {
+        return false;
+    }
+#endif
+    return safeCacheDir(dir);
+}
+
+ConfigSnapshotPtr ConfigSnapshot::fromCache(std::string configFile)
+{
+    std::string cachePath(getCachePath(configFile));
+    if (cachePath.empty() || !safeCacheDir(bf::path(cachePath).parent_path()))
+        return ConfigSnapshotPtr();
+
+    ConfigSnapshotPtr snapshot = load(cachePath);
+    if (snapshot && snapshot->upToDate())
+        return snapshot;
+    return ConfigSnapshotPtr();
+}
+
+bool ConfigSnapshot::upToDate()
+{
+    for (uint32 i = 0; i < m_header->sourceCount; ++i)
+    {
+        const Source& source = m_sources[i];
+        FileVersion version;
+        if (!getFileVersion(getString(source.path), version))
+            return false;
+
+        if ((version.mtime != joinWords(source.mtimeLow, source.mtimeHigh)) ||
+            (version.size != joinWords(source.sizeLow, source.sizeHigh)) ||
+            (version.inode != joinWords(source.inodeLow, source.inodeHigh)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+ConfigType ConfigSnapshot::getType(uint32 node) const
+{
+    if (node >= m_header->nodeCount)
+        return CONFIG_NONE;
+    return (ConfigType)m_nodes[node].type;
+}
+
+std::string ConfigSnapshot::getText(uint32 node) const
+{
+    if (node >= m_header->nodeCount)
+        return "";
+    return getString(m_nodes[node].text);
+}
+
+std::string ConfigSnapshot::getRepr(uint32 node) const
+{
+    if (node >= m_header->nodeCount)
+        return "";
+    return getString(m_nodes[node].repr);
+}
+
+size_t ConfigSnapshot::getChildCount(uint32 node) const
+{
+    if (node >= m_header->nodeCount)
+        return 0;
+    return m_nodes[node].childCount;
+}
+
+uint32 ConfigSnapshot::getChild(uint32 node, size_t index) const
+{
+    if ((node >= m_header->nodeCount) || (index >= m_nodes[node].childCount))
+        return NO_NODE;
+    return m_children[m_nodes[node].firstChild + index].node;
+}
+
+std::string ConfigSnapshot::getKey(uint32 node, size_t index) const
+{
+    if ((node >= m_header->nodeCount) || (index >= m_nodes[node].childCount))
+        return "";
+    return getString(m_children[m_nodes[node].firstChild + index].key);
+}
+
+uint32 ConfigSnapshot::findChild(uint32 node, const std::string& key) const
+{
+    if ((node >= m_header->nodeCount) || (0 == m_nodes[node].slotCount))
+        return NO_NODE;
+
+    const Node& map = m_nodes[node];
+    uint32 mask = map.slotCount - 1;
+    uint32 slot = hashString(key) & mask;
+
+    // The table is never full, so we always hit an empty slot
+    while (0 != m_slots[map.firstSlot + slot])
+    {
+        const Child& child = m_children[map.firstChild +
+                                        m_slots[map.firstSlot + slot] - 1];
+        const String& keyString = m_strings[child.key];
+        if ((keyString.length == key.size()) &&
+            (0 == memcmp(m_data + keyString.offset, key.data(), key.size())))
+        {
+            return child.node;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NO_NODE;
+}
+
+void ConfigSnapshot::setOverride(uint32 node, const std::string& key,
+                                 ConfigType type, const std::string& text)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_overrides[OverrideKey(node, key)] = std::make_pair(type, text);
+}
+
+bool ConfigSnapshot::getOverride(uint32 node, const std::string& key,
+                                 ConfigType& type, std::string& text)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    if (m_overrides.empty())
+        return false;
+
+    OverrideMap::iterator iter = m_overrides.find(OverrideKey(node, key));
+    if (m_overrides.end() == iter)
+        return false;
+
+    type = iter->second.first;
+    text = iter->second.second;
+    return true;
+}
+
+std::vector<std::string> ConfigSnapshot::getOverrideKeys(uint32 node)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    std::vector<std::string> keys;
+    OverrideMap::iterator iter =
+        m_overrides.lower_bound(OverrideKey(node, ""));
+    for (; (m_overrides.end() != iter) && (iter->first.first == node); ++iter)
+        keys.push_back(iter->first.second);
+    return keys;
+}
+
+/** True if [offset, offset + count * size) is inside the file */
+static bool inFile(uint32 offset, uint32 count, size_t size, size_t fileSize)
+{
+    return ((boost::uint64_t)offset + (boost::uint64_t)count * size) <=
+        fileSize;
+}
+
+bool ConfigSnapshot::validate()
+{
+    const Header& header = *m_header;
+    size_t fileSize = m_file->size();
+    if ((0 != memcmp(header.magic, MAGIC, sizeof(MAGIC))) ||
+        (BYTE_ORDER_MARK != header.byteOrder) ||
+        (header.fileSize != fileSize) || (0 == header.nodeCount))
+    {
+        return false;
+    }
+
+    if (!inFile(header.nodeOffset, header.nodeCount, sizeof(Node), fileSize) ||
+        !inFile(header.childOffset, header.childCount, sizeof(Child),
+                fileSize) ||
+        !inFile(header.slotOffset, header.slotCount, 4, fileSize) ||
+        !inFile(header.stringOffset, header.stringCount, sizeof(String),
+                fileSize) ||
+        !inFile(header.sourceOffset, header.sourceCount, sizeof(Source),
+                fileSize) ||
+        !inFile(header.dataOffset, header.dataSize, 1, fileSize))
+    {
+        return false;
+    }
+
+    // The word sections must be aligned to be read in place
+    uint32 offsets[] = {header.nodeOffset, header.childOffset,
+                        header.slotOffset, header.stringOffset,
+                        header.sourceOffset};
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i)
+    {
+        if (0 != (offsets[i] % 4))
+            return false;
+    }
+
+    const char* base = m_file->data();
+    m_nodes = reinterpret_cast<const Node*>(base + header.nodeOffset);
+    m_children = reinterpret_cast<const Child*>(base + header.childOffset);
+    m_slots = reinterpret_cast<const uint32*>(base + header.slotOffset);
+    m_strings = reinterpret_cast<const String*>(base + header.stringOffset);
+    m_sources = reinterpret_cast<const Source*>(base + header.sourceOffset);
+    m_data = base + header.dataOffset;
+
+    // Strings must be in the data and null terminated
+    for (uint32 i = 0; i < header.stringCount; ++i)
+    {
+        const String& str = m_strings[i];
+        if (((boost::uint64_t)str.offset + str.length) >= header.dataSize ||
+            ('\0' != m_data[str.offset + str.length]))
+        {
+            return false;
+        }
+    }
+
+    for (uint32 i = 0; i < header.nodeCount; ++i)
+    {
+        const Node& node = m_nodes[i];
+        if ((node.type > CONFIG_MAP) ||
+            ((NO_STRING != node.text) && (node.text >= header.stringCount)) ||
+            ((NO_STRING != node.repr) && (node.repr >= header.stringCount)) ||
+            (((boost::uint64_t)node.firstChild + node.childCount) >
+             header.childCount) ||
+            (((boost::uint64_t)node.firstSlot + node.slotCount) >
+             header.slotCount) ||
+            (0 != (node.slotCount & (node.slotCount - 1))) ||
+            ((CONFIG_MAP == node.type) && (node.slotCount <= node.childCount)))
+        {
+            return false;
+        }
+
+        for (uint32 j = 0; j < node.slotCount; ++j)
+        {
+            if (m_slots[node.firstSlot + j] > node.childCount)
+                return false;
+        }
+    }
+
+    for (uint32 i = 0; i < header.childCount; ++i)
+    {
+        const Child& child = m_children[i];
+        if ((child.node >= header.nodeCount) ||
+            ((NO_STRING != child.key) && (child.key >= header.stringCount)))
+        {
+            return false;
+        }
+    }
+
+    // Map keys must be strings, the hash lookup assumes it
+    for (uint32 i = 0; i < header.nodeCount; ++i)
+    {
+        const Node& node = m_nodes[i];
+        if (CONFIG_MAP != node.type)
+            continue;
+        for (uint32 j = 0; j < node.childCount; ++j)
+        {
+            if (NO_STRING == m_children[node.firstChild + j].key)
+                return false;
+        }
+    }
+
+    for (uint32 i = 0; i < header.sourceCount; ++i)
+    {
+        if (m_sources[i].path >= header.stringCount)
+            return false;
+    }
+
+    return true;
+}
+
+const char* ConfigSnapshot::getString(uint32 index) const
+{
+    if (index >= m_header->stringCount)
+        return "";
+    return m_data + m_strings[index].offset;
+}
+
+} // namespace core
+} // namespace ram
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/CpuTopology.cpp
+ */
+
+// STD Includes
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <utility>
+
+// Library Includes
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/CpuTopology.h"
+
+namespace ram {
+namespace core {
+
+/** Reads the first line of the file, false if it can't be read */
+static bool readLine(const std::string& path, std::string& line)
+{
+    std::ifstream file(path.c_str());
+    if (!file)
+        return false;
+    std::getline(file, line);
+    return true;
+}
+
+/** Reads a single integer from the file, or returns the default */
+static int readInt(const std::string& path, int defaultValue)
+{
+    std::string line;
+    if (!readLine(path, line) || line.empty())
+        return defaultValue;
+    return atoi(line.c_str());
+}
+
+static bool lowerId(const CpuInfo& a, const CpuInfo& b)
+{
+    return a.id < b.id;
+}
+
+CpuTopology::CpuTopology()
+{
+}
+
+CpuTopology::CpuTopology(const std::vector<CpuInfo>& cpus) :
+    m_cpus(cpus)
+{
+    std::sort(m_cpus.begin(), m_cpus.end(), lowerId);
+
+    // Group by physical core, since the CPUs are in order each core ends up
+    // numbered by its lowest CPU
+    std::map<std::pair<int, int>, size_t> coreIndex;
+    for (size_t i = 0; i < m_cpus.size(); ++i)
+    {
+        std::pair<int, int> key(m_cpus[i].package, m_cpus[i].coreId);
+        std::map<std::pair<int, int>, size_t>::iterator iter =
+            coreIndex.find(key);
+        if (coreIndex.end() == iter)
+        {
+            coreIndex[key] = m_cores.size();
+            m_cores.push_back(std::vector<int>(1, m_cpus[i].id));
+        }
+        else
+        {
+            m_cores[iter->second].push_back(m_cpus[i].id);
+        }
+    }
+}
+
+CpuTopology CpuTopology::fromSysfs(std::string root)
+{
+    std::vector<CpuInfo> cpus;
+
+    std::string line;
+    if (!readLine(root + "/online", line))
+    {
+        // No sysfs, assume nothing is shared
+        int count = (int)boost::thread::hardware_concurrency();
+        for (int i = 0; i < count; ++i)
+            cpus.push_back(CpuInfo(i, 0, i, false));
+        return CpuTopology(cpus);
+    }
+    std::vector<int> online = parseCpuList(line);
+
+    std::set<int> isolated;
+    if (readLine(root + "/isolated", line))
+    {
+        std::vector<int> list = parseCpuList(line);
+        isolated.insert(list.begin(), list.end());
+    }
+
+    for (size_t i = 0; i < online.size(); ++i)
+    {
+        int id = online[i];
+        std::stringstream topology;
+        topology << root << "/cpu" << id << "/topology/";
+
+        // Without topology information the CPU is a core of its own
+        CpuInfo cpu(id,
+                    readInt(topology.str() + "physical_package_id", 0),
+                    readInt(topology.str() + "core_id", -1 - id),
+                    isolated.count(id) > 0);
+        cpus.push_back(cpu);
+    }
+
+    return CpuTopology(cpus);
+}
+
+std::vector<int> CpuTopology::parseCpuList(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ','))
+    {
+        if (range.find_first_of("0123456789") == std::string::npos)
+            continue;
+
+        int first = atoi(range.c_str());
+        int last = first;
+        std::string::size_type dash = range.find('-');
+        if (std::string::npos != dash)
+            last = atoi(range.c_str() + dash + 1);
+
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+const std::vector<CpuInfo>& CpuTopology::getCpus() const
+{
+    return m_cpus;
+}
+
+const std::vector<std::vector<int> >& CpuTopology::getCores() const
+{
+    return m_cores;
+}
+
+int CpuTopology::getCoreOf(int cpu) const
+{
+    for (size_t i = 0; i < m_cores.size(); ++i)
+    {
+        if (std::find(m_cores[i].begin(), m_cores[i].end(), cpu) !=
+            m_cores[i].end())
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+bool CpuTopology::isCoreIsolated(size_t core) const
+{
+    for (size_t i = 0; i < m_cpus.size(); ++i)
+    {
+        if (m_cpus[i].isolated &&
+            (core == (size_t)getCoreOf(m_cpus[i].id)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace core
+} // namespace ram
@@ -8,6 +8,7 @@
  */
 
 // STD Includes
+#include <algorithm>
 #include <iostream>
 
 // Project Includes
@@ -196,6 +197,32 @@ std::vector<std::string> DependencyGraph::getOrder()
     return m_order;
 }
 
+std::vector<std::vector<std::string> > DependencyGraph::getLevels()
+{
+    std::vector<std::vector<std::string> > levels;
+    std::map<std::string, size_t> sectionLevel;
+
+    // Dependencies always come first in the order, so their level is known
+    BOOST_FOREACH(std::string section, m_order)
+    {
+        size_t level = 0;
+        std::map<std::string, std::vector<std::string> >::iterator iter =
+            m_sectionDeps.find(section);
+        if (m_sectionDeps.end() != iter)
+        {
+            BOOST_FOREACH(std::string depName, iter->second)
+                level = std::max(level, sectionLevel[depName] + 1);
+        }
+
+        sectionLevel[section] = level;
+        if (levels.size() <= level)
+            levels.resize(level + 1);
+        levels[level].push_back(section);
+    }
+
+    return levels;
+}
+
 
 std::vector<std::string> DependencyGraph::getDependencies(std::string section)
 {
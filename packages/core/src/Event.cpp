@@ -16,7 +16,9 @@ namespace core {
 
 Event::Event() :
     sender(0),
-    timeStamp(TimeVal::timeOfDay().get_double())
+    timeStamp(TimeVal::timeOfDay().get_double()),
+    traceId(0),
+    parentTraceId(0)
 {
 }
 
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/EventHandler.cpp
+ */
+
+// Library Includes
+#include <boost/thread/tss.hpp>
+
+// Project Includes
+#include "core/include/EventHandler.h"
+#include "core/include/EventProfiler.h"
+
+namespace ram {
+namespace core {
+
+/** A call in progress on the calling thread, they form a stack per thread */
+struct CallFrame
+{
+    EventHandler* handler;
+    CallFrame* next;
+};
+
+/** Never destroyed, threads can still publish after the statics are gone */
+static boost::thread_specific_ptr<CallFrame*>& callStack()
+{
+    static boost::thread_specific_ptr<CallFrame*>* stack =
+        new boost::thread_specific_ptr<CallFrame*>();
+    return *stack;
+}
+
+/** The top of the calling thread's stack of calls */
+static CallFrame*& topFrame()
+{
+    CallFrame** top = callStack().get();
+    if (!top)
+    {
+        top = new CallFrame*(0);
+        callStack().reset(top);
+    }
+    return *top;
+}
+
+/** Counts a call for as long as it is in scope
+ *
+ *  This makes sure we don't leave disconnect() waiting forever when the
+ *  handler throws.
+ */
+class CallGuard
+{
+public:
+    CallGuard(EventHandler* handler) :
+        m_handler(handler),
+        m_top(topFrame())
+    {
+        atomic::add(&m_handler->m_calls, 1);
+        m_frame.handler = handler;
+        m_frame.next = m_top;
+        m_top = &m_frame;
+    }
+
+    ~CallGuard()
+    {
+        m_top = m_frame.next;
+        atomic::add(&m_handler->m_calls, -1);
+
+        // Only a disconnect() can be waiting on us
+        if (!atomic::load(&m_handler->m_connected))
+        {
+            boost::mutex::scoped_lock lock(m_handler->m_mutex);
+            m_handler->m_callFinished.notify_all();
+        }
+    }
+
+private:
+    EventHandler* m_handler;
+    CallFrame*& m_top;
+    CallFrame m_frame;
+};
+
+/** Source of the handler ids */
+static AtomicCounter HANDLER_COUNT;
+
+EventHandler::EventHandler(boost::function<void (EventPtr)> function) :
+    m_id((size_t)HANDLER_COUNT.increment()),
+    m_function(function),
+    m_connected(1),
+    m_calls(0)
+{
+}
+
+void EventHandler::call(EventPtr event)
+{
+    // Counted before checking, so disconnect() either sees this call or the
+    // call sees the disconnect
+    CallGuard guard(this);
+    if (atomic::load(&m_connected))
+        m_function(event);
+}
+
+void EventHandler::disconnect()
+{
+    atomic::store(&m_connected, 0);
+    atomic::memoryBarrier();
+
+    // Calls made by this thread further up the stack can't be waited for
+    AtomicWord ownCalls = 0;
+    for (CallFrame* frame = topFrame(); frame; frame = frame->next)
+    {
+        if (this == frame->handler)
+            ownCalls++;
+    }
+
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        while (atomic::load(&m_calls) != ownCalls)
+            m_callFinished.wait(lock);
+    }
+
+    EventProfiler::dropHandler(m_id);
+}
+
+bool EventHandler::connected()
+{
+    return 0 != atomic::load(&m_connected);
+}
+
+} // namespace core
+} // namespace ram
@@ -7,10 +7,14 @@
  * File:  packages/core/src/EventHub.cpp
  */
 
+// Library Includes
+#include <boost/bind.hpp>
 
 // Project Includes
 #include "core/include/EventHub.h"
 #include "core/include/EventPublisherBase.h"
+#include "core/include/EventTypeRegistry.h"
+#include "core/include/Instrumentation.h"
 #include "core/include/SubsystemMaker.h"
 
 // Event Types
@@ -22,9 +26,8 @@ RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::core::EventHub, EventHub);
 namespace ram {
 namespace core {
 
-typedef EventPublisherBaseTemplate<Event::EventType> TypeEventPublisherType;
-typedef std::pair<Event::EventType, EventPublisher*> TypePublisherPair;
-typedef EventPublisherBaseTemplate<TypePublisherPair>
+typedef EventPublisherBaseTemplate<Event::EventTypeId> TypeEventPublisherType;
+typedef EventPublisherBaseTemplate<TypePublisherKey>
     TypePublisherEventPublisherType;
     
 
@@ -41,17 +44,19 @@ asType(EventPublisherBasePtr basePtr)
 
 EventHub::EventHub(std::string name) : 
     Subsystem(name),
-    m_impType(new EventPublisherBaseTemplate<Event::EventType>()),
-    m_impTypePublisher(new EventPublisherBaseTemplate<TypePublisherPair>()),
-    m_impAll(new EventPublisherBaseTemplate<Event::EventType>())
+    m_impType(new TypeEventPublisherType()),
+    m_impTypePublisher(new TypePublisherEventPublisherType()),
+    m_impAll(new TypeEventPublisherType()),
+    m_allEventsId(EventHub::ALL_EVENTS.getId())
 {
 }
     
 EventHub::EventHub(ConfigNode config, SubsystemList deps) :
     Subsystem(config["name"].asString()),
-    m_impType(new EventPublisherBaseTemplate<Event::EventType>()),
-    m_impTypePublisher(new EventPublisherBaseTemplate<TypePublisherPair>()),
-    m_impAll(new EventPublisherBaseTemplate<Event::EventType>())
+    m_impType(new TypeEventPublisherType()),
+    m_impTypePublisher(new TypePublisherEventPublisherType()),
+    m_impAll(new TypeEventPublisherType()),
+    m_allEventsId(EventHub::ALL_EVENTS.getId())
 {
 }
 
@@ -66,9 +71,9 @@ EventConnectionPtr EventHub::subscribe(
 {
     // Subscribe to the internal event publisher which handles subscribes
     // who want events of a particular type from a certain publisher
-    TypePublisherPair pair(type, publisher);
+    TypePublisherKey key(type.getId(), publisher);
     return asType<TypePublisherEventPublisherType>(m_impTypePublisher)->
-        subscribe(pair, handler);
+        subscribe(key, handler);
 }
 
 EventConnectionPtr EventHub::subscribeToType(
@@ -77,7 +82,8 @@ EventConnectionPtr EventHub::subscribeToType(
 {
     // Subscribe to the internal event publisher which handles subscribes
     // to a specific event type
-    return asType<TypeEventPublisherType>(m_impType)->subscribe(type, handler);
+    return asType<TypeEventPublisherType>(m_impType)->subscribe(
+        type.getId(), handler);
 }
 
     
@@ -85,28 +91,101 @@ EventConnectionPtr EventHub::subscribeToAll(
     boost::function<void (EventPtr)> handler)
 {
     return asType<TypeEventPublisherType>(m_impAll)->subscribe(
-        EventHub::ALL_EVENTS,
+        m_allEventsId,
         handler);
 }
+
+/** Subscribes through the given function, with the handler delivered on an
+ *  AsyncDelivery
+ */
+template<class SubscribeFunc>
+static EventConnectionPtr subscribeAsync(
+    SubscribeFunc subscribeFunc,
+    boost::function<void (EventPtr)> handler,
+    const AsyncDelivery::Options& options)
+{
+    AsyncDeliveryPtr delivery(new AsyncDelivery(handler, options));
+    EventConnectionPtr connection =
+        subscribeFunc(boost::bind(&AsyncDelivery::push, delivery, _1));
+    return EventConnectionPtr(new AsyncEventConnection(connection, delivery));
+}
+
+EventConnectionPtr EventHub::subscribe(
+    Event::EventType type,
+    EventPublisher* publisher,
+    boost::function<void (EventPtr)> handler,
+    const AsyncDelivery::Options& options)
+{
+    EventConnectionPtr (EventHub::*subscribeFunc)(
+        Event::EventType, EventPublisher*, boost::function<void (EventPtr)>) =
+        &EventHub::subscribe;
+    return subscribeAsync(boost::bind(subscribeFunc, this, type, publisher, _1),
+                          handler, options);
+}
+
+EventConnectionPtr EventHub::subscribeToType(
+    Event::EventType type,
+    boost::function<void (EventPtr)> handler,
+    const AsyncDelivery::Options& options)
+{
+    EventConnectionPtr (EventHub::*subscribeFunc)(
+        Event::EventType, boost::function<void (EventPtr)>) =
+        &EventHub::subscribeToType;
+    return subscribeAsync(boost::bind(subscribeFunc, this, type, _1),
+                          handler, options);
+}
+
+EventConnectionPtr EventHub::subscribeToAll(
+    boost::function<void (EventPtr)> handler,
+    const AsyncDelivery::Options& options)
+{
+    EventConnectionPtr (EventHub::*subscribeFunc)(
+        boost::function<void (EventPtr)>) = &EventHub::subscribeToAll;
+    return subscribeAsync(boost::bind(subscribeFunc, this, _1),
+                          handler, options);
+}
     
 void EventHub::publish(EventPtr event)
+{
+    // The type carries its id, all three publishers are indexed by it
+    Event::EventTypeId typeId = event->type.getId();
+    if (Instrumentation::active())
+    {
+        boost::int64_t start = EventProfiler::now();
+        if (Tracer::active())
+            Tracer::startTrace(event);
+
+        publishToHandlers(typeId, event);
+
+        if (EventProfiler::active())
+            EventProfiler::recordHubPublish(typeId, start);
+        if (Tracer::active())
+            Tracer::recordHubPublish(event, start);
+    }
+    else
+    {
+        publishToHandlers(typeId, event);
+    }
+}
+
+void EventHub::publishToHandlers(Event::EventTypeId typeId, EventPtr event)
 {
     // Publish to all subscribers of a specific event type
-    asType<TypeEventPublisherType>(m_impType)->publish(event->type,
+    asType<TypeEventPublisherType>(m_impType)->publish(typeId,
                                                        event->type,
                                                        event->sender,
                                                        event);
 
     // Publish to all subscribers to specific EventType & EventPublisher pairs
     asType<TypePublisherEventPublisherType>(m_impTypePublisher)->publish(
-        std::make_pair(event->type, event->sender),
+        TypePublisherKey(typeId, event->sender),
         event->type,
         event->sender,
         event);
 
     // Publish to subscribers who want all events
     asType<TypeEventPublisherType>(m_impAll)->publish(
-        EventHub::ALL_EVENTS,
+        m_allEventsId,
         event->type,
         event->sender,
         event);
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/EventPool.cpp
+ */
+
+// STD Includes
+#include <map>
+
+// Library Includes
+#include <boost/thread/mutex.hpp>
+
+// Project Includes
+#include "core/include/EventPool.h"
+
+namespace ram {
+namespace core {
+
+BlockPool::BlockPool(size_t blockSize, size_t maxFree) :
+    m_blockSize(blockSize),
+    m_freeBlocks(maxFree)
+{
+}
+
+BlockPool::~BlockPool()
+{
+    void* block = 0;
+    while (m_freeBlocks.tryPop(block))
+        ::operator delete(block);
+}
+
+BlockPool* BlockPool::getPool(size_t blockSize)
+{
+    typedef std::map<size_t, BlockPool*> BlockPoolMap;
+
+    // Leaked on purpose, see the header
+    static boost::mutex* mutex = new boost::mutex();
+    static BlockPoolMap* pools = new BlockPoolMap();
+
+    boost::mutex::scoped_lock lock(*mutex);
+    BlockPool*& pool = (*pools)[blockSize];
+    if (!pool)
+        pool = new BlockPool(blockSize);
+    return pool;
+}
+
+void* BlockPool::allocate()
+{
+    void* block = 0;
+    if (m_freeBlocks.tryPop(block))
+    {
+        m_reuses.increment();
+        return block;
+    }
+
+    m_heapAllocations.increment();
+    return ::operator new(m_blockSize);
+}
+
+void BlockPool::deallocate(void* block)
+{
+    // The free list is full, so the block goes back to the heap
+    if (!m_freeBlocks.tryPush(block))
+        ::operator delete(block);
+}
+
+} // namespace core
+} // namespace ram
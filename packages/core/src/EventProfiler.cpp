@@ -0,0 +1,437 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/EventProfiler.cpp
+ */
+
+// STD Includes
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <ctime>
+
+#if defined(__GNUC__)
+#  include <cxxabi.h>
+#endif
+
+// Library Includes
+#include <boost/foreach.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+// Project Includes
+#include "core/include/EventProfiler.h"
+#include "core/include/EventTypeRegistry.h"
+#include "core/include/SubsystemMaker.h"
+#include "core/include/Logging.h"
+#include "core/include/Events.h"
+#include "core/include/TimeVal.h"
+
+// Register into the maker subsystem
+RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::core::EventProfiler, EventProfiler);
+
+RAM_CORE_EVENT_TYPE(ram::core::EventProfiler, REPORT);
+
+namespace ram {
+namespace core {
+
+typedef std::vector<EventTypeProfilePtr> EventTypeProfileList;
+
+/** Protects the list of profiles, and the handler map of each one
+ *
+ *  Never destroyed, handlers can be disconnected after the statics are gone.
+ */
+static boost::mutex& profileMutex()
+{
+    static boost::mutex* mutex = new boost::mutex();
+    return *mutex;
+}
+
+/** Profiles indexed by event type id */
+static EventTypeProfileList& profiles()
+{
+    static EventTypeProfileList* list = new EventTypeProfileList();
+    return *list;
+}
+
+/** Changed whenever profiles are thrown away, so threads drop their caches */
+static volatile AtomicWord PROFILE_GENERATION = 0;
+
+/** The profiles a thread has already looked up */
+struct ProfileCache
+{
+    ProfileCache() : generation(atomic::load(&PROFILE_GENERATION)) {}
+
+    AtomicWord generation;
+
+    /** Indexed by event type id */
+    EventTypeProfileList types;
+
+    /** Indexed by event type id, then EventHandler::getId() */
+    std::map<std::pair<Event::EventTypeId, size_t>, HandlerProfilePtr>
+    handlers;
+};
+
+/** Never destroyed, threads can still publish after the statics are gone */
+static boost::thread_specific_ptr<ProfileCache>& profileCacheSlot()
+{
+    static boost::thread_specific_ptr<ProfileCache>* slot =
+        new boost::thread_specific_ptr<ProfileCache>();
+    return *slot;
+}
+
+/** The calling thread's cache, emptied if profiles were thrown away */
+static ProfileCache& profileCache()
+{
+    ProfileCache* cache = profileCacheSlot().get();
+    if (!cache)
+    {
+        cache = new ProfileCache();
+        profileCacheSlot().reset(cache);
+    }
+
+    AtomicWord generation = atomic::load(&PROFILE_GENERATION);
+    if (cache->generation != generation)
+    {
+        cache->types.clear();
+        cache->handlers.clear();
+        cache->generation = generation;
+    }
+    return *cache;
+}
+
+/** Finds the profile for the handler, creating it if needed */
+static HandlerProfilePtr getHandlerProfile(EventTypeProfilePtr typeProfile,
+                                           EventHandlerPtr handler)
+{
+    HandlerProfilePtr& profile = typeProfile->handlers[handler->getId()];
+    if (!profile)
+    {
+        profile = HandlerProfilePtr(new HandlerProfile());
+        profile->name = EventProfiler::describeHandler(handler);
+    }
+    return profile;
+}
+
+/** Orders handlers by total time spent in them, most first */
+static bool moreTotalTime(const HandlerProfilePtr& a,
+                          const HandlerProfilePtr& b)
+{
+    return (a->cost.getMean() * a->cost.getCount()) >
+        (b->cost.getMean() * b->cost.getCount());
+}
+
+/** Writes the count, mean, 50th, 99th percentile and max in microseconds */
+static void writeHistogram(std::ostream& out, const char* name,
+                           const Histogram& histogram)
+{
+    out << " " << name << " " << histogram.getCount() << " "
+        << histogram.getMean() / 1000 << " "
+        << histogram.getValueAtPercentile(50) / 1000.0 << " "
+        << histogram.getValueAtPercentile(99) / 1000.0 << " "
+        << histogram.getMax() / 1000.0;
+}
+
+EventProfiler::EventProfiler(ConfigNode config, SubsystemList deps) :
+    Subsystem(config["name"].asString("EventProfiler"), deps),
+    Updatable(this),
+    m_reportInterval(config["reportInterval"].asDouble(5)),
+    m_lastReport(now())
+{
+    std::string fileName =
+        config["fileName"].asString("event_profile.txt");
+    if (!fileName.empty())
+        m_filePath = (Logging::getLogDir() / fileName).string();
+
+    Instrumentation::add(Instrumentation::PROFILER);
+}
+
+EventProfiler::~EventProfiler()
+{
+    unbackground(true);
+    Instrumentation::remove(Instrumentation::PROFILER);
+}
+
+std::string EventProfiler::createReport()
+{
+    boost::int64_t reportTime = now();
+    double seconds = (reportTime - m_lastReport) / 1e9;
+    m_lastReport = reportTime;
+
+    // Copy the lists, so we don't block publishers while we format
+    std::vector<std::pair<EventTypeProfilePtr,
+                          std::vector<HandlerProfilePtr> > > types;
+    {
+        boost::mutex::scoped_lock lock(profileMutex());
+        BOOST_FOREACH(EventTypeProfilePtr profile, profiles())
+        {
+            if (!profile)
+                continue;
+
+            std::vector<HandlerProfilePtr> handlers;
+            typedef std::map<size_t, HandlerProfilePtr> HandlerMap;
+            BOOST_FOREACH(HandlerMap::value_type& item, profile->handlers)
+                handlers.push_back(item.second);
+            types.push_back(std::make_pair(profile, handlers));
+        }
+    }
+
+    std::stringstream out;
+    out << "# type <name> rate <per sec>"
+        << " publish|hub|queue <count mean p50 p99 max>" << std::endl
+        << "#   handler <name> cost <count mean p50 p99 max>"
+        << " (times in usec)" << std::endl;
+
+    for (size_t i = 0; i < types.size(); ++i)
+    {
+        EventTypeProfilePtr profile = types[i].first;
+
+        // Rate of the publishers, or the hub when published to it directly
+        boost::int64_t count = std::max(profile->publishTime.getCount(),
+                                        profile->hubTime.getCount());
+        boost::int64_t& lastCount = m_lastCounts[profile->type];
+        double rate = 0;
+        if (seconds > 0)
+            rate = (count - lastCount) / seconds;
+        lastCount = count;
+
+        out << "type " << profile->type << " rate " << rate;
+        writeHistogram(out, "publish", profile->publishTime);
+        writeHistogram(out, "hub", profile->hubTime);
+        writeHistogram(out, "queue", profile->queueTime);
+        out << std::endl;
+
+        std::vector<HandlerProfilePtr>& handlers = types[i].second;
+        std::sort(handlers.begin(), handlers.end(), moreTotalTime);
+        BOOST_FOREACH(HandlerProfilePtr handler, handlers)
+        {
+            out << "  handler " << handler->name;
+            writeHistogram(out, "cost", handler->cost);
+            out << std::endl;
+        }
+    }
+
+    return out.str();
+}
+
+void EventProfiler::update(double)
+{
+    if ((now() - m_lastReport) < (boost::int64_t)(m_reportInterval * 1e9))
+        return;
+
+    std::string report = createReport();
+    if (!m_filePath.empty())
+    {
+        // Only the latest report is kept
+        std::ofstream file(m_filePath.c_str(), std::ios::out | std::ios::trunc);
+        file << report;
+    }
+
+    StringEventPtr event(new StringEvent());
+    event->string = report;
+    publish(REPORT, event);
+}
+
+void EventProfiler::setPriority(IUpdatable::Priority priority)
+{
+    Updatable::setPriority(priority);
+}
+
+IUpdatable::Priority EventProfiler::getPriority()
+{
+    return Updatable::getPriority();
+}
+
+void EventProfiler::setAffinity(size_t affinity)
+{
+    Updatable::setAffinity(affinity);
+}
+
+int EventProfiler::getAffinity()
+{
+    return Updatable::getAffinity();
+}
+
+void EventProfiler::background(int interval)
+{
+    Updatable::background(interval);
+}
+
+void EventProfiler::unbackground(bool join)
+{
+    Updatable::unbackground(join);
+}
+
+bool EventProfiler::backgrounded()
+{
+    return Updatable::backgrounded();
+}
+
+EventTypeProfilePtr EventProfiler::getProfile(const Event::EventType& type)
+{
+    Event::EventTypeId typeId = EventTypeRegistry::lookup(type);
+    boost::mutex::scoped_lock lock(profileMutex());
+    if (typeId < profiles().size())
+        return profiles()[typeId];
+    return EventTypeProfilePtr();
+}
+
+void EventProfiler::resetProfiles()
+{
+    boost::mutex::scoped_lock lock(profileMutex());
+    profiles().clear();
+    atomic::add(&PROFILE_GENERATION, 1);
+}
+
+void EventProfiler::dropHandler(size_t handlerId)
+{
+    boost::mutex::scoped_lock lock(profileMutex());
+    bool dropped = false;
+    BOOST_FOREACH(EventTypeProfilePtr profile, profiles())
+    {
+        if (profile && profile->handlers.erase(handlerId))
+            dropped = true;
+    }
+
+    // Threads could still hand the old profile out of their caches
+    if (dropped)
+        atomic::add(&PROFILE_GENERATION, 1);
+}
+
+std::string EventProfiler::describeHandler(EventHandlerPtr handler)
+{
+    std::string name = handler->getFunctionType().name();
+#if defined(__GNUC__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name.c_str(), 0, 0, &status);
+    if (demangled)
+    {
+        name = demangled;
+        free(demangled);
+    }
+#endif
+
+    // For bound member functions (boost::_mfi::mf1<R, Class, ...>) the class
+    // is the only useful part of the name
+    std::string::size_type start = name.find("_mfi::");
+    if (std::string::npos != start)
+        start = name.find(',', start);
+    if (std::string::npos != start)
+    {
+        start = name.find_first_not_of(' ', start + 1);
+        std::string::size_type end = name.find_first_of(",<>", start);
+        if (std::string::npos != end)
+            name = name.substr(start, end - start);
+    }
+
+    std::stringstream ss;
+    ss << name << "#" << handler->getId();
+    return ss.str();
+}
+
+boost::int64_t EventProfiler::now()
+{
+#if defined(RAM_POSIX) && defined(CLOCK_MONOTONIC)
+    struct timespec current;
+    clock_gettime(CLOCK_MONOTONIC, &current);
+    return ((boost::int64_t)current.tv_sec) * 1000000000 + current.tv_nsec;
+#else
+    TimeVal current(TimeVal::monotonic());
+    return ((boost::int64_t)current.seconds()) * 1000000000 +
+        ((boost::int64_t)current.microseconds()) * 1000;
+#endif
+}
+
+void EventProfiler::callHandlers(Event::EventTypeId typeId,
+                                 const EventHandlerList& handlers,
+                                 EventPtr event)
+{
+    BOOST_FOREACH(EventHandlerPtr handler, handlers)
+    {
+        HandlerProfilePtr profile = cachedHandlerProfile(typeId, handler);
+
+        boost::int64_t start = now();
+        handler->call(event);
+        profile->cost.record(now() - start);
+    }
+}
+
+void EventProfiler::recordHandler(Event::EventTypeId typeId,
+                                  EventHandlerPtr handler,
+                                  boost::int64_t duration)
+{
+    cachedHandlerProfile(typeId, handler)->cost.record(duration);
+}
+
+void EventProfiler::recordPublish(Event::EventTypeId typeId,
+                                  boost::int64_t start)
+{
+    boost::int64_t duration = now() - start;
+    cachedTypeProfile(typeId)->publishTime.record(duration);
+}
+
+void EventProfiler::recordHubPublish(Event::EventTypeId typeId,
+                                     boost::int64_t start)
+{
+    boost::int64_t duration = now() - start;
+    cachedTypeProfile(typeId)->hubTime.record(duration);
+}
+
+void EventProfiler::recordDequeued(Event::EventTypeId typeId,
+                                   boost::int64_t queueTime)
+{
+    boost::int64_t duration = now() - queueTime;
+    cachedTypeProfile(typeId)->queueTime.record(duration);
+}
+
+EventTypeProfilePtr EventProfiler::getTypeProfile(Event::EventTypeId typeId)
+{
+    EventTypeProfileList& list = profiles();
+    if (typeId >= list.size())
+        list.resize(typeId + 1);
+
+    EventTypeProfilePtr& profile = list[typeId];
+    if (!profile)
+    {
+        profile = EventTypeProfilePtr(new EventTypeProfile());
+        profile->type = EventTypeRegistry::getName(typeId);
+    }
+    return profile;
+}
+
+EventTypeProfilePtr EventProfiler::cachedTypeProfile(Event::EventTypeId typeId)
+{
+    ProfileCache& cache = profileCache();
+    if (typeId >= cache.types.size())
+        cache.types.resize(typeId + 1);
+
+    EventTypeProfilePtr& profile = cache.types[typeId];
+    if (!profile)
+    {
+        boost::mutex::scoped_lock lock(profileMutex());
+        profile = getTypeProfile(typeId);
+    }
+    return profile;
+}
+
+HandlerProfilePtr EventProfiler::cachedHandlerProfile(
+    Event::EventTypeId typeId,
+    EventHandlerPtr handler)
+{
+    ProfileCache& cache = profileCache();
+    HandlerProfilePtr& profile =
+        cache.handlers[std::make_pair(typeId, handler->getId())];
+    if (!profile)
+    {
+        boost::mutex::scoped_lock lock(profileMutex());
+        profile = getHandlerProfile(getTypeProfile(typeId), handler);
+    }
+    return profile;
+}
+
+} // namespace core
+} // namespace ram
@@ -11,11 +11,13 @@
 #include "core/include/EventPublisher.h"
 #include "core/include/EventPublisherBase.h"
 #include "core/include/EventPublisherRegistry.h"
+#include "core/include/EventTypeRegistry.h"
+#include "core/include/Instrumentation.h"
 
 namespace ram {
 namespace core {
 
-typedef EventPublisherBaseTemplate<Event::EventType> EventPublisherType;
+typedef EventPublisherBaseTemplate<Event::EventTypeId> EventPublisherType;
     
 static EventPublisherType*
 asType(EventPublisherBasePtr basePtr)
@@ -28,7 +30,7 @@ asType(EventPublisherBasePtr basePtr)
 }
     
 EventPublisher::EventPublisher(EventHubPtr eventHub, std::string name) :
-    m_imp(new EventPublisherBaseTemplate<Event::EventType>(eventHub, name))
+    m_imp(new EventPublisherType(eventHub, name))
 {
     if (name != "UNNAMED")
         EventPublisherRegistry::registerPublisher(this);
@@ -44,12 +46,29 @@ EventConnectionPtr EventPublisher::subscribe(
     Event::EventType type,
     boost::function<void (EventPtr)> handler)
 {
-    return asType(m_imp)->subscribe(type, handler);
+    return asType(m_imp)->subscribe(type.getId(), handler);
 }
 
 void EventPublisher::publish(Event::EventType type, EventPtr event)
 {
-    asType(m_imp)->publish(type, type, this, event);
+    Event::EventTypeId typeId = type.getId();
+    if (Instrumentation::active())
+    {
+        boost::int64_t start = EventProfiler::now();
+        if (Tracer::active())
+            Tracer::startTrace(event);
+
+        asType(m_imp)->publish(typeId, type, this, event);
+
+        if (EventProfiler::active())
+            EventProfiler::recordPublish(typeId, start);
+        if (Tracer::active())
+            Tracer::recordPublish(event, start);
+    }
+    else
+    {
+        asType(m_imp)->publish(typeId, type, this, event);
+    }
 }
 
 std::string EventPublisher::getPublisherName()
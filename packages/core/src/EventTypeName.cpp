@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/EventTypeName.cpp
+ */
+
+// Project Includes
+#include "core/include/EventTypeName.h"
+
+namespace ram {
+namespace core {
+
+// Every Event starts with an empty type, so it is only interned if asked for
+EventTypeName::EventTypeName() :
+    m_id(EventTypeRegistry::INVALID_TYPE_ID)
+{
+}
+
+EventTypeName::EventTypeName(const std::string& name) :
+    std::string(name),
+    m_id(EventTypeRegistry::intern(name))
+{
+}
+
+EventTypeName::EventTypeName(const char* name) :
+    std::string(name),
+    m_id(EventTypeRegistry::intern(*this))
+{
+}
+
+EventTypeName& EventTypeName::operator=(const std::string& name)
+{
+    std::string::operator=(name);
+    m_id = EventTypeRegistry::intern(name);
+    return *this;
+}
+
+EventTypeName& EventTypeName::operator=(const char* name)
+{
+    std::string::operator=(name);
+    m_id = EventTypeRegistry::intern(*this);
+    return *this;
+}
+
+} // namespace core
+} // namespace ram
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/EventTypeRegistry.cpp
+ */
+
+// STD Includes
+#include <vector>
+
+// Project Includes
+#include "core/include/EventTypeRegistry.h"
+
+// Starting size of the hash table, must be a power of two
+static const size_t INITIAL_BUCKET_COUNT = 512;
+
+namespace ram {
+namespace core {
+
+const EventTypeRegistry::TypeId EventTypeRegistry::INVALID_TYPE_ID =
+    (EventTypeRegistry::TypeId)-1;
+
+/** Open addressing hash table from type name to id
+ *
+ *  The names are stored in id order, so the name lookup is a simple index.
+ *  The table is kept at most half full so probe sequences stay short.
+ */
+struct EventTypeRegistry::Table
+{
+    Table() : buckets(INITIAL_BUCKET_COUNT, INVALID_TYPE_ID) {}
+
+    /** Type names, indexed by id */
+    std::vector<std::string> names;
+
+    /** Hash of each name, indexed by id (avoids rehashing on growth) */
+    std::vector<size_t> hashes;
+
+    /** The hash table itself, holds the ids of the types */
+    std::vector<TypeId> buckets;
+};
+
+/** FNV-1a hash of the type name */
+static size_t hashName(const std::string& name)
+{
+    size_t hash = 2166136261u;
+    for (size_t i = 0; i < name.size(); ++i)
+    {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/** Places the given id into the first free bucket for its hash */
+static void insertBucket(std::vector<EventTypeRegistry::TypeId>& buckets,
+                         size_t hash, EventTypeRegistry::TypeId id)
+{
+    size_t mask = buckets.size() - 1;
+    size_t index = hash & mask;
+    while (EventTypeRegistry::INVALID_TYPE_ID != buckets[index])
+        index = (index + 1) & mask;
+    buckets[index] = id;
+}
+
+EventTypeRegistry::TypeId EventTypeRegistry::intern(const std::string& name)
+{
+    size_t hash = hashName(name);
+
+    // Almost every call is for an already registered type
+    {
+        ReadWriteMutex::ScopedReadLock lock(*getRegistryMutex());
+        TypeId id = find(getTable(), name, hash);
+        if (INVALID_TYPE_ID != id)
+            return id;
+    }
+
+    ReadWriteMutex::ScopedWriteLock lock(*getRegistryMutex());
+    Table* table = getTable();
+
+    // Somebody could have registered it while we waited for the lock
+    TypeId id = find(table, name, hash);
+    if (INVALID_TYPE_ID != id)
+        return id;
+
+    id = table->names.size();
+    table->names.push_back(name);
+    table->hashes.push_back(hash);
+
+    // Grow the table when it becomes half full
+    if ((table->names.size() * 2) > table->buckets.size())
+    {
+        std::vector<TypeId> buckets(table->buckets.size() * 2,
+                                    INVALID_TYPE_ID);
+        for (TypeId i = 0; i < id; ++i)
+            insertBucket(buckets, table->hashes[i], i);
+        table->buckets.swap(buckets);
+    }
+    insertBucket(table->buckets, hash, id);
+
+    return id;
+}
+
+EventTypeRegistry::TypeId EventTypeRegistry::lookup(const std::string& name)
+{
+    ReadWriteMutex::ScopedReadLock lock(*getRegistryMutex());
+    return find(getTable(), name, hashName(name));
+}
+
+std::string EventTypeRegistry::getName(TypeId id)
+{
+    ReadWriteMutex::ScopedReadLock lock(*getRegistryMutex());
+    Table* table = getTable();
+    if (id < table->names.size())
+        return table->names[id];
+    else
+        return std::string();
+}
+
+size_t EventTypeRegistry::getTypeCount()
+{
+    ReadWriteMutex::ScopedReadLock lock(*getRegistryMutex());
+    return getTable()->names.size();
+}
+
+EventTypeRegistry::TypeId EventTypeRegistry::find(Table* table,
+                                                  const std::string& name,
+                                                  size_t hash)
+{
+    size_t mask = table->buckets.size() - 1;
+    size_t index = hash & mask;
+
+    // Walk the probe sequence until we hit an empty bucket
+    TypeId id = table->buckets[index];
+    while (INVALID_TYPE_ID != id)
+    {
+        if ((table->hashes[id] == hash) && (table->names[id] == name))
+            return id;
+        index = (index + 1) & mask;
+        id = table->buckets[index];
+    }
+
+    return INVALID_TYPE_ID;
+}
+
+ReadWriteMutex* EventTypeRegistry::getRegistryMutex()
+{
+    static ReadWriteMutex mutex;
+    return &mutex;
+}
+
+EventTypeRegistry::Table* EventTypeRegistry::getTable()
+{
+    static Table table;
+    return &table;
+}
+
+} // namespace core
+} // namespace ram
@@ -22,6 +22,8 @@ static ram::core::SpecificEventConverter<ram::core::StringEvent>
 RAM_CORE_STRINGEVENT;
 static ram::core::SpecificEventConverter<ram::core::IntEvent>
 RAM_CORE_INTEVENT;
+static ram::core::SpecificEventConverter<ram::core::MetricsEvent>
+RAM_CORE_METRICSEVENT;
    
 #endif // RAM_WITH_WRAPPERS
 
@@ -36,5 +38,14 @@ EventPtr StringEvent::clone()
     return event;
 }
 
+EventPtr MetricsEvent::clone()
+{
+    MetricsEventPtr event = MetricsEventPtr(new MetricsEvent());
+    copyInto(event);
+    event->names = names;
+    event->values = values;
+    return event;
+}
+
 } // namespace core
 } // namespace ram
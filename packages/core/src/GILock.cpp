@@ -51,5 +51,35 @@ ScopedGILock::~ScopedGILock()
     m_lock.unlock();
 }
 
+// Only the thread holding the GIL can give it up
+static bool holdsGIL()
+{
+#if PY_VERSION_HEX >= 0x03040000
+    return 1 == PyGILState_Check();
+#else
+    PyThreadState* state = PyGILState_GetThisThreadState();
+    return state && (state == _PyThreadState_Current);
+#endif
+}
+
+ScopedGILRelease::ScopedGILRelease() :
+    m_state(0)
+{
+    if (Py_IsInitialized() && holdsGIL())
+    {
+#if PY_VERSION_HEX < 0x03070000
+        // Creates the GIL if needed, owned by this thread
+        PyEval_InitThreads();
+#endif
+        m_state = PyEval_SaveThread();
+    }
+}
+
+ScopedGILRelease::~ScopedGILRelease()
+{
+    if (m_state)
+        PyEval_RestoreThread(m_state);
+}
+
 } // namespace core
 } // namespace ram
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/Histogram.cpp
+ */
+
+// STD Includes
+#include <algorithm>
+#include <cmath>
+
+// Project Includes
+#include "core/include/Histogram.h"
+
+namespace ram {
+namespace core {
+
+/** Buckets in each power of two above the linear range */
+static const boost::int64_t HALF_BUCKETS = 1 << (Histogram::SUB_BUCKET_BITS - 1);
+
+/** The largest value which gets its own bucket */
+static const boost::int64_t HIGHEST_TRACKABLE =
+    (((boost::int64_t)1) << Histogram::HIGHEST_BIT) - 1;
+
+Histogram::Histogram() :
+    m_counts(bucketIndex(HIGHEST_TRACKABLE) + 1, 0),
+    m_count(0),
+    m_total(0),
+    m_min(0),
+    m_max(0)
+{
+}
+
+void Histogram::record(boost::int64_t value)
+{
+    if (value < 0)
+        value = 0;
+    size_t index = bucketIndex(std::min(value, HIGHEST_TRACKABLE));
+
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_counts[index]++;
+    if ((0 == m_count) || (value < m_min))
+        m_min = value;
+    if (value > m_max)
+        m_max = value;
+    m_count++;
+    m_total += value;
+}
+
+void Histogram::reset()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_count = 0;
+    m_total = 0;
+    m_min = 0;
+    m_max = 0;
+}
+
+void Histogram::merge(const Histogram& other)
+{
+    if (&other == this)
+        return;
+
+    // Copy first, so we never hold both locks
+    std::vector<boost::int64_t> counts;
+    boost::int64_t count, total, min, max;
+    {
+        boost::mutex::scoped_lock lock(other.m_mutex);
+        counts = other.m_counts;
+        count = other.m_count;
+        total = other.m_total;
+        min = other.m_min;
+        max = other.m_max;
+    }
+
+    if (0 == count)
+        return;
+
+    boost::mutex::scoped_lock lock(m_mutex);
+    for (size_t i = 0; i < m_counts.size(); ++i)
+        m_counts[i] += counts[i];
+    if ((0 == m_count) || (min < m_min))
+        m_min = min;
+    if (max > m_max)
+        m_max = max;
+    m_count += count;
+    m_total += total;
+}
+
+boost::int64_t Histogram::getCount() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_count;
+}
+
+boost::int64_t Histogram::getMin() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_min;
+}
+
+boost::int64_t Histogram::getMax() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_max;
+}
+
+double Histogram::getMean() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    if (0 == m_count)
+        return 0;
+    return (double)m_total / m_count;
+}
+
+boost::int64_t Histogram::getValueAtPercentile(double percentile) const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    if (0 == m_count)
+        return 0;
+
+    // The rank of the value we want, the first value is rank one.  The small
+    // fudge keeps rounding error from pushing us up a rank.
+    percentile = std::max(0.0, std::min(100.0, percentile));
+    boost::int64_t rank =
+        (boost::int64_t)ceil(percentile / 100.0 * m_count - 1e-9);
+    rank = std::max(rank, (boost::int64_t)1);
+
+    // The last bucket holds everything too large to track, use the max
+    boost::int64_t seen = 0;
+    for (size_t i = 0; i < (m_counts.size() - 1); ++i)
+    {
+        seen += m_counts[i];
+        if (seen >= rank)
+            return std::min(highestValue(i), m_max);
+    }
+    return m_max;
+}
+
+size_t Histogram::bucketIndex(boost::int64_t value)
+{
+    // Small values are counted exactly
+    if (value < (2 * HALF_BUCKETS))
+        return (size_t)value;
+
+    // Keep the top SUB_BUCKET_BITS bits of the value
+    int shift = 0;
+    while ((value >> shift) >= (2 * HALF_BUCKETS))
+        shift++;
+    return (size_t)(shift * HALF_BUCKETS + (value >> shift));
+}
+
+boost::int64_t Histogram::highestValue(size_t index)
+{
+    if ((boost::int64_t)index < (2 * HALF_BUCKETS))
+        return (boost::int64_t)index;
+
+    // Undo bucketIndex
+    int shift = (int)(index / HALF_BUCKETS) - 1;
+    boost::int64_t top = (boost::int64_t)(index % HALF_BUCKETS) + HALF_BUCKETS;
+    return ((top + 1) << shift) - 1;
+}
+
+} // namespace core
+} // namespace ram
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/Instrumentation.cpp
+ */
+
+// STD Includes
+#include <cassert>
+
+// Project Includes
+#include "core/include/Instrumentation.h"
+
+namespace ram {
+namespace core {
+
+const AtomicWord Instrumentation::PROFILER;
+const AtomicWord Instrumentation::TRACER;
+
+volatile AtomicWord Instrumentation::s_active = 0;
+
+void Instrumentation::add(AtomicWord instrument)
+{
+    assert(((PROFILER == instrument) || (TRACER == instrument)) &&
+           "Invalid instrument");
+    atomic::add(&s_active, instrument);
+}
+
+void Instrumentation::remove(AtomicWord instrument)
+{
+    assert(((PROFILER == instrument) || (TRACER == instrument)) &&
+           "Invalid instrument");
+    atomic::add(&s_active, -instrument);
+}
+
+} // namespace core
+} // namespace ram
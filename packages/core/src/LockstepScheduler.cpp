@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/LockstepScheduler.cpp
+ */
+
+// Library Includes
+#include <boost/bind.hpp>
+#include <boost/thread/xtime.hpp>
+
+// Project Includes
+#include "core/include/LockstepScheduler.h"
+#include "core/include/Updatable.h"
+#include "core/include/Clock.h"
+#include "core/include/ThreadedQueue.h"
+
+namespace ram {
+namespace core {
+
+typedef boost::int64_t Usec;
+
+/** The scheduling state of a single Updatable */
+struct LockstepScheduler::Task
+{
+    Task(Updatable* updatable_, size_t sequence_) :
+        updatable(updatable_),
+        interval(0),
+        sequence(sequence_),
+        generation(0),
+        running(false),
+        removed(false)
+    {}
+
+    Updatable* updatable;
+
+    /** Milliseconds between updates */
+    int interval;
+
+    /** Order the task was first scheduled in */
+    size_t sequence;
+
+    /** Bumped when the task is queued, so stale heap entries are ignored */
+    size_t generation;
+
+    /** True while the driver is calling update */
+    bool running;
+
+    /** Set by unschedule(), the task is not requeued */
+    bool removed;
+};
+
+LockstepScheduler::Entry::Entry(Usec deadline_, size_t generation_,
+                                TaskPtr task_) :
+    deadline(deadline_),
+    generation(generation_),
+    task(task_)
+{
+}
+
+bool LockstepScheduler::Entry::operator>(const Entry& other) const
+{
+    if (deadline != other.deadline)
+        return deadline > other.deadline;
+    return task->sequence > other.task->sequence;
+}
+
+LockstepScheduler::LockstepScheduler() :
+    m_stop(false),
+    m_driver(0),
+    m_nextSequence(0),
+    m_updateCount(0),
+    m_settleTimeout(0.1)
+{
+}
+
+LockstepScheduler::~LockstepScheduler()
+{
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_stop = true;
+        m_workAvailable.notify_all();
+    }
+
+    if (m_driver)
+    {
+        m_driver->join();
+        delete m_driver;
+    }
+}
+
+LockstepScheduler* LockstepScheduler::getInstance()
+{
+    // Never destroyed, like the UpdatableScheduler instance
+    static LockstepScheduler* scheduler = new LockstepScheduler();
+    return scheduler;
+}
+
+void LockstepScheduler::schedule(Updatable* updatable, int interval)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    TaskPtr& task = m_tasks[updatable];
+    if (!task)
+        task = TaskPtr(new Task(updatable, m_nextSequence++));
+
+    task->interval = interval;
+    task->removed = false;
+
+    // A running task is requeued once its update is done
+    if (!task->running)
+        queueTask(task, Clock::monotonicUsec() + (Usec)interval * 1000);
+
+    if (!m_driver)
+    {
+        m_driver = new boost::thread(
+            boost::bind(&LockstepScheduler::driverLoop, this));
+    }
+}
+
+void LockstepScheduler::unschedule(Updatable* updatable, bool join)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    TaskMap::iterator iter = m_tasks.find(updatable);
+    if (m_tasks.end() == iter)
+        return;
+
+    // Keep the task alive, the driver could be using it
+    TaskPtr task = iter->second;
+    task->removed = true;
+    task->generation++;
+
+    bool onDriver = m_driver &&
+        (m_driver->get_id() == boost::this_thread::get_id());
+    if (join && !onDriver)
+    {
+        while (task->running)
+            m_updateFinished.wait(lock);
+    }
+
+    // A running task is removed by the driver when its update is done
+    if (!task->running)
+        m_tasks.erase(updatable);
+}
+
+bool LockstepScheduler::scheduled(Updatable* updatable)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    TaskMap::iterator iter = m_tasks.find(updatable);
+    return (m_tasks.end() != iter) && !iter->second->removed;
+}
+
+size_t LockstepScheduler::getUpdateCount()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_updateCount;
+}
+
+void LockstepScheduler::setSettleTimeout(double seconds)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_settleTimeout = seconds;
+}
+
+void LockstepScheduler::queueTask(TaskPtr task, Usec deadline)
+{
+    task->generation++;
+    m_heap.push(Entry(deadline, task->generation, task));
+    m_workAvailable.notify_one();
+}
+
+void LockstepScheduler::driverLoop()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    while (!m_stop)
+    {
+        // Throw away entries for removed or requeued tasks
+        while (!m_heap.empty() &&
+               ((m_heap.top().generation != m_heap.top().task->generation) ||
+                m_heap.top().task->removed))
+        {
+            m_heap.pop();
+        }
+
+        Usec nextUpdate = m_heap.empty() ? -1 : m_heap.top().deadline;
+        Usec nextWakeup = Clock::getNextWakeup();
+        double settleTimeout = m_settleTimeout;
+
+        // Nothing to do until something is scheduled or a thread sleeps, the
+        // sleepers don't tell us so check back often
+        if ((-1 == nextUpdate) && (-1 == nextWakeup))
+        {
+            boost::xtime timeout = {0, 10000000}; // 10 milliseconds
+            boost::xtime now;
+            boost::xtime_get(&now, boost::TIME_UTC);
+            m_workAvailable.timed_wait(lock, details::add_xtime(now, timeout));
+            continue;
+        }
+
+        // Sleepers go before updates at the same time
+        if ((-1 != nextWakeup) &&
+            ((-1 == nextUpdate) || (nextWakeup <= nextUpdate)))
+        {
+            lock.unlock();
+            Clock::advanceTo(nextWakeup);
+            Clock::waitForSleepers(settleTimeout);
+            lock.lock();
+            continue;
+        }
+
+        Entry entry = m_heap.top();
+        m_heap.pop();
+        TaskPtr task = entry.task;
+        task->running = true;
+        int interval = task->interval;
+
+        lock.unlock();
+        Clock::advanceTo(entry.deadline);
+        task->updatable->scheduledUpdate(interval / 1000.0, 0);
+        lock.lock();
+
+        task->running = false;
+        m_updateCount++;
+        m_updateFinished.notify_all();
+
+        if (task->removed)
+        {
+            TaskMap::iterator iter = m_tasks.find(task->updatable);
+            if ((m_tasks.end() != iter) && (iter->second == task))
+                m_tasks.erase(iter);
+            continue;
+        }
+
+        queueTask(task, entry.deadline + (Usec)task->interval * 1000);
+    }
+}
+
+} // namespace core
+} // namespace ram
@@ -32,8 +32,11 @@
 
 // Project Includes
 #include "core/include/Logging.h"
+#include "core/include/BinaryLogger.h"
 #include "core/include/ThreadedAppender.h"
+#include "core/include/BatchFileAppender.h"
 #include "core/include/SubsystemMaker.h"
+#include "core/include/QueueFactory.h"
 
 // Register controller in subsystem maker system
 RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::core::Logging, Logging);
@@ -177,6 +180,9 @@ void Logging::init(ConfigNode config)
                            appenders);
         }
     }
+
+    // Binary loggers follow the priorities of their categories
+    BinaryLogger::updatePriorities();
 }
     
 void Logging::createCategory(
@@ -244,8 +250,10 @@ log4cpp::Appender* Logging::createAppender(
         std::string fileName = config["fileName"].asString(name);
         std::string filePath = (getLogDir() / fileName).string();
         
-        // Create the appender which logs to the given file
-        appender = new log4cpp::FileAppender(name, filePath, false);
+        // Create the appender which logs to the given file, writing
+        // batches of messages at most every flushInterval milliseconds
+        double flushInterval = config["flushInterval"].asDouble(0) / 1000.0;
+        appender = new BatchFileAppender(name, filePath, flushInterval);
     }
     else
     {
@@ -254,8 +262,12 @@ log4cpp::Appender* Logging::createAppender(
     
     if (appender)
     {
-        // Wrap in a background threaded container
-        appender = new ThreadedAppender(appender);
+        // Wrap in a background threaded container, with the default
+        // bounded queue unless one is configured
+        IQueue<LoggingEvent>* queue = 0;
+        if (config.exists("queue"))
+            queue = makeQueue<LoggingEvent>(config["queue"]);
+        appender = new ThreadedAppender(appender, queue);
         
         // Set layout (using default if needed)
         log4cpp::Layout* layout = 0;
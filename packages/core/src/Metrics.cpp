@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/Metrics.cpp
+ */
+
+// STD Includes
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__GNUC__)
+#  include <cxxabi.h>
+#endif
+
+// Library Includes
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+// Project Includes
+#include "core/include/Metrics.h"
+
+namespace ram {
+namespace core {
+
+// ------------------------------------------------------------------------- //
+//                               C O U N T E R                               //
+// ------------------------------------------------------------------------- //
+
+static AtomicCounter s_nextShard;
+
+/** Never destroyed, threads can still count after the statics are gone */
+static boost::thread_specific_ptr<int>& shardSlot()
+{
+    static boost::thread_specific_ptr<int>* slot =
+        new boost::thread_specific_ptr<int>();
+    return *slot;
+}
+
+/** The shard of the calling thread, threads are dealt out round robin */
+static int threadShard()
+{
+    int* shard = shardSlot().get();
+    if (!shard)
+    {
+        shard = new int((int)(s_nextShard.increment() % Counter::SHARDS));
+        shardSlot().reset(shard);
+    }
+    return *shard;
+}
+
+Counter::Counter() :
+    m_shards((Shard*)(((size_t)m_storage + CACHE_LINE - 1) &
+                      ~(size_t)(CACHE_LINE - 1)))
+{
+    memset((void*)m_shards, 0, sizeof(Shard) * SHARDS);
+}
+
+void Counter::increment(AtomicWord amount)
+{
+    atomic::add(&m_shards[threadShard()].value, amount);
+}
+
+AtomicWord Counter::get() const
+{
+    AtomicWord total = 0;
+    for (int i = 0; i < SHARDS; ++i)
+        total += atomic::load(&m_shards[i].value);
+    return total;
+}
+
+// ------------------------------------------------------------------------- //
+//                                 G A U G E                                 //
+// ------------------------------------------------------------------------- //
+
+Gauge::Gauge() :
+    m_sequence(0),
+    m_value(0)
+{
+}
+
+Gauge::Gauge(SampleFunction sample) :
+    m_sequence(0),
+    m_value(0),
+    m_sample(sample)
+{
+}
+
+void Gauge::set(double value)
+{
+    // A double can't be stored atomically everywhere, so readers check the
+    // sequence didn't change while they read
+    atomic::add(&m_sequence, 1);
+    m_value = value;
+    atomic::add(&m_sequence, 1);
+}
+
+double Gauge::get() const
+{
+    if (m_sample)
+        return m_sample();
+
+    while (true)
+    {
+        AtomicWord before = atomic::load(&m_sequence);
+        double value = m_value;
+        atomic::acquireReleaseBarrier();
+        if (!(before & 1) && (before == atomic::load(&m_sequence)))
+            return value;
+    }
+}
+
+// ------------------------------------------------------------------------- //
+//                              R E G I S T R Y                              //
+// ------------------------------------------------------------------------- //
+
+/** All the metrics, by full name */
+struct MetricsState
+{
+    boost::mutex mutex;
+    std::map<std::string, CounterPtr> counters;
+    std::map<std::string, GaugePtr> gauges;
+    std::map<std::string, HistogramPtr> histograms;
+};
+
+/** Never destroyed, like the shard slot */
+static MetricsState& metricsState()
+{
+    static MetricsState* state = new MetricsState();
+    return *state;
+}
+
+static std::string fullName(const std::string& owner, const std::string& name)
+{
+    return owner + "." + name;
+}
+
+/** Finds the metric, creating it if needed */
+template <typename T>
+static boost::shared_ptr<T> findOrCreate(
+    std::map<std::string, boost::shared_ptr<T> >& metrics,
+    const std::string& name)
+{
+    boost::shared_ptr<T>& metric = metrics[name];
+    if (!metric)
+        metric = boost::shared_ptr<T>(new T());
+    return metric;
+}
+
+/** Removes the metrics only the registry holds on to */
+template <typename T>
+static void removeUnused(std::map<std::string, boost::shared_ptr<T> >& metrics)
+{
+    typename std::map<std::string, boost::shared_ptr<T> >::iterator iter =
+        metrics.begin();
+    while (metrics.end() != iter)
+    {
+        if (iter->second.unique())
+            metrics.erase(iter++);
+        else
+            ++iter;
+    }
+}
+
+CounterPtr MetricsRegistry::counter(const std::string& owner,
+                                    const std::string& name)
+{
+    MetricsState& state = metricsState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    return findOrCreate(state.counters, fullName(owner, name));
+}
+
+GaugePtr MetricsRegistry::gauge(const std::string& owner,
+                                const std::string& name)
+{
+    MetricsState& state = metricsState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    return findOrCreate(state.gauges, fullName(owner, name));
+}
+
+GaugePtr MetricsRegistry::gauge(const std::string& owner,
+                                const std::string& name,
+                                Gauge::SampleFunction sample)
+{
+    GaugePtr gauge(new Gauge(sample));
+
+    MetricsState& state = metricsState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    state.gauges[fullName(owner, name)] = gauge;
+    return gauge;
+}
+
+HistogramPtr MetricsRegistry::histogram(const std::string& owner,
+                                        const std::string& name)
+{
+    MetricsState& state = metricsState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    return findOrCreate(state.histograms, fullName(owner, name));
+}
+
+MetricsSnapshot MetricsRegistry::snapshot()
+{
+    MetricsSnapshot snapshot;
+
+    MetricsState& state = metricsState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    removeUnused(state.counters);
+    removeUnused(state.gauges);
+    removeUnused(state.histograms);
+
+    typedef std::map<std::string, CounterPtr>::iterator CounterIter;
+    for (CounterIter iter = state.counters.begin();
+         iter != state.counters.end(); ++iter)
+    {
+        snapshot.counters[iter->first] = iter->second->get();
+    }
+
+    typedef std::map<std::string, GaugePtr>::iterator GaugeIter;
+    for (GaugeIter iter = state.gauges.begin();
+         iter != state.gauges.end(); ++iter)
+    {
+        snapshot.gauges[iter->first] = iter->second->get();
+    }
+
+    typedef std::map<std::string, HistogramPtr>::iterator HistogramIter;
+    for (HistogramIter iter = state.histograms.begin();
+         iter != state.histograms.end(); ++iter)
+    {
+        HistogramPtr copy(new Histogram());
+        copy->merge(*iter->second);
+        snapshot.histograms[iter->first] = copy;
+    }
+
+    return snapshot;
+}
+
+std::string MetricsRegistry::typeName(const std::type_info& type)
+{
+    std::string name(type.name());
+#if defined(__GNUC__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name.c_str(), 0, 0, &status);
+    if (demangled)
+    {
+        name = demangled;
+        free(demangled);
+    }
+#endif
+
+    // Drop the namespaces
+    std::string::size_type colon = name.rfind("::");
+    if (std::string::npos != colon)
+        name = name.substr(colon + 2);
+    return name;
+}
+
+} // namespace core
+} // namespace ram
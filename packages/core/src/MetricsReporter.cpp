@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/MetricsReporter.cpp
+ */
+
+// STD Includes
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+// Project Includes
+#include "core/include/MetricsReporter.h"
+#include "core/include/SubsystemMaker.h"
+#include "core/include/Logging.h"
+#include "core/include/Clock.h"
+#include "core/include/TimeVal.h"
+
+// Register into the maker subsystem
+RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::core::MetricsReporter, MetricsReporter);
+
+RAM_CORE_EVENT_TYPE(ram::core::MetricsReporter, METRICS);
+
+namespace ram {
+namespace core {
+
+MetricsReporter::MetricsReporter(ConfigNode config, SubsystemList deps) :
+    Subsystem(config["name"].asString("MetricsReporter"), deps),
+    Updatable(this),
+    m_reportInterval(config["reportInterval"].asDouble(5)),
+    m_publish(0 != config["publish"].asInt(0)),
+    m_lastReport(Clock::monotonicUsec())
+{
+    std::string fileName = config["fileName"].asString("metrics.txt");
+    if (!fileName.empty())
+        m_filePath = (Logging::getLogDir() / fileName).string();
+}
+
+MetricsReporter::~MetricsReporter()
+{
+    unbackground(true);
+}
+
+std::string MetricsReporter::createReport(const MetricsSnapshot& snapshot)
+{
+    std::stringstream out;
+
+    typedef std::map<std::string, AtomicWord>::const_iterator CounterIter;
+    for (CounterIter iter = snapshot.counters.begin();
+         iter != snapshot.counters.end(); ++iter)
+    {
+        out << "counter " << iter->first << " " << iter->second << std::endl;
+    }
+
+    typedef std::map<std::string, double>::const_iterator GaugeIter;
+    for (GaugeIter iter = snapshot.gauges.begin();
+         iter != snapshot.gauges.end(); ++iter)
+    {
+        out << "gauge " << iter->first << " " << iter->second << std::endl;
+    }
+
+    typedef std::map<std::string, HistogramPtr>::const_iterator HistogramIter;
+    for (HistogramIter iter = snapshot.histograms.begin();
+         iter != snapshot.histograms.end(); ++iter)
+    {
+        const Histogram& histogram = *iter->second;
+        out << "histogram " << iter->first << " " << histogram.getCount()
+            << " " << histogram.getMean() << " "
+            << histogram.getValueAtPercentile(50) << " "
+            << histogram.getValueAtPercentile(99) << " "
+            << histogram.getMax() << std::endl;
+    }
+
+    return out.str();
+}
+
+MetricsEventPtr MetricsReporter::createEvent(const MetricsSnapshot& snapshot)
+{
+    MetricsEventPtr event(new MetricsEvent());
+
+    typedef std::map<std::string, AtomicWord>::const_iterator CounterIter;
+    for (CounterIter iter = snapshot.counters.begin();
+         iter != snapshot.counters.end(); ++iter)
+    {
+        event->names.push_back(iter->first);
+        event->values.push_back((double)iter->second);
+    }
+
+    typedef std::map<std::string, double>::const_iterator GaugeIter;
+    for (GaugeIter iter = snapshot.gauges.begin();
+         iter != snapshot.gauges.end(); ++iter)
+    {
+        event->names.push_back(iter->first);
+        event->values.push_back(iter->second);
+    }
+
+    typedef std::map<std::string, HistogramPtr>::const_iterator HistogramIter;
+    for (HistogramIter iter = snapshot.histograms.begin();
+         iter != snapshot.histograms.end(); ++iter)
+    {
+        const Histogram& histogram = *iter->second;
+        event->names.push_back(iter->first + ".count");
+        event->values.push_back((double)histogram.getCount());
+        event->names.push_back(iter->first + ".mean");
+        event->values.push_back(histogram.getMean());
+        event->names.push_back(iter->first + ".p99");
+        event->values.push_back((double)histogram.getValueAtPercentile(99));
+    }
+
+    return event;
+}
+
+void MetricsReporter::update(double)
+{
+    boost::int64_t now = Clock::monotonicUsec();
+    if ((now - m_lastReport) < (boost::int64_t)(m_reportInterval * 1e6))
+        return;
+    m_lastReport = now;
+
+    MetricsSnapshot snapshot = MetricsRegistry::snapshot();
+    if (!m_filePath.empty())
+    {
+        // Every snapshot is kept, each starts with the time it was taken
+        std::ofstream file(m_filePath.c_str(), std::ios::out | std::ios::app);
+        file << "# time " << std::fixed << std::setprecision(3)
+             << TimeVal::timeOfDay().get_double() << std::endl
+             << createReport(snapshot);
+    }
+
+    if (m_publish)
+        publish(METRICS, createEvent(snapshot));
+}
+
+void MetricsReporter::setPriority(IUpdatable::Priority priority)
+{
+    Updatable::setPriority(priority);
+}
+
+IUpdatable::Priority MetricsReporter::getPriority()
+{
+    return Updatable::getPriority();
+}
+
+void MetricsReporter::setAffinity(size_t affinity)
+{
+    Updatable::setAffinity(affinity);
+}
+
+int MetricsReporter::getAffinity()
+{
+    return Updatable::getAffinity();
+}
+
+void MetricsReporter::background(int interval)
+{
+    Updatable::background(interval);
+}
+
+void MetricsReporter::unbackground(bool join)
+{
+    Updatable::unbackground(join);
+}
+
+bool MetricsReporter::backgrounded()
+{
+    return Updatable::backgrounded();
+}
+
+} // namespace core
+} // namespace ram
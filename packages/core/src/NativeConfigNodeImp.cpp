@@ -0,0 +1,520 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/NativeConfigNodeImp.cpp
+ */
+
+// STD Includes
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+// Library Includes
+#include <boost/foreach.hpp>
+
+// Project Includes
+#include "core/include/NativeConfigNodeImp.h"
+#include "core/include/Exception.h"
+
+namespace ram {
+namespace core {
+
+static bool isContainer(ConfigType type)
+{
+    return (CONFIG_LIST == type) || (CONFIG_MAP == type);
+}
+
+/** Quotes the string the way python's repr() does */
+static std::string pythonQuote(const std::string& str)
+{
+    std::stringstream ss;
+    ss << "'";
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+        unsigned char c = str[i];
+        switch (c)
+        {
+            case '\\': ss << "\\\\"; break;
+            case '\'': ss << "\\'"; break;
+            case '\n': ss << "\\n"; break;
+            case '\r': ss << "\\r"; break;
+            case '\t': ss << "\\t"; break;
+            default:
+                if ((c < 0x20) || (c >= 0x7f))
+                {
+                    char hex[5];
+                    sprintf(hex, "\\x%02x", c);
+                    ss << hex;
+                }
+                else
+                {
+                    ss << c;
+                }
+        }
+    }
+    ss << "'";
+    return ss.str();
+}
+
+/** Quotes the string so YAML reads it back as a string */
+static std::string yamlQuote(const std::string& str)
+{
+    if (std::string::npos == str.find_first_of("\n\r\t\\"))
+    {
+        // Single quoted strings only need quotes doubled
+        std::string result("'");
+        for (size_t i = 0; i < str.size(); ++i)
+        {
+            result += str[i];
+            if ('\'' == str[i])
+                result += '\'';
+        }
+        return result + "'";
+    }
+
+    // Python's quoting is valid in a double quoted YAML string
+    std::string quoted(pythonQuote(str));
+    std::string result("\"");
+    for (size_t i = 1; i < quoted.size() - 1; ++i)
+    {
+        if (('\\' == quoted[i]) && ('\'' == quoted[i + 1]))
+            continue;
+        if ('"' == quoted[i])
+            result += '\\';
+        result += quoted[i];
+    }
+    return result + "\"";
+}
+
+/** Keys are written plain when that is safe */
+static std::string yamlKey(const std::string& key)
+{
+    bool plain = !key.empty() && !isdigit((unsigned char)key[0]);
+    for (size_t i = 0; plain && (i < key.size()); ++i)
+    {
+        char c = key[i];
+        plain = isalnum((unsigned char)c) || ('_' == c);
+    }
+    return plain ? key : yamlQuote(key);
+}
+
+/** A python float repr in a form YAML reads back as a float */
+static std::string yamlDouble(const std::string& repr)
+{
+    if ("inf" == repr)
+        return ".inf";
+    if ("-inf" == repr)
+        return "-.inf";
+    if ("nan" == repr)
+        return ".nan";
+
+    // YAML 1.1 needs a '.' in exponent form, python leaves it out
+    size_t exponent = repr.find('e');
+    if ((std::string::npos != exponent) &&
+        (std::string::npos == repr.find('.')))
+    {
+        return repr.substr(0, exponent) + ".0" + repr.substr(exponent);
+    }
+    return repr;
+}
+
+/** Children are always created by this class */
+static NativeConfigNodeImp* native(ConfigNodeImpPtr imp)
+{
+    return static_cast<NativeConfigNodeImp*>(imp.get());
+}
+
+NativeConfigNodeImp::NativeConfigNodeImp(ConfigSnapshotPtr snapshot,
+                                         boost::uint32_t node,
+                                         std::string debugPath) :
+    m_snapshot(snapshot),
+    m_node(node),
+    m_type(CONFIG_NONE),
+    m_debugPath(debugPath)
+{
+}
+
+NativeConfigNodeImp::NativeConfigNodeImp(ConfigSnapshotPtr snapshot,
+                                         ConfigType type,
+                                         std::string text,
+                                         std::string debugPath) :
+    m_snapshot(snapshot),
+    m_node(ConfigSnapshot::NO_NODE),
+    m_type(type),
+    m_text(text),
+    m_debugPath(debugPath)
+{
+}
+
+ConfigNodeImpPtr NativeConfigNodeImp::idx(int index)
+{
+    std::stringstream ss;
+    ss << m_debugPath << "[" << index << "]";
+
+    boost::uint32_t child = ConfigSnapshot::NO_NODE;
+    if ((CONFIG_LIST == getType()) && (index >= 0))
+        child = m_snapshot->getChild(m_node, index);
+
+    if (ConfigSnapshot::NO_NODE == child)
+    {
+        return ConfigNodeImpPtr(new NativeConfigNodeImp(
+            m_snapshot, CONFIG_NONE, "", ss.str()));
+    }
+    return ConfigNodeImpPtr(new NativeConfigNodeImp(m_snapshot, child,
+                                                    ss.str()));
+}
+
+ConfigNodeImpPtr NativeConfigNodeImp::map(std::string key)
+{
+    std::string debugPath(m_debugPath + "." + key);
+
+    if (CONFIG_MAP == getType())
+    {
+        // Values which have been set take the place of the originals
+        ConfigType type;
+        std::string text;
+        if (m_snapshot->getOverride(m_node, key, type, text))
+        {
+            return ConfigNodeImpPtr(new NativeConfigNodeImp(
+                m_snapshot, type, text, debugPath));
+        }
+
+        boost::uint32_t child = m_snapshot->findChild(m_node, key);
+        if (ConfigSnapshot::NO_NODE != child)
+        {
+            return ConfigNodeImpPtr(new NativeConfigNodeImp(
+                m_snapshot, child, debugPath));
+        }
+    }
+
+    // If we got here, we haven't found it
+    return ConfigNodeImpPtr(new NativeConfigNodeImp(
+        m_snapshot, CONFIG_NONE, "", debugPath));
+}
+
+std::string NativeConfigNodeImp::asString()
+{
+    ConfigType type = getType();
+    if (isContainer(type))
+        return toString();
+    if (CONFIG_NONE == type)
+        return "None";
+    if (ConfigSnapshot::NO_NODE == m_node)
+        return m_text;
+    return m_snapshot->getText(m_node);
+}
+
+std::string NativeConfigNodeImp::asString(const std::string& def)
+{
+    if (CONFIG_NONE == getType())
+        return def;
+    return asString();
+}
+
+double NativeConfigNodeImp::asDouble()
+{
+    ConfigType type = getType();
+    if (CONFIG_BOOL == type)
+        return ("True" == asString()) ? 1.0 : 0.0;
+    if ((CONFIG_INT != type) && (CONFIG_DOUBLE != type))
+        conversionError("asDouble");
+
+    // The repr has every digit, the text can be rounded
+    std::string text(m_text);
+    if (ConfigSnapshot::NO_NODE != m_node)
+        text = m_snapshot->getRepr(m_node);
+    return strtod(text.c_str(), 0);
+}
+
+double NativeConfigNodeImp::asDouble(const double def)
+{
+    ConfigType type = getType();
+    if ((CONFIG_BOOL != type) && (CONFIG_INT != type) &&
+        (CONFIG_DOUBLE != type))
+    {
+        return def;
+    }
+    return asDouble();
+}
+
+int NativeConfigNodeImp::asInt()
+{
+    ConfigType type = getType();
+    if (CONFIG_BOOL == type)
+        return ("True" == asString()) ? 1 : 0;
+    if (CONFIG_INT != type)
+        conversionError("asInt");
+    return (int)strtol(asString().c_str(), 0, 10);
+}
+
+int NativeConfigNodeImp::asInt(const int def)
+{
+    ConfigType type = getType();
+    if ((CONFIG_BOOL != type) && (CONFIG_INT != type))
+        return def;
+    return asInt();
+}
+
+NodeNameList NativeConfigNodeImp::subNodes()
+{
+    NodeNameList subnodes;
+    if (CONFIG_MAP != getType())
+        return subnodes;
+
+    BOOST_FOREACH(std::string nodeName, getKeys())
+    {
+        // Only include values that aren't our special "INCLUDE" and
+        // "INCLUDED_LOADED" values
+        if ((nodeName != "INCLUDE") && (nodeName != "INCLUDE_LOADED"))
+            subnodes.insert(nodeName);
+    }
+    return subnodes;
+}
+
+size_t NativeConfigNodeImp::size()
+{
+    switch (getType())
+    {
+        case CONFIG_MAP:
+            return getKeys().size();
+        case CONFIG_LIST:
+            return m_snapshot->getChildCount(m_node);
+        case CONFIG_STRING:
+            return asString().size();
+        default:
+            break;
+    }
+
+    std::stringstream ss;
+    ss << "ConfigNode \"" << m_debugPath << "\"(size) Error: has no length";
+    throw ConfigException(ss.str());
+}
+
+void NativeConfigNodeImp::set(std::string key, std::string str)
+{
+    if (CONFIG_MAP != getType())
+    {
+        std::stringstream ss;
+        ss << "ConfigNode (set string) at: " << m_debugPath << " with key: "
+           << key << " Error: not a map";
+        throw ConfigException(ss.str());
+    }
+    m_snapshot->setOverride(m_node, key, CONFIG_STRING, str);
+}
+
+void NativeConfigNodeImp::set(std::string key, int value)
+{
+    if (CONFIG_MAP != getType())
+    {
+        std::stringstream ss;
+        ss << "ConfigNode (set value) at: " << m_debugPath << " with key: "
+           << key << " Error: not a map";
+        throw ConfigException(ss.str());
+    }
+
+    std::stringstream ss;
+    ss << value;
+    m_snapshot->setOverride(m_node, key, CONFIG_INT, ss.str());
+}
+
+std::string NativeConfigNodeImp::toString()
+{
+    std::stringstream ss;
+    writePython(ss);
+    return ss.str();
+}
+
+void NativeConfigNodeImp::writeToFile(std::string fileName, bool silent)
+{
+    std::stringstream ss;
+    writeYaml(ss, 0);
+
+    // The root is not after a key, so drop the separator
+    std::string yaml(ss.str());
+    if (!yaml.empty() && (('\n' == yaml[0]) || (' ' == yaml[0])))
+        yaml.erase(0, 1);
+
+    std::ofstream file(fileName.c_str());
+    file << yaml;
+    file.close();
+    if (!file && !silent)
+        throw ConfigException("Error during write out to: " + fileName);
+}
+
+ConfigType NativeConfigNodeImp::getType()
+{
+    if (ConfigSnapshot::NO_NODE == m_node)
+        return m_type;
+    return m_snapshot->getType(m_node);
+}
+
+void NativeConfigNodeImp::writePython(std::ostream& out)
+{
+    switch (getType())
+    {
+        case CONFIG_NONE:
+            out << "None";
+            break;
+
+        case CONFIG_STRING:
+            out << pythonQuote(asString());
+            break;
+
+        case CONFIG_DOUBLE:
+            out << m_snapshot->getRepr(m_node);
+            break;
+
+        case CONFIG_LIST:
+        {
+            out << "[";
+            size_t count = m_snapshot->getChildCount(m_node);
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (i > 0)
+                    out << ", ";
+                native(idx(i))->writePython(out);
+            }
+            out << "]";
+        }
+        break;
+
+        case CONFIG_MAP:
+        {
+            out << "{";
+            bool first = true;
+            BOOST_FOREACH(std::string key, getKeys())
+            {
+                if (!first)
+                    out << ", ";
+                first = false;
+                out << pythonQuote(key) << ": ";
+                native(map(key))->writePython(out);
+            }
+            out << "}";
+        }
+        break;
+
+        default:
+            out << asString();
+    }
+}
+
+void NativeConfigNodeImp::writeYaml(std::ostream& out, int indent)
+{
+    std::string spaces(indent, ' ');
+
+    switch (getType())
+    {
+        case CONFIG_NONE:
+            out << " null\n";
+            break;
+
+        case CONFIG_BOOL:
+            out << (asInt() ? " true\n" : " false\n");
+            break;
+
+        case CONFIG_INT:
+            out << " " << asString() << "\n";
+            break;
+
+        case CONFIG_DOUBLE:
+            out << " " << yamlDouble(m_snapshot->getRepr(m_node)) << "\n";
+            break;
+
+        case CONFIG_STRING:
+            out << " " << yamlQuote(asString()) << "\n";
+            break;
+
+        case CONFIG_LIST:
+        {
+            size_t count = m_snapshot->getChildCount(m_node);
+            bool scalars = true;
+            for (size_t i = 0; scalars && (i < count); ++i)
+            {
+                scalars = !isContainer(m_snapshot->getType(
+                    m_snapshot->getChild(m_node, i)));
+            }
+
+            if (scalars)
+            {
+                // Flow style, like "[1, 2, 3]", with the line ending removed
+                out << " [";
+                for (size_t i = 0; i < count; ++i)
+                {
+                    std::stringstream element;
+                    native(idx(i))->writeYaml(element, 0);
+                    std::string text(element.str());
+                    out << (i > 0 ? ", " : "")
+                        << text.substr(1, text.size() - 2);
+                }
+                out << "]\n";
+            }
+            else
+            {
+                out << "\n";
+                for (size_t i = 0; i < count; ++i)
+                {
+                    out << spaces << "-";
+                    native(idx(i))->writeYaml(out, indent + 2);
+                }
+            }
+        }
+        break;
+
+        case CONFIG_MAP:
+        {
+            std::vector<std::string> keys(getKeys());
+            if (keys.empty())
+            {
+                out << " {}\n";
+                break;
+            }
+
+            out << "\n";
+            BOOST_FOREACH(std::string key, keys)
+            {
+                out << spaces << yamlKey(key) << ":";
+                native(map(key))->writeYaml(out, indent + 2);
+            }
+        }
+        break;
+    }
+}
+
+std::vector<std::string> NativeConfigNodeImp::getKeys()
+{
+    std::vector<std::string> keys;
+    size_t count = m_snapshot->getChildCount(m_node);
+    for (size_t i = 0; i < count; ++i)
+        keys.push_back(m_snapshot->getKey(m_node, i));
+
+    // Add the keys that were set but are not in the snapshot
+    std::vector<std::string> setKeys(m_snapshot->getOverrideKeys(m_node));
+    if (!setKeys.empty())
+    {
+        std::vector<std::string> merged;
+        std::sort(keys.begin(), keys.end());
+        std::set_union(keys.begin(), keys.end(), setKeys.begin(),
+                       setKeys.end(), std::back_inserter(merged));
+        keys.swap(merged);
+    }
+    return keys;
+}
+
+void NativeConfigNodeImp::conversionError(const std::string& method)
+{
+    std::stringstream ss;
+    ss << "ConfigNode \"" << m_debugPath << "\"(" << method << ") Error: "
+       << "can not convert " << toString();
+    throw ConfigException(ss.str());
+}
+
+} // namespace core
+} // namespace ram
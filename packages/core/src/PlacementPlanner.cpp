@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/PlacementPlanner.cpp
+ */
+
+// STD Includes
+#include <cassert>
+#include <map>
+#include <sstream>
+
+// Library Includes
+#include <boost/algorithm/string.hpp>
+
+// Project Includes
+#include "core/include/PlacementPlanner.h"
+
+namespace ram {
+namespace core {
+
+typedef std::vector<std::vector<int> > CoreList;
+
+static const char* priorityName(IUpdatable::Priority priority)
+{
+    switch (priority)
+    {
+        case IUpdatable::RT_HIGH_PRIORITY: return "rt_high";
+        case IUpdatable::RT_NORMAL_PRIORITY: return "rt_normal";
+        case IUpdatable::RT_LOW_PRIORITY: return "rt_low";
+        case IUpdatable::HIGH_PRIORITY: return "high";
+        case IUpdatable::NORMAL_PRIORITY: return "normal";
+        case IUpdatable::LOW_PRIORITY: return "low";
+    }
+    return "unknown";
+}
+
+/** The CPUs of the given cores, the first of each core before any sibling */
+static std::vector<int> spreadCpus(const CoreList& cores,
+                                   const std::vector<size_t>& chosen)
+{
+    std::vector<int> cpus;
+    for (size_t level = 0; ; ++level)
+    {
+        bool added = false;
+        for (size_t i = 0; i < chosen.size(); ++i)
+        {
+            const std::vector<int>& core = cores[chosen[i]];
+            if (level < core.size())
+            {
+                cpus.push_back(core[level]);
+                added = true;
+            }
+        }
+        if (!added)
+            break;
+    }
+    return cpus;
+}
+
+PlacementPlanner::PlacementPlanner(const CpuTopology& topology) :
+    m_topology(topology)
+{
+}
+
+PlacementPlanner::Hint PlacementPlanner::stringToHint(std::string str)
+{
+    boost::algorithm::to_lower(str);
+    if ("realtime" == str)
+        return REALTIME;
+    else if ("compute" == str)
+        return COMPUTE;
+    else if ("io" == str)
+        return IO;
+    else if ("background" == str)
+        return BACKGROUND;
+
+    assert(false && "Invalid placement hint");
+    return BACKGROUND;
+}
+
+std::string PlacementPlanner::hintToString(Hint hint)
+{
+    switch (hint)
+    {
+        case REALTIME: return "realtime";
+        case COMPUTE: return "compute";
+        case IO: return "io";
+        case BACKGROUND: return "background";
+    }
+    return "unknown";
+}
+
+void PlacementPlanner::request(const std::string& name, Hint hint)
+{
+    m_requests.push_back(std::make_pair(name, hint));
+}
+
+PlacementPlanner::PlacementList PlacementPlanner::plan() const
+{
+    const CoreList& cores = m_topology.getCores();
+
+    // The housekeeping core is where the OS and interrupts already are
+    int housekeeping = -1;
+    std::vector<size_t> isolated;
+    std::vector<size_t> shared;
+    for (size_t i = 0; i < cores.size(); ++i)
+    {
+        if (m_topology.isCoreIsolated(i))
+            isolated.push_back(i);
+        else if (-1 == housekeeping)
+            housekeeping = (int)i;
+        else
+            shared.push_back(i);
+    }
+
+    // Realtime gets isolated cores, then the highest cores, and the
+    // housekeeping core only when there is nothing left
+    std::vector<size_t> realtimeOrder(isolated);
+    realtimeOrder.insert(realtimeOrder.end(), shared.rbegin(), shared.rend());
+    if (-1 != housekeeping)
+        realtimeOrder.push_back((size_t)housekeeping);
+
+    PlacementList placements(m_requests.size());
+    std::vector<bool> realtimeCores(cores.size(), false);
+    size_t realtimeCount = 0;
+    for (size_t i = 0; i < m_requests.size(); ++i)
+    {
+        Placement& placement = placements[i];
+        placement.name = m_requests[i].first;
+        placement.hint = m_requests[i].second;
+        placement.cpu = -1;
+
+        switch (placement.hint)
+        {
+            case REALTIME:
+                placement.priority = IUpdatable::RT_NORMAL_PRIORITY;
+                break;
+            case COMPUTE:
+                placement.priority = IUpdatable::NORMAL_PRIORITY;
+                break;
+            case IO:
+                placement.priority = IUpdatable::HIGH_PRIORITY;
+                break;
+            case BACKGROUND:
+                placement.priority = IUpdatable::LOW_PRIORITY;
+                break;
+        }
+
+        if ((REALTIME == placement.hint) && !realtimeOrder.empty())
+        {
+            size_t core = realtimeOrder[realtimeCount % realtimeOrder.size()];
+            placement.cpu = cores[core][0];
+            realtimeCores[core] = true;
+            realtimeCount++;
+        }
+    }
+
+    // Compute stays off the realtime and housekeeping cores if it can
+    std::vector<size_t> computeCores;
+    for (size_t i = 0; i < shared.size(); ++i)
+    {
+        if (!realtimeCores[shared[i]])
+            computeCores.push_back(shared[i]);
+    }
+    if (computeCores.empty() && (-1 != housekeeping) &&
+        !realtimeCores[housekeeping])
+    {
+        computeCores.push_back((size_t)housekeeping);
+    }
+    if (computeCores.empty())
+    {
+        computeCores = shared;
+        if (-1 != housekeeping)
+            computeCores.insert(computeCores.begin(), (size_t)housekeeping);
+    }
+
+    // IO and background share the housekeeping core
+    std::vector<size_t> ioCores;
+    if ((-1 != housekeeping) && !realtimeCores[housekeeping])
+        ioCores.push_back((size_t)housekeeping);
+    else
+        ioCores = computeCores;
+
+    std::vector<int> computeCpus = spreadCpus(cores, computeCores);
+    std::vector<int> ioCpus = spreadCpus(cores, ioCores);
+    size_t computeCount = 0;
+    size_t ioCount = 0;
+    for (size_t i = 0; i < placements.size(); ++i)
+    {
+        Placement& placement = placements[i];
+        if ((COMPUTE == placement.hint) && !computeCpus.empty())
+        {
+            placement.cpu = computeCpus[computeCount % computeCpus.size()];
+            computeCount++;
+        }
+        else if (((IO == placement.hint) || (BACKGROUND == placement.hint)) &&
+                 !ioCpus.empty())
+        {
+            placement.cpu = ioCpus[ioCount % ioCpus.size()];
+            ioCount++;
+        }
+    }
+
+    return placements;
+}
+
+std::string PlacementPlanner::describe(const PlacementList& placements) const
+{
+    std::stringstream ss;
+    for (size_t i = 0; i < placements.size(); ++i)
+    {
+        const Placement& placement = placements[i];
+        ss << placement.name << " " << hintToString(placement.hint)
+           << " cpu " << placement.cpu << " core "
+           << m_topology.getCoreOf(placement.cpu) << " priority "
+           << priorityName(placement.priority) << std::endl;
+    }
+    return ss.str();
+}
+
+std::vector<std::string> PlacementPlanner::findConflicts(
+    const PlacementList& placements) const
+{
+    std::map<int, std::vector<std::string> > realtimeByCore;
+    for (size_t i = 0; i < placements.size(); ++i)
+    {
+        const Placement& placement = placements[i];
+        int core = m_topology.getCoreOf(placement.cpu);
+        if ((REALTIME == placement.hint) && (-1 != core))
+            realtimeByCore[core].push_back(placement.name);
+    }
+
+    std::vector<std::string> warnings;
+    typedef std::map<int, std::vector<std::string> >::iterator CoreIter;
+    for (CoreIter iter = realtimeByCore.begin();
+         iter != realtimeByCore.end(); ++iter)
+    {
+        std::vector<std::string>& names = iter->second;
+        if (names.size() < 2)
+            continue;
+
+        std::stringstream ss;
+        ss << "Realtime subsystems " << boost::algorithm::join(names, ", ")
+           << " share physical core " << iter->first << " (CPUs";
+        const std::vector<int>& cpus = m_topology.getCores()[iter->first];
+        for (size_t i = 0; i < cpus.size(); ++i)
+            ss << " " << cpus[i];
+        ss << ")";
+        warnings.push_back(ss.str());
+    }
+    return warnings;
+}
+
+} // namespace core
+} // namespace ram
@@ -19,6 +19,7 @@
 #pragma warning( disable : 4121 )
 #endif 
 #include "core/include/PythonConfigNodeImp.h"
+#include "core/include/GILock.h"
 
 
 namespace py = boost::python;
@@ -26,6 +27,21 @@ namespace py = boost::python;
 namespace ram {
 namespace core {
 
+/** Deletes the node with the GIL held, so any thread can release it */
+struct GILDeleter
+{
+    void operator()(PythonConfigNodeImp* imp) const
+    {
+        ScopedGILock lock;
+        delete imp;
+    }
+};
+
+static ConfigNodeImpPtr newImp(PythonConfigNodeImp* imp)
+{
+    return ConfigNodeImpPtr(imp, GILDeleter());
+}
+
 PythonConfigNodeImp::PythonConfigNodeImp(py::object pyobj,
 					 std::string debugPath) :
     m_pyobj(pyobj),
@@ -84,7 +100,7 @@ ConfigNodeImpPtr PythonConfigNodeImp::fromYamlFile(std::string filename)
                                           main_namespace.ptr()));
         py::object obj(main_namespace["config"]);
     
-        return ConfigNodeImpPtr(new PythonConfigNodeImp(obj));
+        return newImp(new PythonConfigNodeImp(obj));
     } catch(py::error_already_set err) {
         printf("ConfigNode (fromYamlFile) Error:\n");
         PyErr_Print();
@@ -98,11 +114,12 @@ ConfigNodeImpPtr PythonConfigNodeImp::fromYamlFile(std::string filename)
     
 ConfigNode PythonConfigNodeImp::construct(py::object pyobj)
 {
-    return ConfigNode(ConfigNodeImpPtr(new PythonConfigNodeImp(pyobj)));
+    return ConfigNode(newImp(new PythonConfigNodeImp(pyobj)));
 }
     
 ConfigNodeImpPtr PythonConfigNodeImp::idx(int index)
 {
+    ScopedGILock lock;
     try {
          std::stringstream ss;
          ss << m_debugPath << "[" << index << "]";
@@ -110,12 +127,12 @@ ConfigNodeImpPtr PythonConfigNodeImp::idx(int index)
         if ((m_pyobj.ptr() != Py_None) &&
             PyObject_HasAttrString (m_pyobj.ptr(), "__getitem__"))
         {
-            return ConfigNodeImpPtr(new PythonConfigNodeImp(m_pyobj[index],
+            return newImp(new PythonConfigNodeImp(m_pyobj[index],
 							    ss.str()));
         }
         else
         {
-            return ConfigNodeImpPtr(new PythonConfigNodeImp(py::object(),
+            return newImp(new PythonConfigNodeImp(py::object(),
 							    ss.str()));
         }
     } catch(py::error_already_set err) {
@@ -131,6 +148,7 @@ ConfigNodeImpPtr PythonConfigNodeImp::idx(int index)
 
 ConfigNodeImpPtr PythonConfigNodeImp::map(std::string key)
 {
+    ScopedGILock lock;
     try {
         std::string debugPath(m_debugPath + "." + key);
 
@@ -141,12 +159,12 @@ ConfigNodeImpPtr PythonConfigNodeImp::map(std::string key)
             includeIfNeeded(m_pyobj);
             if (m_pyobj.attr("has_key")(key))
             {
-                return ConfigNodeImpPtr(new PythonConfigNodeImp(m_pyobj[key], debugPath));
+                return newImp(new PythonConfigNodeImp(m_pyobj[key], debugPath));
             }
         }
 
         // If we got here, we haven't found it
-        return ConfigNodeImpPtr(new PythonConfigNodeImp(py::object(), debugPath));
+        return newImp(new PythonConfigNodeImp(py::object(), debugPath));
     } catch(py::error_already_set err) {
         printf("ConfigNode (map) Error:\n");
         PyErr_Print();
@@ -159,6 +177,7 @@ ConfigNodeImpPtr PythonConfigNodeImp::map(std::string key)
 
 std::string PythonConfigNodeImp::asString()
 {
+    ScopedGILock lock;
     try {
         return std::string(py::extract<char*>(py::str(m_pyobj)));
     } catch(py::error_already_set err) {
@@ -173,6 +192,7 @@ std::string PythonConfigNodeImp::asString()
 
 std::string PythonConfigNodeImp::asString(const std::string& def)
 {
+    ScopedGILock lock;
     try {
         if (m_pyobj.ptr() == Py_None)
             return def;
@@ -188,6 +208,7 @@ std::string PythonConfigNodeImp::asString(const std::string& def)
     
 double PythonConfigNodeImp::asDouble()
 {
+    ScopedGILock lock;
     try {
         return py::extract<double>(m_pyobj);
     } catch(py::error_already_set err ) {
@@ -202,6 +223,7 @@ double PythonConfigNodeImp::asDouble()
 
 double PythonConfigNodeImp::asDouble(const double def)
 {
+    ScopedGILock lock;
     try {
         if (m_pyobj.ptr() == Py_None)
             return def;
@@ -216,6 +238,7 @@ double PythonConfigNodeImp::asDouble(const double def)
     
 int PythonConfigNodeImp::asInt()
 {
+    ScopedGILock lock;
     try {
         return py::extract<int>(m_pyobj);
     } catch(py::error_already_set err ) {
@@ -230,6 +253,7 @@ int PythonConfigNodeImp::asInt()
 
 int PythonConfigNodeImp::asInt(const int def)
 {
+    ScopedGILock lock;
     try {
         if (m_pyobj.ptr() == Py_None)
             return def;
@@ -244,6 +268,7 @@ int PythonConfigNodeImp::asInt(const int def)
 
 NodeNameList PythonConfigNodeImp::subNodes()
 {
+    ScopedGILock lock;
     try {
         if (m_pyobj.ptr() == Py_None)
             return NodeNameList();
@@ -276,6 +301,7 @@ NodeNameList PythonConfigNodeImp::subNodes()
 
 size_t PythonConfigNodeImp::size()
 {
+    ScopedGILock lock;
     try {
         return py::len(m_pyobj);
     } catch(py::error_already_set err ) {
@@ -288,6 +314,7 @@ size_t PythonConfigNodeImp::size()
     
 void PythonConfigNodeImp::set(std::string key, std::string str)
 {
+    ScopedGILock lock;
     try {
         m_pyobj[key] = py::str(str);
     } catch(py::error_already_set err) {
@@ -302,6 +329,7 @@ void PythonConfigNodeImp::set(std::string key, std::string str)
     
 void PythonConfigNodeImp::set(std::string key, int value)
 {
+    ScopedGILock lock;
     try {
         m_pyobj[key] = py::object(value);
     } catch(py::error_already_set err) {
@@ -324,6 +352,7 @@ struct null_deleter
 
 std::string PythonConfigNodeImp::toString()
 {
+    ScopedGILock lock;
     try {
         // Force includes of all nodes
         std::vector<ConfigNodeImpPtr> nodes;
@@ -360,6 +389,7 @@ std::string PythonConfigNodeImp::toString()
 
 void PythonConfigNodeImp::writeToFile(std::string fileName, bool silent)
 {
+    ScopedGILock lock;
     try {
         // Create python module and namespace
         py::object main_module((py::handle<>(py::borrowed(
@@ -392,7 +422,92 @@ void PythonConfigNodeImp::writeToFile(std::string fileName, bool silent)
     }
 }
 
-void PythonConfigNodeImp::includeIfNeeded(boost::python::object pyObj)
+ConfigValue PythonConfigNodeImp::toConfigValue(
+    std::vector<std::string>& includes)
+{
+    ScopedGILock lock;
+    try {
+        py::list included;
+        ConfigValue value(buildValue(m_pyobj, included));
+
+        size_t count = py::len(included);
+        for (size_t i = 0; i < count; ++i)
+            includes.push_back(py::extract<std::string>(included[i]));
+        return value;
+    } catch(py::error_already_set err) {
+        printf("ConfigNode (toConfigValue) Error:\n");
+        PyErr_Print();
+
+        throw err;
+    }
+}
+
+ConfigValue PythonConfigNodeImp::buildValue(py::object pyObj,
+                                            py::object included)
+{
+    PyObject* obj = pyObj.ptr();
+
+    if (Py_None == obj)
+        return ConfigValue(CONFIG_NONE);
+
+    // bool first, python considers it an int
+    if (PyBool_Check(obj))
+        return ConfigValue(CONFIG_BOOL, (Py_True == obj) ? "True" : "False");
+
+#if PY_MAJOR_VERSION < 3
+    if (PyInt_Check(obj) || PyLong_Check(obj))
+#else
+    if (PyLong_Check(obj))
+#endif
+    {
+        return ConfigValue(CONFIG_INT, py::extract<std::string>(
+                               py::str(pyObj)));
+    }
+
+    if (PyFloat_Check(obj))
+    {
+        ConfigValue value(CONFIG_DOUBLE, py::extract<std::string>(
+                              py::str(pyObj)));
+        py::object repr(py::handle<>(PyObject_Repr(obj)));
+        value.repr = py::extract<std::string>(repr);
+        return value;
+    }
+
+    if (PyList_Check(obj) || PyTuple_Check(obj))
+    {
+        ConfigValue value(CONFIG_LIST);
+        size_t count = py::len(pyObj);
+        for (size_t i = 0; i < count; ++i)
+            value.children.push_back(buildValue(pyObj[i], included));
+        return value;
+    }
+
+    if (PyDict_Check(obj))
+    {
+        if (PyObject_HasAttrString(obj, "has_key"))
+            includeIfNeeded(pyObj, included);
+
+        // Sorted, so the same config always gives the same snapshot
+        py::list keys(pyObj.attr("keys")());
+        keys.sort();
+
+        ConfigValue value(CONFIG_MAP);
+        size_t count = py::len(keys);
+        for (size_t i = 0; i < count; ++i)
+        {
+            value.keys.push_back(py::extract<std::string>(py::str(keys[i])));
+            value.children.push_back(buildValue(pyObj[keys[i]], included));
+        }
+        return value;
+    }
+
+    // Everything else is kept as its text
+    return ConfigValue(CONFIG_STRING, py::extract<std::string>(
+                           py::str(pyObj)));
+}
+
+void PythonConfigNodeImp::includeIfNeeded(boost::python::object pyObj,
+                                          boost::python::object included)
 {
     try {
         // Only include if there is an include tag and we haven't already done
@@ -405,6 +520,7 @@ void PythonConfigNodeImp::includeIfNeeded(boost::python::object pyObj)
 
             py::object main_namespace = main_module.attr("__dict__");
             main_namespace["node"] = pyObj;
+            main_namespace["included"] = included;
         
             std::stringstream ss;
             ss << "import yaml, os, os.path\n"
@@ -415,6 +531,8 @@ void PythonConfigNodeImp::includeIfNeeded(boost::python::object pyObj)
                << "    filePath = node['INCLUDE'].replace('/', os.sep)\n"
                << "    fullPath = os.path.join(basePath, filePath)\n"
                << "    cfg = yaml.load(file(os.path.normpath(fullPath)))\n"
+               << "    if included is not None:\n"
+               << "        included.append(os.path.normpath(fullPath))\n"
                 // Place all loaded item into the key
                << "    for key, val in cfg.iteritems():\n"
                << "        node[key] = val\n"
@@ -10,16 +10,21 @@
 
 // Library Includes
 #include <boost/bind.hpp>
+#include <log4cpp/Category.hh>
 
 // Project Includes
 #include "core/include/QueuedEventHub.h"
 #include "core/include/QueuedEventHubImp.h"
 #include "core/include/EventConnection.h"
 #include "core/include/SubsystemMaker.h"
+#include "core/include/QueueFactory.h"
 
 // Register EventHub into the maker subsystem
 RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::core::QueuedEventHub, QueuedEventHub);
 
+static log4cpp::Category& LOGGER(
+    log4cpp::Category::getInstance("QueuedEventHub"));
+
 namespace ram {
 namespace core {
 
@@ -31,7 +36,10 @@ QueuedEventHub::QueuedEventHub(ram::core::EventHubPtr eventHub,
     // Send all incomming events to be queued, and store the resulting connection
     m_connection(eventHub->subscribeToAll(
         boost::bind(&QueuedEventHubImp::queueEvent, m_imp.get(), _1))),
-    m_waitUpdate(false)
+    m_waitUpdate(false),
+    m_queueDepth(MetricsRegistry::gauge(
+                     name, "queueDepth",
+                     boost::bind(&QueuedEventHubImp::getQueueDepth, m_imp)))
 {
     m_imp->setPublishFunction(boost::bind(&QueuedEventHub::_publish, this, _1));
 }
@@ -40,13 +48,25 @@ QueuedEventHub::QueuedEventHub(ram::core::EventHubPtr eventHub,
 QueuedEventHub::QueuedEventHub(ConfigNode config, SubsystemList deps) :
     EventHub(config["name"].asString()),
     m_hub(core::Subsystem::getSubsystemOfType<EventHub>(deps)),
-    m_imp(new QueuedEventHubImp()),
+    m_imp(new QueuedEventHubImp(
+              makeQueue<QueuedEventHubImp::QueuedEvent>(config["queue"]))),
     // Send all incomming events to be queued and store the resulting connection
     m_connection(m_hub->subscribeToAll(
         boost::bind(&QueuedEventHubImp::queueEvent, m_imp, _1))),
-    m_waitUpdate(false)
+    m_waitUpdate(false),
+    m_queueDepth(MetricsRegistry::gauge(
+                     getName(), "queueDepth",
+                     boost::bind(&QueuedEventHubImp::getQueueDepth, m_imp)))
 {
     m_imp->setPublishFunction(boost::bind(&QueuedEventHub::_publish, this, _1));
+
+    // Determine which event types are coalesced
+    if (config.exists("coalesce"))
+    {
+        ConfigNode coalesceNode(config["coalesce"]);
+        for (size_t i = 0; i < coalesceNode.size(); ++i)
+            setCoalescingByName(coalesceNode[i].asString());
+    }
 }
 
 QueuedEventHub::~QueuedEventHub()
@@ -81,6 +101,22 @@ int QueuedEventHub::waitAndPublishEvents()
     return m_imp->waitAndPublishEvents();
 }
     
+void QueuedEventHub::setCoalescing(const Event::EventType& type,
+                                   bool coalesce)
+{
+    m_imp->setCoalescing(type, coalesce);
+}
+
+bool QueuedEventHub::getCoalescing(const Event::EventType& type)
+{
+    return m_imp->getCoalescing(type);
+}
+
+size_t QueuedEventHub::getCoalescedCount(const Event::EventType& type)
+{
+    return m_imp->getCoalescedCount(type);
+}
+    
 void QueuedEventHub::update(double)
 {
     if (m_waitUpdate)
@@ -89,6 +125,17 @@ void QueuedEventHub::update(double)
         publishEvents();
 }
 
+void QueuedEventHub::setCoalescingByName(const std::string& name)
+{
+    // Could be a typo, or a type from a library which isn't loaded yet
+    if (!m_imp->setCoalescingByName(name))
+    {
+        LOGGER.warnStream() << getName() << ": no event type named \""
+                            << name << "\" yet, it will be coalesced if "
+                            << "one is registered";
+    }
+}
+
 void QueuedEventHub::_publish(EventPtr event)
 {
     EventHub::publish(event);
@@ -7,14 +7,29 @@
  * File:  packages/core/src/QueuedEventHubImp.cpp
  */
 
+// STD Includes
+#include <algorithm>
+#include <vector>
+
+// Library Includes
+#include <boost/foreach.hpp>
+
 // Project Includes
 #include "core/include/QueuedEventHubImp.h"
+#include "core/include/ThreadedQueue.h"
+#include "core/include/EventTypeRegistry.h"
+#include "core/include/EventProfiler.h"
 
 namespace ram {
 namespace core {
 
-QueuedEventHubImp::QueuedEventHubImp()
+QueuedEventHubImp::QueuedEventHubImp(EventQueue* queue) :
+    m_eventQueue(queue),
+    m_coalescing(0),
+    m_matchedTypeCount(0)
 {
+    if (!m_eventQueue)
+        m_eventQueue.reset(new ThreadedQueue<QueuedEvent>());
 }
 
 void QueuedEventHubImp::setPublishFunction(boost::function<void (EventPtr)> publishFunction)
@@ -24,33 +39,247 @@ void QueuedEventHubImp::setPublishFunction(boost::function<void (EventPtr)> publ
     
 void QueuedEventHubImp::queueEvent(EventPtr event)
 {
-    m_eventQueue.push(event);    
+    QueuedEvent queued(event,
+                       EventProfiler::active() ? EventProfiler::now() : 0);
+
+    if (atomic::load(&m_coalescing))
+    {
+        boost::mutex::scoped_lock lock(m_coalesceMutex);
+        Event::EventTypeId typeId = event->type.getId();
+
+        // Types are numbered as they are registered, so a type past the ones
+        // already matched could be one of the names we were given
+        if (!m_coalescedNames.empty() && (typeId >= m_matchedTypeCount))
+            matchNewTypes();
+
+        if (isCoalesced(typeId))
+        {
+            // If an older event from this sender is still waiting, take its
+            // place in the queue instead of adding a new entry
+            CoalesceKey key(typeId, event->sender);
+            PendingEventMap::iterator iter = m_pendingEvents.find(key);
+            if ((m_pendingEvents.end() != iter) && iter->second.newest.event)
+            {
+                iter->second.newest = queued;
+                m_coalescedCounts[typeId]++;
+                return;
+            }
+            m_pendingEvents[key] = PendingEvent(queued);
+        }
+    }
+    
+    m_eventQueue->push(queued);
 }
                                    
 int QueuedEventHubImp::publishEvents()
 {
-    EventPtr event;
+    // Drain in batches, handlers can queue more events while we publish
+    std::vector<QueuedEvent> events;
     int published = 0;
     
-    while(m_eventQueue.popNoWait(event))
+    while (m_eventQueue->popAll(events))
     {
-        m_publishFunction(event);
-        published++;
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            QueuedEvent queued = takeNewest(events[i]);
+            if (queued.event)
+            {
+                publish(queued);
+                published++;
+            }
+        }
+        events.clear();
     }
     
-    return published;    
+    return published + publishPending();
 }
 
 int QueuedEventHubImp::waitAndPublishEvents()
 {
     // Wait for events and publish the new event
-    EventPtr event = m_eventQueue.popWait();
+    QueuedEvent queued = takeNewest(m_eventQueue->popWait());
+    int published = 0;
+    
+    if (queued.event)
+    {
+        publish(queued);
+        published++;
+    }
     
-    m_publishFunction(event);
+    return published + publishEvents();
+}
+
+void QueuedEventHubImp::setCoalescing(const Event::EventType& type,
+                                      bool coalesce)
+{
+    boost::mutex::scoped_lock lock(m_coalesceMutex);
+    Event::EventTypeId typeId = type.getId();
+    if (typeId >= m_coalescedTypes.size())
+    {
+        m_coalescedTypes.resize(typeId + 1, false);
+        m_coalescedCounts.resize(typeId + 1, 0);
+    }
+    m_coalescedTypes[typeId] = coalesce;
+
+    // Events already in the queue keep their pending entries, they are cleaned
+    // up as they are published
+    updateCoalescing();
+}
+
+bool QueuedEventHubImp::setCoalescingByName(const std::string& name)
+{
+    boost::mutex::scoped_lock lock(m_coalesceMutex);
+
+    // The old names only need the new types, the new name needs them all
+    size_t typeCount = EventTypeRegistry::getTypeCount();
+    matchTypes(m_coalescedNames, m_matchedTypeCount, typeCount);
+    bool matched = matchTypes(std::vector<std::string>(1, name), 0,
+                              typeCount);
+    m_matchedTypeCount = typeCount;
+    m_coalescedNames.push_back(name);
+
+    updateCoalescing();
+    return matched;
+}
+
+bool QueuedEventHubImp::getCoalescing(const Event::EventType& type)
+{
+    boost::mutex::scoped_lock lock(m_coalesceMutex);
+    return isCoalesced(EventTypeRegistry::lookup(type));
+}
+
+size_t QueuedEventHubImp::getCoalescedCount(const Event::EventType& type)
+{
+    boost::mutex::scoped_lock lock(m_coalesceMutex);
+    Event::EventTypeId typeId = EventTypeRegistry::lookup(type);
+    if (typeId < m_coalescedCounts.size())
+        return m_coalescedCounts[typeId];
+    return 0;
+}
+
+size_t QueuedEventHubImp::getQueueDepth()
+{
+    return m_eventQueue->size();
+}
+
+QueuedEventHubImp::QueuedEvent QueuedEventHubImp::takeNewest(
+    const QueuedEvent& queued)
+{
+    // Checking the flag alone is not enough, the type could have been
+    // coalesced when the event was queued
+    boost::mutex::scoped_lock lock(m_coalesceMutex);
+    if (m_pendingEvents.empty() && !atomic::load(&m_coalescing))
+        return queued;
+
+    EventPtr event = queued.event;
+    CoalesceKey key(event->type.getId(), event->sender);
+    PendingEventMap::iterator iter = m_pendingEvents.find(key);
+    if (m_pendingEvents.end() == iter)
+    {
+        // Nothing newer waiting, even if the type is coalesced now it wasn't
+        // when this event was queued
+        return queued;
+    }
+
+    if (iter->second.queued != event)
+    {
+        // A newer event holds the key's place further back in the queue
+        return QueuedEvent();
+    }
+
+    // Empty if publishPending() already published it
+    QueuedEvent newest = iter->second.newest;
+    m_pendingEvents.erase(iter);
+    return newest;
+}
+
+int QueuedEventHubImp::publishPending()
+{
+    // Only non-empty if a bounded queue dropped our entry, or an event was
+    // queued since we drained the queue.  The entries stay behind, empty, so
+    // the queue entry is dropped if it does turn up later.
+    std::vector<QueuedEvent> pending;
+    {
+        boost::mutex::scoped_lock lock(m_coalesceMutex);
+        BOOST_FOREACH(PendingEventMap::value_type& item, m_pendingEvents)
+        {
+            if (item.second.newest.event)
+            {
+                pending.push_back(item.second.newest);
+                item.second.newest = QueuedEvent();
+            }
+        }
+    }
+
+    BOOST_FOREACH(const QueuedEvent& queued, pending)
+        publish(queued);
     
-    return 1 + publishEvents();    
+    return (int)pending.size();
+}
+
+void QueuedEventHubImp::publish(const QueuedEvent& queued)
+{
+    // Skip events queued before profiling started
+    if (queued.queueTime && EventProfiler::active())
+    {
+        EventProfiler::recordDequeued(queued.event->type.getId(),
+                                      queued.queueTime);
+    }
+    m_publishFunction(queued.event);
+}
+
+bool QueuedEventHubImp::isCoalesced(Event::EventTypeId typeId)
+{
+    return (typeId < m_coalescedTypes.size()) && m_coalescedTypes[typeId];
+}
+
+bool QueuedEventHubImp::matchNewTypes()
+{
+    size_t typeCount = EventTypeRegistry::getTypeCount();
+    bool matched = matchTypes(m_coalescedNames, m_matchedTypeCount,
+                              typeCount);
+    m_matchedTypeCount = typeCount;
+    return matched;
+}
+
+bool QueuedEventHubImp::matchTypes(const std::vector<std::string>& names,
+                                   Event::EventTypeId begin,
+                                   Event::EventTypeId end)
+{
+    bool matched = false;
+    for (Event::EventTypeId typeId = begin; typeId < end; ++typeId)
+    {
+        std::string type(EventTypeRegistry::getName(typeId));
+        BOOST_FOREACH(const std::string& name, names)
+        {
+            // Event types are prefixed with the line they are defined on, so
+            // match anything which ends with " " + name
+            std::string suffix = " " + name;
+            if ((type == name) || ((type.size() > suffix.size()) &&
+                (0 == type.compare(type.size() - suffix.size(),
+                                   suffix.size(), suffix))))
+            {
+                if (typeId >= m_coalescedTypes.size())
+                {
+                    m_coalescedTypes.resize(typeId + 1, false);
+                    m_coalescedCounts.resize(typeId + 1, 0);
+                }
+                m_coalescedTypes[typeId] = true;
+                matched = true;
+            }
+        }
+    }
+    return matched;
+}
+
+void QueuedEventHubImp::updateCoalescing()
+{
+    // Names waiting for their types keep queueEvent checking
+    AtomicWord count = (AtomicWord)std::count(m_coalescedTypes.begin(),
+                                              m_coalescedTypes.end(), true);
+    atomic::store(&m_coalescing,
+                  count + (AtomicWord)m_coalescedNames.size());
 }
     
 } // namespace core
 } // namespace ram
-
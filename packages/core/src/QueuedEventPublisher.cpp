@@ -10,11 +10,13 @@
 // Project Includes
 #include "core/include/QueuedEventPublisher.h"
 #include "core/include/QueuedEventPublisherBase.h"
+#include "core/include/EventTypeRegistry.h"
 
 namespace ram {
 namespace core {
 
-typedef QueuedEventPublisherBaseTemplate<Event::EventType> QueuedPublisherType;
+typedef QueuedEventPublisherBaseTemplate<Event::EventTypeId>
+    QueuedPublisherType;
     
 static QueuedPublisherType*
 asType(QueuedEventPublisherBasePtr basePtr)
@@ -27,8 +29,7 @@ asType(QueuedEventPublisherBasePtr basePtr)
 }
     
 QueuedEventPublisher::QueuedEventPublisher(EventPublisher* parent) :
-    m_imp(new QueuedEventPublisherBaseTemplate<Event::EventType>(parent,
-                                                                 "UNNAMED"))
+    m_imp(new QueuedPublisherType(parent, "UNNAMED"))
 {
 }
     
@@ -36,12 +37,12 @@ EventConnectionPtr QueuedEventPublisher::subscribe(
     Event::EventType type, 
     boost::function<void (EventPtr)>  handler)
 {
-    return asType(m_imp)->subscribe(type, handler);
+    return asType(m_imp)->subscribe(type.getId(), handler);
 }
     
 void QueuedEventPublisher::publish(Event::EventType type, EventPtr event)
 {
-    asType(m_imp)->publish(type, type, this, event);
+    asType(m_imp)->publish(type.getId(), type, this, event);
 };
 
 int QueuedEventPublisher::publishEvents()
@@ -7,16 +7,36 @@
  * File:  packages/core/src/ThreadedAppender.cpp
  */
 
+// STD Includes
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
 // Project Includes
 #include "core/include/ThreadedAppender.h"
+#include "core/include/BoundedQueue.h"
+#include "core/include/BatchFileAppender.h"
 
 namespace ram {
 namespace core {
 
-ThreadedAppender::ThreadedAppender(log4cpp::Appender* appender) :
+const size_t ThreadedAppender::DEFAULT_CAPACITY;
+
+ThreadedAppender::ThreadedAppender(log4cpp::Appender* appender,
+                                   IQueue<LoggingEvent>* queue) :
     Appender(appender->getName()),
-    m_appender(appender)
+    m_logEvents(queue),
+    m_appender(appender),
+    m_batchAppender(dynamic_cast<BatchFileAppender*>(appender)),
+    m_dropped(0),
+    m_reportedDropped(0)
 {
+    if (!m_logEvents)
+    {
+        m_logEvents.reset(new BoundedQueue<LoggingEvent>(
+            DEFAULT_CAPACITY, BoundedQueueBase::DROP_NEWEST));
+    }
+
     // Start running full out
     background(-1);
 }
@@ -25,32 +45,80 @@ ThreadedAppender::~ThreadedAppender()
 {
     // Stop background thread
     unbackground(true);
+
+    // Write out anything still queued
+    m_logEvents->popAll(m_batch);
+    appendBatch();
     delete m_appender;
 }
 
 void ThreadedAppender::update(double timestep)
 {
-    LoggingEvent event("", "", "", 1);
+    LoggingEvent event;
 
     // Clear all current events
-    while(m_logEvents.popNoWait(event))
-        m_appender->doAppend(event);
+    m_logEvents->popAll(m_batch);
+    appendBatch();
 
-    // Wait for half a second, log event if needed, then reloop
+    // Wait for half a second, or until buffered events are due to be
+    // written, log event if needed, then reloop
     boost::xtime wait ={0, 500000000}; // 500 milliseconds
-    if(m_logEvents.popTimedWait(wait, event))
-        m_appender->doAppend(event);
+    if (m_batchAppender && m_batchAppender->getBufferedSize())
+    {
+        double interval = std::max(m_batchAppender->getFlushInterval(), 0.001);
+        if (interval < 0.5)
+            wait.nsec = (boost::xtime::xtime_nsec_t)(interval * 1e9);
+    }
+
+    if(m_logEvents->popTimedWait(wait, event))
+        m_batch.push_back(event);
+    appendBatch();
+}
+
+void ThreadedAppender::appendBatch()
+{
+    for (size_t i = 0; i < m_batch.size(); ++i)
+        m_appender->doAppend(m_batch[i]);
+    m_batch.clear();
+
+    // Leave a comment line where the messages are missing
+    size_t dropped = getDroppedCount();
+    if (dropped != m_reportedDropped)
+    {
+        std::stringstream ss;
+        ss << "% Dropped " << (dropped - m_reportedDropped)
+           << " log messages";
+        m_appender->doAppend(LoggingEvent(getName(), ss.str(), "",
+                                          log4cpp::Priority::WARN));
+        m_reportedDropped = dropped;
+    }
+
+    if (m_batchAppender)
+        m_batchAppender->endBatch();
 }
 
 log4cpp::Appender* ThreadedAppender::wrappedAppender()
 {
     return m_appender;
 }
+
+size_t ThreadedAppender::getDroppedCount()
+{
+    size_t dropped = (size_t)m_dropped.get();
+
+    // Events pushed out of the queue by newer ones
+    BoundedQueue<LoggingEvent>* boundedQueue =
+        dynamic_cast<BoundedQueue<LoggingEvent>*>(m_logEvents.get());
+    if (boundedQueue)
+        dropped += boundedQueue->getDroppedOldest();
+    return dropped;
+}
     
 void ThreadedAppender::doAppend(const log4cpp::LoggingEvent &event)
 {
     // Queue up event
-    m_logEvents.push(event);
+    if (!m_logEvents->push(event))
+        m_dropped.increment();
 }
 
 bool ThreadedAppender::reopen()
@@ -25,6 +25,7 @@
 
 // Project Includes
 #include "core/include/TimeVal.h"
+#include "core/include/Clock.h"
 
 // On windows we need our own gettimeofday
 #ifdef RAM_WINDOWS
@@ -126,36 +127,47 @@ TimeVal::TimeVal(const struct timeval& timeval)
 
 TimeVal TimeVal::timeOfDay()
 {
-    TimeVal current;
-    current.now();
-    return current;
+    return Clock::timeOfDay();
 }
     
 void TimeVal::now()
 {
-    gettimeofday(time_val(), NULL);
+    *this = Clock::timeOfDay();
+}
+
+TimeVal TimeVal::monotonic()
+{
+    return Clock::monotonic();
 }
     
 void TimeVal::sleep(double seconds)
 {
-    TimeVal::sleep(TimeVal(seconds));
+    Clock::sleep(seconds);
 }
     
 void TimeVal::sleep(const TimeVal& duration)
 {
-#ifdef RAM_POSIX
-    struct timespec sleep = {0, 0};
-    struct timespec act_sleep = {0, 0};
+    Clock::sleep(duration.get_double());
+}
 
-    sleep.tv_sec = duration.seconds();
-    sleep.tv_nsec = duration.microseconds() * 1000;
-    
-    nanosleep(&sleep, &act_sleep);  
+TimeVal Clock::realMonotonic()
+{
+#if defined(RAM_POSIX) && defined(CLOCK_MONOTONIC)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return TimeVal(now.tv_sec, now.tv_nsec / 1000);
 #else
-    long milliseconds = duration.get_double() / 1000;
-    Sleep(milliseconds);
+    // No monotonic clock available, fall back to the time of day
+    return realTimeOfDay();
 #endif
 }
+
+TimeVal Clock::realTimeOfDay()
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return TimeVal(now);
+}
     
 inline bool
 TimeVal::equal(const TimeVal& other) const
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/TimerManager.cpp
+ */
+
+// STD Includes
+#include <algorithm>
+#include <cmath>
+
+// Library Includes
+#include <boost/foreach.hpp>
+
+// Project Includes
+#include "core/include/TimerManager.h"
+#include "core/include/SubsystemMaker.h"
+#include "core/include/Clock.h"
+#include "core/include/ThreadedQueue.h"
+
+// Register the manager in the subsystem maker system, the python
+// ram.timer.TimerManager already has the plain name
+RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::core::TimerManager, CoreTimerManager);
+
+namespace ram {
+namespace core {
+
+/** The longest update() waits, so the thread notices it should stop */
+static const boost::int64_t MAX_WAIT = 100000000;
+
+/** Nanoseconds on the Clock, so timers follow virtual time too */
+static boost::int64_t clockNsec()
+{
+    return Clock::monotonicUsec() * 1000;
+}
+
+TimerManager::TimerManager(ConfigNode config, SubsystemList deps) :
+    Subsystem(config["name"].asString("TimerManager"), deps),
+    Updatable(this),
+    m_tickLength((boost::int64_t)(config["resolution"].asDouble(1) * 1e6)),
+    m_startTime(clockNsec()),
+    m_stopping(false)
+{
+    m_tickLength = std::max(m_tickLength, (boost::int64_t)1000);
+
+    // Runs all out, update() waits for the next timer.  The virtual clock
+    // only moves for scheduled updates, so there we update every tick.
+    if (Clock::isVirtual())
+        background((int)std::max((boost::int64_t)1, m_tickLength / 1000000));
+    else
+        background(-1);
+}
+
+TimerManager::~TimerManager()
+{
+    unbackground(true);
+}
+
+TimerPtr TimerManager::newTimer(Event::EventType eventType, double seconds,
+                                bool repeat, EventPublisher* publisher)
+{
+    if (!publisher)
+        publisher = this;
+
+    boost::int64_t delay = (boost::int64_t)(std::max(seconds, 0.0) * 1e9);
+    boost::int64_t periodTicks = std::max((boost::int64_t)1,
+        (delay + m_tickLength - 1) / m_tickLength);
+    TimerPtr timer(new Timer(eventType, publisher, seconds, periodTicks,
+                             repeat));
+
+    // The first tick which starts at or after the deadline
+    boost::int64_t deadline = clockNsec() - m_startTime + delay;
+    boost::int64_t expires = (deadline + m_tickLength - 1) / m_tickLength;
+
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_wheel.add(timer, expires);
+    }
+    m_wakeup.notify_one();
+
+    return timer;
+}
+
+size_t TimerManager::getTimerCount()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_wheel.size();
+}
+
+double TimerManager::getResolution() const
+{
+    return m_tickLength / 1e9;
+}
+
+void TimerManager::update(double)
+{
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        boost::int64_t now = currentTick();
+        m_wheel.advance(now + 1, m_expired);
+
+        // Repeating timers go back in before publishing, so a handler can
+        // cancel them.  Missed periods are skipped, not made up.
+        BOOST_FOREACH(TimerPtr timer, m_expired)
+        {
+            if (!timer->m_repeat)
+                continue;
+
+            boost::int64_t expires = timer->m_expires + timer->m_periodTicks;
+            if (expires <= now)
+                expires = now + timer->m_periodTicks;
+            m_wheel.add(timer, expires);
+        }
+    }
+
+    // Publish without the lock, so handlers can add timers
+    BOOST_FOREACH(TimerPtr timer, m_expired)
+    {
+        if (!timer->active())
+            continue;
+
+        timer->m_fired.increment();
+        timer->m_publisher->publish(timer->m_eventType,
+                                    EventPtr(new Event()));
+        if (!timer->m_repeat)
+            timer->cancel();
+    }
+    m_expired.clear();
+
+    // Only the background thread waits, a manual update returns right away
+    if (!Updatable::backgrounded() || Clock::isVirtual())
+        return;
+
+    boost::mutex::scoped_lock lock(m_mutex);
+    if (m_stopping)
+        return;
+
+    boost::int64_t wait = MAX_WAIT;
+    boost::int64_t nextTick = m_wheel.getNextTick();
+    if (nextTick >= 0)
+    {
+        wait = std::min(wait, m_startTime + nextTick * m_tickLength -
+                        clockNsec());
+    }
+
+    if (wait > 0)
+    {
+        boost::xtime timeout = {0, (boost::xtime::xtime_nsec_t)wait};
+        boost::xtime now;
+        boost::xtime_get(&now, boost::TIME_UTC);
+        m_wakeup.timed_wait(lock, details::add_xtime(now, timeout));
+    }
+}
+
+void TimerManager::setPriority(IUpdatable::Priority priority)
+{
+    Updatable::setPriority(priority);
+}
+
+IUpdatable::Priority TimerManager::getPriority()
+{
+    return Updatable::getPriority();
+}
+
+void TimerManager::setAffinity(size_t affinity)
+{
+    Updatable::setAffinity(affinity);
+}
+
+int TimerManager::getAffinity()
+{
+    return Updatable::getAffinity();
+}
+
+void TimerManager::background(int interval)
+{
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_stopping = false;
+    }
+    Updatable::background(interval);
+}
+
+void TimerManager::unbackground(bool join)
+{
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+    Updatable::unbackground(join);
+}
+
+bool TimerManager::backgrounded()
+{
+    return Updatable::backgrounded();
+}
+
+boost::int64_t TimerManager::currentTick()
+{
+    return (clockNsec() - m_startTime) / m_tickLength;
+}
+
+} // namespace core
+} // namespace ram
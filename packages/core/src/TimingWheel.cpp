@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/TimingWheel.cpp
+ */
+
+// Project Includes
+#include "core/include/TimingWheel.h"
+
+namespace ram {
+namespace core {
+
+// ------------------------------------------------------------------------ //
+//                               T I M E R                                  //
+// ------------------------------------------------------------------------ //
+
+Timer::Timer(Event::EventType eventType, EventPublisher* publisher,
+             double period, boost::int64_t periodTicks, bool repeat) :
+    m_eventType(eventType),
+    m_publisher(publisher),
+    m_period(period),
+    m_periodTicks(periodTicks),
+    m_repeat(repeat),
+    m_expires(0),
+    m_active(1)
+{
+}
+
+void Timer::cancel()
+{
+    atomic::store(&m_active, 0);
+}
+
+bool Timer::active() const
+{
+    return 0 != atomic::load(&m_active);
+}
+
+int Timer::getFireCount() const
+{
+    return (int)m_fired.get();
+}
+
+// ------------------------------------------------------------------------ //
+//                        T I M I N G   W H E E L                           //
+// ------------------------------------------------------------------------ //
+
+const int TimingWheel::LEVELS;
+const int TimingWheel::ROOT_BITS;
+const int TimingWheel::LEVEL_BITS;
+const int TimingWheel::ROOT_SLOTS;
+const int TimingWheel::LEVEL_SLOTS;
+const boost::int64_t TimingWheel::MAX_TICKS;
+
+TimingWheel::TimingWheel(boost::int64_t startTick) :
+    m_tick(startTick),
+    m_size(0)
+{
+    m_levels[0].resize(ROOT_SLOTS);
+    for (int level = 1; level < LEVELS; ++level)
+        m_levels[level].resize(LEVEL_SLOTS);
+}
+
+void TimingWheel::add(TimerPtr timer, boost::int64_t expires)
+{
+    if (expires < m_tick)
+        expires = m_tick;
+    timer->m_expires = expires;
+
+    // Too far out to place directly, park it at the end of the last level
+    boost::int64_t delta = expires - m_tick;
+    if (delta >= MAX_TICKS)
+    {
+        delta = MAX_TICKS - 1;
+        expires = m_tick + delta;
+    }
+
+    if (delta < ROOT_SLOTS)
+    {
+        m_levels[0][expires & (ROOT_SLOTS - 1)].push_back(timer);
+    }
+    else
+    {
+        int level = 1;
+        while (delta >= ((boost::int64_t)1 << levelShift(level + 1)))
+            ++level;
+
+        int index = (int)((expires >> levelShift(level)) & (LEVEL_SLOTS - 1));
+        m_levels[level][index].push_back(timer);
+    }
+
+    ++m_size;
+}
+
+void TimingWheel::advance(boost::int64_t tick, std::vector<TimerPtr>& expired)
+{
+    while (m_tick < tick)
+    {
+        // Nothing to find, jump straight there
+        if (0 == m_size)
+        {
+            m_tick = tick;
+            break;
+        }
+
+        // Each time the first level wraps around, refill it from the next
+        int index = (int)(m_tick & (ROOT_SLOTS - 1));
+        if (0 == index)
+        {
+            for (int level = 1; level < LEVELS; ++level)
+            {
+                if (0 != cascade(level))
+                    break;
+            }
+        }
+
+        Slot slot;
+        slot.swap(m_levels[0][index]);
+        boost::int64_t current = m_tick;
+        ++m_tick;
+
+        for (Slot::iterator iter = slot.begin(); iter != slot.end(); ++iter)
+        {
+            --m_size;
+            TimerPtr timer = *iter;
+            if (!timer->active())
+                continue;
+
+            if (timer->m_expires > current)
+                add(timer, timer->m_expires);
+            else
+                expired.push_back(timer);
+        }
+    }
+}
+
+boost::int64_t TimingWheel::getNextTick() const
+{
+    if (0 == m_size)
+        return -1;
+
+    // The next level will be moved down here, its timers could be due
+    boost::int64_t tick = m_tick;
+    if (0 == (tick & (ROOT_SLOTS - 1)))
+        return tick;
+
+    for (; 0 != (tick & (ROOT_SLOTS - 1)); ++tick)
+    {
+        if (!m_levels[0][tick & (ROOT_SLOTS - 1)].empty())
+            return tick;
+    }
+
+    return tick;
+}
+
+int TimingWheel::cascade(int level)
+{
+    int index = (int)((m_tick >> levelShift(level)) & (LEVEL_SLOTS - 1));
+
+    Slot slot;
+    slot.swap(m_levels[level][index]);
+    for (Slot::iterator iter = slot.begin(); iter != slot.end(); ++iter)
+    {
+        --m_size;
+        if ((*iter)->active())
+            add(*iter, (*iter)->m_expires);
+    }
+
+    return index;
+}
+
+int TimingWheel::levelShift(int level)
+{
+    if (0 == level)
+        return 0;
+    return ROOT_BITS + (level - 1) * LEVEL_BITS;
+}
+
+} // namespace core
+} // namespace ram
@@ -0,0 +1,581 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/Tracer.cpp
+ */
+
+// STD Includes
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <vector>
+
+// Library Includes
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+// Project Includes
+#include "core/include/Tracer.h"
+#include "core/include/EventProfiler.h"
+#include "core/include/SubsystemMaker.h"
+#include "core/include/Logging.h"
+
+// Register into the maker subsystem
+RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::core::Tracer, Tracer);
+
+namespace ram {
+namespace core {
+
+/** A single entry of the trace, times in EventProfiler::now() units */
+struct TraceRecord
+{
+    /** The Chrome trace phase, 'X' for a span, 's' and 'f' for flows */
+    char phase;
+    const std::string* name;
+    const char* category;
+    boost::int64_t start;
+    boost::int64_t duration;
+    int thread;
+    boost::uint64_t id;
+    boost::uint64_t parent;
+};
+
+/** The spans a thread buffers between writes, a power of two */
+static const size_t RING_RECORDS = 1 << 13;
+
+/** Single producer, single consumer queue of records
+ *
+ *  Like the rings of the BinaryLog, the head and tail only ever grow.  Only
+ *  the owning thread writes, and only a Tracer holding the state mutex
+ *  reads.
+ */
+struct TraceRing
+{
+    TraceRing() : head(0), tail(0), dropped(0), orphaned(0) {}
+
+    void write(const TraceRecord& record)
+    {
+        unsigned long start = (unsigned long)head;
+        if ((start - (unsigned long)atomic::load(&tail)) >= RING_RECORDS)
+        {
+            atomic::add(&dropped, 1);
+            return;
+        }
+
+        records[start & (RING_RECORDS - 1)] = record;
+        atomic::store(&head, (AtomicWord)(start + 1));
+    }
+
+    /** Appends everything in the ring to the given list */
+    void read(std::vector<TraceRecord>& out)
+    {
+        unsigned long end = (unsigned long)atomic::load(&head);
+        for (unsigned long i = (unsigned long)tail; i != end; ++i)
+            out.push_back(records[i & (RING_RECORDS - 1)]);
+        atomic::store(&tail, (AtomicWord)end);
+    }
+
+    volatile AtomicWord head;
+    volatile AtomicWord tail;
+
+    /** Records which did not fit */
+    volatile AtomicWord dropped;
+
+    /** Set when the owning thread exits */
+    volatile AtomicWord orphaned;
+
+    TraceRecord records[RING_RECORDS];
+};
+
+/** Shared by all threads, only used when a thread sees something new, or
+ *  when the trace is written */
+struct TraceState
+{
+    TraceState() : deletedDropped(0) {}
+
+    /** Held while reading the rings and changing anything below */
+    boost::mutex mutex;
+
+    std::vector<TraceRing*> rings;
+
+    /** Dropped records of rings which have been deleted */
+    boost::int64_t deletedDropped;
+
+    /** Every span name, so records only hold a pointer */
+    std::set<std::string> names;
+
+    /** Names of the handlers by EventHandler::getId() */
+    std::map<size_t, const std::string*> handlerNames;
+
+    /** Names of the event types by id */
+    std::vector<const std::string*> typeNames;
+};
+
+/** Never destroyed, threads can still publish after the statics are gone */
+static TraceState& traceState()
+{
+    static TraceState* state = new TraceState();
+    return *state;
+}
+
+/** The name kept for the life of the process, call with the mutex held */
+static const std::string* intern(TraceState& state, const std::string& name)
+{
+    return &(*state.names.insert(name).first);
+}
+
+/** The per thread part of the trace */
+struct TraceThread
+{
+    TraceThread() : id(0), context(0), ring(0), eventName(0) {}
+
+    int id;
+
+    /** The parent for events published on this thread */
+    boost::uint64_t context;
+
+    /** Created the first time the thread records a span */
+    TraceRing* ring;
+
+    /** The names this thread has used, so it only locks the state for new
+     *  ones */
+    std::map<size_t, const std::string*> handlerNames;
+    std::map<size_t, const std::string*> updatableNames;
+    std::vector<const std::string*> typeNames;
+    const std::string* eventName;
+};
+
+/** Called when the thread exits
+ *
+ *  Its ring is freed by the next flush, or right away when it is empty and
+ *  no Tracer is left to flush it.
+ */
+static void releaseThread(TraceThread* thread)
+{
+    TraceRing* ring = thread->ring;
+    delete thread;
+    if (!ring)
+        return;
+
+    TraceState& state = traceState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    atomic::store(&ring->orphaned, 1);
+
+    bool empty = (atomic::load(&ring->head) == atomic::load(&ring->tail));
+    if (!Tracer::active() && empty)
+    {
+        state.rings.erase(std::remove(state.rings.begin(), state.rings.end(),
+                                      ring), state.rings.end());
+        state.deletedDropped += atomic::load(&ring->dropped);
+        delete ring;
+    }
+}
+
+/** Never destroyed, like the state */
+static boost::thread_specific_ptr<TraceThread>& threadSlot()
+{
+    static boost::thread_specific_ptr<TraceThread>* slot =
+        new boost::thread_specific_ptr<TraceThread>(&releaseThread);
+    return *slot;
+}
+
+static AtomicCounter s_nextThread;
+
+static AtomicCounter s_nextTraceId;
+
+static TraceThread& traceThread()
+{
+    TraceThread* thread = threadSlot().get();
+    if (!thread)
+    {
+        thread = new TraceThread();
+        thread->id = (int)s_nextThread.increment();
+        threadSlot().reset(thread);
+    }
+    return *thread;
+}
+
+/** Adds a record to the calling thread's ring, unless it is full */
+static void addRecord(char phase, const std::string* name,
+                      const char* category, boost::int64_t start,
+                      boost::int64_t duration, boost::uint64_t id,
+                      boost::uint64_t parent)
+{
+    TraceThread& thread = traceThread();
+    if (!thread.ring)
+    {
+        thread.ring = new TraceRing();
+
+        TraceState& state = traceState();
+        boost::mutex::scoped_lock lock(state.mutex);
+        state.rings.push_back(thread.ring);
+    }
+
+    TraceRecord record;
+    record.phase = phase;
+    record.name = name;
+    record.category = category;
+    record.start = start;
+    record.duration = duration;
+    record.thread = thread.id;
+    record.id = id;
+    record.parent = parent;
+    thread.ring->write(record);
+}
+
+/** The dropped records of every ring, live or deleted */
+static boost::int64_t totalDropped()
+{
+    TraceState& state = traceState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    boost::int64_t dropped = state.deletedDropped;
+    for (size_t i = 0; i < state.rings.size(); ++i)
+        dropped += atomic::load(&state.rings[i]->dropped);
+    return dropped;
+}
+
+/** Event types start with the line they were defined on, drop it */
+static std::string typeName(const Event::EventType& type)
+{
+    std::string::size_type space = type.find(' ');
+    if (std::string::npos == space)
+        return type;
+    return type.substr(space + 1);
+}
+
+/** The name of the flow arrows */
+static const std::string* eventName()
+{
+    TraceThread& thread = traceThread();
+    if (!thread.eventName)
+    {
+        TraceState& state = traceState();
+        boost::mutex::scoped_lock lock(state.mutex);
+        thread.eventName = intern(state, "event");
+    }
+    return thread.eventName;
+}
+
+/** The interned name of the event's type, looked up by its id */
+static const std::string* eventTypeName(EventPtr event)
+{
+    Event::EventTypeId typeId = event->type.getId();
+    std::vector<const std::string*>& names = traceThread().typeNames;
+    if (typeId >= names.size())
+        names.resize(typeId + 1, 0);
+
+    const std::string*& name = names[typeId];
+    if (!name)
+    {
+        TraceState& state = traceState();
+        boost::mutex::scoped_lock lock(state.mutex);
+        if (typeId >= state.typeNames.size())
+            state.typeNames.resize(typeId + 1, 0);
+
+        const std::string*& sharedName = state.typeNames[typeId];
+        if (!sharedName)
+            sharedName = intern(state, typeName(event->type));
+        name = sharedName;
+    }
+    return name;
+}
+
+/** The interned name of the handler, described once */
+static const std::string* handlerName(EventHandlerPtr handler)
+{
+    const std::string*& name = traceThread().handlerNames[handler->getId()];
+    if (!name)
+    {
+        TraceState& state = traceState();
+        {
+            boost::mutex::scoped_lock lock(state.mutex);
+            name = state.handlerNames[handler->getId()];
+        }
+
+        // Describing the handler is slow, so do it without the lock
+        if (!name)
+        {
+            std::string description(EventProfiler::describeHandler(handler));
+            boost::mutex::scoped_lock lock(state.mutex);
+            name = intern(state, description);
+            state.handlerNames[handler->getId()] = name;
+        }
+    }
+    return name;
+}
+
+/** The interned name of the updatable, worked out once */
+static const std::string* updatableName(Updatable* updatable)
+{
+    size_t id = updatable->getUpdatableId();
+    const std::string*& name = traceThread().updatableNames[id];
+    if (!name)
+    {
+        std::string updatableName(updatable->getUpdatableName());
+        TraceState& state = traceState();
+        boost::mutex::scoped_lock lock(state.mutex);
+        name = intern(state, updatableName);
+    }
+    return name;
+}
+
+/** Writes the string as a quoted JSON string */
+static void writeString(std::ostream& out, const std::string& str)
+{
+    out << '"';
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+        char c = str[i];
+        if (('"' == c) || ('\\' == c))
+        {
+            out << '\\' << c;
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            char escaped[8];
+            sprintf(escaped, "\\u%04x", (unsigned int)c);
+            out << escaped;
+        }
+        else
+        {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+Tracer::Tracer(ConfigNode config, SubsystemList deps) :
+    Subsystem(config["name"].asString("Tracer"), deps),
+    Updatable(this),
+    m_droppedAtStart(totalDropped())
+{
+    std::string fileName = config["fileName"].asString("trace.json");
+    if (!fileName.empty())
+    {
+        std::string filePath = (Logging::getLogDir() / fileName).string();
+        m_file.open(filePath.c_str(), std::ios::out | std::ios::trunc);
+
+        // Chrome accepts the array unterminated, so a crash leaves a
+        // readable trace
+        m_file << "[" << std::endl;
+    }
+
+    Instrumentation::add(Instrumentation::TRACER);
+}
+
+Tracer::~Tracer()
+{
+    unbackground(true);
+    Instrumentation::remove(Instrumentation::TRACER);
+
+    flush();
+
+    boost::mutex::scoped_lock lock(m_fileMutex);
+    if (m_file.is_open())
+    {
+        m_file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+               << "\"args\":{\"name\":";
+        writeString(m_file, getName());
+        m_file << "}}" << std::endl << "]" << std::endl;
+    }
+}
+
+void Tracer::flush()
+{
+    // Drain every ring, and free those whose thread has exited
+    std::vector<TraceRecord> records;
+    {
+        TraceState& state = traceState();
+        boost::mutex::scoped_lock lock(state.mutex);
+
+        std::vector<TraceRing*> live;
+        for (size_t i = 0; i < state.rings.size(); ++i)
+        {
+            // Check first, so the thread made its last write before we read
+            TraceRing* ring = state.rings[i];
+            bool orphaned = (0 != atomic::load(&ring->orphaned));
+            ring->read(records);
+            if (orphaned)
+            {
+                state.deletedDropped += atomic::load(&ring->dropped);
+                delete ring;
+            }
+            else
+            {
+                live.push_back(ring);
+            }
+        }
+        state.rings.swap(live);
+    }
+
+    boost::mutex::scoped_lock lock(m_fileMutex);
+    if (!m_file.is_open())
+        return;
+
+    // Chrome wants microseconds
+    m_file << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const TraceRecord& record = records[i];
+        m_file << "{\"name\":";
+        writeString(m_file, *record.name);
+        m_file << ",\"cat\":\"" << record.category << "\",\"ph\":\""
+               << record.phase << "\",\"ts\":" << record.start / 1000.0
+               << ",\"pid\":1,\"tid\":" << record.thread;
+
+        if ('X' == record.phase)
+        {
+            m_file << ",\"dur\":" << record.duration / 1000.0;
+            if (record.id || record.parent)
+            {
+                m_file << ",\"args\":{\"id\":" << record.id
+                       << ",\"parent\":" << record.parent << "}";
+            }
+        }
+        else
+        {
+            // Flow ends bind to the span they are in, the handler
+            m_file << ",\"id\":" << record.id;
+            if ('f' == record.phase)
+                m_file << ",\"bp\":\"e\"";
+        }
+        m_file << "}," << std::endl;
+    }
+    m_file.flush();
+}
+
+size_t Tracer::getDroppedCount()
+{
+    return (size_t)(totalDropped() - m_droppedAtStart);
+}
+
+void Tracer::update(double)
+{
+    flush();
+}
+
+void Tracer::setPriority(IUpdatable::Priority priority)
+{
+    Updatable::setPriority(priority);
+}
+
+IUpdatable::Priority Tracer::getPriority()
+{
+    return Updatable::getPriority();
+}
+
+void Tracer::setAffinity(size_t affinity)
+{
+    Updatable::setAffinity(affinity);
+}
+
+int Tracer::getAffinity()
+{
+    return Updatable::getAffinity();
+}
+
+void Tracer::background(int interval)
+{
+    Updatable::background(interval);
+}
+
+void Tracer::unbackground(bool join)
+{
+    Updatable::unbackground(join);
+}
+
+bool Tracer::backgrounded()
+{
+    return Updatable::backgrounded();
+}
+
+boost::uint64_t Tracer::currentContext()
+{
+    TraceThread* thread = threadSlot().get();
+    if (!thread)
+        return 0;
+    return thread->context;
+}
+
+Tracer::ScopedContext::ScopedContext(boost::uint64_t traceId) :
+    m_previous(0),
+    m_set(0 != traceId)
+{
+    if (m_set)
+    {
+        TraceThread& thread = traceThread();
+        m_previous = thread.context;
+        thread.context = traceId;
+    }
+}
+
+Tracer::ScopedContext::~ScopedContext()
+{
+    if (m_set)
+        traceThread().context = m_previous;
+}
+
+void Tracer::startTrace(EventPtr event)
+{
+    // Already traced, it is being published again
+    if (0 != event->traceId)
+        return;
+
+    event->traceId = (boost::uint64_t)s_nextTraceId.increment();
+    event->parentTraceId = currentContext();
+
+    // The publish span this is in starts the arrow to the handlers
+    addRecord('s', eventName(), "flow", EventProfiler::now(), 0,
+              event->traceId, 0);
+}
+
+void Tracer::recordPublish(EventPtr event, boost::int64_t start)
+{
+    addRecord('X', eventTypeName(event), "publish", start,
+              EventProfiler::now() - start, event->traceId,
+              event->parentTraceId);
+}
+
+void Tracer::recordHubPublish(EventPtr event, boost::int64_t start)
+{
+    addRecord('X', eventTypeName(event), "hub", start,
+              EventProfiler::now() - start, event->traceId,
+              event->parentTraceId);
+}
+
+void Tracer::callHandlers(Event::EventTypeId typeId,
+                          const EventHandlerList& handlers, EventPtr event)
+{
+    ScopedContext context(event->traceId);
+
+    for (size_t i = 0; i < handlers.size(); ++i)
+    {
+        EventHandlerPtr handler = handlers[i];
+        const std::string* name = handlerName(handler);
+
+        boost::int64_t start = EventProfiler::now();
+        if (event->traceId)
+            addRecord('f', eventName(), "flow", start, 0, event->traceId, 0);
+        handler->call(event);
+        boost::int64_t duration = EventProfiler::now() - start;
+        addRecord('X', name, "handler", start, duration, event->traceId,
+                  event->parentTraceId);
+        if (EventProfiler::active())
+            EventProfiler::recordHandler(typeId, handler, duration);
+    }
+}
+
+void Tracer::recordUpdate(Updatable* updatable, boost::int64_t start)
+{
+    boost::int64_t end = EventProfiler::now();
+    addRecord('X', updatableName(updatable), "update", start, end - start, 0,
+              currentContext());
+}
+
+} // namespace core
+} // namespace ram
@@ -9,18 +9,34 @@
 
 // STD Includes
 #include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <typeinfo>
+#include <algorithm>
+#include <vector>
 
 // Library Includes
 #include <boost/cstdint.hpp>
 #include <boost/thread/xtime.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/bind.hpp>
+#include <boost/algorithm/string.hpp>
 
 // Project Includes
 #include "core/include/Feature.h"
 #include "core/include/TimeVal.h"
 #include "core/include/Events.h"
 #include "core/include/Updatable.h"
+#include "core/include/UpdatableScheduler.h"
+#include "core/include/LockstepScheduler.h"
+#include "core/include/Clock.h"
+#include "core/include/Tracer.h"
+#include "core/include/EventProfiler.h"
+#include "core/include/AllocationTracker.h"
+#include "core/include/Subsystem.h"
+#include "core/include/Metrics.h"
+#include "core/include/Atomic.h"
+#include "core/include/CpuTopology.h"
 
 // System Includes
 #ifdef RAM_POSIX
@@ -45,6 +61,7 @@
 #endif // RAM_POSIX
 
 #include <iostream>
+#include <cerrno>
 
 const static long USEC_PER_MILLISEC = 1000;
 const static long NSEC_PER_MILLISEC = 1000000;
@@ -60,6 +77,9 @@ static int RT_HIGH_PRIORITY_VALUE = 0;
 static int RT_NORMAL_PRIORITY_VALUE = 0;
 static int RT_LOW_PRIORITY_VALUE = 0;
 static size_t CPU_COUNT = 0;
+static std::vector<int> ONLINE_CPUS;
+
+RAM_CORE_EVENT_TYPE(ram::core::Updatable, STATS);
 
 namespace ram {
 namespace core {
@@ -67,74 +87,15 @@ namespace core {
 
 typedef boost::int64_t Usec;
 
-// Adapted from the avahi library, under LPGL
-int timeval_compare(const struct timeval *a, const struct timeval *b) {
-    assert(a);
-    assert(b);
-
-    if (a->tv_sec < b->tv_sec)
-        return -1;
-
-    if (a->tv_sec > b->tv_sec)
-        return 1;
-
-    if (a->tv_usec < b->tv_usec)
-        return -1;
-
-    if (a->tv_usec > b->tv_usec)
-        return 1;
-
-    return 0;
-}
-
-Usec timeval_diff(const struct timeval *a, const struct timeval *b) {
-    assert(a);
-    assert(b);
-
-    if (timeval_compare(a, b) < 0)
-        return - timeval_diff(b, a);
-
-    return ((Usec) a->tv_sec - b->tv_sec)*1000000 + a->tv_usec - b->tv_usec;
-}
-
-struct timeval* timeval_add(struct timeval *a, Usec usec) {
-    Usec u;
-    assert(a);
-
-    u = usec + a->tv_usec;
+/** Source of the updatable ids */
+static AtomicCounter UPDATABLE_COUNT;
 
-    if (u < 0) {
-        a->tv_usec = (long) (1000000 + (u % 1000000));
-        a->tv_sec += (long) (-1 + (u / 1000000));
-    } else {
-        a->tv_usec = (long) (u % 1000000);
-        a->tv_sec += (long) (u / 1000000);
-    }
-
-    return a;
-}
-
-Usec age(const struct timeval *a) {
-    struct timeval now;
-    
-    assert(a);
-
-    gettimeofday(&now, NULL);
-
-    return timeval_diff(&now, a);
-}
-
-struct timeval *elapse_time(struct timeval *tv, unsigned msec) {
-    assert(tv);
-
-    gettimeofday(tv, NULL);
-
-    if (msec)
-        timeval_add(tv, (Usec) msec*1000);
-        
-    return tv;
+/** The current monotonic time in microseconds */
+static Usec monotonicUsec()
+{
+    TimeVal now(TimeVal::monotonic());
+    return ((Usec)now.seconds()) * USEC_PER_SEC + now.microseconds();
 }
-
     
 Updatable::Updatable(EventPublisher *publisher) :
     m_backgrounded(0),
@@ -142,59 +103,70 @@ Updatable::Updatable(EventPublisher *publisher) :
     m_priority(NORMAL_PRIORITY),
     m_priorityValue(NORMAL_PRIORITY_VALUE),
     m_affinity(-1),
+    m_threadMode(DEDICATED_THREAD),
+    m_lockstep(false),
+    m_overrunPolicy(SKIP_MISSED),
     m_settingChange(0),
     m_backgroundThread(0),
     m_threadStopped(1),
     m_publisher(publisher),
-    m_profileCount(0)
+    m_profileCount(0),
+    m_lastProfile(0),
+    m_updatableId((size_t)UPDATABLE_COUNT.increment())
 {
     initThreadingSettings();
 }
 
 Updatable::~Updatable()
 {
+    // Make sure the schedulers are no longer using us
+    if (SHARED_POOL == getThreadMode())
+        UpdatableScheduler::getInstance()->unschedule(this, true);
+    if (m_lockstep)
+        LockstepScheduler::getInstance()->unschedule(this, true);
+    
     // Join and delete background thread if its still running
     cleanUpBackgroundThread();
 }
 
-void Updatable::setPriority(Priority priority)
+/** Translates the priority into the OS specific value */
+static int toPriorityValue(IUpdatable::Priority priority)
 {
-    // Translate prioirty value
     int priorityValue = 0;
     
     switch (priority)
     {
-        case HIGH_PRIORITY:
+        case IUpdatable::HIGH_PRIORITY:
         {
             priorityValue = HIGH_PRIORITY_VALUE;
             break;
         };
         
-        case NORMAL_PRIORITY:
+        case IUpdatable::NORMAL_PRIORITY:
         {
             priorityValue = NORMAL_PRIORITY_VALUE;
             break;
         };
         
-        case LOW_PRIORITY:
+        case IUpdatable::LOW_PRIORITY:
         {
             priorityValue = LOW_PRIORITY_VALUE;
             break;
         };
         
-        case RT_HIGH_PRIORITY:
+        case IUpdatable::RT_HIGH_PRIORITY:
         {
             priorityValue = RT_HIGH_PRIORITY_VALUE;
             break;
         };
         
-        case RT_NORMAL_PRIORITY:
+        case IUpdatable::RT_NORMAL_PRIORITY:
         {
             priorityValue = RT_NORMAL_PRIORITY_VALUE;
             break;
         };
         
-        case RT_LOW_PRIORITY:
+        case IUpdatable::RT_LOW_PRIORITY:
         {
             priorityValue = RT_LOW_PRIORITY_VALUE;
             break;
@@ -206,9 +178,17 @@ void Updatable::setPriority(Priority priority)
 
     // Make sure we only do real time threads on Linux
     #ifndef RAM_LINUX
-    assert(priorityValue <= LOW_PRIORITY &&
+    assert(priorityValue <= IUpdatable::LOW_PRIORITY &&
            "Can't have real time threads on non-linux platforms");
     #endif
+
+    return priorityValue;
+}
+
+void Updatable::setPriority(Priority priority)
+{
+    // Translate prioirty value
+    int priorityValue = toPriorityValue(priority);
     
     // Set value if needed
     boost::mutex::scoped_lock lock(m_upStateMutex);
@@ -220,6 +200,13 @@ void Updatable::setPriority(Priority priority)
         m_priorityValue = priorityValue;
         // Set priority change flag
         m_settingChange |= PRIORITY;
+
+        // Move to the pool for the new priority
+        if ((SHARED_POOL == m_threadMode) && m_backgrounded && !m_lockstep)
+        {
+            UpdatableScheduler::getInstance()->schedule(
+                this, m_interval, m_priority, m_affinity);
+        }
     }
 }
 
@@ -233,9 +220,16 @@ void Updatable::setAffinity(size_t core)
 {
     boost::mutex::scoped_lock lock(m_upStateMutex);
     assert(CPU_COUNT != 1 && "Can't set affinity on single core system");
-    assert(core < CPU_COUNT && "Core too large");
+    assert(isCPUOnline((int)core) && "Core not online");
     m_affinity = (int)core;
     m_settingChange |= AFFINITY;
+
+    // Move to the pool for the new core
+    if ((SHARED_POOL == m_threadMode) && m_backgrounded && !m_lockstep)
+    {
+        UpdatableScheduler::getInstance()->schedule(
+            this, m_interval, m_priority, m_affinity);
+    }
 }
 
 int Updatable::getAffinity()
@@ -243,6 +237,51 @@ int Updatable::getAffinity()
     boost::mutex::scoped_lock lock(m_upStateMutex);
     return m_affinity;
 }
+
+void Updatable::setThreadMode(ThreadMode mode)
+{
+    boost::mutex::scoped_lock lock(m_upStateMutex);
+    assert(!m_backgrounded && "Can't change thread mode while backgrounded");
+    m_threadMode = mode;
+}
+
+Updatable::ThreadMode Updatable::getThreadMode()
+{
+    boost::mutex::scoped_lock lock(m_upStateMutex);
+    return m_threadMode;
+}
+
+void Updatable::setOverrunPolicy(OverrunPolicy policy)
+{
+    boost::mutex::scoped_lock lock(m_upStateMutex);
+    m_overrunPolicy = policy;
+}
+
+Updatable::OverrunPolicy Updatable::getOverrunPolicy()
+{
+    boost::mutex::scoped_lock lock(m_upStateMutex);
+    return m_overrunPolicy;
+}
+
+Updatable::OverrunPolicy Updatable::stringToOverrunPolicy(std::string str)
+{
+    boost::algorithm::to_lower(str);
+    assert((str == "skip" || str == "catchup") && "Invalid overrun policy");
+    
+    if (str == "catchup")
+        return CATCH_UP;
+    return SKIP_MISSED;
+}
+
+Updatable::ThreadMode Updatable::stringToThreadMode(std::string str)
+{
+    boost::algorithm::to_lower(str);
+    assert((str == "thread" || str == "pool") && "Invalid thread mode");
+    
+    if (str == "pool")
+        return SHARED_POOL;
+    return DEDICATED_THREAD;
+}
      
 void Updatable::background(int interval)
 {
@@ -254,6 +293,33 @@ void Updatable::background(int interval)
         // Set state
         m_interval = interval;
 
+        // Updates on a schedule follow the virtual clock in lockstep, objects
+        // running all out keep their own thread
+        if (Clock::isVirtual() && (interval > 0) &&
+            (m_lockstep || !m_backgrounded))
+        {
+            m_backgrounded = true;
+            m_lockstep = true;
+            LockstepScheduler::getInstance()->schedule(this, m_interval);
+            return;
+        }
+        else if (m_lockstep)
+        {
+            // Now running all out, move to a thread of our own
+            LockstepScheduler::getInstance()->unschedule(this, false);
+            m_lockstep = false;
+            m_backgrounded = false;
+        }
+
+        // The scheduler handles both starting up, and changing the interval
+        if (SHARED_POOL == m_threadMode)
+        {
+            m_backgrounded = true;
+            UpdatableScheduler::getInstance()->schedule(
+                this, m_interval, m_priority, m_affinity);
+            return;
+        }
+
         // Only start up the background thread if we aren't already
         // running
         if (!m_backgrounded)
@@ -297,6 +363,25 @@ void Updatable::unbackground(bool join)
         m_backgrounded = false;
     }
 
+    bool lockstep = false;
+    {
+        boost::mutex::scoped_lock lock(m_upStateMutex);
+        lockstep = m_lockstep;
+        m_lockstep = false;
+    }
+
+    if (lockstep)
+    {
+        LockstepScheduler::getInstance()->unschedule(this, join);
+        return;
+    }
+
+    if (SHARED_POOL == getThreadMode())
+    {
+        UpdatableScheduler::getInstance()->unschedule(this, join);
+        return;
+    }
+
     // Wait for background thread to stop runnig and the delete it
     if (join)
         cleanUpBackgroundThread();
@@ -317,36 +402,20 @@ void Updatable::getState(bool& backgrounded, int& interval)
     
 void Updatable::loop()
 {
-    struct timeval last;
-    struct timeval start;
-    struct timeval profile; // last time a profile update happened
-    Usec sleep_time;
-    Usec offset;
-
-    // This call determines the time it takes for a gettimeofday call
-    // This makes the calls more accurate
-    gettimeofday(&last, NULL);
-    gettimeofday(&start, NULL);
-    offset = timeval_diff(&start, &last);
-
-    // Get time of day for profiling
-    gettimeofday(&profile, NULL);
-    m_profileCount = 0;
-
-    // Zero last so we can check
-    last.tv_usec = 0;
+    // Monotonic times, in microseconds, of the last update and the deadline
+    // for the next one
+    Usec last = 0;
+    Usec deadline = monotonicUsec();
     
     while (1)
     {
-        // Grab current time
-        gettimeofday(&start, NULL);
-
         // Grab our running state
         bool in_background = false;
         int interval = 10;
         getState(in_background, interval);
 
         // Change thread state if needed
+        OverrunPolicy policy = SKIP_MISSED;
         {
             boost::mutex::scoped_lock lock(m_upStateMutex);
             if (m_settingChange & PRIORITY)
@@ -356,61 +425,54 @@ void Updatable::loop()
                 setThreadAffinity();
 
             m_settingChange = 0;
+            policy = m_overrunPolicy;
         }
         
-        if (in_background)
+        // Time to quit
+        if (!in_background)
+            break;
+        
+        Usec start = monotonicUsec();
+        Usec latency = (interval > 0) ? (start - deadline) : 0;
+
+        // On the first loop through, set the step to ideal
+        Usec period = 0;
+        double timestep = interval / 1000.0;
+        if (0 != last)
         {
-            // On the first loop through, set the step to ideal
-            double diff = (double)(interval *(double)1000);
-            if (0 != last.tv_usec)
-                diff = (double)(timeval_diff(&start, &last) + offset);
+            period = start - last;
+            timestep = period / (double)USEC_PER_SEC;
+        }
+        last = start;
+        
+        // Call our update function
+        callUpdate(timestep);
+        Usec end = monotonicUsec();
+        
+        recordUpdate(interval, period / (double)USEC_PER_SEC,
+                     (end - start) / (double)USEC_PER_SEC,
+                     latency / (double)USEC_PER_SEC);
 
-            // Record time for next run 
-            last = start;
-            
-            // Call our update function
-            update(diff / (double)1000000);
-            m_profileCount += 1;
+        // Only sleep if we aren't running all out
+        if (interval > 0)
+        {
+            Usec step = (Usec)interval * USEC_PER_MILLISEC;
+            deadline += step;
 
-            Usec profile_time = timeval_diff(&last, &profile);
-            // If 1 second has passed since the last profile, publish and reset
-            if (profile_time > 1000000)
+            // Handle overrun, either run the missed updates right away or
+            // jump to the next deadline still in the future
+            if (deadline < end)
             {
-                if (m_publisher) {
-                    IntEventPtr event(new IntEvent());
-                    event->data = m_profileCount;
-                    m_publisher->publish(IUpdatable::PROFILE, event);
-                }
-                profile = last;
-                m_profileCount = 0;
+                Usec missed = (end - deadline) / step + 1;
+                if ((CATCH_UP != policy) || (missed > MAX_CATCH_UP))
+                    deadline += missed * step;
             }
 
-            // Only sleep if we aren't running all out
-            if (interval > 0)
-            {
-                // Determine next time to awake
-                struct timeval next = start;
-                timeval_add(&next, (Usec)interval * USEC_PER_MILLISEC);
-            
-                // Sleep for the rest for the remainder of our time
-                sleep_time = -age(&next);
-
-                // Handle overrun
-                if (sleep_time < 0)
-                    sleep_time = interval * USEC_PER_MILLISEC;
-
-                // If the wait ends early keep waiting
-                while(sleep_time > SLEEP_THRESHOLD)
-                {
-                    waitForUpdate((long)sleep_time);
-                    sleep_time = -age(&next);
-                }
-            }
+            waitUntil(deadline);
         }
-        // Time to quit
         else
         {
-            break;
+            deadline = end;
         }
     }
 
@@ -418,8 +480,137 @@ void Updatable::loop()
     m_threadStopped.countDown();
 }
 
+void Updatable::scheduledUpdate(double timestep, double latency)
+{
+    Usec start = monotonicUsec();
+    callUpdate(timestep);
+    Usec end = monotonicUsec();
+
+    int interval = 0;
+    {
+        boost::mutex::scoped_lock lock(m_upStateMutex);
+        interval = m_interval;
+    }
+
+    // The first update of the pool gets the ideal timestep, and no period
+    double period = timestep;
+    {
+        boost::mutex::scoped_lock lock(m_statsMutex);
+        if (0 == m_stats.updates)
+            period = 0;
+    }
+    
+    recordUpdate(interval, period, (end - start) / (double)USEC_PER_SEC,
+                 latency);
+}
+
+void Updatable::callUpdate(double timestep)
+{
+    // Allocations made by the update are counted against us
+    AllocationTracker::UpdateScope allocations(
+        AllocationTracker::active() ? this : 0);
+
+    if (Tracer::active())
+    {
+        boost::int64_t start = EventProfiler::now();
+        update(timestep);
+        Tracer::recordUpdate(this, start);
+    }
+    else
+    {
+        update(timestep);
+    }
+}
+
+void Updatable::recordUpdate(int interval, double period, double duration,
+                             double latency)
+{
+    {
+        boost::mutex::scoped_lock lock(m_statsMutex);
+        m_stats.record(interval / 1000.0, period, duration, latency);
+    }
+
+    // If 1 second has passed since the last profile, publish and reset
+    m_profileCount += 1;
+    double now = TimeVal::monotonic().get_double();
+    if (0 == m_lastProfile)
+    {
+        m_lastProfile = now;
+    }
+    else if ((now - m_lastProfile) > 1.0)
+    {
+        if (m_publisher)
+        {
+            IntEventPtr event(new IntEvent());
+            event->data = m_profileCount;
+            m_publisher->publish(IUpdatable::PROFILE, event);
+
+            UpdatableStatsEventPtr statsEvent(new UpdatableStatsEvent());
+            statsEvent->stats = getStats();
+            m_publisher->publish(STATS, statsEvent);
+        }
+        m_lastProfile = now;
+        m_profileCount = 0;
+    }
+}
+
+void Updatable::waitUntil(Usec deadline)
+{
+#if defined(RAM_POSIX) && defined(TIMER_ABSTIME) && defined(CLOCK_MONOTONIC)
+    struct timespec wakeUp;
+    wakeUp.tv_sec = (time_t)(deadline / USEC_PER_SEC);
+    wakeUp.tv_nsec = (long)((deadline % USEC_PER_SEC) * NSEC_PER_USEC);
+
+    // Absolute sleeps can just be restarted when interrupted by a signal
+    while (EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeUp,
+                                    NULL))
+    {
+    }
+#else
+    // No absolute sleep, so keep sleeping until we are close enough
+    Usec sleep_time = deadline - monotonicUsec();
+    while (sleep_time > SLEEP_THRESHOLD)
+    {
+        waitForUpdate((long)sleep_time);
+        sleep_time = deadline - monotonicUsec();
+    }
+#endif
+}
+
+UpdatableStats Updatable::getStats()
+{
+    boost::mutex::scoped_lock lock(m_statsMutex);
+    return m_stats;
+}
+
+void Updatable::resetStats()
+{
+    boost::mutex::scoped_lock lock(m_statsMutex);
+    m_stats.reset();
+}
+
+std::string Updatable::getUpdatableName()
+{
+    boost::mutex::scoped_lock lock(m_statsMutex);
+    if (m_updatableName.empty())
+    {
+        Subsystem* subsystem = dynamic_cast<Subsystem*>(this);
+        if (subsystem)
+            m_updatableName = subsystem->getName();
+        else
+            m_updatableName = MetricsRegistry::typeName(typeid(*this));
+    }
+    return m_updatableName;
+}
+
 void Updatable::waitForUpdate(long microseconds)
 {
+    if (Clock::isVirtual())
+    {
+        Clock::sleep(microseconds / (double)USEC_PER_SEC);
+        return;
+    }
+
 #ifdef RAM_POSIX
     struct timespec sleep = {0, 0};
     struct timespec act_sleep = {0, 0};
@@ -461,13 +652,12 @@ void Updatable::initThreadingSettings()
         RT_HIGH_PRIORITY_VALUE = sched_get_priority_max(SCHED_FIFO);
         RT_LOW_PRIORITY_VALUE = sched_get_priority_min(SCHED_FIFO);
 
-        // Check default affinity set to determine CPU count
-        cpu_set_t defaultSet;
-        sched_getaffinity(0, sizeof(defaultSet), &defaultSet);
-
-        CPU_COUNT = 0;
-        while (CPU_ISSET((int)CPU_COUNT, &defaultSet))
-            CPU_COUNT++;
+        // Every online CPU, not just our default affinity, which leaves out
+        // the isolated ones
+        std::vector<CpuInfo> cpus = CpuTopology::fromSysfs().getCpus();
+        for (size_t i = 0; i < cpus.size(); ++i)
+            ONLINE_CPUS.push_back(cpus[i].id);
+        CPU_COUNT = ONLINE_CPUS.size();
         assert(CPU_COUNT != 0 && "Getting CPU count failed");
 
         // Assume these are standard accross all systems
@@ -495,6 +685,8 @@ void Updatable::initThreadingSettings()
         size_t size = sizeof(CPU_COUNT) ;
         int ret = sysctlbyname("hw.ncpu", &CPU_COUNT, &size, NULL, 0);
         assert(ret == 0 && "Getting CPU count failed");
+        for (size_t i = 0; i < CPU_COUNT; ++i)
+            ONLINE_CPUS.push_back((int)i);
 #else
         #error "Unsupported platform"
 #endif
@@ -510,12 +702,49 @@ void Updatable::initThreadingSettings()
 
 void Updatable::setThreadPriority()
 {
-    switch (m_priority)
+    setCurrentThreadPriority(m_priority);
+}
+
+void Updatable::setThreadAffinity()
+{
+    setCurrentThreadAffinity(m_affinity);
+}
+
+size_t Updatable::getCPUCount()
+{
+    initThreadingSettings();
+    return CPU_COUNT;
+}
+
+bool Updatable::isCPUOnline(int cpu)
+{
+    initThreadingSettings();
+    return std::find(ONLINE_CPUS.begin(), ONLINE_CPUS.end(), cpu) !=
+        ONLINE_CPUS.end();
+}
+
+void Updatable::setCurrentThreadPriority(Priority priority)
+{
+    initThreadingSettings();
+    int priorityValue = toPriorityValue(priority);
+    
+    switch (priority)
     {
         case HIGH_PRIORITY:
         case NORMAL_PRIORITY:
         case LOW_PRIORITY:
         {
+#ifdef RAM_LINUX
+            // Leave the real time class, if the thread was in it
+            struct sched_param param;
+            int policy = SCHED_OTHER;
+            if (!pthread_getschedparam(pthread_self(), &policy, &param) &&
+                (SCHED_OTHER != policy))
+            {
+                param.sched_priority = 0;
+                pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+            }
+#endif
 #ifdef RAM_POSIX
             int which = 0;
             int who = 0;
@@ -524,7 +753,7 @@ void Updatable::setThreadPriority()
 #else
             who = gettid();
 #endif 
-            if(setpriority(which, who, m_priorityValue))
+            if(setpriority(which, who, priorityValue))
                 perror("ERROR setpriority");
 
 #elif defined(RAM_WINDOWS)
@@ -540,19 +769,16 @@ void Updatable::setThreadPriority()
         case RT_LOW_PRIORITY:
         {
 #ifdef RAM_LINUX
-/* Use the following            
-    struct sched_param param;  // scheduling priority
-    int policy = SCHED_RR;     // scheduling policy
-    
-    // Get the current thread id
-    
-    pthread_t thread_id = pthread_self();
-    
-    // To set the scheduling priority of the thread
-    param.sched_priority = 90;
-    pthread_setschedparam(thread_id, policy, &param);
-*/
-            
+            // Needs root, or CAP_SYS_NICE
+            struct sched_param param;
+            param.sched_priority = priorityValue;
+            int error = pthread_setschedparam(pthread_self(), SCHED_FIFO,
+                                              &param);
+            if (error)
+            {
+                errno = error;
+                perror("ERROR pthread_setschedparam");
+            }
 #else
 	  assert(false && "Unsupported platform");
 #endif
@@ -566,13 +792,13 @@ void Updatable::setThreadPriority()
 
 }
 
-void Updatable::setThreadAffinity()
+void Updatable::setCurrentThreadAffinity(int core)
 {
 #ifdef RAM_LINUX
     // Create a mask which runs us on the proper CPU
     cpu_set_t cpuMask;
     CPU_ZERO(&cpuMask);
-    CPU_SET(m_affinity, &cpuMask);
+    CPU_SET(core, &cpuMask);
     
     if(sched_setaffinity(0, sizeof(cpuMask), &cpuMask))
         perror("ERROR sched_setaffinity");
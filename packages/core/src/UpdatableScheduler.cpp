@@ -0,0 +1,341 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/UpdatableScheduler.cpp
+ */
+
+// STD Includes
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include <functional>
+
+// Library Includes
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/xtime.hpp>
+
+// Project Includes
+#include "core/include/UpdatableScheduler.h"
+#include "core/include/Updatable.h"
+#include "core/include/TimeVal.h"
+
+namespace ram {
+namespace core {
+
+typedef boost::int64_t Usec;
+
+/** The current monotonic time in microseconds */
+static Usec nowUsec()
+{
+    TimeVal now(TimeVal::monotonic());
+    return ((Usec)now.seconds()) * 1000000 + now.microseconds();
+}
+
+/** Converts our monotonic time into the absolute time boost waits on
+ *
+ *  Boost can only wait on the time of day, so if the time of day is changed
+ *  the wait can end early or late.  An early wake up is harmless, and the
+ *  UPDATE_WAKEUP_LIMIT bounds a late one.
+ */
+static boost::xtime toXtime(Usec time)
+{
+    // Never sleep longer than this, in case the time of day jumps forward
+    const Usec UPDATE_WAKEUP_LIMIT = 1000000;
+    Usec wait = std::min(time - nowUsec(), UPDATE_WAKEUP_LIMIT);
+    TimeVal now(TimeVal::timeOfDay());
+    Usec wakeUp = ((Usec)now.seconds()) * 1000000 + now.microseconds() + wait;
+    
+    boost::xtime xt;
+    xt.sec = (boost::xtime::xtime_sec_t)(wakeUp / 1000000);
+    xt.nsec = (boost::xtime::xtime_nsec_t)((wakeUp % 1000000) * 1000);
+    return xt;
+}
+
+/** The scheduling state of a single Updatable */
+struct UpdatableScheduler::Task
+{
+    Task(Updatable* updatable_) :
+        updatable(updatable_),
+        interval(0),
+        pool(0),
+        lastUpdate(0),
+        generation(0),
+        running(false),
+        removed(false)
+    {}
+
+    Updatable* updatable;
+
+    /** Milliseconds between updates */
+    int interval;
+
+    /** The pool the task will run in next */
+    Pool* pool;
+
+    /** When the last update started, zero before the first */
+    Usec lastUpdate;
+
+    /** Bumped when the task is queued, so stale heap entries are ignored */
+    size_t generation;
+
+    /** True while a worker is calling update */
+    bool running;
+    boost::thread::id runner;
+
+    /** Set by unschedule(), the task is not requeued */
+    bool removed;
+};
+
+/** An entry in a pool's deadline heap */
+struct HeapEntry
+{
+    HeapEntry(Usec deadline_, size_t generation_,
+              boost::shared_ptr<void> task_) :
+        deadline(deadline_),
+        generation(generation_),
+        task(task_)
+    {}
+
+    bool operator>(const HeapEntry& other) const
+    {
+        return deadline > other.deadline;
+    }
+
+    Usec deadline;
+    size_t generation;
+    boost::shared_ptr<void> task;
+};
+
+/** A set of workers sharing a single heap of deadlines */
+struct UpdatableScheduler::Pool
+{
+    Pool(IUpdatable::Priority priority_, int affinity_) :
+        priority(priority_),
+        affinity(affinity_)
+    {}
+
+    IUpdatable::Priority priority;
+    int affinity;
+
+    /** Signaled when an earlier deadline is added, or we are stopping */
+    boost::condition workAvailable;
+
+    /** Earliest deadline on top */
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>,
+                        std::greater<HeapEntry> > heap;
+
+    std::vector<boost::thread*> threads;
+};
+
+UpdatableScheduler::UpdatableScheduler(size_t threadsPerPool) :
+    m_threadsPerPool(threadsPerPool),
+    m_stop(false)
+{
+    if (0 == m_threadsPerPool)
+        m_threadsPerPool = Updatable::getCPUCount();
+    if (0 == m_threadsPerPool)
+        m_threadsPerPool = 1;
+}
+
+UpdatableScheduler::~UpdatableScheduler()
+{
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_stop = true;
+        BOOST_FOREACH(PoolMap::value_type& item, m_pools)
+            item.second->workAvailable.notify_all();
+    }
+
+    BOOST_FOREACH(PoolMap::value_type& item, m_pools)
+    {
+        BOOST_FOREACH(boost::thread* thread, item.second->threads)
+        {
+            thread->join();
+            delete thread;
+        }
+        delete item.second;
+    }
+}
+
+UpdatableScheduler* UpdatableScheduler::getInstance()
+{
+    // Never destroyed, static Updatables unschedule themselves after
+    // function local statics are gone
+    static UpdatableScheduler* scheduler = new UpdatableScheduler();
+    return scheduler;
+}
+
+void UpdatableScheduler::schedule(Updatable* updatable, int interval,
+                                  IUpdatable::Priority priority, int affinity)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    TaskPtr& task = m_tasks[updatable];
+    if (!task)
+        task = TaskPtr(new Task(updatable));
+
+    task->interval = interval;
+    task->pool = getPool(priority, affinity);
+    task->removed = false;
+
+    // A running task is requeued, into its new pool, once its update is done
+    if (!task->running)
+        queueTask(task, nowUsec());
+}
+
+void UpdatableScheduler::unschedule(Updatable* updatable, bool join)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    TaskMap::iterator iter = m_tasks.find(updatable);
+    if (m_tasks.end() == iter)
+        return;
+
+    // Keep the task alive, the worker could be using it
+    TaskPtr task = iter->second;
+    task->removed = true;
+    task->generation++;
+
+    if (join && (task->runner != boost::this_thread::get_id()))
+    {
+        while (task->running)
+            m_updateFinished.wait(lock);
+    }
+
+    // A running task is removed by the worker when its update is done
+    if (!task->running)
+        m_tasks.erase(updatable);
+}
+
+bool UpdatableScheduler::scheduled(Updatable* updatable)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    TaskMap::iterator iter = m_tasks.find(updatable);
+    return (m_tasks.end() != iter) && !iter->second->removed;
+}
+
+size_t UpdatableScheduler::getPoolCount()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_pools.size();
+}
+
+size_t UpdatableScheduler::getThreadCount()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    size_t count = 0;
+    BOOST_FOREACH(PoolMap::value_type& item, m_pools)
+        count += item.second->threads.size();
+    return count;
+}
+
+UpdatableScheduler::Pool* UpdatableScheduler::getPool(
+    IUpdatable::Priority priority, int affinity)
+{
+    PoolKey key((int)priority, affinity);
+    PoolMap::iterator iter = m_pools.find(key);
+    if (m_pools.end() != iter)
+        return iter->second;
+
+    // Workers set their own priority and affinity as they start
+    Pool* pool = new Pool(priority, affinity);
+    size_t threadCount = (affinity >= 0) ? 1 : m_threadsPerPool;
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        pool->threads.push_back(new boost::thread(
+            boost::bind(&UpdatableScheduler::workerLoop, this, pool)));
+    }
+
+    m_pools[key] = pool;
+    return pool;
+}
+
+void UpdatableScheduler::queueTask(TaskPtr task, Usec deadline)
+{
+    task->generation++;
+    task->pool->heap.push(HeapEntry(deadline, task->generation, task));
+
+    // The new task could be earlier than what the workers are waiting on
+    task->pool->workAvailable.notify_one();
+}
+
+void UpdatableScheduler::workerLoop(Pool* pool)
+{
+    Updatable::setCurrentThreadPriority(pool->priority);
+    if (pool->affinity >= 0)
+        Updatable::setCurrentThreadAffinity(pool->affinity);
+
+    boost::mutex::scoped_lock lock(m_mutex);
+    while (!m_stop)
+    {
+        if (pool->heap.empty())
+        {
+            pool->workAvailable.wait(lock);
+            continue;
+        }
+
+        // Throw away entries for removed, moved, or requeued tasks
+        HeapEntry entry = pool->heap.top();
+        TaskPtr task = boost::static_pointer_cast<Task>(entry.task);
+        if ((entry.generation != task->generation) || task->removed ||
+            (task->pool != pool))
+        {
+            pool->heap.pop();
+            continue;
+        }
+
+        // Sleep until the deadline, or an earlier task shows up
+        Usec now = nowUsec();
+        if (entry.deadline > now)
+        {
+            pool->workAvailable.timed_wait(lock, toXtime(entry.deadline));
+            continue;
+        }
+        pool->heap.pop();
+
+        // The first update gets the ideal timestep
+        double latency = 0;
+        if (task->interval > 0)
+            latency = (now - entry.deadline) / 1000000.0;
+        double timestep = task->interval / 1000.0;
+        if (0 != task->lastUpdate)
+            timestep = (now - task->lastUpdate) / 1000000.0;
+        task->lastUpdate = now;
+        task->running = true;
+        task->runner = boost::this_thread::get_id();
+
+        lock.unlock();
+        task->updatable->scheduledUpdate(timestep, latency);
+        lock.lock();
+
+        task->running = false;
+        task->runner = boost::thread::id();
+        m_updateFinished.notify_all();
+
+        if (task->removed)
+        {
+            TaskMap::iterator iter = m_tasks.find(task->updatable);
+            if ((m_tasks.end() != iter) && (iter->second == task))
+                m_tasks.erase(iter);
+            continue;
+        }
+
+        // Stay on the original schedule, skipping any missed updates
+        Usec deadline = nowUsec();
+        if (task->interval > 0)
+        {
+            Usec next = entry.deadline + (Usec)task->interval * 1000;
+            if (next > deadline)
+                deadline = next;
+        }
+        queueTask(task, deadline);
+    }
+}
+
+} // namespace core
+} // namespace ram
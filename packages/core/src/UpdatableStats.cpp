@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/UpdatableStats.cpp
+ */
+
+// STD Includes
+#include <cmath>
+
+// Project Includes
+#include "core/include/Feature.h"
+#include "core/include/UpdatableStats.h"
+
+// This section is only needed when we are compiling the wrappers
+#if defined(RAM_WITH_WRAPPERS)
+
+#include "core/include/EventConverter.h"
+
+static ram::core::SpecificEventConverter<ram::core::UpdatableStatsEvent>
+RAM_CORE_UPDATABLESTATSEVENT;
+
+#endif // RAM_WITH_WRAPPERS
+
+namespace ram {
+namespace core {
+
+const double UpdatableStats::JITTER_LIMITS[JITTER_BUCKETS - 1] = {
+    0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005
+};
+
+UpdatableStats::UpdatableStats()
+{
+    reset();
+}
+
+void UpdatableStats::record(double interval, double period, double duration,
+                            double latency)
+{
+    // Running mean, so we don't have to keep a total
+    updates++;
+    meanDuration += (duration - meanDuration) / updates;
+    lastDuration = duration;
+    if (duration > maxDuration)
+        maxDuration = duration;
+    if (latency > maxLatency)
+        maxLatency = latency;
+
+    // Jitter and overruns only make sense with a fixed interval
+    if (interval > 0)
+    {
+        if ((latency + duration) > interval)
+            overruns++;
+
+        if (period > 0)
+        {
+            double error = fabs(period - interval);
+            int bucket = 0;
+            while ((bucket < (JITTER_BUCKETS - 1)) &&
+                   (error >= JITTER_LIMITS[bucket]))
+            {
+                bucket++;
+            }
+            jitter[bucket]++;
+        }
+    }
+}
+
+void UpdatableStats::reset()
+{
+    updates = 0;
+    overruns = 0;
+    lastDuration = 0;
+    meanDuration = 0;
+    maxDuration = 0;
+    maxLatency = 0;
+    for (int i = 0; i < JITTER_BUCKETS; ++i)
+        jitter[i] = 0;
+}
+
+EventPtr UpdatableStatsEvent::clone()
+{
+    UpdatableStatsEventPtr event =
+        UpdatableStatsEventPtr(new UpdatableStatsEvent());
+    copyInto(event);
+    event->stats = stats;
+    return event;
+}
+
+} // namespace core
+} // namespace ram
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/WorkerPool.cpp
+ */
+
+// Library Includes
+#include <boost/bind.hpp>
+
+// Project Includes
+#include "core/include/WorkerPool.h"
+
+namespace ram {
+namespace core {
+
+WorkerPool::WorkerPool(size_t threads) :
+    m_threadCount(threads)
+{
+    if (0 == m_threadCount)
+        m_threadCount = boost::thread::hardware_concurrency();
+    if (0 == m_threadCount)
+        m_threadCount = 1;
+
+    for (size_t i = 0; i < m_threadCount; ++i)
+        m_threads.create_thread(boost::bind(&WorkerPool::run, this));
+}
+
+WorkerPool::~WorkerPool()
+{
+    // An empty task stops a thread, they go after everything already queued
+    for (size_t i = 0; i < m_threadCount; ++i)
+        submit(Task());
+    m_threads.join_all();
+}
+
+void WorkerPool::submit(Task task)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_tasks.push_back(task);
+    m_taskAvailable.notify_one();
+}
+
+void WorkerPool::run()
+{
+    while (true)
+    {
+        Task task;
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            while (m_tasks.empty())
+                m_taskAvailable.wait(lock);
+            task = m_tasks.front();
+            m_tasks.pop_front();
+        }
+
+        if (!task)
+            return;
+        task();
+    }
+}
+
+} // namespace core
+} // namespace ram
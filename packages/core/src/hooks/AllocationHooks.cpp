@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/hooks/AllocationHooks.cpp
+ */
+
+// The allocation hooks for the AllocationTracker.  These replace the C
+// allocator and the global operator new and delete, so they are built into
+// their own library, ram_alloc_hooks, which programs opt in to by linking to
+// it or with LD_PRELOAD.  They only work with glibc, which lets us call its
+// real allocator directly.  Memory from memalign and friends is not counted.
+
+// STD Includes
+#include <cstdlib>
+#include <new>
+
+// Project Includes
+#include "core/include/AllocationTracker.h"
+
+using ram::core::AllocationTracker;
+
+// glibc's real allocator
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* memory, size_t size);
+void __libc_free(void* memory);
+}
+
+/** Tells the tracker the hooks are here when the library is loaded */
+static struct InstallHooks
+{
+    InstallHooks() { AllocationTracker::setHooksInstalled(); }
+} INSTALL_HOOKS;
+
+extern "C" {
+
+void* malloc(size_t size) throw()
+{
+    if (AllocationTracker::active())
+        AllocationTracker::recordAllocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) throw()
+{
+    if (AllocationTracker::active())
+        AllocationTracker::recordAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* memory, size_t size) throw()
+{
+    if (AllocationTracker::active())
+    {
+        if (size)
+            AllocationTracker::recordAllocation(size);
+        if (memory)
+            AllocationTracker::recordFree();
+    }
+    return __libc_realloc(memory, size);
+}
+
+void free(void* memory) throw()
+{
+    if (memory && AllocationTracker::active())
+        AllocationTracker::recordFree();
+    __libc_free(memory);
+}
+
+} // extern "C"
+
+// Everything goes through malloc and free, so it is only counted once
+
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+    void* memory = malloc(size ? size : 1);
+    if (!memory)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) throw()
+{
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) throw()
+{
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void* memory) throw()
+{
+    free(memory);
+}
+
+void operator delete[](void* memory) throw()
+{
+    free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) throw()
+{
+    free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) throw()
+{
+    free(memory);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/src/tools/DecodeBinaryLog.cpp
+ */
+
+// STD Includes
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Project Includes
+#include "core/include/BinaryLog.h"
+
+using namespace ram;
+
+/** log4cpp's "%r", milliseconds since logging started */
+static long relativeTime(boost::int64_t time, boost::int64_t startTime)
+{
+    long seconds = (long)(time / 1000000 - startTime / 1000000);
+    long milliseconds = (long)((time % 1000000) / 1000 -
+                               (startTime % 1000000) / 1000);
+    return seconds * 1000 + milliseconds;
+}
+
+/** Turns a binary log from the BinaryLog subsystem back into text
+ *
+ *  Given a category, only its messages are written in the same "%m %r"
+ *  format as the text log files, so the output can replace control.log and
+ *  friends.  Otherwise every message is written as "%c %m %r", like the
+ *  console.
+ *
+ *  Usage: DecodeBinaryLog <binary log> [category]
+ */
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <binary log> [category]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::string category;
+    if (argc > 2)
+        category = argv[2];
+
+    boost::int64_t startTime = 0;
+    std::vector<core::BinaryLogEntry> entries;
+    if (!core::BinaryLog::readFile(argv[1], startTime, entries))
+    {
+        std::cerr << "Not a binary log: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        const core::BinaryLogEntry& entry = entries[i];
+        if (category.empty())
+            std::cout << entry.category << " ";
+        else if (category != entry.category)
+            continue;
+
+        std::cout << entry.message << " "
+                  << relativeTime(entry.time, startTime) << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,395 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/CoreBenchmark.cpp
+ */
+
+// STD Includes
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Library Includes
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+
+// Project Includes
+#include "core/include/EventPublisher.h"
+#include "core/include/EventConnection.h"
+#include "core/include/EventHub.h"
+#include "core/include/QueuedEventHub.h"
+#include "core/include/ThreadedQueue.h"
+#include "core/include/EventProfiler.h"
+#include "core/include/Histogram.h"
+
+using namespace ram;
+
+typedef std::vector<core::EventConnectionPtr> ConnectionList;
+
+// Nanoseconds on the monotonic clock
+static boost::int64_t now()
+{
+    return core::EventProfiler::now();
+}
+
+/** Prints one result as a line of CSV, see main for the columns
+ *
+ *  Throughput only benchmarks have no latency histogram, and leave the
+ *  latency columns empty.
+ */
+static void report(const std::string& benchmark, const std::string& variant,
+                   int param, long operations, boost::int64_t elapsed,
+                   const core::Histogram* latency = 0)
+{
+    double seconds = elapsed / 1e9;
+    std::cout << benchmark << "," << variant << "," << param << ","
+              << operations << "," << seconds << ","
+              << (seconds > 0 ? operations / seconds : 0) << ",";
+    if (latency)
+    {
+        std::cout << latency->getValueAtPercentile(50) / 1000.0 << ","
+                  << latency->getValueAtPercentile(99) / 1000.0 << ","
+                  << latency->getMax() / 1000.0;
+    }
+    else
+    {
+        std::cout << ",,";
+    }
+    std::cout << std::endl;
+}
+
+// Does a minimal amount of work, so we measure the event system itself
+static double TOTAL = 0;
+static void handler(core::EventPtr event)
+{
+    TOTAL += event->timeStamp;
+}
+
+// Publishes count events of the given type, returning the time taken
+static boost::int64_t publishLoop(core::EventPublisher* publisher,
+                                  const core::Event::EventType& type,
+                                  int count)
+{
+    // Warm up the caches and the subscriber lists
+    for (int i = 0; i < 1000; ++i)
+        publisher->publish(type, core::EventPtr(new core::Event()));
+
+    boost::int64_t start = now();
+    for (int i = 0; i < count; ++i)
+        publisher->publish(type, core::EventPtr(new core::Event()));
+    return now() - start;
+}
+
+static void disconnectAll(ConnectionList& connections)
+{
+    for (size_t i = 0; i < connections.size(); ++i)
+        connections[i]->disconnect();
+    connections.clear();
+}
+
+/** EventPublisher::publish throughput as the subscriber count grows */
+static void publisherSubscribers(int events)
+{
+    for (int subscribers = 0; subscribers <= 64;
+         subscribers = subscribers ? subscribers * 2 : 1)
+    {
+        core::EventPublisher publisher;
+        ConnectionList connections;
+        for (int i = 0; i < subscribers; ++i)
+        {
+            connections.push_back(publisher.subscribe(
+                "Type", boost::bind(&handler, _1)));
+        }
+
+        boost::int64_t elapsed = publishLoop(&publisher, "Type", events);
+        report("publisher_subscribers", "publish", subscribers, events,
+               elapsed);
+        disconnectAll(connections);
+    }
+}
+
+/** Cost of each of EventHub's internal publishers, alone and together
+ *
+ *  The hub keeps one publisher for subscribeToAll, one for subscribeToType
+ *  and one for subscribe(type, publisher), an event goes through all three.
+ *  Each variant gives every used publisher the same number of subscribers.
+ */
+static void hubFanout(int events)
+{
+    const char* variants[] = {"none", "all", "type", "sender",
+                              "all+type+sender"};
+    for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); ++v)
+    {
+        std::string variant(variants[v]);
+        for (int subscribers = 1; subscribers <= 16; subscribers *= 4)
+        {
+            core::EventHubPtr hub(new core::EventHub());
+            core::EventPublisher publisher(hub);
+            ConnectionList connections;
+
+            for (int i = 0; i < subscribers; ++i)
+            {
+                boost::function<void (core::EventPtr)> func =
+                    boost::bind(&handler, _1);
+                if (std::string::npos != variant.find("all"))
+                    connections.push_back(hub->subscribeToAll(func));
+                if (std::string::npos != variant.find("type"))
+                    connections.push_back(hub->subscribeToType("Type", func));
+                if (std::string::npos != variant.find("sender"))
+                {
+                    connections.push_back(
+                        hub->subscribe("Type", &publisher, func));
+                }
+            }
+
+            boost::int64_t elapsed = publishLoop(&publisher, "Type", events);
+            report("hub_fanout", variant, subscribers, events, elapsed);
+            disconnectAll(connections);
+        }
+    }
+}
+
+/** subscribeToType against subscribe(type, publisher)
+ *
+ *  Half of the subscribers of the "sender" variant listen to another
+ *  publisher, so the hub has to filter by sender for them.
+ */
+static void hubSubscription(int events)
+{
+    for (int subscribers = 1; subscribers <= 64; subscribers *= 4)
+    {
+        for (int sender = 0; sender < 2; ++sender)
+        {
+            core::EventHubPtr hub(new core::EventHub());
+            core::EventPublisher publisher(hub);
+            core::EventPublisher other(hub);
+            ConnectionList connections;
+
+            for (int i = 0; i < subscribers; ++i)
+            {
+                boost::function<void (core::EventPtr)> func =
+                    boost::bind(&handler, _1);
+                if (sender)
+                {
+                    core::EventPublisher* from = (i % 2) ? &other : &publisher;
+                    connections.push_back(hub->subscribe("Type", from, func));
+                }
+                else
+                {
+                    connections.push_back(hub->subscribeToType("Type", func));
+                }
+            }
+
+            boost::int64_t elapsed = publishLoop(&publisher, "Type", events);
+            report("hub_subscription", sender ? "sender" : "type",
+                   subscribers, events, elapsed);
+            disconnectAll(connections);
+        }
+    }
+}
+
+/** Carries the time it was published, in nanoseconds */
+struct StampedEvent : public core::Event
+{
+    StampedEvent(boost::int64_t stamp_) : stamp(stamp_) {}
+    boost::int64_t stamp;
+};
+
+typedef boost::shared_ptr<StampedEvent> StampedEventPtr;
+
+/** Records the latency of each event, and wakes up the publisher */
+struct LatencyReciever
+{
+    LatencyReciever() : recieved(false), stop(false) {}
+
+    void handler(core::EventPtr event)
+    {
+        StampedEventPtr stamped =
+            boost::dynamic_pointer_cast<StampedEvent>(event);
+        boost::mutex::scoped_lock lock(mutex);
+        if (stamped)
+            latency.record(now() - stamped->stamp);
+        recieved = true;
+        done.notify_one();
+    }
+
+    void waitForEvent()
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        while (!recieved)
+            done.wait(lock);
+        recieved = false;
+    }
+
+    // Runs the queue, like a QueuedEventHub in the main loop
+    void dispatchLoop(core::QueuedEventHubPtr queuedHub)
+    {
+        while (!stop)
+            queuedHub->waitAndPublishEvents();
+    }
+
+    boost::mutex mutex;
+    boost::condition done;
+    bool recieved;
+    volatile bool stop;
+    core::Histogram latency;
+};
+
+/** Time from EventPublisher::publish to the handler on a QueuedEventHub
+ *
+ *  The handler runs in a separate dispatch thread, one event is in flight at
+ *  a time so this is the latency of an idle system, wake up included.
+ */
+static void queuedHubLatency(int events)
+{
+    // Each event is a round trip between threads, so use fewer
+    int count = std::max(events / 10, 1);
+
+    core::EventHubPtr hub(new core::EventHub());
+    core::QueuedEventHubPtr queuedHub(new core::QueuedEventHub(hub));
+    core::EventPublisher publisher(hub);
+
+    LatencyReciever reciever;
+    core::EventConnectionPtr connection = queuedHub->subscribeToType(
+        "Type", boost::bind(&LatencyReciever::handler, &reciever, _1));
+    boost::thread dispatcher(boost::bind(&LatencyReciever::dispatchLoop,
+                                         &reciever, queuedHub));
+
+    // Warm up, then throw the results away
+    for (int i = 0; i < 100; ++i)
+    {
+        publisher.publish("Type", StampedEventPtr(new StampedEvent(now())));
+        reciever.waitForEvent();
+    }
+    reciever.latency.reset();
+
+    boost::int64_t start = now();
+    for (int i = 0; i < count; ++i)
+    {
+        publisher.publish("Type", StampedEventPtr(new StampedEvent(now())));
+        reciever.waitForEvent();
+    }
+    boost::int64_t elapsed = now() - start;
+    report("queued_hub_latency", "round_trip", 1, count, elapsed,
+           &reciever.latency);
+
+    // Wake up the dispatch thread so it can see it should stop
+    reciever.stop = true;
+    publisher.publish("Type", core::EventPtr(new core::Event()));
+    dispatcher.join();
+    connection->disconnect();
+}
+
+// Pushes count items once the barrier is released
+static void pushLoop(boost::barrier* barrier, core::ThreadedQueue<int>* queue,
+                     int count)
+{
+    barrier->wait();
+    for (int i = 0; i < count; ++i)
+        queue->push(i);
+}
+
+/** ThreadedQueue push/pop throughput with many producers, one consumer */
+static void threadedQueueContention(int events)
+{
+    for (int producers = 1; producers <= 8; producers *= 2)
+    {
+        core::ThreadedQueue<int> queue;
+        int perThread = events / producers;
+        int total = perThread * producers;
+
+        boost::barrier barrier(producers + 1);
+        std::vector<boost::thread*> threads;
+        for (int i = 0; i < producers; ++i)
+        {
+            threads.push_back(new boost::thread(
+                boost::bind(&pushLoop, &barrier, &queue, perThread)));
+        }
+
+        boost::int64_t start = now();
+        barrier.wait();
+        for (int i = 0; i < total; ++i)
+            queue.popWait();
+        boost::int64_t elapsed = now() - start;
+
+        for (int i = 0; i < producers; ++i)
+        {
+            threads[i]->join();
+            delete threads[i];
+        }
+
+        report("threaded_queue_contention", "push_pop", producers, total,
+               elapsed);
+    }
+}
+
+struct Benchmark
+{
+    const char* name;
+    void (*run)(int events);
+};
+
+/** Micro-benchmarks of the core event system
+ *
+ *  Results are written to standard out as CSV, one line per measurement, so
+ *  runs from different releases can be compared with a script.  The columns
+ *  are:
+ *
+ *    benchmark  - Which benchmark, see the list below
+ *    variant    - What is being compared within the benchmark
+ *    param      - Subscribers, or producer threads for the queue benchmark
+ *    operations - Events published, or items pushed and popped
+ *    seconds    - Wall clock time for all operations
+ *    ops_per_sec
+ *    p50_usec, p99_usec, max_usec - Latency, for latency benchmarks only
+ *
+ *  Usage: CoreBenchmark [events] [benchmark name]
+ */
+int main(int argc, char* argv[])
+{
+    Benchmark benchmarks[] = {
+        {"publisher_subscribers", &publisherSubscribers},
+        {"hub_fanout", &hubFanout},
+        {"hub_subscription", &hubSubscription},
+        {"queued_hub_latency", &queuedHubLatency},
+        {"threaded_queue_contention", &threadedQueueContention},
+    };
+    size_t benchmarkCount = sizeof(benchmarks) / sizeof(benchmarks[0]);
+
+    int events = 200000;
+    std::string only;
+    if (argc > 1)
+        events = atoi(argv[1]);
+    if (argc > 2)
+        only = argv[2];
+
+    std::cout << "benchmark,variant,param,operations,seconds,ops_per_sec,"
+              << "p50_usec,p99_usec,max_usec" << std::endl;
+
+    bool found = false;
+    for (size_t i = 0; i < benchmarkCount; ++i)
+    {
+        if (only.empty() || (only == benchmarks[i].name))
+        {
+            benchmarks[i].run(events);
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        std::cerr << "Unknown benchmark: " << only << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/EventAllocation.cpp
+ */
+
+// STD Includes
+#include <iostream>
+#include <cstdlib>
+#include <new>
+
+// Library Includes
+#include <boost/bind.hpp>
+
+// Project Includes
+#include "core/include/EventPool.h"
+#include "core/include/EventPublisher.h"
+#include "core/include/EventConnection.h"
+#include "core/include/Atomic.h"
+#include "core/include/TimeVal.h"
+
+using namespace ram;
+
+// Every trip to the heap made by the program
+static core::AtomicCounter ALLOCATIONS;
+
+// The default operator delete already frees memory from malloc
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+    ALLOCATIONS.increment();
+    void* memory = malloc(size ? size : 1);
+    if (!memory)
+        throw std::bad_alloc();
+    return memory;
+}
+
+// The same size as a math::Vector3Event, a typical high rate event
+struct VectorEvent : public core::Event
+{
+    double x, y, z;
+};
+
+typedef boost::shared_ptr<VectorEvent> VectorEventPtr;
+
+// A subscriber which just touches the event
+static double TOTAL = 0;
+static void handler(core::EventPtr event)
+{
+    TOTAL += event->timeStamp;
+}
+
+static VectorEventPtr heapEvent()
+{
+    return VectorEventPtr(new VectorEvent());
+}
+
+static VectorEventPtr pooledEvent()
+{
+    return core::EventPool<VectorEvent>::create();
+}
+
+// Creates and publishes count events, then prints the results
+static void run(const char* name, VectorEventPtr (*create)(),
+                core::EventPublisher* publisher, int count)
+{
+    // Warm up so pools and caches are in their steady state
+    for (int i = 0; i < 1000; ++i)
+        publisher->publish("Vector", create());
+
+    long startAllocations = ALLOCATIONS.get();
+    core::TimeVal start(core::TimeVal::timeOfDay());
+    for (int i = 0; i < count; ++i)
+    {
+        VectorEventPtr event = create();
+        event->x = i;
+        publisher->publish("Vector", event);
+    }
+    double seconds = (core::TimeVal::timeOfDay() - start).get_double();
+    long allocations = ALLOCATIONS.get() - startAllocations;
+
+    std::cout << name << " " << count << " " << seconds << " "
+              << (count / seconds) << " "
+              << ((double)allocations / count) << " "
+              << (allocations / seconds) << std::endl;
+}
+
+/** Compares heap allocated events against events from an EventPool
+ *
+ *  Each event is created and published to a single subscriber, like the
+ *  control and estimation loops do.  Allocations are counted by replacing the
+ *  global operator new.
+ *
+ *  Usage: EventAllocation [events]
+ */
+int main(int argc, char* argv[])
+{
+    int events = 1000000;
+    if (argc > 1)
+        events = atoi(argv[1]);
+
+    core::EventPublisher publisher;
+    core::EventConnectionPtr connection =
+        publisher.subscribe("Vector", boost::bind(&handler, _1));
+
+    std::cout << "method events seconds events/sec allocations/event "
+              << "allocations/sec" << std::endl;
+    run("heap", &heapEvent, &publisher, events);
+    run("pool", &pooledEvent, &publisher, events);
+
+    connection->disconnect();
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/PublishContention.cpp
+ */
+
+// STD Includes
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+// Library Includes
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Project Includes
+#include "core/include/EventPublisher.h"
+#include "core/include/EventConnection.h"
+#include "core/include/TimeVal.h"
+
+using namespace ram;
+
+// Publishes events as fast as possible once the barrier is released
+void publishLoop(boost::barrier* barrier, core::EventPublisher* publisher,
+                 int count)
+{
+    barrier->wait();
+
+    for (int i = 0; i < count; ++i)
+        publisher->publish("Type", core::EventPtr(new core::Event()));
+}
+
+// Does a small amount of work per event, like a typical handler
+struct Subscriber
+{
+    Subscriber() : calls(0), total(0) {}
+
+    void handler(core::EventPtr event)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        calls++;
+        total += event->timeStamp;
+    }
+
+    boost::mutex mutex;
+    long calls;
+    double total;
+};
+
+/** Stresses EventPublisher with many concurrent publishers and subscribers
+ *
+ *  All publishers publish the same event type, so before copy-on-write
+ *  subscriber lists they were all serialized on the same mutex.
+ *
+ *  Usage: PublishContention [publishers] [subscribers] [events]
+ */
+int main(int argc, char* argv[])
+{
+    int maxPublishers = 8;
+    int maxSubscribers = 16;
+    int events = 100000;
+    if (argc > 1)
+        maxPublishers = atoi(argv[1]);
+    if (argc > 2)
+        maxSubscribers = atoi(argv[2]);
+    if (argc > 3)
+        events = atoi(argv[3]);
+
+    std::cout << "publishers subscribers events seconds events/sec"
+              << std::endl;
+
+    for (int publishers = 1; publishers <= maxPublishers; publishers *= 2)
+    {
+        for (int subscribers = 1; subscribers <= maxSubscribers;
+             subscribers *= 2)
+        {
+            core::EventPublisher publisher;
+            std::vector<Subscriber*> recievers;
+            std::vector<core::EventConnectionPtr> connections;
+            for (int i = 0; i < subscribers; ++i)
+            {
+                Subscriber* subscriber = new Subscriber();
+                recievers.push_back(subscriber);
+                connections.push_back(publisher.subscribe("Type",
+                    boost::bind(&Subscriber::handler, subscriber, _1)));
+            }
+
+            // Start all the threads at once
+            int perThread = events / publishers;
+            boost::barrier barrier(publishers + 1);
+            std::vector<boost::thread*> threads;
+            for (int i = 0; i < publishers; ++i)
+            {
+                threads.push_back(new boost::thread(
+                    boost::bind(&publishLoop, &barrier, &publisher,
+                                perThread)));
+            }
+
+            core::TimeVal start(core::TimeVal::timeOfDay());
+            barrier.wait();
+            for (int i = 0; i < publishers; ++i)
+            {
+                threads[i]->join();
+                delete threads[i];
+            }
+            double seconds =
+                (core::TimeVal::timeOfDay() - start).get_double();
+
+            int published = perThread * publishers;
+            std::cout << publishers << " " << subscribers << " "
+                      << published << " " << seconds << " "
+                      << (published / seconds) << std::endl;
+
+            for (int i = 0; i < subscribers; ++i)
+            {
+                connections[i]->disconnect();
+                delete recievers[i];
+            }
+        }
+    }
+
+    return 0;
+}
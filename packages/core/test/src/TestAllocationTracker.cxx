@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestAllocationTracker.cxx
+ */
+
+// STD Includes
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "core/include/AllocationTracker.h"
+#include "core/include/Atomic.h"
+#include "core/include/TimeVal.h"
+
+using namespace ram;
+
+// Allocates, through a volatile so the compiler can't drop the pair
+static void allocate(size_t size)
+{
+    void* volatile memory = malloc(size);
+    free(memory);
+}
+
+// Makes two allocations on every update
+class Allocator : public core::Updatable
+{
+public:
+    virtual void update(double)
+    {
+        std::vector<int> values(10);
+        allocate(16);
+        updates.increment();
+    }
+
+    core::AtomicCounter updates;
+};
+
+SUITE(AllocationTracker) {
+
+// The tests link to the hooks
+TEST(HooksInstalled)
+{
+    CHECK(core::AllocationTracker::hooksInstalled());
+}
+
+TEST(Guard)
+{
+    CHECK_EQUAL(false, core::AllocationTracker::active());
+
+    size_t allocations = 0;
+    size_t bytes = 0;
+    {
+        core::AllocationTracker::NoAllocationGuard guard(false);
+        CHECK(core::AllocationTracker::active());
+
+        int* volatile value = new int(5);
+        delete value;
+        allocate(100);
+        allocations = guard.getAllocations();
+        bytes = guard.getBytes();
+    }
+    CHECK_EQUAL(false, core::AllocationTracker::active());
+    CHECK_EQUAL(2u, allocations);
+    CHECK_EQUAL(sizeof(int) + 100, bytes);
+}
+
+TEST(NoAllocations)
+{
+    volatile double total = 0;
+    size_t allocations = 1;
+    {
+        core::AllocationTracker::NoAllocationGuard guard(false);
+        for (int i = 0; i < 100; ++i)
+            total += i * 0.5;
+        allocations = guard.getAllocations();
+    }
+    CHECK_EQUAL(0u, allocations);
+    CHECK_EQUAL(2475.0, total);
+}
+
+TEST(Nested)
+{
+    size_t outerAllocations = 0;
+    size_t innerAllocations = 0;
+    {
+        core::AllocationTracker::NoAllocationGuard outer(false);
+        allocate(8);
+        {
+            core::AllocationTracker::NoAllocationGuard inner(false);
+            allocate(8);
+            innerAllocations = inner.getAllocations();
+        }
+        outerAllocations = outer.getAllocations();
+    }
+    CHECK_EQUAL(1u, innerAllocations);
+    CHECK_EQUAL(2u, outerAllocations);
+}
+
+TEST(Report)
+{
+    core::AllocationTracker tracker(core::ConfigNode::fromString("{}"));
+
+    Allocator allocator;
+    allocator.background(1);
+    while (allocator.updates.get() < 5)
+        core::TimeVal::sleep(0.001);
+    allocator.unbackground(true);
+
+    // Both the thread and the update are attributed
+    std::string report = core::AllocationTracker::report();
+    CHECK(std::string::npos != report.find("Allocations by thread:"));
+    CHECK(std::string::npos != report.find("(Allocator)"));
+    CHECK(std::string::npos != report.find("  Allocator: "));
+    CHECK(std::string::npos != report.find("(2.0 per update)"));
+}
+
+} // SUITE(AllocationTracker)
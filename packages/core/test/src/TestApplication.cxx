@@ -211,4 +211,28 @@ TEST(setAffinity)
     CHECK_EQUAL(1, subsystem->getAffinity());
 }
 
+TEST(ParallelStartup)
+{
+    bf::path path(getConfigRoot() / "parallelSubsystems.yml");
+    ram::core::Application app(path.string());
+
+    // Created a level at a time
+    std::vector<std::string> expected = ba::list_of("Manager")("Servant2")
+        ("Servant1")("SubServant");
+    CHECK(expected == app.getSubsystemNames());
+
+    MockSubsystem* subServant =
+        dynamic_cast<MockSubsystem*>(app.getSubsystem("SubServant").get());
+    ram::core::SubsystemList expectedDeps =
+        ba::list_of(app.getSubsystem("Servant1"))(app.getSubsystem("Servant2"));
+    CHECK(subServant);
+    CHECK(expectedDeps == subServant->dependents);
+
+    BOOST_FOREACH(std::string name, app.getSubsystemNames())
+    {
+        CHECK(app.getStartupTime(name) >= 0);
+    }
+    CHECK_EQUAL(0, app.getStartupTime("NotASubsystem"));
+}
+
 } // SUITE(Application)
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestAsyncDelivery.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/pointer_cast.hpp>
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/EventHub.h"
+#include "core/include/EventPublisher.h"
+#include "core/include/AsyncDelivery.h"
+#include "core/include/TimeVal.h"
+#include "core/test/include/Reciever.h"
+
+using namespace ram;
+
+/** Records the thread each event arrives on, after a delay */
+struct DelayedReciever
+{
+    DelayedReciever(int delayMs) : delay(delayMs), calls(0) {}
+
+    void handler(core::EventPtr)
+    {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(delay));
+        boost::mutex::scoped_lock lock(mutex);
+        threads.push_back(boost::this_thread::get_id());
+        ++calls;
+    }
+
+    int getCalls()
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        return calls;
+    }
+
+    /** Waits up to a second for the given number of calls */
+    bool waitForCalls(int count)
+    {
+        for (int i = 0; i < 100 && (getCalls() < count); ++i)
+            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        return getCalls() >= count;
+    }
+
+    int delay;
+    int calls;
+    std::vector<boost::thread::id> threads;
+    boost::mutex mutex;
+};
+
+struct AsyncDeliveryFixture
+{
+    AsyncDeliveryFixture() :
+        eventHub(new core::EventHub()),
+        publisher(eventHub)
+    {}
+
+    void publish(int count)
+    {
+        for (int i = 0; i < count; ++i)
+            publisher.publish("Type", core::EventPtr(new core::Event()));
+    }
+
+    static core::AsyncDeliveryPtr getDelivery(
+        core::EventConnectionPtr connection)
+    {
+        return boost::dynamic_pointer_cast<core::AsyncEventConnection>(
+            connection)->getDelivery();
+    }
+
+    core::EventHubPtr eventHub;
+    core::EventPublisher publisher;
+};
+
+SUITE(AsyncDelivery) {
+
+TEST_FIXTURE(AsyncDeliveryFixture, manual)
+{
+    Reciever recv;
+    core::EventConnectionPtr connection = eventHub->subscribeToType(
+        "Type", boost::bind(&Reciever::handler, &recv, _1),
+        core::AsyncDelivery::Options(core::AsyncDelivery::MANUAL_EXECUTOR));
+    core::AsyncDeliveryPtr delivery = getDelivery(connection);
+
+    // Nothing happens until the subscriber asks for the events
+    publish(3);
+    CHECK_EQUAL(0, recv.calls);
+    CHECK_EQUAL(3u, delivery->getQueuedCount());
+
+    delivery->update(0);
+    CHECK_EQUAL(3, recv.calls);
+    CHECK_EQUAL(3u, delivery->getDeliveredCount());
+    CHECK_EQUAL(0u, delivery->getQueuedCount());
+    CHECK_EQUAL(3, delivery->getLag().getCount());
+
+    connection->disconnect();
+}
+
+TEST_FIXTURE(AsyncDeliveryFixture, manualStop)
+{
+    DelayedReciever recv(50);
+    core::EventConnectionPtr connection = eventHub->subscribeToType(
+        "Type", boost::bind(&DelayedReciever::handler, &recv, _1),
+        core::AsyncDelivery::Options(core::AsyncDelivery::MANUAL_EXECUTOR));
+    core::AsyncDeliveryPtr delivery = getDelivery(connection);
+
+    // The subscriber delivers on its own thread while we disconnect
+    publish(1);
+    boost::thread updater(boost::bind(&core::AsyncDelivery::update,
+                                      delivery.get(), 0.0));
+
+    // The lag is recorded right before the handler is called
+    for (int i = 0; (i < 1000) && (0 == delivery->getLag().getCount()); ++i)
+        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+
+    // Only returns once the handler in progress has finished
+    connection->disconnect();
+    CHECK_EQUAL(1, recv.getCalls());
+    updater.join();
+}
+
+TEST_FIXTURE(AsyncDeliveryFixture, overflow)
+{
+    Reciever recv;
+    core::EventConnectionPtr connection = eventHub->subscribeToAll(
+        boost::bind(&Reciever::handler, &recv, _1),
+        core::AsyncDelivery::Options(core::AsyncDelivery::MANUAL_EXECUTOR, 2,
+                                     core::BoundedQueueBase::DROP_OLDEST));
+    core::AsyncDeliveryPtr delivery = getDelivery(connection);
+
+    core::EventPtr last(new core::Event());
+    publish(4);
+    publisher.publish("Type", last);
+
+    // Only the newest events are left
+    delivery->update(0);
+    CHECK_EQUAL(2, recv.calls);
+    CHECK_EQUAL(3u, delivery->getDroppedCount());
+    if (2 == recv.calls)
+        CHECK_EQUAL(last, recv.events[1]);
+
+    connection->disconnect();
+}
+
+TEST_FIXTURE(AsyncDeliveryFixture, thread)
+{
+    DelayedReciever recv(20);
+    core::EventConnectionPtr connection = eventHub->subscribe(
+        "Type", &publisher, boost::bind(&DelayedReciever::handler, &recv, _1),
+        core::AsyncDelivery::Options(core::AsyncDelivery::THREAD_EXECUTOR));
+
+    // The publisher doesn't wait for the handler
+    core::TimeVal start(core::TimeVal::monotonic());
+    publish(5);
+    double elapsed = (core::TimeVal::monotonic() - start).get_double();
+    CHECK(elapsed < 0.05);
+
+    CHECK(recv.waitForCalls(5));
+    connection->disconnect();
+
+    // All on the delivery thread
+    CHECK_EQUAL(5u, recv.threads.size());
+    for (size_t i = 0; i < recv.threads.size(); ++i)
+    {
+        CHECK(boost::this_thread::get_id() != recv.threads[i]);
+        CHECK(recv.threads[0] == recv.threads[i]);
+    }
+}
+
+TEST_FIXTURE(AsyncDeliveryFixture, pool)
+{
+    DelayedReciever recv(0);
+    core::AsyncDelivery::Options options(core::AsyncDelivery::POOL_EXECUTOR);
+    options.interval = 5;
+    core::EventConnectionPtr connection = eventHub->subscribeToType(
+        "Type", boost::bind(&DelayedReciever::handler, &recv, _1), options);
+
+    publish(3);
+    CHECK(recv.waitForCalls(3));
+    connection->disconnect();
+}
+
+TEST_FIXTURE(AsyncDeliveryFixture, disconnect)
+{
+    DelayedReciever recv(20);
+    core::EventConnectionPtr connection = eventHub->subscribeToType(
+        "Type", boost::bind(&DelayedReciever::handler, &recv, _1),
+        core::AsyncDelivery::Options(core::AsyncDelivery::THREAD_EXECUTOR));
+
+    // Queued events are dropped, and nothing is called after disconnect
+    publish(10);
+    connection->disconnect();
+    int calls = recv.getCalls();
+    CHECK(calls < 10);
+    CHECK(!connection->connected());
+
+    publish(1);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+    CHECK_EQUAL(calls, recv.getCalls());
+}
+
+} // SUITE(AsyncDelivery)
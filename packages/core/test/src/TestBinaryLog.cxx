@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestBinaryLog.cxx
+ */
+
+// STD Includes
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/BinaryLog.h"
+#include "core/include/Logging.h"
+
+using namespace ram;
+
+static core::BinaryLogger& BLOGGER(
+    core::BinaryLogger::getInstance("TestBinaryLog"));
+
+static const std::string LOG_NAME("TestBinaryLog.log");
+
+struct BinaryLogFixture
+{
+    BinaryLogFixture() :
+        logPath((core::Logging::getLogDir() / LOG_NAME).string()),
+        config(core::ConfigNode::fromString(
+                   "{ 'fileName' : '" + LOG_NAME + "' }"))
+    {
+        BLOGGER.setPriority(log4cpp::Priority::INFO);
+    }
+
+    ~BinaryLogFixture()
+    {
+        std::remove(logPath.c_str());
+    }
+
+    std::vector<core::BinaryLogEntry> readLog()
+    {
+        boost::int64_t startTime = 0;
+        std::vector<core::BinaryLogEntry> entries;
+        CHECK(core::BinaryLog::readFile(logPath, startTime, entries));
+        return entries;
+    }
+
+    std::string logPath;
+    core::ConfigNode config;
+};
+
+static void logLoop(int thread, int count)
+{
+    for (int i = 0; i < count; ++i)
+        RAM_CORE_BLOG_INFO(BLOGGER) << thread << i;
+}
+
+SUITE(BinaryLog) {
+
+TEST(Disabled)
+{
+    BLOGGER.setPriority(log4cpp::Priority::WARN);
+    CHECK(!BLOGGER.isEnabledFor(log4cpp::Priority::INFO));
+    CHECK(BLOGGER.isEnabledFor(log4cpp::Priority::ERROR));
+
+    // Nothing after the macro is evaluated
+    bool evaluated = false;
+    RAM_CORE_BLOG_INFO(BLOGGER) << (evaluated = true);
+    CHECK(!evaluated);
+}
+
+TEST_FIXTURE(BinaryLogFixture, Fields)
+{
+    core::BinaryLog binaryLog(config);
+    CHECK(BLOGGER.isEnabledFor(log4cpp::Priority::INFO));
+
+    std::string str("str");
+    RAM_CORE_BLOG_INFO(BLOGGER) << 1 << -2.5 << "abc" << str << 'x' << true
+                                << 7u << 8L << 9ul << 0.25f;
+    binaryLog.update(0);
+
+    std::vector<core::BinaryLogEntry> entries = readLog();
+    CHECK_EQUAL(1u, entries.size());
+    if (1 == entries.size())
+    {
+        CHECK_EQUAL("TestBinaryLog", entries[0].category);
+        CHECK_EQUAL(log4cpp::Priority::INFO, entries[0].priority);
+        CHECK_EQUAL("1 -2.5 abc str x 1 7 8 9 0.25", entries[0].message);
+    }
+}
+
+TEST_FIXTURE(BinaryLogFixture, Format)
+{
+    core::BinaryLog binaryLog(config);
+
+    RAM_CORE_BLOG_INFO(BLOGGER).format("%5.2f %03d%% %ld %s %c %x")
+        << 1.125 << 7 << 8L << "abc" << 'x' << 255u;
+    // Missing fields leave the rest of the format as is
+    RAM_CORE_BLOG_INFO(BLOGGER).format("%d %d") << 1;
+    binaryLog.update(0);
+
+    std::vector<core::BinaryLogEntry> entries = readLog();
+    CHECK_EQUAL(2u, entries.size());
+    if (2 == entries.size())
+    {
+        CHECK_EQUAL(" 1.12 007% 8 abc x ff", entries[0].message);
+        CHECK_EQUAL("1 %d", entries[1].message);
+    }
+}
+
+TEST_FIXTURE(BinaryLogFixture, Priority)
+{
+    core::BinaryLog binaryLog(config);
+    BLOGGER.setPriority(log4cpp::Priority::WARN);
+
+    RAM_CORE_BLOG_DEBUG(BLOGGER) << 1;
+    RAM_CORE_BLOG_INFO(BLOGGER) << 2;
+    RAM_CORE_BLOG_WARN(BLOGGER) << 3;
+    RAM_CORE_BLOG_ERROR(BLOGGER) << 4;
+    binaryLog.update(0);
+
+    std::vector<core::BinaryLogEntry> entries = readLog();
+    CHECK_EQUAL(2u, entries.size());
+    if (2 == entries.size())
+    {
+        CHECK_EQUAL("3", entries[0].message);
+        CHECK_EQUAL("4", entries[1].message);
+    }
+}
+
+TEST_FIXTURE(BinaryLogFixture, LongString)
+{
+    core::BinaryLog binaryLog(config);
+
+    // Cut off at the record size
+    std::string longString(2 * core::BinaryLogRecord::MAX_SIZE, 'a');
+    RAM_CORE_BLOG_INFO(BLOGGER) << longString << 5;
+    binaryLog.update(0);
+
+    std::vector<core::BinaryLogEntry> entries = readLog();
+    CHECK_EQUAL(1u, entries.size());
+    if (1 == entries.size())
+    {
+        CHECK_EQUAL(core::BinaryLogRecord::MAX_SIZE -
+                    core::BinaryLogRecord::HEADER_SIZE - 3,
+                    entries[0].message.size());
+    }
+}
+
+TEST_FIXTURE(BinaryLogFixture, Threads)
+{
+    core::BinaryLog binaryLog(config);
+    boost::int64_t dropped = core::BinaryLog::getDroppedCount();
+
+    const int THREADS = 4;
+    const int COUNT = 1000;
+    std::vector<boost::thread*> threads;
+    for (int i = 0; i < THREADS; ++i)
+        threads.push_back(new boost::thread(boost::bind(&logLoop, i, COUNT)));
+    for (int i = 0; i < THREADS; ++i)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+    binaryLog.update(0);
+
+    std::vector<core::BinaryLogEntry> entries = readLog();
+    CHECK_EQUAL(THREADS * COUNT, (int)entries.size());
+    CHECK_EQUAL(dropped, core::BinaryLog::getDroppedCount());
+
+    // Merged in time order, with each thread's records in order
+    std::vector<int> next(THREADS, 0);
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        if (i > 0)
+            CHECK(entries[i - 1].time <= entries[i].time);
+
+        int thread = -1;
+        int count = -1;
+        sscanf(entries[i].message.c_str(), "%d %d", &thread, &count);
+        CHECK(thread >= 0 && thread < THREADS);
+        if (thread >= 0 && thread < THREADS)
+        {
+            CHECK_EQUAL(next[thread], count);
+            next[thread] = count + 1;
+        }
+    }
+}
+
+TEST_FIXTURE(BinaryLogFixture, Overflow)
+{
+    core::BinaryLog binaryLog(config);
+    boost::int64_t dropped = core::BinaryLog::getDroppedCount();
+
+    // Far more than fits in the ring before it is drained
+    const int COUNT = 100000;
+    logLoop(0, COUNT);
+    boost::int64_t newlyDropped = core::BinaryLog::getDroppedCount() - dropped;
+    CHECK(newlyDropped > 0);
+    binaryLog.update(0);
+
+    std::vector<core::BinaryLogEntry> entries = readLog();
+    CHECK_EQUAL(COUNT, (int)(entries.size() + newlyDropped));
+}
+
+} // SUITE(BinaryLog)
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestBoundedQueue.cxx
+ */
+
+// STD Includes
+#include <vector>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/scoped_ptr.hpp>
+
+// Project Includes
+#include "core/include/BoundedQueue.h"
+#include "core/include/QueueFactory.h"
+#include "core/include/ConfigNode.h"
+#include "core/include/TimeVal.h"
+
+using namespace ram;
+
+typedef core::BoundedQueue<int> IntQueue;
+
+// Pushes count values, starting at start, into the queue
+static void pushLoop(IntQueue* queue, int start, int count)
+{
+    for (int i = start; i < (start + count); ++i)
+        queue->push(i);
+}
+
+SUITE(BoundedQueue) {
+
+TEST(Capacity)
+{
+    IntQueue queue(5);
+    CHECK_EQUAL(8u, queue.capacity());
+    CHECK_EQUAL(0u, queue.size());
+
+    IntQueue queue2(16);
+    CHECK_EQUAL(16u, queue2.capacity());
+}
+
+TEST(PushPop)
+{
+    IntQueue queue(4);
+    int value = -1;
+    CHECK_EQUAL(false, queue.popNoWait(value));
+    CHECK_EQUAL(-1, value);
+
+    CHECK(queue.push(1));
+    CHECK(queue.push(2));
+    CHECK_EQUAL(2u, queue.size());
+
+    CHECK(queue.popNoWait(value));
+    CHECK_EQUAL(1, value);
+    CHECK_EQUAL(2, queue.popWait());
+    CHECK_EQUAL(false, queue.popNoWait(value));
+
+    // Wrap around the ring a few times
+    for (int i = 0; i < 20; ++i)
+    {
+        CHECK(queue.push(i));
+        CHECK(queue.popNoWait(value));
+        CHECK_EQUAL(i, value);
+    }
+}
+
+TEST(DropNewest)
+{
+    IntQueue queue(4, IntQueue::DROP_NEWEST);
+    for (int i = 0; i < 4; ++i)
+        CHECK(queue.push(i));
+    CHECK_EQUAL(false, queue.push(4));
+    CHECK_EQUAL(false, queue.push(5));
+    CHECK_EQUAL(2u, queue.getDroppedNewest());
+    CHECK_EQUAL(0u, queue.getDroppedOldest());
+
+    // The original items are all still there
+    std::vector<int> items;
+    CHECK_EQUAL(4u, queue.popAll(items));
+    CHECK_EQUAL(4u, items.size());
+    for (int i = 0; i < 4; ++i)
+        CHECK_EQUAL(i, items[i]);
+}
+
+TEST(DropOldest)
+{
+    IntQueue queue(4, IntQueue::DROP_OLDEST);
+    for (int i = 0; i < 7; ++i)
+        CHECK(queue.push(i));
+    CHECK_EQUAL(3u, queue.getDroppedOldest());
+    CHECK_EQUAL(0u, queue.getDroppedNewest());
+
+    // Only the newest items remain
+    std::vector<int> items;
+    CHECK_EQUAL(4u, queue.popAll(items));
+    for (int i = 0; i < 4; ++i)
+        CHECK_EQUAL(i + 3, items[i]);
+}
+
+TEST(SingleProducer)
+{
+    IntQueue queue(4, IntQueue::DROP_OLDEST, IntQueue::SINGLE_PRODUCER);
+    for (int i = 0; i < 6; ++i)
+        CHECK(queue.push(i));
+
+    int value = 0;
+    CHECK(queue.popNoWait(value));
+    CHECK_EQUAL(2, value);
+}
+
+TEST(Block)
+{
+    IntQueue queue(2, IntQueue::BLOCK);
+    queue.push(0);
+    queue.push(1);
+
+    // This thread will block until we pop
+    boost::thread producer(boost::bind(&pushLoop, &queue, 2, 3));
+
+    std::vector<int> items;
+    while (items.size() < 5)
+        items.push_back(queue.popWait());
+    producer.join();
+
+    for (int i = 0; i < 5; ++i)
+        CHECK_EQUAL(i, items[i]);
+    CHECK(queue.getBlockedPushes() > 0);
+}
+
+TEST(PopTimedWait)
+{
+    IntQueue queue(4);
+    int value = 0;
+
+    // Times out on the empty queue
+    boost::xtime wait = {0, 10000000}; // 10 milliseconds
+    core::TimeVal start(core::TimeVal::timeOfDay());
+    CHECK_EQUAL(false, queue.popTimedWait(wait, value));
+    CHECK((core::TimeVal::timeOfDay() - start).get_double() >= 0.009);
+
+    queue.push(5);
+    CHECK(queue.popTimedWait(wait, value));
+    CHECK_EQUAL(5, value);
+}
+
+TEST(MultipleProducers)
+{
+    const int PRODUCERS = 4;
+    const int COUNT = 20000;
+    IntQueue queue(64, IntQueue::BLOCK);
+
+    std::vector<boost::thread*> threads;
+    for (int i = 0; i < PRODUCERS; ++i)
+    {
+        threads.push_back(new boost::thread(
+            boost::bind(&pushLoop, &queue, i * COUNT, COUNT)));
+    }
+
+    // Every item must come out exactly once, and in order per producer
+    std::vector<int> last(PRODUCERS, -1);
+    bool ordered = true;
+    for (int i = 0; i < (PRODUCERS * COUNT); ++i)
+    {
+        int value = queue.popWait();
+        int producer = value / COUNT;
+        ordered = ordered && (value > last[producer]);
+        last[producer] = value;
+    }
+    CHECK(ordered);
+
+    for (int i = 0; i < PRODUCERS; ++i)
+    {
+        threads[i]->join();
+        delete threads[i];
+        CHECK_EQUAL((i + 1) * COUNT - 1, last[i]);
+    }
+    CHECK_EQUAL(0u, queue.size());
+}
+
+TEST(MakeQueue)
+{
+    // No config gives the old unbounded queue
+    boost::scoped_ptr<core::IQueue<int> > queue(
+        core::makeQueue<int>(core::ConfigNode::fromString("{}")));
+    CHECK(dynamic_cast<core::ThreadedQueue<int>*>(queue.get()));
+
+    queue.reset(core::makeQueue<int>(core::ConfigNode::fromString(
+        "{ 'capacity' : 10, 'overflow' : 'dropNewest' }")));
+    IntQueue* bounded = dynamic_cast<IntQueue*>(queue.get());
+    CHECK(bounded);
+    if (bounded)
+    {
+        CHECK_EQUAL(16u, bounded->capacity());
+        CHECK_EQUAL(IntQueue::DROP_NEWEST, bounded->getOverflowPolicy());
+    }
+}
+
+} // SUITE(BoundedQueue)
+
+SUITE(ThreadedQueue) {
+
+TEST(PopAll)
+{
+    core::ThreadedQueue<int> queue;
+    std::vector<int> items;
+    CHECK_EQUAL(0u, queue.popAll(items));
+
+    queue.push(1);
+    queue.push(2);
+    CHECK_EQUAL(2u, queue.popAll(items));
+    CHECK_EQUAL(2u, items.size());
+    CHECK_EQUAL(1, items[0]);
+    CHECK_EQUAL(2, items[1]);
+
+    int value;
+    CHECK_EQUAL(false, queue.popNoWait(value));
+}
+
+} // SUITE(ThreadedQueue)
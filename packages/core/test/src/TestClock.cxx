@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestClock.cxx
+ */
+
+// STD Includes
+#include <utility>
+#include <vector>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/Clock.h"
+#include "core/include/LockstepScheduler.h"
+#include "core/include/Updatable.h"
+#include "core/include/TimeVal.h"
+
+using namespace ram;
+
+typedef boost::int64_t Usec;
+typedef std::vector<std::pair<int, Usec> > UpdateLog;
+
+// Puts every test on the virtual clock, and back on the real one after
+struct VirtualClockFixture
+{
+    VirtualClockFixture()
+    {
+        core::Clock::setMode(core::Clock::VIRTUAL);
+        start = core::Clock::monotonicUsec();
+    }
+
+    ~VirtualClockFixture()
+    {
+        core::Clock::setMode(core::Clock::REAL_TIME);
+    }
+
+    Usec start;
+};
+
+// Records its id and the clock time of every update in a shared log
+class Recorder : public core::Updatable
+{
+public:
+    Recorder(int id, Usec start, boost::mutex& mutex, UpdateLog& log) :
+        m_id(id), m_start(start), m_mutex(mutex), m_log(log)
+    {
+    }
+
+    ~Recorder()
+    {
+        unbackground(true);
+    }
+
+    virtual void update(double)
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_log.push_back(std::make_pair(
+                            m_id, core::Clock::monotonicUsec() - m_start));
+    }
+
+private:
+    int m_id;
+    Usec m_start;
+    boost::mutex& m_mutex;
+    UpdateLog& m_log;
+};
+
+static void sleepFor(double seconds, Usec* wokeAt)
+{
+    core::Clock::sleep(seconds);
+    *wokeAt = core::Clock::monotonicUsec();
+}
+
+SUITE(Clock) {
+
+TEST(ModeString)
+{
+    CHECK_EQUAL(core::Clock::REAL_TIME, core::Clock::stringToMode("real"));
+    CHECK_EQUAL(core::Clock::VIRTUAL, core::Clock::stringToMode("Virtual"));
+    CHECK(!core::Clock::isVirtual());
+}
+
+TEST_FIXTURE(VirtualClockFixture, StandsStill)
+{
+    core::TimeVal before = core::TimeVal::timeOfDay();
+    boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+
+    CHECK_EQUAL(start, core::Clock::monotonicUsec());
+    core::TimeVal after = core::TimeVal::timeOfDay();
+    CHECK_EQUAL(before.seconds(), after.seconds());
+    CHECK_EQUAL(before.microseconds(), after.microseconds());
+
+    // Only forward
+    core::Clock::advanceTo(start + 5000);
+    core::Clock::advanceTo(start);
+    CHECK_EQUAL(start + 5000, core::Clock::monotonicUsec());
+}
+
+TEST_FIXTURE(VirtualClockFixture, SleepUntilAdvanced)
+{
+    Usec wokeAt = 0;
+    boost::thread sleeper(boost::bind(sleepFor, 1.0, &wokeAt));
+
+    // Wait for it to go to sleep, then jump the whole second
+    while (-1 == core::Clock::getNextWakeup())
+        boost::this_thread::yield();
+    CHECK_EQUAL(start + 1000000, core::Clock::getNextWakeup());
+
+    core::Clock::advanceTo(start + 1000000);
+    sleeper.join();
+    CHECK_EQUAL(start + 1000000, wokeAt);
+    CHECK_EQUAL(-1, core::Clock::getNextWakeup());
+}
+
+TEST_FIXTURE(VirtualClockFixture, LockstepOrder)
+{
+    boost::mutex mutex;
+    UpdateLog log;
+    Recorder fast(1, start, mutex, log);
+    Recorder medium(2, start, mutex, log);
+    Recorder slow(3, start, mutex, log);
+
+    core::TimeVal realStart = core::Clock::realMonotonic();
+    fast.background(10);
+    medium.background(20);
+    slow.background(30);
+    CHECK(core::LockstepScheduler::getInstance()->scheduled(&fast));
+
+    // Ten virtual seconds, far quicker than real time
+    core::Clock::sleep(10.005);
+    fast.unbackground(true);
+    medium.unbackground(true);
+    slow.unbackground(true);
+    CHECK(!core::LockstepScheduler::getInstance()->scheduled(&fast));
+    CHECK((core::Clock::realMonotonic() - realStart).get_double() < 5);
+
+    // Every update on time, ties go in the order they were backgrounded
+    boost::mutex::scoped_lock lock(mutex);
+    size_t i = 0;
+    for (Usec now = 10000; now <= 10000000; now += 10000)
+    {
+        for (int id = 1; id <= 3; ++id)
+        {
+            if (0 != (now % (id * 10000)))
+                continue;
+
+            CHECK(i < log.size());
+            if (i >= log.size())
+                return;
+            CHECK_EQUAL(id, log[i].first);
+            CHECK_EQUAL(now, log[i].second);
+            ++i;
+        }
+    }
+}
+
+TEST_FIXTURE(VirtualClockFixture, TimeVal)
+{
+    // Everything built on TimeVal follows the virtual clock
+    core::TimeVal before = core::TimeVal::monotonic();
+    core::Clock::advanceTo(start + 2500000);
+    CHECK_CLOSE(2.5, (core::TimeVal::monotonic() - before).get_double(),
+                1e-6);
+}
+
+} // SUITE(Clock)
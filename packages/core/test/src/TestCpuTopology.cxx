@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestCpuTopology.cxx
+ */
+
+// STD Includes
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/filesystem.hpp>
+
+// Project Includes
+#include "core/include/CpuTopology.h"
+
+using namespace ram;
+namespace bfs = boost::filesystem;
+
+static void writeFile(const bfs::path& path, const std::string& contents)
+{
+    bfs::create_directories(path.branch_path());
+    std::ofstream file(path.string().c_str());
+    file << contents << std::endl;
+}
+
+// A fake sysfs cpu directory, removed when done
+struct SysfsFixture
+{
+    SysfsFixture() :
+        root(bfs::path("test_sysfs_cpu"))
+    {
+        bfs::remove_all(root);
+    }
+
+    ~SysfsFixture()
+    {
+        bfs::remove_all(root);
+    }
+
+    /** Adds a CPU with the given core */
+    void addCpu(int id, int core)
+    {
+        std::stringstream ss;
+        ss << "cpu" << id;
+        bfs::path topology = root / ss.str() / "topology";
+
+        std::stringstream coreId;
+        coreId << core;
+        writeFile(topology / "core_id", coreId.str());
+        writeFile(topology / "physical_package_id", "0");
+    }
+
+    bfs::path root;
+};
+
+SUITE(CpuTopology) {
+
+TEST(ParseCpuList)
+{
+    std::vector<int> cpus = core::CpuTopology::parseCpuList("0-2,5,7-8");
+    CHECK_EQUAL(6u, cpus.size());
+    if (6u == cpus.size())
+    {
+        CHECK_EQUAL(0, cpus[0]);
+        CHECK_EQUAL(2, cpus[2]);
+        CHECK_EQUAL(5, cpus[3]);
+        CHECK_EQUAL(8, cpus[5]);
+    }
+
+    CHECK(core::CpuTopology::parseCpuList("").empty());
+    CHECK(core::CpuTopology::parseCpuList("\n").empty());
+}
+
+TEST(Siblings)
+{
+    // Two cores with two threads each, numbered like Intel does
+    std::vector<core::CpuInfo> cpus;
+    cpus.push_back(core::CpuInfo(0, 0, 0));
+    cpus.push_back(core::CpuInfo(1, 0, 1));
+    cpus.push_back(core::CpuInfo(2, 0, 0));
+    cpus.push_back(core::CpuInfo(3, 0, 1, true));
+    core::CpuTopology topology(cpus);
+
+    CHECK_EQUAL(2u, topology.getCores().size());
+    CHECK_EQUAL(0, topology.getCoreOf(2));
+    CHECK_EQUAL(1, topology.getCoreOf(1));
+    CHECK_EQUAL(-1, topology.getCoreOf(4));
+    CHECK(!topology.isCoreIsolated(0));
+    CHECK(topology.isCoreIsolated(1));
+}
+
+TEST_FIXTURE(SysfsFixture, FromSysfs)
+{
+    writeFile(root / "online", "0-3");
+    writeFile(root / "isolated", "3");
+    addCpu(0, 0);
+    addCpu(1, 1);
+    addCpu(2, 0);
+    addCpu(3, 1);
+
+    core::CpuTopology topology =
+        core::CpuTopology::fromSysfs(root.string());
+    CHECK_EQUAL(4u, topology.getCpus().size());
+    CHECK_EQUAL(2u, topology.getCores().size());
+    CHECK_EQUAL(topology.getCoreOf(1), topology.getCoreOf(3));
+    CHECK(topology.getCpus()[3].isolated);
+    CHECK(!topology.getCpus()[2].isolated);
+}
+
+TEST_FIXTURE(SysfsFixture, Missing)
+{
+    // Every CPU is a core of its own
+    core::CpuTopology topology =
+        core::CpuTopology::fromSysfs(root.string());
+    CHECK(topology.getCpus().size() > 0);
+    CHECK_EQUAL(topology.getCpus().size(), topology.getCores().size());
+}
+
+} // SUITE(CpuTopology)
@@ -88,3 +88,24 @@ TEST(writeDependencyGraph)
 
     CHECK_EQUAL(expected, ss.str());
 }
+
+TEST(getLevels)
+{
+    bf::path path(getConfigRoot() / "subsystems.yml");
+    ram::core::ConfigNode config(
+        ram::core::ConfigNode::fromFile(path.string()));
+    ram::core::ConfigNode sysCfg(config["Subsystems"]);
+    ram::core::DependencyGraph depGraph(sysCfg);
+
+    std::vector<std::vector<std::string> > levels = depGraph.getLevels();
+    CHECK_EQUAL(3u, levels.size());
+
+    std::vector<std::string> expected = ba::list_of("Manager");
+    CHECK(expected == levels[0]);
+
+    expected = ba::list_of("Servant2")("Servant1");
+    CHECK(expected == levels[1]);
+
+    expected = ba::list_of("SubServant");
+    CHECK(expected == levels[2]);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestEventPool.cxx
+ */
+
+// STD Includes
+#include <vector>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/EventPool.h"
+#include "core/include/Event.h"
+
+using namespace ram;
+
+// Counts how many are alive, so we can check they are destroyed
+struct CountedEvent : public core::Event
+{
+    CountedEvent() : value(0) { alive++; }
+    CountedEvent(int value_) : value(value_) { alive++; }
+    virtual ~CountedEvent() { alive--; }
+
+    int value;
+    static int alive;
+};
+
+int CountedEvent::alive = 0;
+
+// A size which no other test uses, so its pool starts empty
+struct PaddedEvent : public core::Event
+{
+    char padding[1000];
+};
+
+// Creates and releases events as fast as possible
+static void createLoop(int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        boost::shared_ptr<CountedEvent> event =
+            core::EventPool<CountedEvent>::create(i);
+        event->value++;
+    }
+}
+
+SUITE(EventPool) {
+
+TEST(BlockPool)
+{
+    core::BlockPool pool(16, 2);
+    CHECK_EQUAL(16u, pool.getBlockSize());
+
+    void* first = pool.allocate();
+    void* second = pool.allocate();
+    void* third = pool.allocate();
+    CHECK_EQUAL(3u, pool.getHeapAllocations());
+    CHECK_EQUAL(0u, pool.getReuses());
+
+    // Only two blocks are kept, the third goes back to the heap
+    pool.deallocate(first);
+    pool.deallocate(second);
+    pool.deallocate(third);
+
+    void* block = pool.allocate();
+    CHECK(block == first);
+    pool.deallocate(block);
+    CHECK_EQUAL(1u, pool.getReuses());
+    CHECK_EQUAL(3u, pool.getHeapAllocations());
+}
+
+TEST(SharedPool)
+{
+    CHECK(core::BlockPool::getPool(24) == core::BlockPool::getPool(24));
+    CHECK(core::BlockPool::getPool(24) != core::BlockPool::getPool(32));
+    CHECK_EQUAL(24u, core::BlockPool::getPool(24)->getBlockSize());
+}
+
+TEST(CreateDestroy)
+{
+    int alive = CountedEvent::alive;
+    {
+        boost::shared_ptr<CountedEvent> event =
+            core::EventPool<CountedEvent>::create(5);
+        CHECK_EQUAL(5, event->value);
+        CHECK_EQUAL(alive + 1, CountedEvent::alive);
+
+        // The event outlives the original pointer as a normal event
+        core::EventPtr base = event;
+        event = core::EventPool<CountedEvent>::create();
+        CHECK_EQUAL(0, event->value);
+        CHECK_EQUAL(alive + 2, CountedEvent::alive);
+    }
+    CHECK_EQUAL(alive, CountedEvent::alive);
+}
+
+TEST(Reuse)
+{
+    core::BlockPool* pool = core::EventPool<PaddedEvent>::getPool();
+    size_t heapAllocations = pool->getHeapAllocations();
+
+    PaddedEvent* address = 0;
+    {
+        boost::shared_ptr<PaddedEvent> event =
+            core::EventPool<PaddedEvent>::create();
+        address = event.get();
+    }
+    CHECK_EQUAL(heapAllocations + 1, pool->getHeapAllocations());
+
+    // The memory of the released event is used again
+    for (int i = 0; i < 10; ++i)
+    {
+        boost::shared_ptr<PaddedEvent> event =
+            core::EventPool<PaddedEvent>::create();
+        CHECK(event.get() == address);
+    }
+    CHECK_EQUAL(heapAllocations + 1, pool->getHeapAllocations());
+}
+
+TEST(Threads)
+{
+    const int THREADS = 4;
+    int alive = CountedEvent::alive;
+
+    std::vector<boost::thread*> threads;
+    for (int i = 0; i < THREADS; ++i)
+        threads.push_back(new boost::thread(boost::bind(&createLoop, 10000)));
+    for (int i = 0; i < THREADS; ++i)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    // Every event was destroyed and memory was reused.  How much depends on
+    // how often a thread is preempted in the middle of the free list.
+    CHECK(core::EventPool<CountedEvent>::getPool()->getReuses() > 0);
+    CHECK_EQUAL(alive, CountedEvent::alive);
+}
+
+} // SUITE(EventPool)
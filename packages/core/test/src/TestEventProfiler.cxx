@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestEventProfiler.cxx
+ */
+
+// STD Includes
+#include <string>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+
+// Project Includes
+#include "core/include/EventProfiler.h"
+#include "core/include/EventHub.h"
+#include "core/include/QueuedEventHub.h"
+#include "core/include/EventPublisher.h"
+#include "core/include/EventConnection.h"
+#include "core/include/TimeVal.h"
+#include "core/test/include/Reciever.h"
+
+using namespace ram;
+
+// Takes a known amount of time to handle each event
+struct TimedReciever : public Reciever
+{
+    void handler(core::EventPtr event)
+    {
+        core::TimeVal::sleep(0.002);
+        Reciever::handler(event);
+    }
+};
+
+struct EventProfilerFixture
+{
+    EventProfilerFixture() :
+        config(core::ConfigNode::fromString("{ 'fileName' : '' }"))
+    {
+        core::EventProfiler::resetProfiles();
+    }
+
+    ~EventProfilerFixture()
+    {
+        core::EventProfiler::resetProfiles();
+    }
+
+    core::ConfigNode config;
+};
+
+SUITE(EventProfiler) {
+
+TEST_FIXTURE(EventProfilerFixture, Inactive)
+{
+    CHECK_EQUAL(false, core::EventProfiler::active());
+
+    // Nothing is recorded without a profiler
+    Reciever recv;
+    core::EventPublisher publisher;
+    core::EventConnectionPtr connection = publisher.subscribe(
+        "ProfileType", boost::bind(&Reciever::handler, &recv, _1));
+    publisher.publish("ProfileType", core::EventPtr(new core::Event()));
+
+    CHECK_EQUAL(1, recv.calls);
+    CHECK(!core::EventProfiler::getProfile("ProfileType"));
+    connection->disconnect();
+}
+
+TEST_FIXTURE(EventProfilerFixture, Handlers)
+{
+    Reciever recv;
+    TimedReciever slowRecv;
+    core::EventPublisher publisher;
+    core::EventConnectionPtr connection = publisher.subscribe(
+        "ProfileType", boost::bind(&Reciever::handler, &recv, _1));
+    core::EventConnectionPtr slowConnection = publisher.subscribe(
+        "ProfileType", boost::bind(&TimedReciever::handler, &slowRecv, _1));
+
+    {
+        core::EventProfiler profiler(config);
+        CHECK(core::EventProfiler::active());
+        for (int i = 0; i < 5; ++i)
+            publisher.publish("ProfileType", core::EventPtr(new core::Event()));
+    }
+    CHECK_EQUAL(false, core::EventProfiler::active());
+    CHECK_EQUAL(5, recv.calls);
+    CHECK_EQUAL(5, slowRecv.calls);
+
+    core::EventTypeProfilePtr profile =
+        core::EventProfiler::getProfile("ProfileType");
+    CHECK(profile);
+    if (!profile)
+        return;
+
+    CHECK_EQUAL(5, profile->publishTime.getCount());
+    CHECK(profile->publishTime.getMin() >= 2000000);
+    CHECK_EQUAL(0, profile->hubTime.getCount());
+    CHECK_EQUAL(2u, profile->handlers.size());
+
+    // Both handlers were called every time, the slow one shows its sleep
+    int slowHandlers = 0;
+    typedef std::map<size_t, core::HandlerProfilePtr> HandlerMap;
+    for (HandlerMap::iterator iter = profile->handlers.begin();
+         iter != profile->handlers.end(); ++iter)
+    {
+        core::HandlerProfilePtr handler = iter->second;
+        CHECK_EQUAL(5, handler->cost.getCount());
+        if (handler->cost.getMin() >= 2000000)
+        {
+            slowHandlers++;
+            CHECK(std::string::npos != handler->name.find("TimedReciever"));
+        }
+    }
+    CHECK_EQUAL(1, slowHandlers);
+
+    connection->disconnect();
+    slowConnection->disconnect();
+}
+
+TEST_FIXTURE(EventProfilerFixture, DisconnectDropsHandler)
+{
+    Reciever recv;
+    Reciever otherRecv;
+    core::EventPublisher publisher;
+    core::EventConnectionPtr connection = publisher.subscribe(
+        "ProfileType", boost::bind(&Reciever::handler, &recv, _1));
+    core::EventConnectionPtr otherConnection = publisher.subscribe(
+        "ProfileType", boost::bind(&Reciever::handler, &otherRecv, _1));
+
+    core::EventProfiler profiler(config);
+    publisher.publish("ProfileType", core::EventPtr(new core::Event()));
+
+    core::EventTypeProfilePtr profile =
+        core::EventProfiler::getProfile("ProfileType");
+    CHECK(profile);
+    if (!profile)
+        return;
+    CHECK_EQUAL(2u, profile->handlers.size());
+
+    // Only the handler still connected is profiled from now on
+    connection->disconnect();
+    CHECK_EQUAL(1u, profile->handlers.size());
+
+    publisher.publish("ProfileType", core::EventPtr(new core::Event()));
+    CHECK_EQUAL(1u, profile->handlers.size());
+    if (1u == profile->handlers.size())
+        CHECK_EQUAL(2, profile->handlers.begin()->second->cost.getCount());
+
+    otherConnection->disconnect();
+    CHECK_EQUAL(0u, profile->handlers.size());
+}
+
+TEST_FIXTURE(EventProfilerFixture, Hub)
+{
+    Reciever recv;
+    core::EventHubPtr hub(new core::EventHub());
+    core::EventPublisher publisher(hub);
+    core::EventConnectionPtr connection = hub->subscribeToType(
+        "ProfileType", boost::bind(&Reciever::handler, &recv, _1));
+
+    core::EventProfiler profiler(config);
+    publisher.publish("ProfileType", core::EventPtr(new core::Event()));
+    hub->publish("ProfileType", core::EventPtr(new core::Event()));
+    CHECK_EQUAL(2, recv.calls);
+
+    core::EventTypeProfilePtr profile =
+        core::EventProfiler::getProfile("ProfileType");
+    CHECK(profile);
+    if (profile)
+    {
+        CHECK_EQUAL(1, profile->publishTime.getCount());
+        CHECK_EQUAL(2, profile->hubTime.getCount());
+        CHECK_EQUAL(1u, profile->handlers.size());
+    }
+
+    connection->disconnect();
+}
+
+TEST_FIXTURE(EventProfilerFixture, AllEvents)
+{
+    Reciever recv;
+    core::EventHubPtr hub(new core::EventHub());
+    core::EventConnectionPtr connection = hub->subscribeToAll(
+        boost::bind(&Reciever::handler, &recv, _1));
+
+    core::EventProfiler profiler(config);
+    hub->publish("ProfileType", core::EventPtr(new core::Event()));
+    CHECK_EQUAL(1, recv.calls);
+
+    // The handler is charged to the type it was called for
+    CHECK(!core::EventProfiler::getProfile(core::EventHub::ALL_EVENTS));
+    core::EventTypeProfilePtr profile =
+        core::EventProfiler::getProfile("ProfileType");
+    CHECK(profile);
+    if (profile)
+        CHECK_EQUAL(1u, profile->handlers.size());
+
+    connection->disconnect();
+}
+
+TEST_FIXTURE(EventProfilerFixture, QueueTime)
+{
+    Reciever recv;
+    core::EventHubPtr hub(new core::EventHub());
+    core::QueuedEventHubPtr queuedHub(new core::QueuedEventHub(hub));
+    core::EventPublisher publisher(hub);
+    core::EventConnectionPtr connection = queuedHub->subscribeToType(
+        "ProfileType", boost::bind(&Reciever::handler, &recv, _1));
+
+    // Queued before we start profiling, so not counted
+    publisher.publish("ProfileType", core::EventPtr(new core::Event()));
+
+    core::EventProfiler profiler(config);
+    publisher.publish("ProfileType", core::EventPtr(new core::Event()));
+    core::TimeVal::sleep(0.005);
+    CHECK_EQUAL(2, queuedHub->publishEvents());
+
+    core::EventTypeProfilePtr profile =
+        core::EventProfiler::getProfile("ProfileType");
+    CHECK(profile);
+    if (profile)
+    {
+        CHECK_EQUAL(1, profile->queueTime.getCount());
+        CHECK(profile->queueTime.getMin() >= 5000000);
+    }
+
+    connection->disconnect();
+}
+
+TEST_FIXTURE(EventProfilerFixture, Report)
+{
+    Reciever recv;
+    core::EventPublisher publisher;
+    core::EventConnectionPtr connection = publisher.subscribe(
+        "ProfileType", boost::bind(&Reciever::handler, &recv, _1));
+
+    core::EventProfiler profiler(config);
+    publisher.publish("ProfileType", core::EventPtr(new core::Event()));
+
+    std::string report = profiler.createReport();
+    CHECK(std::string::npos != report.find("type ProfileType rate"));
+    CHECK(std::string::npos != report.find("handler Reciever#"));
+
+    connection->disconnect();
+}
+
+} // SUITE(EventProfiler)
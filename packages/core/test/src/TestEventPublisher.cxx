@@ -10,6 +10,7 @@
 // STD Includes
 #include <string>
 #include <vector>
+#include <unistd.h>
 
 // Library Includes
 #include <UnitTest++/UnitTest++.h>
@@ -150,7 +151,7 @@ void threadFunc(boost::barrier* barrier, ram::core::EventPublisher* publisher)
 boost::mutex mutex;
 void threadCount(int* calls, ram::core::EventPtr event)
 {
-    boost::mutex::scoped_lock(mutex);
+    boost::mutex::scoped_lock lock(mutex);
     *calls = (*calls) + 1;
 }
 
@@ -173,3 +174,106 @@ TEST_FIXTURE(EventPublisherFixture, Threads)
 
     CHECK_EQUAL(200, calls);
 }
+
+// Helper for the DisconnectWaitsForHandler test
+struct SlowReciever
+{
+    SlowReciever() : started(2), calls(0), finished(false) {}
+
+    void handler(ram::core::EventPtr)
+    {
+        calls++;
+        started.wait();
+        usleep(50 * 1000);
+        finished = true;
+    }
+
+    boost::barrier started;
+    int calls;
+    bool finished;
+};
+
+void publishOnce(ram::core::EventPublisher* publisher)
+{
+    publisher->publish("Type", ram::core::EventPtr(new ram::core::Event()));
+}
+
+TEST_FIXTURE(EventPublisherFixture, DisconnectWaitsForHandler)
+{
+    SlowReciever slow;
+    ram::core::EventConnectionPtr connection = publisher.subscribe(
+        "Type", boost::bind(&SlowReciever::handler, &slow, _1));
+
+    // Start a publish in the background, and wait for the handler to start
+    boost::thread thread(boost::bind(&publishOnce, &publisher));
+    slow.started.wait();
+
+    // The handler is still running, disconnect must wait for it
+    connection->disconnect();
+    CHECK(slow.finished);
+    thread.join();
+
+    // No more calls after disconnect
+    publisher.publish("Type", ram::core::EventPtr(new ram::core::Event()));
+    CHECK_EQUAL(1, slow.calls);
+}
+
+// Helper for the DisconnectInHandler test
+struct SelfDisconnecter
+{
+    SelfDisconnecter() : calls(0) {}
+
+    void handler(ram::core::EventPtr)
+    {
+        calls++;
+        connection->disconnect();
+    }
+
+    int calls;
+    ram::core::EventConnectionPtr connection;
+};
+
+TEST_FIXTURE(EventPublisherFixture, DisconnectInHandler)
+{
+    SelfDisconnecter recvA;
+    recvA.connection = publisher.subscribe(
+        "Type", boost::bind(&SelfDisconnecter::handler, &recvA, _1));
+    publisher.subscribe("Type", boost::bind(&Reciever::handler, &recv, _1));
+
+    // Must not deadlock, and the other handler still gets the event
+    publisher.publish("Type", ram::core::EventPtr(new ram::core::Event()));
+    publisher.publish("Type", ram::core::EventPtr(new ram::core::Event()));
+
+    CHECK_EQUAL(1, recvA.calls);
+    CHECK_EQUAL(2, recv.calls);
+    CHECK(!recvA.connection->connected());
+}
+
+// Helper for the SubscribeInHandler test
+struct Subscriber
+{
+    Subscriber(ram::core::EventPublisher* publisher_) :
+        publisher(publisher_) {}
+
+    void handler(ram::core::EventPtr)
+    {
+        publisher->subscribe("Type",
+                             boost::bind(&Reciever::handler, &recv, _1));
+    }
+
+    ram::core::EventPublisher* publisher;
+    Reciever recv;
+};
+
+TEST_FIXTURE(EventPublisherFixture, SubscribeInHandler)
+{
+    Subscriber subscriber(&publisher);
+    publisher.subscribe("Type", boost::bind(&Subscriber::handler,
+                                            &subscriber, _1));
+
+    // The new subscriber only sees events published after it subscribed
+    publisher.publish("Type", ram::core::EventPtr(new ram::core::Event()));
+    CHECK_EQUAL(0, subscriber.recv.calls);
+    publisher.publish("Type", ram::core::EventPtr(new ram::core::Event()));
+    CHECK_EQUAL(1, subscriber.recv.calls);
+}
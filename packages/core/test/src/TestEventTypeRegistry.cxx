@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestEventTypeRegistry.cxx
+ */
+
+// STD Includes
+#include <sstream>
+#include <vector>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "core/include/EventTypeRegistry.h"
+#include "core/include/EventHub.h"
+
+using namespace ram;
+
+SUITE(EventTypeRegistry) {
+
+TEST(StaticTypesRegistered)
+{
+    // Defined with RAM_CORE_EVENT_TYPE so it is interned at startup
+    core::EventTypeRegistry::TypeId id =
+        core::EventTypeRegistry::lookup(core::EventHub::ALL_EVENTS);
+    CHECK(core::EventTypeRegistry::INVALID_TYPE_ID != id);
+    CHECK_EQUAL(core::EventHub::ALL_EVENTS,
+                core::EventTypeRegistry::getName(id));
+}
+
+TEST(Intern)
+{
+    CHECK_EQUAL(core::EventTypeRegistry::INVALID_TYPE_ID,
+                core::EventTypeRegistry::lookup("TestEventTypeRegistry::A"));
+
+    core::EventTypeRegistry::TypeId id =
+        core::EventTypeRegistry::intern("TestEventTypeRegistry::A");
+
+    // Lookups and further interning give back the same id
+    CHECK_EQUAL(id, core::EventTypeRegistry::lookup("TestEventTypeRegistry::A"));
+    CHECK_EQUAL(id, core::EventTypeRegistry::intern("TestEventTypeRegistry::A"));
+    CHECK_EQUAL("TestEventTypeRegistry::A",
+                core::EventTypeRegistry::getName(id));
+
+    // New types get new ids
+    core::EventTypeRegistry::TypeId otherId =
+        core::EventTypeRegistry::intern("TestEventTypeRegistry::B");
+    CHECK(id != otherId);
+}
+
+TEST(ManyTypes)
+{
+    // Enough types to force the table to grow several times
+    std::vector<core::EventTypeRegistry::TypeId> ids;
+    for (int i = 0; i < 3000; ++i)
+    {
+        std::stringstream ss;
+        ss << "TestEventTypeRegistry::MANY_" << i;
+        ids.push_back(core::EventTypeRegistry::intern(ss.str()));
+    }
+
+    CHECK(core::EventTypeRegistry::getTypeCount() >= 3000);
+    for (int i = 0; i < 3000; ++i)
+    {
+        std::stringstream ss;
+        ss << "TestEventTypeRegistry::MANY_" << i;
+        CHECK_EQUAL(ids[i], core::EventTypeRegistry::lookup(ss.str()));
+        CHECK_EQUAL(ss.str(), core::EventTypeRegistry::getName(ids[i]));
+    }
+}
+
+TEST(EventTypeName)
+{
+    // Event types carry the id they were interned under
+    CHECK_EQUAL(core::EventTypeRegistry::lookup(core::EventHub::ALL_EVENTS),
+                core::EventHub::ALL_EVENTS.getId());
+
+    core::Event::EventType type("TestEventTypeRegistry::C");
+    CHECK_EQUAL(core::EventTypeRegistry::lookup("TestEventTypeRegistry::C"),
+                type.getId());
+
+    // Copies keep it, and assigning a new name changes it
+    core::Event::EventType copy(type);
+    CHECK_EQUAL(type.getId(), copy.getId());
+    copy = std::string("TestEventTypeRegistry::D");
+    CHECK_EQUAL(core::EventTypeRegistry::lookup("TestEventTypeRegistry::D"),
+                copy.getId());
+    CHECK(type.getId() != copy.getId());
+
+    // The empty name is interned when asked for
+    core::Event::EventType empty;
+    CHECK_EQUAL(core::EventTypeRegistry::intern(""), empty.getId());
+}
+
+TEST(InvalidName)
+{
+    CHECK_EQUAL("", core::EventTypeRegistry::getName(
+                    core::EventTypeRegistry::INVALID_TYPE_ID));
+}
+
+} // SUITE(EventTypeRegistry)
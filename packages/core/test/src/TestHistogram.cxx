@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestHistogram.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "core/include/Histogram.h"
+
+using namespace ram;
+
+SUITE(Histogram) {
+
+TEST(Empty)
+{
+    core::Histogram histogram;
+    CHECK_EQUAL(0, histogram.getCount());
+    CHECK_EQUAL(0, histogram.getMin());
+    CHECK_EQUAL(0, histogram.getMax());
+    CHECK_EQUAL(0.0, histogram.getMean());
+    CHECK_EQUAL(0, histogram.getValueAtPercentile(50));
+}
+
+TEST(SmallValues)
+{
+    // Values below 128 are exact
+    core::Histogram histogram;
+    for (int i = 1; i <= 100; ++i)
+        histogram.record(i);
+
+    CHECK_EQUAL(100, histogram.getCount());
+    CHECK_EQUAL(1, histogram.getMin());
+    CHECK_EQUAL(100, histogram.getMax());
+    CHECK_CLOSE(50.5, histogram.getMean(), 0.0001);
+    CHECK_EQUAL(50, histogram.getValueAtPercentile(50));
+    CHECK_EQUAL(99, histogram.getValueAtPercentile(99));
+    CHECK_EQUAL(100, histogram.getValueAtPercentile(100));
+    CHECK_EQUAL(1, histogram.getValueAtPercentile(0));
+}
+
+TEST(Precision)
+{
+    core::Histogram histogram;
+    boost::int64_t values[] = {1000, 12345, 1000000, 987654321};
+    for (int i = 0; i < 4; ++i)
+    {
+        histogram.reset();
+        histogram.record(values[i] / 2);
+        histogram.record(values[i]);
+
+        // Within the precision of a bucket, but never past the max
+        boost::int64_t result = histogram.getValueAtPercentile(50);
+        CHECK(result >= values[i] / 2);
+        CHECK(result <= (values[i] / 2) + (values[i] / 2) / 64);
+        CHECK_EQUAL(values[i], histogram.getValueAtPercentile(100));
+    }
+}
+
+TEST(Tail)
+{
+    // One slow value in a thousand only shows up above the 99.9th percentile
+    core::Histogram histogram;
+    for (int i = 0; i < 999; ++i)
+        histogram.record(1000);
+    histogram.record(1000000);
+
+    CHECK(histogram.getValueAtPercentile(99) < 1020);
+    CHECK(histogram.getValueAtPercentile(99.9) < 1020);
+    CHECK_EQUAL(1000000, histogram.getValueAtPercentile(99.95));
+}
+
+TEST(Limits)
+{
+    core::Histogram histogram;
+    histogram.record(-5);
+    CHECK_EQUAL(0, histogram.getMax());
+
+    // Huge values land in the last bucket, but the max is still exact
+    boost::int64_t huge = ((boost::int64_t)1) << 50;
+    histogram.record(huge);
+    CHECK_EQUAL(huge, histogram.getMax());
+    CHECK_EQUAL(huge, histogram.getValueAtPercentile(100));
+    CHECK_EQUAL(2, histogram.getCount());
+}
+
+TEST(Merge)
+{
+    core::Histogram first;
+    core::Histogram second;
+    for (int i = 1; i <= 50; ++i)
+        first.record(i);
+    for (int i = 51; i <= 100; ++i)
+        second.record(i);
+
+    // The same as recording everything in one
+    first.merge(second);
+    CHECK_EQUAL(100, first.getCount());
+    CHECK_EQUAL(1, first.getMin());
+    CHECK_EQUAL(100, first.getMax());
+    CHECK_CLOSE(50.5, first.getMean(), 0.0001);
+    CHECK_EQUAL(99, first.getValueAtPercentile(99));
+
+    // Into an empty one, and from an empty one
+    core::Histogram empty;
+    empty.merge(second);
+    CHECK_EQUAL(51, empty.getMin());
+    second.merge(core::Histogram());
+    CHECK_EQUAL(50, second.getCount());
+}
+
+} // SUITE(Histogram)
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestMetrics.cxx
+ */
+
+// STD Includes
+#include <string>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/Metrics.h"
+#include "core/include/MetricsReporter.h"
+#include "core/include/QueuedEventHub.h"
+#include "core/include/EventHub.h"
+
+using namespace ram;
+
+static void countMany(core::CounterPtr counter)
+{
+    for (int i = 0; i < 10000; ++i)
+        counter->increment();
+}
+
+static double answer()
+{
+    return 42;
+}
+
+SUITE(Metrics) {
+
+TEST(Counter)
+{
+    core::CounterPtr counter = core::MetricsRegistry::counter("Test", "count");
+    CHECK_EQUAL(0, counter->get());
+    counter->increment(5);
+    CHECK_EQUAL(5, counter->get());
+
+    // No increments are lost between threads
+    boost::thread_group threads;
+    for (int i = 0; i < 4; ++i)
+        threads.create_thread(boost::bind(countMany, counter));
+    threads.join_all();
+    CHECK_EQUAL(40005, counter->get());
+}
+
+TEST(Gauge)
+{
+    core::Gauge gauge;
+    CHECK_EQUAL(0.0, gauge.get());
+    gauge.set(29.5);
+    CHECK_EQUAL(29.5, gauge.get());
+
+    core::Gauge sampled(answer);
+    CHECK_EQUAL(42.0, sampled.get());
+}
+
+TEST(Registry)
+{
+    // The same name gives the same metric, under each owner
+    core::CounterPtr counter = core::MetricsRegistry::counter("A", "frames");
+    CHECK(counter == core::MetricsRegistry::counter("A", "frames"));
+    CHECK(counter != core::MetricsRegistry::counter("B", "frames"));
+
+    core::HistogramPtr histogram =
+        core::MetricsRegistry::histogram("A", "timeUsec");
+    core::GaugePtr gauge = core::MetricsRegistry::gauge("A", "fps");
+    counter->increment(3);
+    histogram->record(10);
+    histogram->record(20);
+    gauge->set(15);
+
+    core::MetricsSnapshot snapshot = core::MetricsRegistry::snapshot();
+    CHECK_EQUAL(3, snapshot.counters["A.frames"]);
+    CHECK_EQUAL(15.0, snapshot.gauges["A.fps"]);
+    CHECK_EQUAL(2, snapshot.histograms["A.timeUsec"]->getCount());
+
+    // The snapshot is a copy
+    histogram->record(30);
+    CHECK_EQUAL(2, snapshot.histograms["A.timeUsec"]->getCount());
+
+    // Metrics nobody holds on to are dropped, "B.frames" was never held
+    CHECK_EQUAL(0u, snapshot.counters.count("B.frames"));
+    gauge = core::GaugePtr();
+    snapshot = core::MetricsRegistry::snapshot();
+    CHECK_EQUAL(0u, snapshot.gauges.count("A.fps"));
+    CHECK_EQUAL(1u, snapshot.counters.count("A.frames"));
+}
+
+TEST(TypeName)
+{
+    CHECK_EQUAL("Histogram",
+                core::MetricsRegistry::typeName(typeid(core::Histogram)));
+}
+
+TEST(QueueDepth)
+{
+    core::EventHubPtr hub(new core::EventHub());
+    core::QueuedEventHub queuedHub(hub, "DepthHub");
+    hub->publish("Type", core::EventPtr(new core::Event()));
+    hub->publish("Type", core::EventPtr(new core::Event()));
+
+    core::MetricsSnapshot snapshot = core::MetricsRegistry::snapshot();
+    CHECK_EQUAL(2.0, snapshot.gauges["DepthHub.queueDepth"]);
+
+    queuedHub.publishEvents();
+    snapshot = core::MetricsRegistry::snapshot();
+    CHECK_EQUAL(0.0, snapshot.gauges["DepthHub.queueDepth"]);
+}
+
+TEST(Report)
+{
+    core::CounterPtr counter = core::MetricsRegistry::counter("R", "errors");
+    core::HistogramPtr histogram =
+        core::MetricsRegistry::histogram("R", "periodUsec");
+    counter->increment(7);
+    histogram->record(25000);
+
+    core::MetricsSnapshot snapshot = core::MetricsRegistry::snapshot();
+    std::string report = core::MetricsReporter::createReport(snapshot);
+    CHECK(std::string::npos != report.find("counter R.errors 7\n"));
+    CHECK(std::string::npos != report.find("histogram R.periodUsec 1 "));
+
+    // Histograms are summed up in the event
+    core::MetricsEventPtr event = core::MetricsReporter::createEvent(snapshot);
+    CHECK_EQUAL(event->names.size(), event->values.size());
+    bool foundCounter = false;
+    bool foundMean = false;
+    for (size_t i = 0; i < event->names.size(); ++i)
+    {
+        if ("R.errors" == event->names[i])
+        {
+            foundCounter = true;
+            CHECK_EQUAL(7.0, event->values[i]);
+        }
+        else if ("R.periodUsec.mean" == event->names[i])
+        {
+            foundMean = true;
+            CHECK_EQUAL(25000.0, event->values[i]);
+        }
+    }
+    CHECK(foundCounter);
+    CHECK(foundMean);
+}
+
+} // SUITE(Metrics)
@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestNativeConfigNodeImp.cxx
+ */
+
+// STD Includes
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/foreach.hpp>
+#include <boost/filesystem.hpp>
+
+#ifdef RAM_POSIX
+#include <sys/stat.h>
+#endif
+
+// Project Includes
+#include "core/include/ConfigNode.h"
+#include "core/include/ConfigSnapshot.h"
+#include "core/include/NativeConfigNodeImp.h"
+#include "core/include/Exception.h"
+
+using namespace ram;
+
+static const std::string SNAPSHOT_FILE("TestNativeConfigNodeImp.bin");
+static const std::string SOURCE_FILE("TestNativeConfigNodeImp.yml");
+
+// The same as: {'TestInt': 10, 'TestDouble': 23.5, 'TestStr': 'Str',
+//  'TestBool': True, 'Array': [4, 5, 6], 'Map': {'A': 'D', 'B': 'E'},
+//  'INCLUDE': 'some/file.yml', 'INCLUDE_LOADED': True}
+static core::ConfigValue basicConfig()
+{
+    core::ConfigValue root(core::CONFIG_MAP);
+
+    root.keys.push_back("Array");
+    core::ConfigValue array(core::CONFIG_LIST);
+    array.children.push_back(core::ConfigValue(core::CONFIG_INT, "4"));
+    array.children.push_back(core::ConfigValue(core::CONFIG_INT, "5"));
+    array.children.push_back(core::ConfigValue(core::CONFIG_INT, "6"));
+    root.children.push_back(array);
+
+    root.keys.push_back("INCLUDE");
+    root.children.push_back(
+        core::ConfigValue(core::CONFIG_STRING, "some/file.yml"));
+
+    root.keys.push_back("INCLUDE_LOADED");
+    root.children.push_back(core::ConfigValue(core::CONFIG_BOOL, "True"));
+
+    root.keys.push_back("Map");
+    core::ConfigValue map(core::CONFIG_MAP);
+    map.keys.push_back("A");
+    map.children.push_back(core::ConfigValue(core::CONFIG_STRING, "D"));
+    map.keys.push_back("B");
+    map.children.push_back(core::ConfigValue(core::CONFIG_STRING, "E"));
+    root.children.push_back(map);
+
+    root.keys.push_back("TestBool");
+    root.children.push_back(core::ConfigValue(core::CONFIG_BOOL, "True"));
+
+    root.keys.push_back("TestDouble");
+    core::ConfigValue testDouble(core::CONFIG_DOUBLE, "23.5");
+    testDouble.repr = "23.5";
+    root.children.push_back(testDouble);
+
+    root.keys.push_back("TestInt");
+    root.children.push_back(core::ConfigValue(core::CONFIG_INT, "10"));
+
+    root.keys.push_back("TestStr");
+    root.children.push_back(core::ConfigValue(core::CONFIG_STRING, "Str"));
+
+    return root;
+}
+
+static void writeSource(const std::string& contents)
+{
+    std::ofstream file(SOURCE_FILE.c_str());
+    file << contents;
+}
+
+struct NativeConfigFixture
+{
+    NativeConfigFixture() :
+        config(core::ConfigNodeImpPtr(new core::NativeConfigNodeImp(
+            writeAndLoad(basicConfig()))))
+    {
+    }
+
+    ~NativeConfigFixture()
+    {
+        std::remove(SNAPSHOT_FILE.c_str());
+        std::remove(SOURCE_FILE.c_str());
+    }
+
+    static core::ConfigSnapshotPtr writeAndLoad(const core::ConfigValue& root)
+    {
+        writeSource("Test: 1\n");
+        std::vector<std::string> sources;
+        sources.push_back(SOURCE_FILE);
+        core::ConfigSnapshot::write(SNAPSHOT_FILE, root, sources);
+        return core::ConfigSnapshot::load(SNAPSHOT_FILE);
+    }
+
+    core::ConfigNode config;
+};
+
+SUITE(NativeConfigNodeImp) {
+
+TEST_FIXTURE(NativeConfigFixture, asString)
+{
+    CHECK_EQUAL("Str", config["TestStr"].asString());
+    CHECK_EQUAL("Def", config["NotThere"].asString("Def"));
+    CHECK_EQUAL("None", config["NotThere"].asString());
+    CHECK_EQUAL("10", config["TestInt"].asString());
+    CHECK_EQUAL("True", config["TestBool"].asString());
+}
+
+TEST_FIXTURE(NativeConfigFixture, asInt)
+{
+    CHECK_EQUAL(10, config["TestInt"].asInt());
+    CHECK_EQUAL(1, config["TestBool"].asInt());
+    CHECK_EQUAL(2, config["NotThere"].asInt(2));
+    CHECK_EQUAL(2, config["TestStr"].asInt(2));
+    CHECK_THROW(config["TestStr"].asInt(), core::ConfigException);
+    CHECK_THROW(config["NotThere"].asInt(), core::ConfigException);
+}
+
+TEST_FIXTURE(NativeConfigFixture, asDouble)
+{
+    CHECK_CLOSE(23.5, config["TestDouble"].asDouble(), 0.0001);
+    CHECK_CLOSE(10.0, config["TestInt"].asDouble(), 0.0001);
+    CHECK_CLOSE(1.5, config["NotThere"].asDouble(1.5), 0.0001);
+    CHECK_THROW(config["Map"].asDouble(), core::ConfigException);
+}
+
+TEST_FIXTURE(NativeConfigFixture, Array)
+{
+    CHECK_EQUAL(3u, config["Array"].size());
+    CHECK_EQUAL(4, config["Array"][0].asInt());
+    CHECK_EQUAL(6, config["Array"][2].asInt());
+    CHECK_EQUAL(-1, config["Array"][3].asInt(-1));
+    CHECK_EQUAL(-1, config["TestStr"][0].asInt(-1));
+}
+
+TEST_FIXTURE(NativeConfigFixture, Map)
+{
+    CHECK_EQUAL("D", config["Map"]["A"].asString());
+    CHECK_EQUAL("E", config["Map"]["B"].asString());
+    CHECK_EQUAL("Def", config["Map"]["C"].asString("Def"));
+    CHECK_EQUAL("Def", config["TestInt"]["A"].asString("Def"));
+    CHECK_EQUAL(2u, config["Map"].size());
+}
+
+TEST_FIXTURE(NativeConfigFixture, subNodes)
+{
+    core::NodeNameList expected;
+    expected.insert("Array");
+    expected.insert("Map");
+    expected.insert("TestBool");
+    expected.insert("TestDouble");
+    expected.insert("TestInt");
+    expected.insert("TestStr");
+
+    // INCLUDE and INCLUDE_LOADED are hidden
+    core::NodeNameList subNodes(config.subNodes());
+    CHECK_EQUAL(expected.size(), subNodes.size());
+    CHECK(std::equal(expected.begin(), expected.end(), subNodes.begin()));
+    CHECK(config.exists("Map"));
+    CHECK(!config.exists("NotThere"));
+    CHECK(config["TestInt"].subNodes().empty());
+}
+
+TEST_FIXTURE(NativeConfigFixture, set)
+{
+    config["Map"].set("A", "New");
+    config["Map"].set("C", 5);
+    config.set("TestStr", 12);
+
+    CHECK_EQUAL("New", config["Map"]["A"].asString());
+    CHECK_EQUAL(5, config["Map"]["C"].asInt());
+    CHECK_EQUAL(12, config["TestStr"].asInt());
+    CHECK_EQUAL(3u, config["Map"].size());
+    CHECK(config["Map"].exists("C"));
+
+    CHECK_THROW(config["TestInt"].set("A", 1), core::ConfigException);
+}
+
+TEST_FIXTURE(NativeConfigFixture, toString)
+{
+    CHECK_EQUAL("[4, 5, 6]", config["Array"].toString());
+    CHECK_EQUAL("{'A': 'D', 'B': 'E'}", config["Map"].toString());
+    CHECK_EQUAL("{'A': 'D', 'B': 'E'}", config["Map"].asString());
+
+    config["Map"].set("C", "it's");
+    CHECK_EQUAL("{'A': 'D', 'B': 'E', 'C': 'it\\'s'}",
+                config["Map"].toString());
+    CHECK_EQUAL("{'Array': [4, 5, 6], 'INCLUDE': 'some/file.yml', "
+                "'INCLUDE_LOADED': True, "
+                "'Map': {'A': 'D', 'B': 'E', 'C': 'it\\'s'}, "
+                "'TestBool': True, 'TestDouble': 23.5, 'TestInt': 10, "
+                "'TestStr': 'Str'}", config.toString());
+}
+
+TEST_FIXTURE(NativeConfigFixture, writeToFile)
+{
+    config["Map"].set("C", "it's");
+    config.writeToFile(SOURCE_FILE);
+
+    std::ifstream file(SOURCE_FILE.c_str());
+    std::string contents((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+    CHECK_EQUAL("Array: [4, 5, 6]\n"
+                "INCLUDE: 'some/file.yml'\n"
+                "INCLUDE_LOADED: true\n"
+                "Map:\n"
+                "  A: 'D'\n"
+                "  B: 'E'\n"
+                "  C: 'it''s'\n"
+                "TestBool: true\n"
+                "TestDouble: 23.5\n"
+                "TestInt: 10\n"
+                "TestStr: 'Str'\n", contents);
+}
+
+TEST_FIXTURE(NativeConfigFixture, ManyKeys)
+{
+    // Enough keys to fill many hash slots
+    core::ConfigValue root(core::CONFIG_MAP);
+    for (int i = 0; i < 1000; ++i)
+    {
+        char key[32];
+        sprintf(key, "Key%d", i);
+        root.keys.push_back(key);
+        sprintf(key, "%d", i);
+        root.children.push_back(core::ConfigValue(core::CONFIG_INT, key));
+    }
+
+    core::ConfigNode node(core::ConfigNodeImpPtr(
+        new core::NativeConfigNodeImp(writeAndLoad(root))));
+    CHECK_EQUAL(1000u, node.size());
+    for (int i = 0; i < 1000; ++i)
+    {
+        char key[32];
+        sprintf(key, "Key%d", i);
+        CHECK_EQUAL(i, node[key].asInt());
+    }
+    CHECK_EQUAL(-1, node["Key1000"].asInt(-1));
+}
+
+TEST_FIXTURE(NativeConfigFixture, UpToDate)
+{
+    core::ConfigSnapshotPtr snapshot = writeAndLoad(basicConfig());
+    CHECK(snapshot->upToDate());
+
+    // A change in size is always noticed, even within the mtime resolution
+    writeSource("Test: 100\n");
+    CHECK(!snapshot->upToDate());
+
+    std::remove(SOURCE_FILE.c_str());
+    CHECK(!snapshot->upToDate());
+}
+
+TEST_FIXTURE(NativeConfigFixture, ReplacedSource)
+{
+    core::ConfigSnapshotPtr snapshot = writeAndLoad(basicConfig());
+    CHECK(snapshot->upToDate());
+
+    // Saved the way editors do, same size and likely within the same tick
+    std::string tempFile(SOURCE_FILE + ".new");
+    {
+        std::ofstream file(tempFile.c_str());
+        file << "Test: 2\n";
+    }
+    std::rename(tempFile.c_str(), SOURCE_FILE.c_str());
+    CHECK(!snapshot->upToDate());
+}
+
+#ifdef RAM_POSIX
+TEST(CacheDir)
+{
+    namespace bf = boost::filesystem;
+
+    // The shared temporary directory gets a directory per user
+    unsetenv("RAM_CONFIG_CACHE_DIR");
+    CHECK(std::string::npos != core::ConfigSnapshot::getCachePath(
+              "test.yml").find("ram_config_cache_"));
+
+    std::string cacheDir("TestConfigCache");
+    setenv("RAM_CONFIG_CACHE_DIR", cacheDir.c_str(), 1);
+    std::string cachePath(core::ConfigSnapshot::getCachePath("test.yml"));
+    CHECK(core::ConfigSnapshot::createCacheDir(cachePath));
+
+    struct stat info;
+    CHECK_EQUAL(0, stat(cacheDir.c_str(), &info));
+    CHECK_EQUAL(0700, (int)(info.st_mode & 0777));
+
+    // Nothing is cached where other users could swap in their own snapshot
+    chmod(cacheDir.c_str(), 0777);
+    CHECK(!core::ConfigSnapshot::createCacheDir(cachePath));
+    CHECK(!core::ConfigSnapshot::fromCache("test.yml"));
+
+    unsetenv("RAM_CONFIG_CACHE_DIR");
+    bf::remove_all(cacheDir);
+}
+#endif // RAM_POSIX
+
+TEST_FIXTURE(NativeConfigFixture, Invalid)
+{
+    CHECK(!core::ConfigSnapshot::load("NotThere.bin"));
+
+    // Not a snapshot at all
+    writeSource("Test: 1\n");
+    CHECK(!core::ConfigSnapshot::load(SOURCE_FILE));
+
+    // A truncated snapshot
+    writeAndLoad(basicConfig());
+    std::ifstream in(SNAPSHOT_FILE.c_str(), std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream out(SNAPSHOT_FILE.c_str(), std::ios::binary);
+    out << contents.substr(0, contents.size() / 2);
+    out.close();
+    CHECK(!core::ConfigSnapshot::load(SNAPSHOT_FILE));
+}
+
+} // SUITE(NativeConfigNodeImp)
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestPlacementPlanner.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "core/include/PlacementPlanner.h"
+
+using namespace ram;
+
+typedef core::PlacementPlanner Planner;
+
+// Four cores with two threads each, CPU n and n + 4 are siblings
+static core::CpuTopology smtTopology(int isolatedCore = -1)
+{
+    std::vector<core::CpuInfo> cpus;
+    for (int i = 0; i < 8; ++i)
+        cpus.push_back(core::CpuInfo(i, 0, i % 4, (i % 4) == isolatedCore));
+    return core::CpuTopology(cpus);
+}
+
+SUITE(PlacementPlanner) {
+
+TEST(HintString)
+{
+    CHECK_EQUAL(Planner::REALTIME, Planner::stringToHint("RealTime"));
+    CHECK_EQUAL(Planner::IO, Planner::stringToHint("io"));
+    CHECK_EQUAL("background", Planner::hintToString(Planner::BACKGROUND));
+}
+
+TEST(Layout)
+{
+    Planner planner(smtTopology());
+    planner.request("Controller", Planner::REALTIME);
+    planner.request("Vision", Planner::COMPUTE);
+    planner.request("SensorBoard", Planner::REALTIME);
+    planner.request("Network", Planner::IO);
+    planner.request("Logging", Planner::BACKGROUND);
+    Planner::PlacementList placements = planner.plan();
+
+    CHECK_EQUAL(5u, placements.size());
+    CHECK_EQUAL("Controller", placements[0].name);
+
+    // Realtime from the top core down, compute on what is left
+    CHECK_EQUAL(3, placements[0].cpu);
+    CHECK_EQUAL(core::IUpdatable::RT_NORMAL_PRIORITY, placements[0].priority);
+    CHECK_EQUAL(2, placements[2].cpu);
+    CHECK_EQUAL(1, placements[1].cpu);
+    CHECK_EQUAL(core::IUpdatable::NORMAL_PRIORITY, placements[1].priority);
+
+    // IO and background share the housekeeping core
+    CHECK_EQUAL(0, placements[3].cpu);
+    CHECK_EQUAL(core::IUpdatable::HIGH_PRIORITY, placements[3].priority);
+    CHECK_EQUAL(4, placements[4].cpu);
+    CHECK_EQUAL(core::IUpdatable::LOW_PRIORITY, placements[4].priority);
+
+    CHECK(planner.findConflicts(placements).empty());
+}
+
+TEST(Isolated)
+{
+    // Only realtime goes on the isolated core, and it goes there first
+    Planner planner(smtTopology(1));
+    planner.request("Vision", Planner::COMPUTE);
+    planner.request("Estimator", Planner::COMPUTE);
+    planner.request("Controller", Planner::REALTIME);
+    Planner::PlacementList placements = planner.plan();
+
+    CHECK_EQUAL(1, placements[2].cpu);
+    CHECK_EQUAL(2, placements[0].cpu);
+    CHECK_EQUAL(3, placements[1].cpu);
+}
+
+TEST(Conflicts)
+{
+    // More realtime subsystems than cores
+    Planner planner(smtTopology());
+    for (int i = 0; i < 5; ++i)
+        planner.request("RT", Planner::REALTIME);
+    Planner::PlacementList placements = planner.plan();
+    CHECK_EQUAL(1u, planner.findConflicts(placements).size());
+
+    // Siblings are the same physical core
+    Planner::PlacementList pair(placements.begin(), placements.begin() + 2);
+    pair[0].cpu = 1;
+    pair[1].cpu = 5;
+    std::vector<std::string> warnings = planner.findConflicts(pair);
+    CHECK_EQUAL(1u, warnings.size());
+    if (!warnings.empty())
+    {
+        CHECK_EQUAL("Realtime subsystems RT, RT share physical core 1 "
+                    "(CPUs 1 5)", warnings[0]);
+    }
+}
+
+TEST(Sparse)
+{
+    // CPUs 0, 1, 4 and 6, the last isolated, as with "isolcpus=6" and the
+    // others offline
+    std::vector<core::CpuInfo> cpus;
+    cpus.push_back(core::CpuInfo(0, 0, 0));
+    cpus.push_back(core::CpuInfo(1, 0, 1));
+    cpus.push_back(core::CpuInfo(4, 0, 4));
+    cpus.push_back(core::CpuInfo(6, 0, 6, true));
+    core::CpuTopology topology(cpus);
+
+    Planner planner(topology);
+    planner.request("Controller", Planner::REALTIME);
+    planner.request("Vision", Planner::COMPUTE);
+    planner.request("Estimator", Planner::REALTIME);
+    planner.request("Network", Planner::IO);
+    Planner::PlacementList placements = planner.plan();
+
+    // Placed by CPU id, not by position, so past the number of CPUs
+    CHECK_EQUAL(6, placements[0].cpu);
+    CHECK_EQUAL(4, placements[2].cpu);
+    CHECK_EQUAL(1, placements[1].cpu);
+    CHECK_EQUAL(0, placements[3].cpu);
+    for (size_t i = 0; i < placements.size(); ++i)
+        CHECK(topology.getCoreOf(placements[i].cpu) >= 0);
+}
+
+TEST(NoCpus)
+{
+    Planner planner((core::CpuTopology()));
+    planner.request("Controller", Planner::REALTIME);
+    planner.request("Vision", Planner::COMPUTE);
+    Planner::PlacementList placements = planner.plan();
+    CHECK_EQUAL(-1, placements[0].cpu);
+    CHECK_EQUAL(-1, placements[1].cpu);
+}
+
+} // SUITE(PlacementPlanner)
@@ -303,3 +303,92 @@ TEST_FIXTURE(QueuedEventHubFixture, publichEventPublisher)
 
     connectionB->disconnect();
 }
+
+TEST_FIXTURE(QueuedEventHubFixture, coalescing)
+{
+    queuedEventHub->subscribeToAll(boost::bind(&Reciever::handler, &recv, _1));
+    queuedEventHub->setCoalescing("State");
+    CHECK(queuedEventHub->getCoalescing("State"));
+    CHECK(!queuedEventHub->getCoalescing("Found"));
+
+    // Interleave state updates from two publishers with discrete events
+    std::vector<ram::core::EventPtr> statesA;
+    for (int i = 0; i < 3; ++i)
+    {
+        statesA.push_back(ram::core::EventPtr(new ram::core::Event()));
+        publisherA.publish("State", statesA.back());
+        publisherA.publish("Found", ram::core::EventPtr(new ram::core::Event()));
+    }
+    ram::core::EventPtr stateB(new ram::core::Event());
+    publisherB.publish("State", stateB);
+
+    queuedEventHub->publishEvents();
+
+    // The newest state from A takes the place of the oldest, then come all
+    // the discrete events, in order
+    CHECK_EQUAL(5, recv.calls);
+    CHECK_EQUAL(statesA[2], recv.events[0]);
+    CHECK_EQUAL("Found", recv.events[1]->type);
+    CHECK_EQUAL("Found", recv.events[2]->type);
+    CHECK_EQUAL("Found", recv.events[3]->type);
+    CHECK_EQUAL(stateB, recv.events[4]);
+    CHECK_EQUAL(2u, queuedEventHub->getCoalescedCount("State"));
+    CHECK_EQUAL(0u, queuedEventHub->getCoalescedCount("Found"));
+
+    // Once published a new state is queued normally
+    publisherA.publish("State", ram::core::EventPtr(new ram::core::Event()));
+    queuedEventHub->publishEvents();
+    CHECK_EQUAL(6, recv.calls);
+    CHECK_EQUAL("State", recv.events[5]->type);
+
+    // Turning it off goes back to FIFO
+    queuedEventHub->setCoalescing("State", false);
+    publisherA.publish("State", ram::core::EventPtr(new ram::core::Event()));
+    publisherA.publish("State", ram::core::EventPtr(new ram::core::Event()));
+    queuedEventHub->publishEvents();
+    CHECK_EQUAL(8, recv.calls);
+    CHECK_EQUAL(2u, queuedEventHub->getCoalescedCount("State"));
+}
+
+TEST_FIXTURE(QueuedEventHubFixture, coalescingQueuedBefore)
+{
+    queuedEventHub->subscribeToAll(boost::bind(&Reciever::handler, &recv, _1));
+
+    // Queued before the type was coalesced, nothing newer replaces it
+    ram::core::EventPtr first(new ram::core::Event());
+    publisherA.publish("State", first);
+    queuedEventHub->setCoalescing("State");
+    queuedEventHub->publishEvents();
+    CHECK_EQUAL(1, recv.calls);
+    CHECK_EQUAL(first, recv.events[0]);
+
+    // When a newer one is queued after, only the newer one is published
+    queuedEventHub->setCoalescing("State", false);
+    publisherA.publish("State", ram::core::EventPtr(new ram::core::Event()));
+    queuedEventHub->setCoalescing("State");
+    ram::core::EventPtr second(new ram::core::Event());
+    publisherA.publish("State", second);
+    queuedEventHub->publishEvents();
+    CHECK_EQUAL(2, recv.calls);
+    CHECK_EQUAL(second, recv.events[1]);
+}
+
+TEST_FIXTURE(QueuedEventHubFixture, coalescingByNameLater)
+{
+    queuedEventHub->subscribeToAll(boost::bind(&Reciever::handler, &recv, _1));
+
+    // The type doesn't exist until after the name is given
+    queuedEventHub->setCoalescingByName("ram::test::LATE_COALESCED_UPDATE");
+    ram::core::Event::EventType type("42 ram::test::LATE_COALESCED_UPDATE");
+    CHECK(!queuedEventHub->getCoalescing(type));
+
+    ram::core::EventPtr newest(new ram::core::Event());
+    publisherA.publish(type, ram::core::EventPtr(new ram::core::Event()));
+    publisherA.publish(type, newest);
+    queuedEventHub->publishEvents();
+
+    CHECK(queuedEventHub->getCoalescing(type));
+    CHECK_EQUAL(1, recv.calls);
+    CHECK_EQUAL(newest, recv.events[0]);
+    CHECK_EQUAL(1u, queuedEventHub->getCoalescedCount(type));
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestSnapshotPointer.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/SnapshotPointer.h"
+
+using namespace ram;
+
+SUITE(SnapshotPointer) {
+
+/** Marks itself dead when deleted, so readers can tell if they were too late */
+struct Value
+{
+    Value(int value_, int* live_) : value(value_), alive(true), live(live_)
+    {
+        (*live)++;
+    }
+
+    ~Value()
+    {
+        alive = false;
+        (*live)--;
+    }
+
+    int value;
+    volatile bool alive;
+    int* live;
+};
+
+TEST(Reset)
+{
+    int live = 0;
+    {
+        core::SnapshotPointer<Value> pointer(new Value(1, &live));
+        CHECK_EQUAL(1, pointer.get()->value);
+        {
+            core::SnapshotPointer<Value>::ScopedRead read(pointer);
+            CHECK_EQUAL(1, read.get()->value);
+        }
+
+        // The old value is deleted
+        pointer.reset(new Value(2, &live));
+        CHECK_EQUAL(1, live);
+        CHECK_EQUAL(2, pointer.get()->value);
+
+        core::SnapshotPointer<Value>::ScopedRead read(pointer);
+        CHECK_EQUAL(2, read.get()->value);
+    }
+
+    // So is the last one
+    CHECK_EQUAL(0, live);
+}
+
+void readValues(core::SnapshotPointer<Value>* pointer, volatile bool* done,
+                volatile bool* failed)
+{
+    while (!*done)
+    {
+        core::SnapshotPointer<Value>::ScopedRead read(*pointer);
+        if (!read.get()->alive)
+            *failed = true;
+    }
+}
+
+TEST(ConcurrentReaders)
+{
+    int live = 0;
+    core::SnapshotPointer<Value> pointer(new Value(0, &live));
+    volatile bool done = false;
+    volatile bool failed = false;
+
+    boost::thread_group readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.create_thread(boost::bind(readValues, &pointer, &done,
+                                          &failed));
+    }
+
+    // The readers never see a deleted value
+    for (int i = 1; i < 2000; ++i)
+        pointer.reset(new Value(i, &live));
+
+    done = true;
+    readers.join_all();
+    CHECK(!failed);
+    CHECK_EQUAL(1999, pointer.get()->value);
+}
+
+} // SUITE(SnapshotPointer)
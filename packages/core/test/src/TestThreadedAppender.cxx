@@ -8,15 +8,23 @@
  */
 
 // STD Includes
+#include <cstdio>
+#include <fstream>
+#include <string>
 #include <vector>
 
 // Library Includes
 #include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
 #include <log4cpp/Category.hh>
 #include <log4cpp/LayoutAppender.hh>
+#include <log4cpp/PatternLayout.hh>
 
 // Project Includes
 #include "core/include/ThreadedAppender.h"
+#include "core/include/BatchFileAppender.h"
+#include "core/include/BoundedQueue.h"
 #include "core/test/include/BufferedAppender.h"
 
 using namespace ram;
@@ -68,3 +76,141 @@ TEST_FIXTURE(ThreadedAppenderFixture, update)
     CHECK_EQUAL(1u, appender->logEvents.size());
     CHECK_EQUAL("Test", appender->logEvents[0].message);
 }
+
+TEST_FIXTURE(ThreadedAppenderFixture, dropped)
+{
+    // Replace with an appender with a tiny queue
+    core::ThreadedAppender* smallAppender = new core::ThreadedAppender(
+        new BufferedAppender("Small"),
+        new core::BoundedQueue<core::LoggingEvent>(
+            2, core::BoundedQueueBase::DROP_NEWEST));
+    smallAppender->unbackground(true);
+    category->setAppender(smallAppender);
+
+    for (int i = 0; i < 5; ++i)
+        category->error("Test");
+    CHECK_EQUAL(3u, smallAppender->getDroppedCount());
+
+    // The kept events, then a note of what was lost
+    smallAppender->update(0.0);
+    BufferedAppender* buffered =
+        dynamic_cast<BufferedAppender*>(smallAppender->wrappedAppender());
+    CHECK_EQUAL(3u, buffered->logEvents.size());
+    if (3u == buffered->logEvents.size())
+    {
+        CHECK_EQUAL("Test", buffered->logEvents[1].message);
+        CHECK_EQUAL("% Dropped 3 log messages", buffered->logEvents[2].message);
+    }
+}
+
+static const char* BATCH_LOG_NAME = "TestThreadedAppender.log";
+
+struct BatchAppenderFixture
+{
+    BatchAppenderFixture(double flushInterval = 0) :
+        fileAppender(new core::BatchFileAppender("Batch", BATCH_LOG_NAME,
+                                                 flushInterval)),
+        threadedAppender(new core::ThreadedAppender(fileAppender)),
+        category(0)
+    {
+        log4cpp::Category::getInstance("BatchTesting");
+        category = log4cpp::Category::exists("BatchTesting");
+        category->setAppender(threadedAppender);
+    }
+
+    ~BatchAppenderFixture()
+    {
+        log4cpp::Category::shutdown();
+        std::remove(BATCH_LOG_NAME);
+    }
+
+    std::vector<std::string> readLines()
+    {
+        std::vector<std::string> lines;
+        std::ifstream file(BATCH_LOG_NAME);
+        std::string line;
+        while (std::getline(file, line))
+            lines.push_back(line);
+        return lines;
+    }
+
+    core::BatchFileAppender* fileAppender;
+    core::ThreadedAppender* threadedAppender;
+    log4cpp::Category* category;
+};
+
+struct SlowBatchAppenderFixture : public BatchAppenderFixture
+{
+    SlowBatchAppenderFixture() : BatchAppenderFixture(1000) {}
+};
+
+TEST_FIXTURE(BatchAppenderFixture, batchWrite)
+{
+    threadedAppender->unbackground(true);
+
+    for (int i = 0; i < 100; ++i)
+        category->error("Test");
+
+    // All the events go out in a single write
+    threadedAppender->update(0.0);
+    CHECK_EQUAL(1u, fileAppender->getWriteCount());
+    CHECK_EQUAL(100u, readLines().size());
+}
+
+TEST_FIXTURE(SlowBatchAppenderFixture, flushInterval)
+{
+    threadedAppender->unbackground(true);
+
+    // Held until the flush interval passes
+    category->error("Test");
+    threadedAppender->update(0.0);
+    CHECK_EQUAL(0u, fileAppender->getWriteCount());
+    CHECK(fileAppender->getBufferedSize() > 0);
+
+    fileAppender->flush();
+    CHECK_EQUAL(1u, fileAppender->getWriteCount());
+    CHECK_EQUAL(1u, readLines().size());
+}
+
+static void logLoop(log4cpp::Category* category, int count)
+{
+    for (int i = 0; i < count; ++i)
+        category->info("Conserved test message");
+}
+
+TEST_FIXTURE(BatchAppenderFixture, messagesConserved)
+{
+    // Only the message on each line, so they can be matched exactly
+    log4cpp::PatternLayout* layout = new log4cpp::PatternLayout();
+    layout->setConversionPattern("%m%n");
+    fileAppender->setLayout(layout);
+
+    const int THREADS = 4;
+    const int COUNT = 20000;
+    std::vector<boost::thread*> threads;
+    for (int i = 0; i < THREADS; ++i)
+    {
+        threads.push_back(new boost::thread(
+            boost::bind(&logLoop, category, COUNT)));
+    }
+    for (int i = 0; i < THREADS; ++i)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    // Stops the background thread and writes everything still queued
+    size_t dropped = threadedAppender->getDroppedCount();
+    log4cpp::Category::shutdown();
+
+    // Every message is either written or counted as dropped
+    std::vector<std::string> lines = readLines();
+    size_t written = 0;
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        if ("Conserved test message" == lines[i])
+            ++written;
+    }
+    CHECK(dropped < (size_t)(THREADS * COUNT));
+    CHECK_EQUAL((size_t)(THREADS * COUNT), written + dropped);
+}
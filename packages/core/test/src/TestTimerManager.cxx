@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestTimerManager.cxx
+ */
+
+// STD Includes
+#include <cstdlib>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/TimerManager.h"
+#include "core/include/EventHub.h"
+#include "core/include/ConfigNode.h"
+#include "core/include/TimeVal.h"
+
+using namespace ram;
+
+/** Records the monotonic time of each timer event */
+struct TimerReciever
+{
+    TimerReciever() : calls(0) {}
+
+    void handler(core::EventPtr)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        times.push_back(core::TimeVal::monotonic().get_double());
+        ++calls;
+    }
+
+    int getCalls()
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        return calls;
+    }
+
+    /** Waits up to a second for the given number of calls */
+    bool waitForCalls(int count)
+    {
+        for (int i = 0; i < 100 && (getCalls() < count); ++i)
+            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        return getCalls() >= count;
+    }
+
+    int calls;
+    std::vector<double> times;
+    boost::mutex mutex;
+};
+
+struct TimerManagerFixture
+{
+    TimerManagerFixture() :
+        eventHub(new core::EventHub()),
+        deps(1, eventHub),
+        manager(core::ConfigNode::fromString("{ 'resolution' : 1 }"), deps)
+    {}
+
+    core::EventHubPtr eventHub;
+    core::SubsystemList deps;
+    core::TimerManager manager;
+};
+
+SUITE(TimerManager) {
+
+TEST(wheelOrder)
+{
+    // Timers on every level, and past the end of the last one
+    boost::int64_t delays[] = {0, 1, 5, 255, 256, 257, 1000, 16383, 16384,
+                               100000, 2000000, core::TimingWheel::MAX_TICKS,
+                               core::TimingWheel::MAX_TICKS + 3};
+    size_t count = sizeof(delays) / sizeof(delays[0]);
+
+    core::SubsystemList noDeps;
+    core::TimerManager manager(core::ConfigNode::fromString("{}"), noDeps);
+    manager.unbackground(true);
+
+    core::TimingWheel wheel(7);
+    std::vector<core::TimerPtr> timers;
+    for (size_t i = 0; i < count; ++i)
+    {
+        timers.push_back(manager.newTimer("Type", 1));
+        wheel.add(timers.back(), 7 + delays[i]);
+    }
+    CHECK_EQUAL(count, wheel.size());
+
+    // Jump in uneven steps, checking each timer comes out on its tick
+    std::vector<core::TimerPtr> expired;
+    size_t found = 0;
+    boost::int64_t end = 7 + core::TimingWheel::MAX_TICKS + 4;
+    while (wheel.getTick() < end)
+    {
+        boost::int64_t next = wheel.getNextTick();
+        CHECK(next >= wheel.getTick());
+        wheel.advance(std::min(end, wheel.getTick() + 1 + (std::rand() % 5000)),
+                      expired);
+
+        for (; found < expired.size(); ++found)
+        {
+            CHECK(timers[found] == expired[found]);
+            CHECK(7 + delays[found] < wheel.getTick());
+            CHECK(7 + delays[found] >= next);
+        }
+    }
+
+    CHECK_EQUAL(count, expired.size());
+    CHECK_EQUAL(0u, wheel.size());
+    CHECK_EQUAL(-1, wheel.getNextTick());
+}
+
+TEST(wheelCancel)
+{
+    core::SubsystemList noDeps;
+    core::TimerManager manager(core::ConfigNode::fromString("{}"), noDeps);
+    manager.unbackground(true);
+
+    core::TimingWheel wheel;
+    core::TimerPtr near = manager.newTimer("Type", 1);
+    core::TimerPtr far = manager.newTimer("Type", 1);
+    wheel.add(near, 10);
+    wheel.add(far, 10000);
+    near->cancel();
+    far->cancel();
+
+    // Canceled timers are dropped when they come up
+    std::vector<core::TimerPtr> expired;
+    wheel.advance(20000, expired);
+    CHECK_EQUAL(0u, expired.size());
+    CHECK_EQUAL(0u, wheel.size());
+}
+
+TEST_FIXTURE(TimerManagerFixture, oneShot)
+{
+    TimerReciever recv;
+    eventHub->subscribeToType("Timer",
+        boost::bind(&TimerReciever::handler, &recv, _1));
+
+    double start = core::TimeVal::monotonic().get_double();
+    core::TimerPtr timer = manager.newTimer("Timer", 0.05);
+    CHECK(timer->active());
+
+    CHECK(recv.waitForCalls(1));
+    if (1 == recv.getCalls())
+    {
+        double delay = recv.times[0] - start;
+        CHECK(delay >= 0.05);
+        CHECK_CLOSE(0.05, delay, 0.03);
+    }
+
+    // Fires once only
+    boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+    CHECK_EQUAL(1, recv.getCalls());
+    CHECK_EQUAL(1, timer->getFireCount());
+    CHECK(!timer->active());
+    CHECK_EQUAL(0u, manager.getTimerCount());
+}
+
+TEST_FIXTURE(TimerManagerFixture, repeat)
+{
+    TimerReciever recv;
+    eventHub->subscribeToType("Timer",
+        boost::bind(&TimerReciever::handler, &recv, _1));
+
+    core::TimerPtr timer = manager.newTimer("Timer", 0.02, true);
+    CHECK(recv.waitForCalls(5));
+    timer->cancel();
+    int calls = recv.getCalls();
+
+    boost::this_thread::sleep(boost::posix_time::milliseconds(60));
+    CHECK(recv.getCalls() <= calls + 1);
+    CHECK(!timer->active());
+
+    // Periods don't drift, each is measured from the last deadline
+    if (recv.times.size() >= 5)
+    {
+        double average = (recv.times[4] - recv.times[0]) / 4;
+        CHECK_CLOSE(0.02, average, 0.005);
+    }
+}
+
+TEST_FIXTURE(TimerManagerFixture, cancel)
+{
+    TimerReciever recv;
+    eventHub->subscribeToType("Timer",
+        boost::bind(&TimerReciever::handler, &recv, _1));
+
+    core::TimerPtr timer = manager.newTimer("Timer", 0.03);
+    timer->cancel();
+    CHECK(!timer->active());
+
+    boost::this_thread::sleep(boost::posix_time::milliseconds(80));
+    CHECK_EQUAL(0, recv.getCalls());
+    CHECK_EQUAL(0, timer->getFireCount());
+}
+
+TEST_FIXTURE(TimerManagerFixture, publisher)
+{
+    // Events go out through the given publisher
+    core::EventPublisher publisher(eventHub);
+    TimerReciever recv;
+    eventHub->subscribe("Timer", &publisher,
+        boost::bind(&TimerReciever::handler, &recv, _1));
+
+    manager.newTimer("Timer", 0.01, false, &publisher);
+    CHECK(recv.waitForCalls(1));
+}
+
+TEST_FIXTURE(TimerManagerFixture, many)
+{
+    TimerReciever recv;
+    eventHub->subscribeToType("Timer",
+        boost::bind(&TimerReciever::handler, &recv, _1));
+
+    // Lots of timers don't need lots of threads
+    std::vector<core::TimerPtr> timers;
+    for (int i = 0; i < 500; ++i)
+        timers.push_back(manager.newTimer("Timer", 0.001 * (i % 50)));
+
+    CHECK(recv.waitForCalls(500));
+    CHECK_EQUAL(0u, manager.getTimerCount());
+}
+
+} // SUITE(TimerManager)
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestTracer.cxx
+ */
+
+// STD Includes
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+
+// Project Includes
+#include "core/include/Tracer.h"
+#include "core/include/EventProfiler.h"
+#include "core/include/EventHub.h"
+#include "core/include/EventPublisher.h"
+#include "core/include/EventConnection.h"
+#include "core/include/Logging.h"
+#include "core/include/Updatable.h"
+#include "core/include/TimeVal.h"
+#include "core/test/include/Reciever.h"
+
+using namespace ram;
+
+static const std::string TRACE_NAME("test_trace.json");
+
+struct TracerFixture
+{
+    TracerFixture() :
+        tracePath((core::Logging::getLogDir() / TRACE_NAME).string()),
+        config(core::ConfigNode::fromString(
+                   "{ 'fileName' : '" + TRACE_NAME + "' }"))
+    {
+    }
+
+    ~TracerFixture()
+    {
+        std::remove(tracePath.c_str());
+    }
+
+    std::string readTrace()
+    {
+        std::ifstream file(tracePath.c_str());
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    std::string tracePath;
+    core::ConfigNode config;
+};
+
+// Publishes a second event from inside its handler
+struct Relay : public Reciever
+{
+    Relay(core::EventPublisher* publisher_) : publisher(publisher_) {}
+
+    void handler(core::EventPtr event)
+    {
+        Reciever::handler(event);
+        publisher->publish("Second", core::EventPtr(new core::Event()));
+    }
+
+    core::EventPublisher* publisher;
+};
+
+// Publishes an event on every update
+class Source : public core::Updatable
+{
+public:
+    Source(core::EventPublisher* publisher) : m_publisher(publisher) {}
+
+    virtual void update(double)
+    {
+        m_publisher->publish("First", core::EventPtr(new core::Event()));
+    }
+
+private:
+    core::EventPublisher* m_publisher;
+};
+
+SUITE(Tracer) {
+
+TEST(Inactive)
+{
+    CHECK_EQUAL(false, core::Tracer::active());
+
+    // No IDs are handed out without a tracer
+    Reciever recv;
+    core::EventPublisher publisher;
+    core::EventConnectionPtr connection = publisher.subscribe(
+        "First", boost::bind(&Reciever::handler, &recv, _1));
+    publisher.publish("First", core::EventPtr(new core::Event()));
+
+    CHECK_EQUAL(1, recv.calls);
+    CHECK_EQUAL(0u, recv.events[0]->traceId);
+    connection->disconnect();
+}
+
+TEST_FIXTURE(TracerFixture, Causality)
+{
+    core::Tracer tracer(config);
+    core::EventHubPtr eventHub(new core::EventHub());
+    core::EventPublisher publisher(eventHub);
+
+    Relay relay(&publisher);
+    Reciever recv;
+    core::EventConnectionPtr first = publisher.subscribe(
+        "First", boost::bind(&Relay::handler, &relay, _1));
+    core::EventConnectionPtr second = eventHub->subscribeToType(
+        "Second", boost::bind(&Reciever::handler, &recv, _1));
+
+    publisher.publish("First", core::EventPtr(new core::Event()));
+    CHECK_EQUAL(1, relay.calls);
+    CHECK_EQUAL(1, recv.calls);
+
+    // The second event was caused by the first
+    core::EventPtr cause = relay.events[0];
+    core::EventPtr effect = recv.events[0];
+    CHECK(0u != cause->traceId);
+    CHECK_EQUAL(0u, cause->parentTraceId);
+    CHECK(cause->traceId != effect->traceId);
+    CHECK_EQUAL(cause->traceId, effect->parentTraceId);
+
+    // And nothing is left behind on the thread
+    CHECK_EQUAL(0u, core::Tracer::currentContext());
+
+    first->disconnect();
+    second->disconnect();
+}
+
+TEST_FIXTURE(TracerFixture, ScopedContext)
+{
+    core::Tracer tracer(config);
+    Reciever recv;
+    core::EventPublisher publisher;
+    core::EventConnectionPtr connection = publisher.subscribe(
+        "First", boost::bind(&Reciever::handler, &recv, _1));
+
+    {
+        core::Tracer::ScopedContext context(42);
+        CHECK_EQUAL(42u, core::Tracer::currentContext());
+
+        // Zero keeps the current context
+        core::Tracer::ScopedContext ignored(0);
+        publisher.publish("First", core::EventPtr(new core::Event()));
+    }
+    CHECK_EQUAL(0u, core::Tracer::currentContext());
+    CHECK_EQUAL(42u, recv.events[0]->parentTraceId);
+
+    connection->disconnect();
+}
+
+TEST_FIXTURE(TracerFixture, Profiler)
+{
+    core::EventProfiler::resetProfiles();
+    Reciever recv;
+    core::EventPublisher publisher;
+    core::EventConnectionPtr connection = publisher.subscribe(
+        "First", boost::bind(&Reciever::handler, &recv, _1));
+
+    {
+        core::EventProfiler profiler(core::ConfigNode::fromString(
+                                         "{ 'fileName' : '' }"));
+        core::Tracer tracer(config);
+        publisher.publish("First", core::EventPtr(new core::Event()));
+    }
+    CHECK_EQUAL(1, recv.calls);
+
+    // Tracing doesn't hide the handler from the profiler
+    core::EventTypeProfilePtr profile =
+        core::EventProfiler::getProfile("First");
+    CHECK(profile);
+    if (profile)
+    {
+        CHECK_EQUAL(1u, profile->handlers.size());
+        if (1u == profile->handlers.size())
+            CHECK_EQUAL(1, profile->handlers.begin()->second->cost.getCount());
+    }
+
+    core::EventProfiler::resetProfiles();
+    connection->disconnect();
+}
+
+TEST_FIXTURE(TracerFixture, ChromeTrace)
+{
+    {
+        core::Tracer tracer(config);
+        core::EventPublisher publisher;
+        Reciever recv;
+        core::EventConnectionPtr connection = publisher.subscribe(
+            "First", boost::bind(&Reciever::handler, &recv, _1));
+
+        Source source(&publisher);
+        source.update(0);
+        tracer.flush();
+        CHECK_EQUAL(0u, tracer.getDroppedCount());
+
+        // Only update() from the background thread, or the scheduler, is
+        // recorded
+        source.background(1);
+        while (recv.calls < 2)
+            core::TimeVal::sleep(0.001);
+        source.unbackground(true);
+        connection->disconnect();
+    }
+
+    std::string trace = readTrace();
+    CHECK_EQUAL('[', trace[0]);
+    CHECK_EQUAL("]\n", trace.substr(trace.size() - 2));
+    CHECK(std::string::npos != trace.find("\"cat\":\"publish\""));
+    CHECK(std::string::npos != trace.find("\"cat\":\"handler\""));
+    CHECK(std::string::npos != trace.find("\"cat\":\"update\""));
+    CHECK(std::string::npos != trace.find("\"name\":\"Source\""));
+    CHECK(std::string::npos != trace.find("\"ph\":\"s\""));
+    CHECK(std::string::npos != trace.find("\"bp\":\"e\""));
+}
+
+} // SUITE(Tracer)
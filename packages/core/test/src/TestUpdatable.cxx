@@ -30,6 +30,8 @@ get the mutex from the lower priority threads.
 
 // Project Includes
 #include "core/include/Updatable.h"
+#include "core/include/TimeVal.h"
+#include "core/include/CpuTopology.h"
 
 #ifdef RAM_LINUX
 // Linux Includes
@@ -93,6 +95,19 @@ TEST(setPriority)
 }
 
 #ifdef RAM_LINUX
+TEST(CPUOnline)
+{
+    // Every online CPU, even if isolated or past a gap in the numbering
+    std::vector<ram::core::CpuInfo> cpus =
+        ram::core::CpuTopology::fromSysfs().getCpus();
+    CHECK_EQUAL(cpus.size(), ram::core::Updatable::getCPUCount());
+    for (size_t i = 0; i < cpus.size(); ++i)
+        CHECK(ram::core::Updatable::isCPUOnline(cpus[i].id));
+
+    CHECK(!ram::core::Updatable::isCPUOnline(-1));
+    CHECK(!ram::core::Updatable::isCPUOnline(cpus.back().id + 1));
+}
+
 TEST(getTID)
 {
 /*    int myTID = gettid();
@@ -109,3 +124,113 @@ TEST(getTID)
 #endif // RAM_LINUX
 
 } // SUITE(Updatable)
+
+// Sleeps in its update to cause overruns
+class Sleeper : public ram::core::Updatable
+{
+public:
+    Sleeper() : sleep(0), count(0) {}
+
+    ~Sleeper()
+        {
+            unbackground(true);
+        }
+    
+    virtual void update(double)
+        {
+            count++;
+            if (sleep > 0)
+                ram::core::TimeVal::sleep(sleep);
+        }
+
+    double sleep;
+    int count;
+};
+
+SUITE(UpdatableStats)
+{
+
+TEST(Record)
+{
+    ram::core::UpdatableStats stats;
+    stats.record(0.01, 0, 0.002, 0.0001);
+    stats.record(0.01, 0.0102, 0.004, 0.0002);
+    stats.record(0.01, 0.013, 0.009, 0.003);
+
+    CHECK_EQUAL(3u, stats.updates);
+    CHECK_EQUAL(1u, stats.overruns);
+    CHECK_CLOSE(0.009, stats.lastDuration, 1e-9);
+    CHECK_CLOSE(0.005, stats.meanDuration, 1e-9);
+    CHECK_CLOSE(0.009, stats.maxDuration, 1e-9);
+    CHECK_CLOSE(0.003, stats.maxLatency, 1e-9);
+
+    // 200us and 3ms of jitter, the first update has no period
+    CHECK_EQUAL(1u, stats.jitter[2]);
+    CHECK_EQUAL(1u, stats.jitter[6]);
+
+    stats.reset();
+    CHECK_EQUAL(0u, stats.updates);
+    CHECK_EQUAL(0u, stats.jitter[2]);
+}
+
+// Waits, up to a generous timeout, for the sleeper to run the given number of
+// updates so the checks below depend on counts instead of wall clock time
+static void waitForUpdates(Sleeper& sleeper, int updates)
+{
+    for (int i = 0; (i < 5000) && (sleeper.count < updates); ++i)
+        ram::core::TimeVal::sleep(0.001);
+}
+
+TEST(BackgroundStats)
+{
+    Sleeper sleeper;
+    sleeper.background(10);
+    waitForUpdates(sleeper, 5);
+    sleeper.unbackground(true);
+
+    ram::core::UpdatableStats stats = sleeper.getStats();
+    CHECK(stats.updates >= 5);
+    CHECK_EQUAL((unsigned long)sleeper.count, stats.updates);
+
+    sleeper.resetStats();
+    CHECK_EQUAL(0u, sleeper.getStats().updates);
+}
+
+TEST(SkipMissed)
+{
+    // Every update takes 1.5 periods, so every update overruns
+    Sleeper sleeper;
+    sleeper.sleep = 0.015;
+    ram::core::TimeVal start(ram::core::TimeVal::timeOfDay());
+    sleeper.background(10);
+    waitForUpdates(sleeper, 5);
+    sleeper.unbackground(true);
+    double elapsed = ram::core::TimeVal::timeOfDay().get_double() -
+        start.get_double();
+
+    ram::core::UpdatableStats stats = sleeper.getStats();
+    CHECK(stats.updates >= 5);
+    CHECK_EQUAL(stats.updates, stats.overruns);
+
+    // The updates run one after another, never faster than they sleep
+    CHECK(stats.updates * sleeper.sleep <= elapsed);
+}
+
+TEST(CatchUp)
+{
+    Sleeper sleeper;
+    sleeper.sleep = 0.015;
+    sleeper.setOverrunPolicy(ram::core::Updatable::CATCH_UP);
+    sleeper.background(10);
+    waitForUpdates(sleeper, 5);
+    sleeper.unbackground(true);
+
+    // Runs back to back trying to catch up, so each update starts 5ms later
+    // than the one before it relative to its deadline
+    ram::core::UpdatableStats stats = sleeper.getStats();
+    CHECK(stats.updates >= 5);
+    CHECK_EQUAL(stats.updates, stats.overruns);
+    CHECK(stats.maxLatency > 0.01);
+}
+
+} // SUITE(UpdatableStats)
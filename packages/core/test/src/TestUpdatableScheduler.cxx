@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestUpdatableScheduler.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/UpdatableScheduler.h"
+#include "core/include/Updatable.h"
+#include "core/include/TimeVal.h"
+
+using namespace ram;
+
+// Counts updates and records whether two ever ran at once
+class Counter : public core::Updatable
+{
+public:
+    Counter(int sleepMs = 0) :
+        count(0), active(0), overlapped(false), lastTimestep(0),
+        m_sleepMs(sleepMs)
+    {
+        setThreadMode(SHARED_POOL);
+    }
+
+    ~Counter()
+    {
+        unbackground(true);
+    }
+
+    virtual void update(double timestep)
+    {
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            active++;
+            overlapped = overlapped || (active > 1);
+            lastTimestep = timestep;
+        }
+
+        if (m_sleepMs)
+            core::TimeVal::sleep(m_sleepMs / 1000.0);
+
+        boost::mutex::scoped_lock lock(mutex);
+        active--;
+        count++;
+    }
+
+    int getCount()
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        return count;
+    }
+
+    boost::mutex mutex;
+    int count;
+    int active;
+    bool overlapped;
+    double lastTimestep;
+
+private:
+    int m_sleepMs;
+};
+
+// Unbackgrounds itself from inside its update
+class OneShot : public core::Updatable
+{
+public:
+    OneShot() : count(0) { setThreadMode(SHARED_POOL); }
+
+    ~OneShot() { unbackground(true); }
+
+    virtual void update(double)
+    {
+        count++;
+        unbackground(true);
+    }
+
+    int count;
+};
+
+SUITE(UpdatableScheduler) {
+
+TEST(ThreadModeString)
+{
+    CHECK_EQUAL(core::Updatable::SHARED_POOL,
+                core::Updatable::stringToThreadMode("pool"));
+    CHECK_EQUAL(core::Updatable::DEDICATED_THREAD,
+                core::Updatable::stringToThreadMode("Thread"));
+}
+
+TEST(PeriodicUpdates)
+{
+    Counter counter;
+    counter.background(10);
+    CHECK(counter.backgrounded());
+    CHECK(core::UpdatableScheduler::getInstance()->scheduled(&counter));
+
+    core::TimeVal::sleep(0.2);
+    counter.unbackground(true);
+    CHECK(!core::UpdatableScheduler::getInstance()->scheduled(&counter));
+
+    // Roughly 20 updates, with room for a slow machine
+    int count = counter.getCount();
+    CHECK(count >= 10);
+    CHECK(count <= 22);
+    CHECK_CLOSE(0.01, counter.lastTimestep, 0.008);
+
+    // No more updates once unbackgrounded
+    core::TimeVal::sleep(0.05);
+    CHECK_EQUAL(count, counter.getCount());
+}
+
+TEST(SharedWorkers)
+{
+    core::UpdatableScheduler scheduler(2);
+    Counter counters[8];
+    for (int i = 0; i < 8; ++i)
+        scheduler.schedule(&counters[i], 5, core::IUpdatable::NORMAL_PRIORITY);
+
+    core::TimeVal::sleep(0.1);
+    for (int i = 0; i < 8; ++i)
+        scheduler.unschedule(&counters[i], true);
+
+    // All share the one pool, and every object was updated
+    CHECK_EQUAL(1u, scheduler.getPoolCount());
+    CHECK_EQUAL(2u, scheduler.getThreadCount());
+    for (int i = 0; i < 8; ++i)
+        CHECK(counters[i].getCount() > 5);
+}
+
+TEST(NeverConcurrent)
+{
+    // A slow update with a short interval, on many workers
+    core::UpdatableScheduler scheduler(4);
+    Counter counter(5);
+    scheduler.schedule(&counter, 1, core::IUpdatable::NORMAL_PRIORITY);
+    core::TimeVal::sleep(0.1);
+    scheduler.unschedule(&counter, true);
+
+    CHECK(counter.getCount() > 5);
+    CHECK(!counter.overlapped);
+}
+
+TEST(PriorityPools)
+{
+    core::UpdatableScheduler scheduler(1);
+    Counter counter;
+    scheduler.schedule(&counter, 5, core::IUpdatable::NORMAL_PRIORITY);
+    scheduler.schedule(&counter, 5, core::IUpdatable::LOW_PRIORITY);
+    CHECK_EQUAL(2u, scheduler.getPoolCount());
+
+    // Moving pools keeps it updating
+    core::TimeVal::sleep(0.05);
+    int count = counter.getCount();
+    core::TimeVal::sleep(0.05);
+    scheduler.unschedule(&counter, true);
+    CHECK(counter.getCount() > count);
+    CHECK(!counter.overlapped);
+}
+
+TEST(UnbackgroundInUpdate)
+{
+    OneShot oneShot;
+    oneShot.background(1);
+    core::TimeVal::sleep(0.05);
+    CHECK_EQUAL(1, oneShot.count);
+    CHECK(!oneShot.backgrounded());
+}
+
+} // SUITE(UpdatableScheduler)
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/core/test/src/TestWorkerPool.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/WorkerPool.h"
+#include "core/include/CountDownLatch.h"
+#include "core/include/Atomic.h"
+
+using namespace ram;
+
+static void work(core::AtomicCounter* count, core::CountDownLatch* done)
+{
+    count->increment();
+    done->countDown();
+}
+
+// Waits until the other task has started, so both must be running at once
+static void meet(core::CountDownLatch* arrived, core::CountDownLatch* done)
+{
+    arrived->countDown();
+    arrived->await();
+    done->countDown();
+}
+
+SUITE(WorkerPool) {
+
+TEST(ThreadCount)
+{
+    core::WorkerPool pool(3);
+    CHECK_EQUAL(3u, pool.getThreadCount());
+
+    // One per CPU by default
+    core::WorkerPool defaultPool;
+    CHECK(defaultPool.getThreadCount() >= 1u);
+}
+
+TEST(RunsEveryTask)
+{
+    core::AtomicCounter count;
+    core::CountDownLatch done(100);
+    core::WorkerPool pool(4);
+
+    for (int i = 0; i < 100; ++i)
+        pool.submit(boost::bind(work, &count, &done));
+    done.await();
+
+    CHECK_EQUAL(100, count.get());
+}
+
+TEST(Concurrent)
+{
+    core::CountDownLatch arrived(2);
+    core::CountDownLatch done(2);
+    core::WorkerPool pool(2);
+
+    pool.submit(boost::bind(meet, &arrived, &done));
+    pool.submit(boost::bind(meet, &arrived, &done));
+    done.await();
+    CHECK_EQUAL(0, done.getCount());
+}
+
+TEST(FinishesOnDestruction)
+{
+    core::AtomicCounter count;
+    core::CountDownLatch done(10);
+    {
+        core::WorkerPool pool(1);
+        for (int i = 0; i < 10; ++i)
+            pool.submit(boost::bind(work, &count, &done));
+    }
+    CHECK_EQUAL(10, count.get());
+}
+
+} // SUITE(WorkerPool)
@@ -16,6 +16,7 @@
 #include "estimation/include/EstimatedState.h"
 #include "math/include/Events.h"
 #include "core/include/ReadWriteMutex.h"
+#include "core/include/EventPool.h"
 
 namespace ram {
 namespace estimation {
@@ -268,21 +269,24 @@ ObstaclePtr EstimatedState::getObstacle(Obstacle::ObstacleType name)
 
 void EstimatedState::publishPositionUpdate(const math::Vector2& position)
 {
-    math::Vector2EventPtr event(new math::Vector2Event());
+    math::Vector2EventPtr event =
+        core::EventPool<math::Vector2Event>::create();
     event->vector2 = position;
     publish(estimation::IStateEstimator::ESTIMATED_POSITION_UPDATE, event);
 }
 
 void EstimatedState::publishVelocityUpdate(const math::Vector2& velocity)
 {
-    math::Vector2EventPtr event(new math::Vector2Event());
+    math::Vector2EventPtr event =
+        core::EventPool<math::Vector2Event>::create();
     event->vector2 = velocity;
     publish(estimation::IStateEstimator::ESTIMATED_VELOCITY_UPDATE, event);
 }
 
 void EstimatedState::publishLinearAccelUpdate(const math::Vector3& linearAccel)
 {
-    math::Vector3EventPtr event(new math::Vector3Event());
+    math::Vector3EventPtr event =
+        core::EventPool<math::Vector3Event>::create();
     event->vector3 = linearAccel;
     publish(estimation::IStateEstimator::ESTIMATED_LINEARACCELERATION_UPDATE,
             event);
@@ -290,35 +294,40 @@ void EstimatedState::publishLinearAccelUpdate(const math::Vector3& linearAccel)
 
 void EstimatedState::publishAngularRateUpdate(const math::Vector3& angularRate)
 {
-    math::Vector3EventPtr event(new math::Vector3Event());
+    math::Vector3EventPtr event =
+        core::EventPool<math::Vector3Event>::create();
     event->vector3 = angularRate;
     publish(estimation::IStateEstimator::ESTIMATED_ANGULARRATE_UPDATE, event);
 }
 
 void EstimatedState::publishOrientationUpdate(const math::Quaternion& orientation)
 {
-    math::OrientationEventPtr event(new math::OrientationEvent());
+    math::OrientationEventPtr event =
+        core::EventPool<math::OrientationEvent>::create();
     event->orientation = orientation;
     publish(estimation::IStateEstimator::ESTIMATED_ORIENTATION_UPDATE, event);
 }
 
 void EstimatedState::publishDepthUpdate(const double& depth)
 {
-    math::NumericEventPtr event(new math::NumericEvent());
+    math::NumericEventPtr event =
+        core::EventPool<math::NumericEvent>::create();
     event->number = depth;
     publish(estimation::IStateEstimator::ESTIMATED_DEPTH_UPDATE, event);
 }
 
 void EstimatedState::publishDepthRateUpdate(const double& depthRate)
 {
-    math::NumericEventPtr event(new math::NumericEvent());
+    math::NumericEventPtr event =
+        core::EventPool<math::NumericEvent>::create();
     event->number = depthRate;
     publish(estimation::IStateEstimator::ESTIMATED_DEPTHRATE_UPDATE, event);
 }
 
 void EstimatedState::publishBottomRangeUpdate(const double& bottomRange)
 {
-    math::NumericEventPtr event(new math::NumericEvent());
+    math::NumericEventPtr event =
+        core::EventPool<math::NumericEvent>::create();
     event->number = bottomRange;
     publish(estimation::IStateEstimator::ESTIMATED_BOTTOMRANGE_UPDATE, event);
 }
@@ -326,11 +335,13 @@ void EstimatedState::publishBottomRangeUpdate(const double& bottomRange)
 void EstimatedState::publishThrustUpdate(const math::Vector3& forces,
                                          const math::Vector3& torques)
 {
-    math::Vector3EventPtr fEvent(new math::Vector3Event());
+    math::Vector3EventPtr fEvent =
+        core::EventPool<math::Vector3Event>::create();
     fEvent->vector3 = forces;
     publish(estimation::IStateEstimator::ESTIMATED_FORCES_UPDATE, fEvent);
 
-    math::Vector3EventPtr tEvent(new math::Vector3Event());
+    math::Vector3EventPtr tEvent =
+        core::EventPool<math::Vector3Event>::create();
     tEvent->vector3 = torques;
     publish(estimation::IStateEstimator::ESTIMATED_TORQUES_UPDATE, tEvent);
 }
@@ -20,6 +20,7 @@
 
 // Project Includes
 #include "math/include/Helpers.h"
+#include "core/include/BinaryLogger.h"
 
 #include "estimation/include/Utility.h"
 #include "estimation/include/modules/BasicIMUEstimationModule.h"
@@ -27,6 +28,8 @@
 #include "vehicle/include/device/IIMU.h"
 
 static log4cpp::Category& LOGGER(log4cpp::Category::getInstance("StEstIMU"));
+static ram::core::BinaryLogger& BLOGGER(
+    ram::core::BinaryLogger::getInstance("StEstIMU"));
 
 namespace ram {
 namespace estimation {
@@ -238,27 +241,27 @@ void BasicIMUEstimationModule::update(core::EventPtr event)
     m_estimatedState->setEstimatedAngularRate(estAngularRate);
 
     // Log data directly
-    LOGGER.infoStream() << name << " "
-                        << m_filteredState[name]->accelX << " "
-                        << m_filteredState[name]->accelY << " "
-                        << m_filteredState[name]->accelZ << " "
-                        << m_filteredState[name]->magX << " "
-                        << m_filteredState[name]->magY << " "
-                        << m_filteredState[name]->magZ << " "
-                        << m_filteredState[name]->gyroX << " "
-                        << m_filteredState[name]->gyroY << " "
-                        << m_filteredState[name]->gyroZ << " "
-                        << newState.accelX << " "
-                        << newState.accelY << " "
-                        << newState.accelZ << " "
-                        << newState.magX << " " 
-                        << newState.magY << " "
-                        << newState.magZ << " "
-                        << newState.gyroX << " " 
-                        << newState.gyroY << " "
-                        << newState.gyroZ << " "
-                        << estOrientation[0] << " " << estOrientation[1] << " "
-                        << estOrientation[2] << " " << estOrientation[3];
+    RAM_CORE_BLOG_INFO(BLOGGER) << name
+                                << m_filteredState[name]->accelX
+                                << m_filteredState[name]->accelY
+                                << m_filteredState[name]->accelZ
+                                << m_filteredState[name]->magX
+                                << m_filteredState[name]->magY
+                                << m_filteredState[name]->magZ
+                                << m_filteredState[name]->gyroX
+                                << m_filteredState[name]->gyroY
+                                << m_filteredState[name]->gyroZ
+                                << newState.accelX
+                                << newState.accelY
+                                << newState.accelZ
+                                << newState.magX
+                                << newState.magY
+                                << newState.magZ
+                                << newState.gyroX
+                                << newState.gyroY
+                                << newState.gyroZ
+                                << estOrientation[0] << estOrientation[1]
+                                << estOrientation[2] << estOrientation[3];
 }
 
 } // namespace estimation
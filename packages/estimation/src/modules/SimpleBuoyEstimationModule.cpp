@@ -23,8 +23,10 @@
 #include "vision/include/Color.h"
 #include "math/include/Helpers.h"
 #include "math/include/Events.h"
+#include "core/include/BinaryLogger.h"
 
-static log4cpp::Category& LOGGER(log4cpp::Category::getInstance("StEstBuoy"));
+static ram::core::BinaryLogger& BLOGGER(
+    ram::core::BinaryLogger::getInstance("StEstBuoy"));
 
 namespace ram {
 namespace estimation {
@@ -129,15 +131,15 @@ void SimpleBuoyEstimationModule::update(core::EventPtr event)
     
     publish(IStateEstimator::ESTIMATED_OBSTACLE_UPDATE, obstacleEvent);
 
-    LOGGER.infoStream() << measurement_i[0] << " "
-                        << measurement_i[1] << " "
-                        << measurement_i[2] << " "
-                        << measurement_w[0] << " "
-                        << measurement_w[1] << " "
-                        << measurement_w[2] << " "
-                        << bestEstimate[0] << " "
-                        << bestEstimate[1] << " "
-                        << bestEstimate[2];
+    RAM_CORE_BLOG_INFO(BLOGGER) << measurement_i[0]
+                                << measurement_i[1]
+                                << measurement_i[2]
+                                << measurement_w[0]
+                                << measurement_w[1]
+                                << measurement_w[2]
+                                << bestEstimate[0]
+                                << bestEstimate[1]
+                                << bestEstimate[2];
 }
 
 math::Vector3 SimpleBuoyEstimationModule::getBestEstimate()
@@ -16,12 +16,13 @@
 
 // Library Includes
 #include <boost/archive/text_oarchive.hpp>
+#include <boost/scoped_ptr.hpp>
 
 // Project Includes
 #include "core/include/Subsystem.h"
 #include "core/include/Updatable.h"
 #include "core/include/ConfigNode.h"
-#include "core/include/ThreadedQueue.h"
+#include "core/include/IQueue.h"
 #include "logging/include/Common.h"
 
 namespace ram {
@@ -61,8 +62,12 @@ private:
     /** Connection for the recieved events */
     core::EventConnectionPtr m_connection;
 
-    /** Holds queued events we are goign to log to the file */
-    core::ThreadedQueue<core::EventPtr> m_eventQueue;
+    /** Holds queued events we are goign to log to the file
+     *
+     *  Unbounded by default, can be bounded with the "queue" config section
+     *  (see core::makeQueue)
+     */
+    boost::scoped_ptr<core::IQueue<core::EventPtr> > m_eventQueue;
 
     /** The file we are writing the data to */
     std::ofstream m_logFile;
@@ -105,7 +105,9 @@ namespace serialization {
 template<class Archive>
 void save(Archive& ar, const ram::core::Event& t, unsigned int version)
 {
-    ar & t.type;
+    // Stored as a plain string, the id is only good for this process
+    std::string type(t.type);
+    ar & type;
     ar & t.timeStamp;
 
     // Lookup the name of the sending publisher
@@ -118,7 +120,9 @@ void save(Archive& ar, const ram::core::Event& t, unsigned int version)
 template<class Archive>
 void load(Archive& ar, ram::core::Event& t, unsigned int version)
 {
-    ar & t.type;
+    std::string type;
+    ar & type;
+    t.type = type;
     ar & t.timeStamp;
 
     // Read back the name of the sending publisher and assign back to an
@@ -160,6 +164,15 @@ void serialize(Archive &ar, ram::core::IntEvent& t,
     ar & t.data;
 }
 
+template <class Archive>
+void serialize(Archive &ar, ram::core::MetricsEvent& t,
+               const unsigned int file_version)
+{
+    ar & boost::serialization::base_object<ram::core::Event>(t);
+    ar & t.names;
+    ar & t.values;
+}
+
 
 // ------------------------------------------------------------------------- //
 //                           M A T H   E V E N T S                           //
@@ -250,14 +263,17 @@ BOOST_SERIALIZATION_SHARED_PTR(ram::math::NumericEvent)
 template<class Archive>
 void save(Archive& ar, const ram::vision::ImageEvent& t, unsigned int version)
 {
-    ar & t.type;
+    std::string type(t.type);
+    ar & type;
     ar & t.timeStamp;
 }
     
 template<class Archive>
 void load(Archive& ar, ram::vision::ImageEvent& t, unsigned int version)
 {
-    ar & t.type;
+    std::string type;
+    ar & type;
+    t.type = type;
     ar & t.timeStamp;
     t.sender = 0;
 }
@@ -13,6 +13,7 @@
 
 // STD Includes
 #include <iostream>
+#include <vector>
 
 // Library Includes
 #include <boost/bind.hpp>
@@ -26,6 +27,7 @@
 #include "core/include/Logging.h"
 #include "core/include/EventHub.h"
 #include "core/include/Events.h"
+#include "core/include/QueueFactory.h"
 
 // Register controller in subsystem maker system
 RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::logging::EventLogger, EventLogger);
@@ -53,9 +55,7 @@ EventLogger::~EventLogger()
     m_connection->disconnect();
 
     // Flush the log to disk
-    core::EventPtr event;
-    while(m_eventQueue.popNoWait(event))
-        writeEvent(event, *m_archive);
+    update(0);
 
     // Close the log file
     m_logFile.close();
@@ -65,10 +65,11 @@ EventLogger::~EventLogger()
 void EventLogger::update(double)
 {
     // Read off events and write them to disk
-    core::EventPtr event;
+    std::vector<core::EventPtr> events;
+    m_eventQueue->popAll(events);
     
-    while(m_eventQueue.popNoWait(event))
-        writeEvent(event, *m_archive);
+    for (size_t i = 0; i < events.size(); ++i)
+        writeEvent(events[i], *m_archive);
 }
 
 void EventLogger::setPriority(core::IUpdatable::Priority priority)
@@ -119,6 +120,9 @@ void EventLogger::init(core::ConfigNode config, core::SubsystemList deps)
     m_archive = new boost::archive::text_oarchive(m_logFile,
                                                   boost::archive::no_tracking);
 
+    // Create the queue which holds events until the background thread runs
+    m_eventQueue.reset(core::makeQueue<core::EventPtr>(config["queue"]));
+
     // Get our subsystem
     core::EventHubPtr eventHub =
          core::Subsystem::getSubsystemOfType<core::EventHub>(deps);
@@ -131,7 +135,7 @@ void EventLogger::init(core::ConfigNode config, core::SubsystemList deps)
 void EventLogger::queueEvent(core::EventPtr event)
 {
     // Queue up the event so it will get logged to disk in the background
-    m_eventQueue.push(event);
+    m_eventQueue->push(event);
 }
     
 } // namespace logging
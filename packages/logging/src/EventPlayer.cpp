@@ -278,6 +278,12 @@ void PlayerThread::update(double)
         m_player->publishUpdate();
         m_presentEvent++;
     }
+    else
+    {
+        // Out of events, idle on the clock instead of spinning, that also
+        // lets a lockstep run move on without us
+        eventSleep(0.1);
+    }
 }
 
 void PlayerThread::setPriority(core::IUpdatable::Priority priority)
@@ -9,6 +9,7 @@
 #include <boost/serialization/export.hpp>
 BOOST_CLASS_EXPORT(ram::core::Event)
 BOOST_CLASS_EXPORT(ram::core::StringEvent)
+BOOST_CLASS_EXPORT(ram::core::MetricsEvent)
 
 #ifdef RAM_WITH_MATH
 BOOST_CLASS_EXPORT(ram::math::OrientationEvent)
@@ -72,7 +72,7 @@ public:
     static const uint16_t PORT;
 
   private:
-    void init();
+    void init(core::ConfigNode config);
 
     void startReceive();
 
@@ -88,6 +88,9 @@ public:
 
     core::EventHubPtr m_eventHub;
 
+    /** Our subscription to all events, see the "delivery" config section */
+    core::EventConnectionPtr m_connection;
+
     boost::asio::io_service io_service;
     boost::asio::ip::udp::socket socket_;
     boost::thread *m_bthread;
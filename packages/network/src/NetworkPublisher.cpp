@@ -18,6 +18,7 @@
 // Project Includes
 #include "network/include/NetworkPublisher.h"
 #include "core/include/EventHub.h"
+#include "core/include/EventConnection.h"
 #include "core/include/SubsystemMaker.h"
 #include "logging/include/Serialize.h"
 
@@ -42,7 +43,7 @@ NetworkPublisher::NetworkPublisher(core::ConfigNode config,
     socket_(io_service, udp::endpoint(udp::v4(), config["port"].asInt(PORT))),
     m_bthread(0)
 {
-    init();
+    init(config);
 }
 
 NetworkPublisher::NetworkPublisher(core::ConfigNode config,
@@ -52,11 +53,14 @@ NetworkPublisher::NetworkPublisher(core::ConfigNode config,
     socket_(io_service, udp::endpoint(udp::v4(), config["port"].asInt(PORT))),
     m_bthread(0)
 {
-    init();
+    init(config);
 }
 
 NetworkPublisher::~NetworkPublisher()
 {
+    if (m_connection)
+        m_connection->disconnect();
+
     io_service.stop();
     if (m_bthread) {
         m_bthread->join();
@@ -66,10 +70,14 @@ NetworkPublisher::~NetworkPublisher()
     }
 }
 
-void NetworkPublisher::init()
+void NetworkPublisher::init(core::ConfigNode config)
 {
     assert(m_eventHub && "Need an EventHub");
-    m_eventHub->subscribeToAll(boost::bind(&NetworkPublisher::handleEvent, this, _1));
+
+    // Serialize events on our own thread, so publishers don't wait on it
+    m_connection = m_eventHub->subscribeToAll(
+        boost::bind(&NetworkPublisher::handleEvent, this, _1),
+        core::AsyncDelivery::Options::fromConfig(config["delivery"]));
 
     startReceive();
     m_bthread = new boost::thread(
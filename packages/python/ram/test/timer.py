@@ -164,43 +164,60 @@ class TestTimer(TimerTester):
         self.assertEqual(TestTimer.TIMER_EVENT, self.event.type)
 
                 
-class TestTimerManager(TimerTester):
+class TestTimerManager(unittest.TestCase):
+    def setUp(self):
+        self.event = None
+        self.count = 0
+        self.eventHub = core.EventHub()
+        self.timerManager = timer.TimerManager(deps = [self.eventHub])
+
+    def tearDown(self):
+        self.timerManager.unbackground(True)
+
     def handleTimer(self, event):
+        self.count += 1
         self.event = event
         self.endTime = timer.time()
     
     def testNewTimer(self):
         # Set up publisher and event handler
-        timerManager = timer.TimerManager(deps = [core.EventHub()])
-        timerManager.subscribe(TestTimer.TIMER_EVENT, self.handleTimer)
+        self.timerManager.subscribe(TestTimer.TIMER_EVENT, self.handleTimer)
         
         # Create times
-        newTimer = timerManager.newTimer(TestTimer.TIMER_EVENT, 0.25)
+        newTimer = self.timerManager.newTimer(TestTimer.TIMER_EVENT, 0.1)
         
-        # Start the timer and sleep to wait for it to complete, then check
+        # Start the timer, it runs on the manager's thread not its own
+        startTime = timer.time()
         newTimer.start()
-        time.sleep(0.1)
-        self.assertEquals(0, self.sec)
-        self.assertEquals(0.25 * 1e9, self.nsec)
+        self.assertFalse(newTimer.isAlive())
+        self.assertEquals(None, self.event)
+
+        time.sleep(0.2)
+        self.assertEquals(1, self.count)
         self.assertEquals(TestTimer.TIMER_EVENT, self.event.type)
+        self.assert_(self.endTime - startTime >= 0.1)
+
+    def testStop(self):
+        self.timerManager.subscribe(TestTimer.TIMER_EVENT, self.handleTimer)
+        newTimer = self.timerManager.newTimer(TestTimer.TIMER_EVENT, 0.1)
+        newTimer.start()
+        newTimer.stop()
+
+        time.sleep(0.2)
+        self.assertEquals(None, self.event)
         
     def testQueuedEvents(self):
-        self.event = None
-        eventHub = core.EventHub()
-        qeventHub = core.QueuedEventHub(eventHub)
-        timerManager = timer.TimerManager(deps = [eventHub])
+        qeventHub = core.QueuedEventHub(self.eventHub)
         
         # Subscribe event queue
         qeventHub.subscribeToType(TestTimer.TIMER_EVENT, self.handleTimer)
         
         # Create times
-        newTimer = timerManager.newTimer(TestTimer.TIMER_EVENT, 0.25)
+        newTimer = self.timerManager.newTimer(TestTimer.TIMER_EVENT, 0.1)
         
         # Start the timer and sleep to wait for it to complete, then check
         newTimer.start()
-        time.sleep(0.1)
-        self.assertEquals(0, self.sec)
-        self.assertEquals(0.25 * 1e9, self.nsec)
+        time.sleep(0.2)
         self.assertEquals(None, self.event)
         
         # Now release the events
@@ -125,6 +125,17 @@ class Timer(threading.Thread):
         self._sleepTime = float(duration)
         self._running = True
         self._repeat = repeat
+        self._handle = None
+
+    def start(self):
+        """
+        Starts the timer, on the TimerManager's thread if it made the timer
+        """
+        if isinstance(self._eventPublisher, TimerManager):
+            self._handle = self._eventPublisher._startTimer(
+                self._eventType, self._sleepTime, self._repeat)
+        else:
+            threading.Thread.start(self)
         
     def run(self):
         """
@@ -151,6 +162,8 @@ class Timer(threading.Thread):
         Stops the backgruond thread from publishing its event when it wakes up
         """
         self._running = False
+        if self._handle is not None:
+            self._handle.cancel()
         
     def _complete(self):
         """
@@ -166,6 +179,10 @@ class TimerManager(ext.core.Subsystem):
     
     It makes sure all of its events are forward to the main EventHub so they
     can be properly queued by the QueuedEventHub.
+
+    The timers don't get their own threads, they are run by an
+    ext.core.TimerManager, which keeps them all on a single C++ thread. The
+    'resolution' config value is its tick length in milliseconds.
     """
     def __init__(self, config = None, deps = None):
         if config is None:
@@ -177,6 +194,14 @@ class TimerManager(ext.core.Subsystem):
                                                    nonNone = True)
         ext.core.Subsystem.__init__(self, config.get('name', 'TimerManager'), 
                                     deps)
+
+        cppDeps = ext.core.SubsystemList()
+        for d in deps:
+            cppDeps.append(d)
+        cfg = {'name' : config.get('name', 'TimerManager'),
+               'resolution' : config.get('resolution', 1)}
+        self._timers = ext.core.TimerManager(
+            ext.core.ConfigNode.fromString(str(cfg)), cppDeps)
         
     def newTimer(self, eventType, duration):
         """
@@ -188,6 +213,19 @@ class TimerManager(ext.core.Subsystem):
         return Timer(self, eventType, duration)
 
 
+    def _startTimer(self, eventType, duration, repeat):
+        """
+        Schedules the event on the C++ timers, published by this object
+
+        @rtype: ext.core.Timer
+        @return: The handle to cancel the timer with
+        """
+        return self._timers.newTimer(eventType, duration, repeat,
+                                     publisher = self)
+
     def backgrounded(self):
         return True
+
+    def unbackground(self, join = False):
+        self._timers.unbackground(join)
 ext.core.registerSubsystem('TimerManager', TimerManager)
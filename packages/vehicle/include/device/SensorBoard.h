@@ -22,6 +22,7 @@
 #include "core/include/Updatable.h"
 #include "core/include/ConfigNode.h"
 #include "core/include/ReadWriteMutex.h"
+#include "core/include/Metrics.h"
 
 #include "math/include/SGolaySmoothingFilter.h"
 
@@ -333,6 +334,9 @@ private:
 
     /** The fire servo position for the treasure grabber */
     int m_servo4FirePosition;
+
+    /** Failed reads and writes, each one resets the connection */
+    core::CounterPtr m_serialErrors;
 };
     
 } // namespace device
@@ -22,6 +22,7 @@
 #include "vehicle/include/Common.h"
 
 #include "math/include/Events.h"
+#include "core/include/BinaryLogger.h"
 
 
 RAM_CORE_EVENT_TYPE(ram::vehicle::device::SensorBoard, POWERSOURCE_UPDATE);
@@ -44,6 +45,14 @@ static log4cpp::Category& s_powerLog
 static log4cpp::Category& s_tempLog
 (log4cpp::Category::getInstance("Temp"));
 
+// The per update messages go through the binary log
+static ram::core::BinaryLogger& s_thrusterBLog
+(ram::core::BinaryLogger::getInstance("Thruster"));
+static ram::core::BinaryLogger& s_powerBLog
+(ram::core::BinaryLogger::getInstance("Power"));
+static ram::core::BinaryLogger& s_tempBLog
+(ram::core::BinaryLogger::getInstance("Temp"));
+
 static void setupLogging() {
     s_thrusterLog.info("%% MC1 MC2 MC3 MC4 MC5 MC6"
                        " TV1 TV2 TV3 TV4 TV5 TV6 TimeStamp");
@@ -65,7 +74,8 @@ SensorBoard::SensorBoard(int deviceFD,
     m_depthCalibSlope(config["depthCalibSlope"].asDouble()),
     m_depthCalibIntercept(config["depthCalibIntercept"].asDouble()),
     m_deviceFile(""),
-    m_deviceFD(deviceFD)
+    m_deviceFD(deviceFD),
+    m_serialErrors(core::MetricsRegistry::counter(getName(), "serialErrors"))
 {
     // Initialize values
     m_location = math::Vector3(config["depthSensorLocation"][0].asDouble(0), 
@@ -101,7 +111,8 @@ SensorBoard::SensorBoard(core::ConfigNode config,
     m_depthCalibSlope(config["depthCalibSlope"].asDouble()),
     m_depthCalibIntercept(config["depthCalibIntercept"].asDouble()),
     m_deviceFile(config["deviceFile"].asString("/dev/sensor")),
-    m_deviceFD(-1)
+    m_deviceFD(-1),
+    m_serialErrors(core::MetricsRegistry::counter(getName(), "serialErrors"))
 {
 
     // Initialize values
@@ -203,49 +214,53 @@ void SensorBoard::update(double timestep)
         sonarEvent(&state.telemetry);
         
         // Thruster logging data
-        s_thrusterLog.info("%3.1f %3.1f %3.1f %3.1f %3.1f %3.1f" // Current
-                           " %d %d %d %d %d %d",                 // Command
-                           state.telemetry.powerInfo.motorCurrents[0],
-                           state.telemetry.powerInfo.motorCurrents[1],
-                           state.telemetry.powerInfo.motorCurrents[2],
-                           state.telemetry.powerInfo.motorCurrents[3],
-                           state.telemetry.powerInfo.motorCurrents[4],
-                           state.telemetry.powerInfo.motorCurrents[5],
-                           state.thrusterValues[0],
-                           state.thrusterValues[1],
-                           state.thrusterValues[2],
-                           state.thrusterValues[3],
-                           state.thrusterValues[4],
-                           state.thrusterValues[5]);
+        const struct powerInfo& power = state.telemetry.powerInfo;
+        RAM_CORE_BLOG_INFO(s_thrusterBLog)
+            .format("%3.1f %3.1f %3.1f %3.1f %3.1f %3.1f" // Current
+                    " %d %d %d %d %d %d")                 // Command
+            << power.motorCurrents[0]
+            << power.motorCurrents[1]
+            << power.motorCurrents[2]
+            << power.motorCurrents[3]
+            << power.motorCurrents[4]
+            << power.motorCurrents[5]
+            << state.thrusterValues[0]
+            << state.thrusterValues[1]
+            << state.thrusterValues[2]
+            << state.thrusterValues[3]
+            << state.thrusterValues[4]
+            << state.thrusterValues[5];
         
         // Power Logging Data
-        s_powerLog.info("%3.1f %3.1f %3.1f %3.1f %3.1f " // Batt Current
-                        "%3.1f %3.1f %3.1f %3.1f %3.1f " // Batt Voltage
-                        "%3.1f %3.1f %3.1f %3.1f",       // Bus I, Bus V
-                        state.telemetry.powerInfo.battCurrents[0],
-                        state.telemetry.powerInfo.battCurrents[1],
-                        state.telemetry.powerInfo.battCurrents[2],
-                        state.telemetry.powerInfo.battCurrents[3],
-                        state.telemetry.powerInfo.battCurrents[4],
-                        state.telemetry.powerInfo.battVoltages[0],
-                        state.telemetry.powerInfo.battVoltages[1],
-                        state.telemetry.powerInfo.battVoltages[2],
-                        state.telemetry.powerInfo.battVoltages[3],
-                        state.telemetry.powerInfo.battVoltages[4],
-                        state.telemetry.powerInfo.i5VBus,
-                        state.telemetry.powerInfo.i12VBus,
-                        state.telemetry.powerInfo.v5VBus,
-                        state.telemetry.powerInfo.v12VBus);
+        RAM_CORE_BLOG_INFO(s_powerBLog)
+            .format("%3.1f %3.1f %3.1f %3.1f %3.1f " // Batt Current
+                    "%3.1f %3.1f %3.1f %3.1f %3.1f " // Batt Voltage
+                    "%3.1f %3.1f %3.1f %3.1f")       // Bus I, Bus V
+            << power.battCurrents[0]
+            << power.battCurrents[1]
+            << power.battCurrents[2]
+            << power.battCurrents[3]
+            << power.battCurrents[4]
+            << power.battVoltages[0]
+            << power.battVoltages[1]
+            << power.battVoltages[2]
+            << power.battVoltages[3]
+            << power.battVoltages[4]
+            << power.i5VBus
+            << power.i12VBus
+            << power.v5VBus
+            << power.v12VBus;
         
         // Temp Logging data
-        s_tempLog.info("%d %d %d %d %d %d %d",
-                       (int)state.telemetry.temperature[0],
-                       (int)state.telemetry.temperature[1],
-                       (int)state.telemetry.temperature[2],
-                       (int)state.telemetry.temperature[3],
-                       (int)state.telemetry.temperature[4],
-                       (int)state.telemetry.temperature[5],
-                       (int)state.telemetry.temperature[6]);
+        RAM_CORE_BLOG_INFO(s_tempBLog)
+            .format("%d %d %d %d %d %d %d")
+            << (int)state.telemetry.temperature[0]
+            << (int)state.telemetry.temperature[1]
+            << (int)state.telemetry.temperature[2]
+            << (int)state.telemetry.temperature[3]
+            << (int)state.telemetry.temperature[4]
+            << (int)state.telemetry.temperature[5]
+            << (int)state.telemetry.temperature[6];
     } // end partialRet == SB_UPDATEDONE
     
     // Copy the values back
@@ -597,6 +612,7 @@ bool SensorBoard::handleReturn(int ret)
 {
     if (ret < 0)
     {
+        m_serialErrors->increment();
         std::cout << "some kind of error.  reestablishing connection." << std::endl;
 
 //         int j, nptrs;
@@ -55,6 +55,7 @@ class RAM_EXPORT BinDetector : public Detector
     ~BinDetector();
 
     void processImage(Image* input, Image* output= 0);
+    bool changesInput() const { return false; }
     
     bool found();
 
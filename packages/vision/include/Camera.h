@@ -10,12 +10,19 @@
 #ifndef RAM_VISION_CAMERA_H_05_23_2007
 #define RAM_VISION_CAMERA_H_05_23_2007
 
+// STD Includes
+#include <string>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+
 // Project Includes
 #include "core/include/Updatable.h"
 #include "core/include/ReadWriteMutex.h"
 #include "core/include/CountDownLatch.h"
 //#include "core/include/Event.h"
 #include "core/include/EventPublisher.h"
+#include "core/include/Metrics.h"
 
 #include "vision/include/Common.h"
 #include "vision/include/Export.h"
@@ -51,6 +58,34 @@ public:
      */
     void getImage(Image* current);
 
+    /** The latest frame from the camera, without copying it
+     *
+     *  Hold on to the frame for as long as you need the image, it never
+     *  changes.  Before the first capture this is a blank frame with a
+     *  sequence number of zero.
+     */
+    FramePtr getFrame();
+
+    /** The trace ID of the IMAGE_CAPTURED event of the latest image
+     *
+     *  Zero unless a core::Tracer is active.  Give it to a
+     *  core::Tracer::ScopedContext while processing the image, so what gets
+     *  published traces back to the frame.
+     */
+    boost::uint64_t getImageTraceId();
+
+    /** Sets the owner of the camera metrics, ie: "ForwardCamera"
+     *
+     *  The camera counts its "frames" and tracks its "fps" under this name,
+     *  "Camera" by default.  The "frameCache.hits" and "frameCache.misses"
+     *  of conversions of its frames are there too.  Call it before the
+     *  camera is backgrounded.
+     */
+    void setMetricsName(const std::string& name);
+
+    /** The owner of the camera metrics, for metrics about its images */
+    std::string getMetricsName();
+
     /** Waits for next image from the camera, then copies to given image
      *
      *  This will block until the next image is grabed from the camera then call
@@ -140,14 +175,15 @@ protected:
      */
     void cleanup();
     
-    /** Copies image to the public images release those waiting on the image
+    /** Copies image to a new frame and release those waiting on the image
      *
-     *  This use the virtual copyToPublicImage function to perform the copy. If
-     *  you wish to optimize the copy or perform some kind of processing, that
-     *  is the function you should overload.
+     *  This use the virtual copyToPublic function to perform the copy, into
+     *  a buffer from the frame pool. If you wish to optimize the copy or
+     *  perform some kind of processing, that is the function you should
+     *  overload.
      *
-     * @param newImage  This image is copied to the public image in a thread
-     *                  safe manner. The public image is accessed by getImage.
+     * @param newImage  This image is copied into the frame which becomes the
+     *                  latest, accessed by getFrame and getImage.
      */
     void capturedImage(Image* newImage);
 
@@ -159,11 +195,39 @@ protected:
     virtual void copyToPublic(Image* newImage, Image* publicImage);
     
 private:
-    /** Protects access to the public image */
+    /** Protects access to the latest frame and its trace ID */
     core::ReadWriteMutex m_imageMutex;
 
-    /** Image returned from get image*/
-    Image* m_publicImage;
+    /** Buffers for the frames, reused once every consumer drops them */
+    FramePoolPtr m_framePool;
+
+    /** The latest frame, returned from getFrame */
+    FramePtr m_frame;
+
+    /** Sequence number of the latest frame */
+    boost::uint64_t m_sequence;
+
+    /** Trace ID of the event published for the public image */
+    boost::uint64_t m_imageTraceId;
+
+    /** Owner of the metrics below */
+    std::string m_metricsName;
+
+    /** Counts every captured image */
+    core::CounterPtr m_frames;
+
+    /** Smoothed rate of captured images */
+    core::GaugePtr m_fps;
+
+    /** Conversions of frames shared and made, see Frame::getImage(format) */
+    core::GaugePtr m_conversionHits;
+    core::GaugePtr m_conversionMisses;
+
+    /** Smoothed frame rate, zero before the second image */
+    double m_averageFps;
+
+    /** When the last image was captured, in microseconds */
+    boost::int64_t m_lastCapture;
     
     /** Latch to release threads waiting on a new image */
     core::CountDownLatch m_imageLatch;
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/vision/include/ColorClassifier.h
+ */
+
+#ifndef RAM_VISION_COLORCLASSIFIER_H_02_13_2010
+#define RAM_VISION_COLORCLASSIFIER_H_02_13_2010
+
+// STD Includes
+#include <utility>
+#include <vector>
+
+// Project Includes
+#include "vision/include/Common.h"
+
+// Must be incldued last
+#include "vision/include/Export.h"
+
+namespace ram {
+namespace vision {
+
+class TableColorFilter;
+
+/** Sorts every pixel into up to eight color classes in one pass
+ *
+ *  Running a filter per color reads the whole image and writes a whole mask
+ *  for each one.  Instead give the classifier each color's filter, classify
+ *  the image once into a label image, and pick the mask for a color out of
+ *  the labels.  Each pixel's label has bit i set when it is in class i.
+ *
+ *  The classes use the filters directly, so changes to the filters through
+ *  their properties show up in the next classify().  The ColorFilter classes
+ *  are all tested at once with three table lookups per pixel.  Every class
+ *  is tested on the same image, so the filters must all expect its format.
+ */
+class RAM_EXPORT ColorClassifier
+{
+public:
+    /** The most classes, one per bit of a label */
+    static const size_t MAX_CLASSES = 8;
+
+    ColorClassifier();
+
+    /** Adds a class of the pixels the filter passes
+     *
+     *  @return  The bit of the class in the labels
+     */
+    unsigned char addClass(ColorFilter* filter);
+
+    /** Adds a class of the pixels in the filter's lookup table
+     *
+     *  @return  The bit of the class in the labels
+     */
+    unsigned char addClass(TableColorFilter* filter);
+
+    size_t getClassCount() const;
+
+    /** Labels every pixel of the input with the classes it is in
+     *
+     *  @param input   A three channel image
+     *  @param labels  A one channel image the same size as the input
+     */
+    void classify(Image* input, Image* labels);
+
+    /** Makes a mask of the pixels in any of the given classes
+     *
+     *  The mask is the same as ColorFilter::filterImage gives, every channel
+     *  is 255 for pixels in the classes and 0 for the rest.
+     *
+     *  @param labels   The labels from classify
+     *  @param classes  The bits of the classes wanted
+     *  @param output   The mask, one or more channels the size of the labels
+     */
+    static void extractMask(Image* labels, unsigned char classes,
+                            Image* output);
+
+private:
+    /** Fills in m_channelClasses from the current ranges of the filters */
+    void setupRanges();
+
+    /** The range filters and the bit of their class */
+    std::vector<std::pair<ColorFilter*, unsigned char> > m_rangeClasses;
+
+    /** The table filters and the bit of their class */
+    std::vector<std::pair<TableColorFilter*, unsigned char> > m_tableClasses;
+
+    /** For each channel value, the bits of the range classes it passes */
+    unsigned char m_channelClasses[3][256];
+};
+
+} // namespace vision
+} // namespace ram
+
+#endif // RAM_VISION_COLORCLASSIFIER_H_02_13_2010
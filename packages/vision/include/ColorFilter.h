@@ -24,9 +24,25 @@
 namespace ram {
 namespace vision {
 
+/** Marks the pixels whose three channels are all within a range
+ *
+ *  A range with a low above its high wraps around, passing the values from
+ *  zero to high and from low to 255.
+ *
+ *  Ranges which don't wrap are tested many pixels at a time with SSE2 or
+ *  AVX2, when the CPU has them and the output has one or three channels.
+ *  Everything else goes a pixel at a time through lookup tables.
+ */
 class RAM_EXPORT ColorFilter : public ImageFilter
 {
 public:
+    /** The ways to filter an image, from slowest to fastest */
+    enum Kernel {
+        SCALAR, /** A pixel at a time through lookup tables */
+        SSE2,   /** 16 pixels at a time */
+        AVX2    /** 32 pixels at a time */
+    };
+
     ColorFilter(unsigned char channel1Low, unsigned char channel1High,
                 unsigned char channel2Low, unsigned char channel2High,
                 unsigned char channel3Low, unsigned char channel3High);
@@ -34,13 +50,35 @@ public:
     virtual ~ColorFilter();
 
     /** Run the Filter on the input image, debug results to output Image
+     *
+     *  Every channel of the output is 255 for pixels in range, and 0 for the
+     *  rest.  So a one channel output gets a single mask, and a three channel
+     *  one the same mask three times.
      *
      *  @param input   The image to run the detector on
      *  @param output  Place results, (its input if NULL)
      */
     virtual void filterImage(Image* input, Image* output = 0);
+
+    /** Like filterImage, but marks the pixels out of range */
     void inverseFilterImage(Image* input, Image* output = 0);
 
+    /** Whether the value is in range for the channel, from 1 to 3 */
+    bool inChannelRange(int channel, unsigned char value) const;
+
+    /** The kernel every filter uses, the fastest the CPU supports to start */
+    static Kernel getKernel();
+
+    /** Changes the kernel of every filter, for testing and benchmarking
+     *
+     *  @return  False, leaving the kernel alone, if the CPU doesn't support
+     *           the kernel or it wasn't compiled in
+     */
+    static bool setKernel(Kernel kernel);
+
+    /** Whether the kernel was compiled in, and the CPU supports it */
+    static bool isKernelSupported(Kernel kernel);
+
     /**
      * @defgroup Set/Get methods for channel low and high values
      */
@@ -80,6 +118,9 @@ private:
     /** Sets the up range lookup tables based on the current highs and lows */
     void setupRanges();
 
+    /** Does the work of filterImage and inverseFilterImage */
+    void filter(Image* input, Image* output, bool inverse);
+
     /** Gets the short name for a channel based on the name */
     std::string getShortChannelName(std::string shortName, bool isMin);
 
@@ -96,6 +137,13 @@ private:
     unsigned char m_channel1Range[256];
     unsigned char m_channel2Range[256];
     unsigned char m_channel3Range[256];
+
+    /** The lows and highs repeated, in the layout the kernels need */
+    unsigned char m_lows[96];
+    unsigned char m_highs[96];
+
+    /** Whether any of the ranges wrap, which only the tables handle */
+    bool m_wraps;
 };
     
 } // namespace vision
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/vision/include/ColorFilterKernels.h
+ */
+
+#ifndef RAM_VISION_COLORFILTERKERNELS_H_02_12_2010
+#define RAM_VISION_COLORFILTERKERNELS_H_02_12_2010
+
+// STD Includes
+#include <cstddef>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+
+namespace ram {
+namespace vision {
+namespace detail {
+
+/** The vector kernels behind ColorFilter, only ColorFilter should use these
+ *
+ *  Each kernel tests the three channels of every pixel against inclusive
+ *  [low, high] ranges, which must not wrap.  The lows and highs are 96 byte
+ *  patterns holding the bound for channel (i % 3) at byte i, so any block of
+ *  the image lines up with the same offset in the pattern.
+ *
+ *  They only do whole blocks of pixels, and return the number of pixels
+ *  done.  The caller filters the rest one pixel at a time.  A kernel not
+ *  compiled in does nothing and returns zero.
+ *
+ *  The kernels live in their own files so they can be built with the
+ *  instruction set they need, without the rest of the library requiring it.
+ */
+
+/** Whether the kernel was compiled in, the CPU must also support it */
+bool hasSSE2Kernel();
+bool hasAVX2Kernel();
+
+/** Filters 16 pixels at a time */
+size_t filterRangesSSE2(const unsigned char* input, unsigned char* output,
+                        size_t pixels, int outputChannels,
+                        const unsigned char* lows, const unsigned char* highs,
+                        bool inverse);
+
+/** Filters 32 pixels at a time */
+size_t filterRangesAVX2(const unsigned char* input, unsigned char* output,
+                        size_t pixels, int outputChannels,
+                        const unsigned char* lows, const unsigned char* highs,
+                        bool inverse);
+
+/** Writes the mask for 16 pixels from the bytes which were in range
+ *
+ *  Built without any special instructions, so the kernels can share it.
+ *
+ *  @param bytesInRange
+ *      Bit i is set when byte i of the 48 input bytes was in its range
+ *  @param output
+ *      Gets 16 bytes for a single channel mask, or 48 for three channels
+ *  @param outputChannels
+ *      One or three
+ *  @param inverse
+ *      Marks the pixels out of range instead
+ */
+void writeRangeMask(boost::uint64_t bytesInRange, unsigned char* output,
+                    int outputChannels, bool inverse);
+
+} // namespace detail
+} // namespace vision
+} // namespace ram
+
+#endif // RAM_VISION_COLORFILTERKERNELS_H_02_12_2010
@@ -22,6 +22,10 @@ typedef boost::shared_ptr<Camera> CameraPtr;
     
 class Image;
 class OpenCVImage;
+class Frame;
+typedef boost::shared_ptr<const Frame> FramePtr;
+class FramePool;
+typedef boost::shared_ptr<FramePool> FramePoolPtr;
 class OpenCVCamera;
 class Calibration;
 class Recorder;
@@ -14,6 +14,7 @@
 #include "core/include/Forward.h"
 #include "core/include/EventPublisher.h"
 #include "vision/include/Common.h"
+#include "vision/include/Image.h"
 
 // Must be incldued last
 #include "vision/include/Export.h"
@@ -38,6 +39,27 @@ public:
      */
     virtual void processImage(Image* input, Image* output = 0) = 0;
 
+    /** Whether processImage changes the input image
+     *
+     *  The VisionRunner gives detectors which do a copy of their own, the
+     *  rest share the camera frame.  Override to return false when the input
+     *  is only read.
+     */
+    virtual bool changesInput() const { return true; }
+
+    /** Sets the camera frame the next processImage input holds
+     *
+     *  The VisionRunner sets it while the detector runs, so conversions of
+     *  the frame are shared with the other detectors.
+     *
+     *  @param frame
+     *      Null when the input is not known to hold the frame
+     *  @param input
+     *      The image processImage will be given, either the frame's image or
+     *      a fresh copy of it
+     */
+    void setInputFrame(FramePtr frame, Image* input = 0);
+
     /** Get the set of properties for this object */
     virtual core::PropertySetPtr getPropertySet();
 
@@ -65,9 +87,31 @@ public:
 protected:
     Detector(core::EventHubPtr eventHub = core::EventHubPtr());
 
+    /** The input in the given format, which must <b>NOT</b> be changed
+     *
+     *  When the input is the image given with the input frame, the frame's
+     *  shared conversion is used.  Otherwise the input is copied to scratch
+     *  and converted there.
+     *
+     *  @param input
+     *      The image given to processImage, before it has been changed
+     *  @param format
+     *      The pixel format needed
+     *  @param scratch
+     *      Where to convert the image when it can't be shared
+     */
+    Image* getConvertedInput(Image* input, Image::PixelFormat format,
+                             Image* scratch);
+
 private:
     /** Holds all the properties for this detector */
     core::PropertySetPtr m_propertySet;
+
+    /** The frame processImage is currently working on, can be null */
+    FramePtr m_inputFrame;
+
+    /** The image processImage was given which holds m_inputFrame */
+    Image* m_inputImage;
 };
     
 } // namespace vision
@@ -29,6 +29,7 @@ public:
 	virtual ~DownwardDuctDetector();
         
     void processImage(Image* input, Image* output = 0);
+    bool changesInput() const { return false; }
     
 private:
     void init(core::ConfigNode config);
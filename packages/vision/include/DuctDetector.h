@@ -30,6 +30,7 @@ public:
 	virtual ~DuctDetector();
         
     void processImage(Image* input, Image* output = 0);
+    bool changesInput() const { return false; }
 
     /** Normalized from -1 to 1*/
     double getX();
@@ -121,8 +121,12 @@ public:
 
     ImageEvent() : image(0) {}
 
+    /** The image of the frame, when sent by a Camera */
     Image* image;
 
+    /** Hold on to this to keep using the image after the handler returns */
+    FramePtr frame;
+
     virtual core::EventPtr clone();
 };
 
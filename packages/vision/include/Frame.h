@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/vision/include/Frame.h
+ */
+
+#ifndef RAM_VISION_FRAME_H_02_10_2010
+#define RAM_VISION_FRAME_H_02_10_2010
+
+// STD Includes
+#include <cstddef>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+#include <boost/utility.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Project Includes
+#include "vision/include/Common.h"
+#include "vision/include/Image.h"
+#include "core/include/BoundedQueue.h"
+#include "core/include/Atomic.h"
+
+// Must Be Included last
+#include "vision/include/Export.h"
+
+namespace ram {
+namespace vision {
+
+/** A single captured image, shared by everyone who uses it
+ *
+ *  Frames are immutable once the Camera has published them, so any number of
+ *  threads can hold and read the same one without copying or locking.  The
+ *  image buffer goes back to its FramePool when the last FramePtr to it is
+ *  released.
+ *
+ *  Conversions of the image to other pixel formats are made the first time
+ *  they are asked for, then shared by everyone using the frame.  Like the
+ *  image their buffers are kept when the frame goes back to the pool.
+ */
+class RAM_EXPORT Frame : boost::noncopyable
+{
+public:
+    /** The image, which must <b>NOT</b> be changed
+     *
+     *  Copy it first with Image::copyFrom if you need to work on it.
+     */
+    Image* getImage() const { return m_image; }
+
+    /** The image converted to the given format, which must <b>NOT</b> be
+     *  changed either
+     *
+     *  The first call for a format does the conversion, the rest wait for it
+     *  and share the result.  Safe to call from any number of threads.
+     *
+     *  @throw ImageConversionException
+     *      When the image can't be converted to the format
+     */
+    Image* getImage(Image::PixelFormat format) const;
+
+    /** Counts up by one with each image captured by the camera
+     *
+     *  So gaps show dropped frames, and repeats show an old frame.
+     */
+    boost::uint64_t getSequence() const { return m_sequence; }
+
+    /** When the image was captured, in seconds like core::Event::timeStamp */
+    double getTimeStamp() const { return m_timeStamp; }
+
+private:
+    friend class FramePool;
+
+    Frame(Image* image, FramePool* pool);
+    ~Frame();
+
+    /** A lazily made conversion of the image to one format */
+    struct Conversion
+    {
+        Conversion();
+        ~Conversion();
+
+        /** Held while the conversion is made */
+        boost::mutex mutex;
+
+        /** Kept between uses of the frame, null until first needed */
+        Image* image;
+
+        /** Whether image holds the conversion of the current image */
+        bool valid;
+    };
+
+    Image* m_image;
+    boost::uint64_t m_sequence;
+    double m_timeStamp;
+
+    /** Counts conversion hits and misses, frames never outlive it */
+    FramePool* m_pool;
+
+    mutable Conversion m_conversions[Image::PF_END];
+};
+
+/** Recycles the image buffers of Frames
+ *
+ *  A Camera fills the image of a Frame from allocate(), then share()s it.
+ *  When the last reference to the frame is released its buffer comes back to
+ *  the free list, so once every consumer has reached its steady state frames
+ *  cost no image allocations.  When the free list is full released frames are
+ *  deleted.
+ *
+ *  Frames hold on to their pool, so it lives until the last one is released.
+ */
+class RAM_EXPORT FramePool : boost::noncopyable,
+                             public boost::enable_shared_from_this<FramePool>
+{
+public:
+    /** The default number of free frames to hold on to */
+    static const size_t DEFAULT_MAX_FREE = 16;
+
+    /** Creates a pool, frames start as 640x480 images
+     *
+     *  @param maxFree
+     *      The most free frames to keep around, rounded to a power of two
+     */
+    static FramePoolPtr create(size_t maxFree = DEFAULT_MAX_FREE);
+
+    /** Deletes all the free frames */
+    ~FramePool();
+
+    /** A frame not in use by anyone, fill its image then share() it */
+    Frame* allocate();
+
+    /** Stamps the frame and hands it out, it can't be changed after this */
+    FramePtr share(Frame* frame, boost::uint64_t sequence, double timeStamp);
+
+    /** The number of allocate() calls which had to create a frame */
+    size_t getHeapAllocations() const { return m_heapAllocations.get(); }
+
+    /** The number of allocate() calls satisfied by a free frame */
+    size_t getReuses() const { return m_reuses.get(); }
+
+    /** The number of Frame::getImage(format) calls which had to convert */
+    size_t getConversionMisses() const { return m_conversionMisses.get(); }
+
+    /** The number of Frame::getImage(format) calls which shared a conversion
+     *  already made */
+    size_t getConversionHits() const { return m_conversionHits.get(); }
+
+private:
+    friend class Frame;
+
+    FramePool(size_t maxFree);
+
+    /** Called when the last reference to a shared frame is released */
+    void release(Frame* frame);
+
+    core::BoundedQueue<Frame*> m_freeFrames;
+
+    core::AtomicCounter m_heapAllocations;
+    core::AtomicCounter m_reuses;
+    core::AtomicCounter m_conversionMisses;
+    core::AtomicCounter m_conversionHits;
+};
+
+} // namespace vision
+} // namespace ram
+
+#endif // RAM_VISION_FRAME_H_02_10_2010
@@ -40,6 +40,7 @@ class RAM_EXPORT HedgeDetector : public Detector
 
     void update();
     void processImage(Image* input, Image* output = 0);
+    bool changesInput() const { return false; }
 
     bool m_found;
 
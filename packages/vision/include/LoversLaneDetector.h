@@ -42,6 +42,7 @@ class RAM_EXPORT LoversLaneDetector : public Detector
 
     void update();
     void processImage(Image* input, Image* output = 0);
+    bool changesInput() const { return false; }
 
     bool m_found;
 
@@ -34,6 +34,7 @@ class RAM_EXPORT NullDetector : public Detector
 
     void update();
     void processImage(Image* input, Image* output = 0);
+    bool changesInput() const { return false; }
     
     void setImageLogging(bool value);
   
@@ -16,12 +16,14 @@
 #include <string>
 
 // Library Includes
+#include <boost/cstdint.hpp>
 #include <boost/thread/mutex.hpp>
 
 // Project Includes
 #include "vision/include/Common.h"
 #include "core/include/Forward.h"
 #include "core/include/Updatable.h"
+#include "core/include/Metrics.h"
 
 // Must be included last
 #include "vision/include/Export.h"
@@ -93,8 +95,19 @@ class RAM_EXPORT Recorder : public core::Updatable
      */
     virtual void waitForImage(Camera* camera);
     
-    /** Called when ever there is a new frame to record */
+    /** Called when ever there is a new frame to record
+     *
+     *  The image is always BGR and the recording size.  It is shared with
+     *  everyone else using the camera frame, unless it had to be converted,
+     *  so never change it, copy it first.
+     */
     virtual void recordFrame(Image* image) = 0;
+
+    /** The frame whose image recordFrame was given, null when it was copied
+     *
+     *  Only valid during recordFrame.
+     */
+    FramePtr getRecordingFrame() const { return m_recordingFrame; }
     
   private:
     /** Called when the camera has processed a new event */
@@ -114,7 +127,7 @@ class RAM_EXPORT Recorder : public core::Updatable
     /** The height of the image we are recording in pixels */
     size_t m_height;
     
-    /** Protects access to m_nextFrame and m_newFrame */
+    /** Protects access to m_frame, m_frameTraceId and m_newFrame */
     boost::mutex m_mutex;
 
     /** Weather or not we have a new frame */
@@ -123,10 +136,17 @@ class RAM_EXPORT Recorder : public core::Updatable
     /** The camera we are recording from */
     Camera* m_camera;
 
-    /** The frame we get from the camera */
-    Image* m_frameFromCamera;
+    /** The latest frame from the camera, waiting to be recorded */
+    FramePtr m_frame;
 
-    /** The current frame we are recording */
+    /** Trace ID of the IMAGE_CAPTURED event of m_frame */
+    boost::uint64_t m_frameTraceId;
+
+    /** The frame passed to recordFrame, when its image was not copied */
+    FramePtr m_recordingFrame;
+
+    /** The current frame we are recording, when it must be resized or
+     *  converted */
     Image* m_frameResized;
 
     /** Current time in seconds */
@@ -134,6 +154,12 @@ class RAM_EXPORT Recorder : public core::Updatable
 
     /** The next time an image can be recorded */
     double m_nextRecordTime;
+
+    /** Frames replaced by a newer one before they were recorded
+     *
+     *  Created on the first drop, so it is named after the actual type
+     */
+    core::CounterPtr m_droppedFrames;
 };
     
 } // namespace vision
@@ -33,6 +33,7 @@ class RAM_EXPORT SafeDetector : public Detector
     ~SafeDetector();
 
     void processImage(Image* input, Image* output= 0);
+    bool changesInput() const { return false; }
     
     bool found();
 
@@ -41,6 +41,10 @@ public:
      */
     virtual void filterImage(Image* input, Image* output = 0);
     virtual void inverseFilterImage(Image* input, Image* output = 0);
+
+    /** Whether the color is in the lookup table */
+    bool inTable(unsigned char channel1, unsigned char channel2,
+                 unsigned char channel3) const;
     
     static void saveLookupTable(std::string filepath, 
                                 core::BitField3D &filterTable);
@@ -37,6 +37,7 @@ class RAM_EXPORT VelocityDetector : public Detector
     void update();
 
     void processImage(Image* input, Image* output= 0);
+    bool changesInput() const { return false; }
     
     /** Gives the motion of the camera in pixels per frame
      *
@@ -11,7 +11,9 @@
 #define RAM_VISION_RUNNER_H_07_11_2007
 
 // STD Includes
+#include <map>
 #include <set>
+#include <string>
 //#include <utility>
 
 // Project Includes
@@ -21,6 +23,9 @@
 
 #include "core/include/Event.h"
 #include "core/include/ThreadedQueue.h"
+#include "core/include/Metrics.h"
+#include "core/include/WorkerPool.h"
+#include "core/include/CountDownLatch.h"
 
 // Must be included last
 #include "vision/include/Export.h"
@@ -32,6 +37,15 @@ namespace vision {
  *
  *  If the runner has detecctors, and the given camera is caputring images the
  *  detectors will be running.
+ *
+ *  Given a WorkerPool the detectors all process a frame at once, each on a
+ *  thread of the pool, and the runner waits for them all before the next
+ *  frame.  Detectors which change their input get a copy of the frame of
+ *  their own.  Detectors share conversions of the frame to other pixel
+ *  formats, see Detector::getConvertedInput.
+ *
+ *  Under the camera name it tracks its "VisionRunner.fps" and
+ *  the "VisionRunner.frameUsec" to run all the detectors on a frame.
  */
 class RAM_EXPORT VisionRunner : public Recorder
 {
@@ -41,10 +55,12 @@ public:
      *  @param camera  The camera to record images from
      *  @param policy  Determines how often images from the camera are recorded
      *  @param policyArg  An argument for use by the given recording policy.
+     *  @param workers  Runs the detectors in parallel, when given
      *
      */
     VisionRunner(Camera* camera, Recorder::RecordingPolicy policy,
-                 int policyArg = 0);
+                 int policyArg = 0,
+                 core::WorkerPoolPtr workers = core::WorkerPoolPtr());
     ~VisionRunner();
     
     /** Process detector changes, then goes into the normal Recorder update */
@@ -82,12 +98,60 @@ private:
      *  @return  Whether or not the background thread needs to be toggle on/off
      */
     bool processDetectorChanges(bool canBackground = true);
+
+    /** Runs the detectors one after another */
+    void processSerial(Image* image, FramePtr frame);
+
+    /** Runs the detectors on the worker pool, returns when all are done */
+    void processParallel(Image* image, FramePtr frame);
+
+    /** Run on a worker, copy is the detector's own image or null */
+    void processTask(DetectorPtr detector, Image* image, Image* copy,
+                     FramePtr frame, boost::uint64_t traceId,
+                     core::CountDownLatch* done);
+
+    /** Runs the detector on the image from the frame, timing it */
+    void runDetector(DetectorPtr detector, Image* image, FramePtr frame);
+
+    /** Deletes the detector's copy of the frame, if it has one */
+    void removeDetectorImage(DetectorPtr detector);
+
+    /** Updates the frame rate metrics after a frame which began at start */
+    void recordFrameMetrics(boost::int64_t start);
     
     /** Detectors to be added or removed */
     core::ThreadedQueue<DetectorChange> m_detectorChanges;
 
     /** Current list of dectors being added */
     std::set<DetectorPtr> m_detectors;
+
+    /** The detectors' copy of the frame, for the ones which change it */
+    Image* m_image;
+
+    /** The copies of the frame for each detector which changes it, only
+     *  used when running in parallel */
+    std::map<DetectorPtr, Image*> m_detectorImages;
+
+    /** Runs the detectors in parallel, or null to run them in turn */
+    core::WorkerPoolPtr m_workers;
+
+    /** Owner of the detector metrics, the name of the camera */
+    std::string m_metricsName;
+
+    /** Microseconds each detector takes per image */
+    std::map<DetectorPtr, core::HistogramPtr> m_detectorTimes;
+
+    /** Microseconds to run all the detectors on a frame */
+    core::HistogramPtr m_frameTimes;
+
+    /** Smoothed rate of frames processed */
+    core::GaugePtr m_fps;
+
+    /** Smoothed frame rate, zero before the second frame */
+    double m_averageFps;
+
+    /** When the last frame was processed, in EventProfiler::now() units */
+    boost::int64_t m_lastFrame;
 };
         
 } // namespace vision
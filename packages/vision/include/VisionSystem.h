@@ -17,6 +17,7 @@
 #include "core/include/Subsystem.h"
 #include "core/include/ConfigNode.h"
 #include "core/include/Forward.h"
+#include "core/include/WorkerPool.h"
 
 #include "vision/include/Common.h"
 
@@ -90,12 +91,11 @@ public:
         return core::IUpdatable::NORMAL_PRIORITY;
     }
 
-    /** Not implemented */
-    virtual void setAffinity(size_t) {};
-    /** Not implemented */
-    virtual int getAffinity() {
-        return -1;
-    };
+    /** Calls setAffinity on the Cameras, VisionRunners and Recorders */
+    virtual void setAffinity(size_t affinity);
+
+    /** The affinity of the forward VisionRunner */
+    virtual int getAffinity();
     
     /** Calls background on the Cameras, VisionRunners and Recorders
      *
@@ -201,6 +201,9 @@ private:
     VisionRunner* m_forward;
     VisionRunner* m_downward;
 
+    /** Shared by the runners which run their detectors in parallel */
+    core::WorkerPoolPtr m_detectorWorkers;
+
     DetectorPtr m_buoyDetector;
     DetectorPtr m_binDetector;
     DetectorPtr m_pipelineDetector;
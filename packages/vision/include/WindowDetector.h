@@ -22,6 +22,7 @@
 #include "vision/include/Color.h"
 #include "vision/include/Detector.h"
 #include "vision/include/BlobDetector.h"
+#include "vision/include/ColorClassifier.h"
 
 #include "core/include/ConfigNode.h"
 
@@ -48,9 +49,10 @@ class RAM_EXPORT WindowDetector : public Detector
   private:
     void init(core::ConfigNode config);
 
-    /* Normal processing to find one blob/color */
+    /* Normal processing to find one blob/color, input is in LCh and the
+     * color comes from m_labels */
     bool processColor(Image* input, Image* output,
-                      ColorFilter& filter,
+                      ColorFilter& filter, unsigned char colorClass,
                       BlobDetector::Blob& outerBlob,
                       BlobDetector::Blob& innerBlob);
 
@@ -77,6 +79,15 @@ class RAM_EXPORT WindowDetector : public Detector
     ColorFilter *m_antiYellowFilter;
     ColorFilter *m_antiBlueFilter;
 
+    /** Labels each pixel with the colors above, all in one pass */
+    ColorClassifier m_classifier;
+
+    /** The bit of each color in m_labels */
+    unsigned char m_redClass;
+    unsigned char m_greenClass;
+    unsigned char m_yellowClass;
+    unsigned char m_blueClass;
+
     /** Blob detector */
     BlobDetector m_blobDetector;
 
@@ -86,6 +97,7 @@ class RAM_EXPORT WindowDetector : public Detector
     Image *greenFrame;
     Image *yellowFrame;
     Image *blueFrame;
+    Image *m_labels;
 
     bool m_redFound;
     bool m_greenFound;
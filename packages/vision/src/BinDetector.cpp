@@ -180,29 +180,26 @@ BinDetector::~BinDetector()
 
 void BinDetector::processImage(Image* input, Image* out)
 {
-    m_frame->copyFrom(input);
-
     // Ensure all the images are the proper size
-    if ((m_whiteMaskedFrame->getWidth() != m_frame->getWidth()) || 
-        (m_whiteMaskedFrame->getHeight() != m_frame->getHeight()))
+    if ((m_whiteMaskedFrame->getWidth() != input->getWidth()) || 
+        (m_whiteMaskedFrame->getHeight() != input->getHeight()))
     {
         // We are the wrong size delete them and recreate
         deleteImages();
-        allocateImages(m_frame->getWidth(), m_frame->getHeight());
+        allocateImages(input->getWidth(), input->getHeight());
     }
 
-    // Make debug output look like m_frame (will be marked up later)
+    // Make debug output look like the input (will be marked up later)
     if (out)
-        out->copyFrom(m_frame);
+        out->copyFrom(input);
     
-    // Convert the image to LCh
-    m_frame->setPixelFormat(Image::PF_RGB_8);
-    m_frame->setPixelFormat(Image::PF_LCHUV_8);
+    // Convert the image to LCh, shared with the other detectors if we can
+    Image* lch = getConvertedInput(input, Image::PF_LCHUV_8, m_frame);
     
     // Filter for white, black, and red
-    filterForWhite(m_frame, m_whiteMaskedFrame);
-    filterForRed(m_frame, m_redMaskedFrame);
-    filterForBlack(m_frame, m_blackMaskedFrame);
+    filterForWhite(lch, m_whiteMaskedFrame);
+    filterForRed(lch, m_redMaskedFrame);
+    filterForBlack(lch, m_blackMaskedFrame);
     
     // Update debug image with black, white and red color info
     filterDebugOutput(out);
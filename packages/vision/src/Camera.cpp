@@ -11,6 +11,7 @@
 #include <sstream>
 
 // Library Includes
+#include <boost/bind.hpp>
 #include <boost/regex.hpp>
 #include <boost/tuple/tuple.hpp>
 
@@ -18,10 +19,15 @@
 #include "vision/include/Camera.h"
 #include "vision/include/Image.h"
 #include "vision/include/OpenCVImage.h"
+#include "vision/include/Frame.h"
 #include "vision/include/Events.h"
 #include "vision/include/CameraMaker.h"
 #include "vision/include/VisionSystem.h"
 
+#include "core/include/EventPool.h"
+#include "core/include/EventProfiler.h"
+#include "core/include/TimeVal.h"
+
 RAM_CORE_EVENT_TYPE(ram::vision::Camera, IMAGE_CAPTURED);
 
 namespace ram {
@@ -30,11 +36,17 @@ namespace vision {
 Camera::Camera() :
     Updatable(this),
     EventPublisher(core::EventHubPtr()),
-    m_publicImage(0),
+    m_framePool(FramePool::create()),
+    m_sequence(0),
+    m_imageTraceId(0),
+    m_averageFps(0),
+    m_lastCapture(0),
     m_imageLatch(1)
 {
-    /// TODO: Make me a basic image, and check that copying work properly
-    m_publicImage = new OpenCVImage(640, 480);
+    setMetricsName("Camera");
+
+    // A blank frame until the first capture
+    m_frame = m_framePool->share(m_framePool->allocate(), 0, 0);
 }
 
 Camera::~Camera()
@@ -43,17 +55,46 @@ Camera::~Camera()
            "anything");
     assert(!backgrounded() &&
            "Camera must not be backgrounded for destruction");
-    delete m_publicImage;
 }
 
 void Camera::getImage(Image* current)
 {
     assert(current && "Can't copy into a null image");
-    
+
+    // Frames never change, so the copy is made without holding the lock
+    current->copyFrom(getFrame()->getImage());
+}
+
+FramePtr Camera::getFrame()
+{
     core::ReadWriteMutex::ScopedReadLock lock(m_imageMutex);
+    return m_frame;
+}
 
-    // Copy over the image (uses copy assignment operator)
-    current->copyFrom(m_publicImage);
+boost::uint64_t Camera::getImageTraceId()
+{
+    core::ReadWriteMutex::ScopedReadLock lock(m_imageMutex);
+    return m_imageTraceId;
+}
+
+void Camera::setMetricsName(const std::string& name)
+{
+    m_metricsName = name;
+    m_frames = core::MetricsRegistry::counter(name, "frames");
+    m_fps = core::MetricsRegistry::gauge(name, "fps");
+
+    // Sampled from the pool, which the gauges keep alive
+    m_conversionHits = core::MetricsRegistry::gauge(
+        name, "frameCache.hits",
+        boost::bind(&FramePool::getConversionHits, m_framePool));
+    m_conversionMisses = core::MetricsRegistry::gauge(
+        name, "frameCache.misses",
+        boost::bind(&FramePool::getConversionMisses, m_framePool));
+}
+
+std::string Camera::getMetricsName()
+{
+    return m_metricsName;
 }
 
 bool Camera::waitForImage(Image* current)
@@ -173,30 +214,50 @@ void Camera::cleanup()
 void Camera::capturedImage(Image* newImage)
 {
     assert(newImage && "Can't copy null image");
-    
-    {    
-        core::ReadWriteMutex::ScopedWriteLock lock(m_imageMutex);
 
-        // Copy over the image data to the public image
-        // (Silently ignore a new image if the new image is null.)
-        if (newImage)
-        {
-            copyToPublic(newImage, m_publicImage);
-        }
+    // (Silently ignore a new image if the new image is null.)
+    if (!newImage)
+        return;
+
+    // Fill a free buffer, readers of the last frame aren't held up
+    Frame* buffer = m_framePool->allocate();
+    copyToPublic(newImage, buffer->getImage());
+    FramePtr frame = m_framePool->share(
+        buffer, ++m_sequence, core::TimeVal::timeOfDay().get_double());
+
+    {
+        core::ReadWriteMutex::ScopedWriteLock lock(m_imageMutex);
+        m_frame = frame;
     }
 
-    // no need to hold the mutex after the image is copied
-    // it would be nice if we could publish this somewhere else
-    // after the image is copied because this blocks the capture loop
-    // alternatively, we could require everyone to use waitForImage
-    // in order to get images upon copy or getImage if dropped or
-    // duplicate frames are not problematic
-    // we could add a timestamp or index for the image in order to
-    // let other modules figure out if they are getting duplicate
-    // frames or dropping frames
-    publish(Camera::IMAGE_CAPTURED,
-            ImageEventPtr(new ImageEvent(m_publicImage)));
+    // it would be nice if we could publish this somewhere else because this
+    // blocks the capture loop, handlers should just hold on to the frame
+    ImageEventPtr event =
+        core::EventPool<ImageEvent>::create(frame->getImage());
+    event->frame = frame;
+    event->timeStamp = frame->getTimeStamp();
+    publish(Camera::IMAGE_CAPTURED, event);
+
+    if (event->traceId)
+    {
+        core::ReadWriteMutex::ScopedWriteLock lock(m_imageMutex);
+        m_imageTraceId = event->traceId;
+    }
     
+    // The rate is smoothed over roughly the last ten images
+    boost::int64_t now = core::EventProfiler::now() / 1000;
+    if ((0 != m_lastCapture) && (now > m_lastCapture))
+    {
+        double fps = 1e6 / (now - m_lastCapture);
+        if (0 == m_averageFps)
+            m_averageFps = fps;
+        else
+            m_averageFps = 0.9 * m_averageFps + 0.1 * fps;
+        m_fps->set(m_averageFps);
+    }
+    m_lastCapture = now;
+    m_frames->increment();
+
     // Now release all waiting threads
     m_imageLatch.countDown();
     // Reset count to one
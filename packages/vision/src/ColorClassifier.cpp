@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/vision/src/ColorClassifier.cpp
+ */
+
+// STD Includes
+#include <cassert>
+#include <cstring>
+
+// Project Includes
+#include "vision/include/ColorClassifier.h"
+#include "vision/include/ColorFilter.h"
+#include "vision/include/TableColorFilter.h"
+#include "vision/include/Image.h"
+
+namespace ram {
+namespace vision {
+
+ColorClassifier::ColorClassifier()
+{
+    memset(m_channelClasses, 0, sizeof(m_channelClasses));
+}
+
+unsigned char ColorClassifier::addClass(ColorFilter* filter)
+{
+    assert(getClassCount() < MAX_CLASSES && "Too many color classes");
+
+    unsigned char bit = (unsigned char)(1 << getClassCount());
+    m_rangeClasses.push_back(std::make_pair(filter, bit));
+    return bit;
+}
+
+unsigned char ColorClassifier::addClass(TableColorFilter* filter)
+{
+    assert(getClassCount() < MAX_CLASSES && "Too many color classes");
+
+    unsigned char bit = (unsigned char)(1 << getClassCount());
+    m_tableClasses.push_back(std::make_pair(filter, bit));
+    return bit;
+}
+
+size_t ColorClassifier::getClassCount() const
+{
+    return m_rangeClasses.size() + m_tableClasses.size();
+}
+
+void ColorClassifier::setupRanges()
+{
+    memset(m_channelClasses, 0, sizeof(m_channelClasses));
+
+    for (size_t i = 0; i < m_rangeClasses.size(); ++i)
+    {
+        ColorFilter* filter = m_rangeClasses[i].first;
+        unsigned char bit = m_rangeClasses[i].second;
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            for (int value = 0; value < 256; ++value)
+            {
+                if (filter->inChannelRange(channel + 1, value))
+                    m_channelClasses[channel][value] |= bit;
+            }
+        }
+    }
+}
+
+void ColorClassifier::classify(Image* input, Image* labels)
+{
+    assert((input->getWidth() == labels->getWidth()) &&
+           (input->getHeight() == labels->getHeight()) &&
+           "Labels must be the size of the input");
+    assert(1 == labels->getNumChannels() && "Labels must be one channel");
+
+    // The filters may have changed since the last image
+    setupRanges();
+
+    size_t numPixels = input->getWidth() * input->getHeight();
+    unsigned char* inputData = input->getData();
+    unsigned char* labelData = labels->getData();
+
+    // A pixel is in a range class when all three channels are in its range,
+    // so and'ing the bits for each channel tests every range class at once
+    const unsigned char* channel1 = m_channelClasses[0];
+    const unsigned char* channel2 = m_channelClasses[1];
+    const unsigned char* channel3 = m_channelClasses[2];
+    if (m_tableClasses.empty())
+    {
+        for (size_t i = 0; i < numPixels; ++i, inputData += 3)
+        {
+            labelData[i] = channel1[inputData[0]] & channel2[inputData[1]] &
+                channel3[inputData[2]];
+        }
+    }
+    else
+    {
+        size_t tableCount = m_tableClasses.size();
+        for (size_t i = 0; i < numPixels; ++i, inputData += 3)
+        {
+            unsigned char label = channel1[inputData[0]] &
+                channel2[inputData[1]] & channel3[inputData[2]];
+            for (size_t t = 0; t < tableCount; ++t)
+            {
+                if (m_tableClasses[t].first->inTable(
+                        inputData[0], inputData[1], inputData[2]))
+                {
+                    label |= m_tableClasses[t].second;
+                }
+            }
+            labelData[i] = label;
+        }
+    }
+}
+
+void ColorClassifier::extractMask(Image* labels, unsigned char classes,
+                                  Image* output)
+{
+    assert((output->getWidth() == labels->getWidth()) &&
+           (output->getHeight() == labels->getHeight()) &&
+           "Mask must be the size of the labels");
+
+    size_t numPixels = labels->getWidth() * labels->getHeight();
+    int nChannels = output->getNumChannels();
+    unsigned char* labelData = labels->getData();
+    unsigned char* outputData = output->getData();
+
+    for (size_t i = 0; i < numPixels; ++i)
+    {
+        unsigned char result = (labelData[i] & classes) ? 255 : 0;
+        for (int k = 0; k < nChannels; k++, outputData++)
+            *outputData = result;
+    }
+}
+
+} // namespace vision
+} // namespace ram
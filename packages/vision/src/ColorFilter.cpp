@@ -18,6 +18,7 @@
 
 // Project Includes
 #include "vision/include/ColorFilter.h"
+#include "vision/include/ColorFilterKernels.h"
 #include "vision/include/Image.h"
 
 #include "core/include/PropertySet.h"
@@ -26,6 +27,98 @@
 namespace ram {
 namespace vision {
 
+namespace detail {
+
+// Bit 3i set for each of the 16 pixels in 48 bytes
+static const boost::uint64_t PIXEL_BITS = 0x249249249249ULL;
+
+/** Expands each bit of a byte into a byte of 0 or 255 */
+struct ByteMasks
+{
+    ByteMasks()
+    {
+        for (int value = 0; value < 256; ++value)
+        {
+            for (int bit = 0; bit < 8; ++bit)
+                masks[value][bit] = (value & (1 << bit)) ? 255 : 0;
+        }
+    }
+
+    unsigned char masks[256][8];
+};
+
+static const ByteMasks BYTE_MASKS;
+
+void writeRangeMask(boost::uint64_t bytesInRange, unsigned char* output,
+                    int outputChannels, bool inverse)
+{
+    // A pixel is in range when all three of its bytes are, which leaves its
+    // result in the bit of its first byte
+    boost::uint64_t pixels = bytesInRange & (bytesInRange >> 1) &
+        (bytesInRange >> 2) & PIXEL_BITS;
+    if (inverse)
+        pixels ^= PIXEL_BITS;
+
+    if (3 == outputChannels)
+    {
+        // Copy the result to the bits of the other two bytes
+        boost::uint64_t bytes = pixels | (pixels << 1) | (pixels << 2);
+        for (int i = 0; i < 6; ++i)
+        {
+            memcpy(output + 8 * i, BYTE_MASKS.masks[(bytes >> (8 * i)) & 0xFF],
+                   8);
+        }
+    }
+    else
+    {
+        // Pack the results together, two pixels every six bits
+        unsigned int packed = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            unsigned int two = (unsigned int)(pixels >> (6 * i));
+            packed |= ((two & 1) | ((two >> 2) & 2)) << (2 * i);
+        }
+        memcpy(output, BYTE_MASKS.masks[packed & 0xFF], 8);
+        memcpy(output + 8, BYTE_MASKS.masks[packed >> 8], 8);
+    }
+}
+
+} // namespace detail
+
+static bool cpuSupports(ColorFilter::Kernel kernel)
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    __builtin_cpu_init();
+    switch (kernel)
+    {
+        case ColorFilter::SCALAR:
+            return true;
+        case ColorFilter::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case ColorFilter::AVX2:
+            return __builtin_cpu_supports("avx2");
+    }
+    return false;
+#else
+    return ColorFilter::SCALAR == kernel;
+#endif
+}
+
+static ColorFilter::Kernel fastestKernel()
+{
+    if (ColorFilter::isKernelSupported(ColorFilter::AVX2))
+        return ColorFilter::AVX2;
+    if (ColorFilter::isKernelSupported(ColorFilter::SSE2))
+        return ColorFilter::SSE2;
+    return ColorFilter::SCALAR;
+}
+
+static ColorFilter::Kernel& currentKernel()
+{
+    static ColorFilter::Kernel kernel = fastestKernel();
+    return kernel;
+}
+
 ColorFilter::ColorFilter(
     unsigned char channel1Low, unsigned char channel1High,
     unsigned char channel2Low, unsigned char channel2High,
@@ -92,11 +185,75 @@ void ColorFilter::setupRanges()
         }
     }
 
+    // The bounds for the kernels, byte i is for channel i % 3
+    unsigned char lows[3] = {m_channel1Low, m_channel2Low, m_channel3Low};
+    unsigned char highs[3] = {m_channel1High, m_channel2High, m_channel3High};
+    for (size_t i = 0; i < sizeof(m_lows); ++i)
+    {
+        m_lows[i] = lows[i % 3];
+        m_highs[i] = highs[i % 3];
+    }
+
+    m_wraps = (m_channel1Low > m_channel1High) ||
+        (m_channel2Low > m_channel2High) ||
+        (m_channel3Low > m_channel3High);
 }
 
 void ColorFilter::filterImage(Image* input, Image* output)
 {
-    int numPixels = input->getWidth() * input->getHeight();
+    filter(input, output, false);
+}
+
+void ColorFilter::inverseFilterImage(Image* input, Image *output)
+{
+    filter(input, output, true);
+}
+
+bool ColorFilter::inChannelRange(int channel, unsigned char value) const
+{
+    assert((channel >= 1) && (channel <= 3) && "Invalid channel");
+    switch (channel)
+    {
+        case 1:
+            return m_channel1Range[value];
+        case 2:
+            return m_channel2Range[value];
+        default:
+            return m_channel3Range[value];
+    }
+}
+
+ColorFilter::Kernel ColorFilter::getKernel()
+{
+    return currentKernel();
+}
+
+bool ColorFilter::setKernel(Kernel kernel)
+{
+    if (!isKernelSupported(kernel))
+        return false;
+
+    currentKernel() = kernel;
+    return true;
+}
+
+bool ColorFilter::isKernelSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+        case SCALAR:
+            return true;
+        case SSE2:
+            return detail::hasSSE2Kernel() && cpuSupports(SSE2);
+        case AVX2:
+            return detail::hasAVX2Kernel() && cpuSupports(AVX2);
+    }
+    return false;
+}
+
+void ColorFilter::filter(Image* input, Image* output, bool inverse)
+{
+    size_t numPixels = input->getWidth() * input->getHeight();
     int nChannels;
     unsigned char* inputData = input->getData();
     unsigned char* outputData = NULL;
@@ -111,52 +268,46 @@ void ColorFilter::filterImage(Image* input, Image* output)
         nChannels = input->getNumChannels();
     }
 
-    for (int i = 0; i < numPixels; ++i)
+    // The kernels test a range with two compares, so wrapped ranges must use
+    // the tables
+    size_t done = 0;
+    if (!m_wraps && ((1 == nChannels) || (3 == nChannels)))
     {
-        unsigned char result = 
-            m_channel1Range[*inputData] & 
-            m_channel2Range[*(inputData + 1)] &
-            m_channel3Range[*(inputData + 2)];
-        
-        for (int k = 0; k < nChannels; k++, outputData++)
-            *outputData = result;
-
-        inputData += 3;
-    }
-}
-
-void ColorFilter::inverseFilterImage(Image* input, Image *output)
-{
-    int numPixels = input->getWidth() * input->getHeight();
-    int nChannels;
-    unsigned char* inputData = input->getData();
-    unsigned char* outputData = 0;
-    if (output) {
-        outputData = output->getData();
-        nChannels = output->getNumChannels();
-    } else {
-        outputData = input->getData();
-        nChannels = input->getNumChannels();
+        switch (getKernel())
+        {
+            case AVX2:
+                done = detail::filterRangesAVX2(inputData, outputData,
+                                                numPixels, nChannels,
+                                                m_lows, m_highs, inverse);
+                break;
+            case SSE2:
+                done = detail::filterRangesSSE2(inputData, outputData,
+                                                numPixels, nChannels,
+                                                m_lows, m_highs, inverse);
+                break;
+            case SCALAR:
+                break;
+        }
+        inputData += 3 * done;
+        outputData += nChannels * done;
     }
 
-    for (int i = 0; i < numPixels; ++i)
+    // The results are 0 or 255, so this flips them when inverting
+    unsigned char flip = inverse ? 255 : 0;
+    for (size_t i = done; i < numPixels; ++i)
     {
-        unsigned char result = 255 * !(
+        unsigned char result = flip ^ (
             m_channel1Range[*inputData] & 
             m_channel2Range[*(inputData + 1)] &
             m_channel3Range[*(inputData + 2)]);
         
-        for (int k = 0; k < nChannels; k++, outputData++) {
+        for (int k = 0; k < nChannels; k++, outputData++)
             *outputData = result;
-        }
-        
+
         inputData += 3;
     }
 }
 
-
-
-
 void ColorFilter::setChannel1Low(int value)
 {
     // Ensure the value is in the proper range
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/vision/src/ColorFilterAVX2.cpp
+ */
+
+// Library Includes
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Project Includes
+#include "vision/include/ColorFilterKernels.h"
+
+namespace ram {
+namespace vision {
+namespace detail {
+
+#ifdef __AVX2__
+
+bool hasAVX2Kernel()
+{
+    return true;
+}
+
+// Bit i is set when byte i is within [low, high], the saturating subtracts
+// are only zero when neither bound is crossed
+static inline boost::uint64_t inRange(__m256i value, __m256i low,
+                                      __m256i high, __m256i zero)
+{
+    __m256i outside = _mm256_or_si256(_mm256_subs_epu8(low, value),
+                                      _mm256_subs_epu8(value, high));
+    return (unsigned int)_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(outside, zero));
+}
+
+size_t filterRangesAVX2(const unsigned char* input, unsigned char* output,
+                        size_t pixels, int outputChannels,
+                        const unsigned char* lows, const unsigned char* highs,
+                        bool inverse)
+{
+    // 32 pixels are 96 bytes, so each of the three loads starts on a
+    // different channel
+    __m256i low0 = _mm256_loadu_si256((const __m256i*)lows);
+    __m256i low1 = _mm256_loadu_si256((const __m256i*)(lows + 32));
+    __m256i low2 = _mm256_loadu_si256((const __m256i*)(lows + 64));
+    __m256i high0 = _mm256_loadu_si256((const __m256i*)highs);
+    __m256i high1 = _mm256_loadu_si256((const __m256i*)(highs + 32));
+    __m256i high2 = _mm256_loadu_si256((const __m256i*)(highs + 64));
+    __m256i zero = _mm256_setzero_si256();
+
+    size_t done = 0;
+    for (; done + 32 <= pixels; done += 32)
+    {
+        const unsigned char* data = input + 3 * done;
+        boost::uint64_t first =
+            inRange(_mm256_loadu_si256((const __m256i*)data),
+                    low0, high0, zero);
+        boost::uint64_t second =
+            inRange(_mm256_loadu_si256((const __m256i*)(data + 32)),
+                    low1, high1, zero);
+        boost::uint64_t third =
+            inRange(_mm256_loadu_si256((const __m256i*)(data + 64)),
+                    low2, high2, zero);
+
+        // The masks are written 16 pixels (48 input bytes) at a time, all
+        // the input is read first so filtering in place is fine
+        unsigned char* out = output + outputChannels * done;
+        writeRangeMask(first | ((second & 0xFFFF) << 32), out,
+                       outputChannels, inverse);
+        writeRangeMask((second >> 16) | (third << 16),
+                       out + outputChannels * 16, outputChannels, inverse);
+    }
+
+    return done;
+}
+
+#else // __AVX2__
+
+bool hasAVX2Kernel()
+{
+    return false;
+}
+
+size_t filterRangesAVX2(const unsigned char*, unsigned char*, size_t, int,
+                        const unsigned char*, const unsigned char*, bool)
+{
+    return 0;
+}
+
+#endif // __AVX2__
+
+} // namespace detail
+} // namespace vision
+} // namespace ram
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/vision/src/ColorFilterSSE2.cpp
+ */
+
+// Library Includes
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Project Includes
+#include "vision/include/ColorFilterKernels.h"
+
+namespace ram {
+namespace vision {
+namespace detail {
+
+#ifdef __SSE2__
+
+bool hasSSE2Kernel()
+{
+    return true;
+}
+
+// Bit i is set when byte i is within [low, high], the saturating subtracts
+// are only zero when neither bound is crossed
+static inline boost::uint64_t inRange(__m128i value, __m128i low,
+                                      __m128i high, __m128i zero)
+{
+    __m128i outside = _mm_or_si128(_mm_subs_epu8(low, value),
+                                   _mm_subs_epu8(value, high));
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(outside, zero));
+}
+
+size_t filterRangesSSE2(const unsigned char* input, unsigned char* output,
+                        size_t pixels, int outputChannels,
+                        const unsigned char* lows, const unsigned char* highs,
+                        bool inverse)
+{
+    // 16 pixels are 48 bytes, so each of the three loads starts on a
+    // different channel
+    __m128i low0 = _mm_loadu_si128((const __m128i*)lows);
+    __m128i low1 = _mm_loadu_si128((const __m128i*)(lows + 16));
+    __m128i low2 = _mm_loadu_si128((const __m128i*)(lows + 32));
+    __m128i high0 = _mm_loadu_si128((const __m128i*)highs);
+    __m128i high1 = _mm_loadu_si128((const __m128i*)(highs + 16));
+    __m128i high2 = _mm_loadu_si128((const __m128i*)(highs + 32));
+    __m128i zero = _mm_setzero_si128();
+
+    size_t done = 0;
+    for (; done + 16 <= pixels; done += 16)
+    {
+        const unsigned char* data = input + 3 * done;
+        boost::uint64_t bytesInRange =
+            inRange(_mm_loadu_si128((const __m128i*)data), low0, high0, zero) |
+            (inRange(_mm_loadu_si128((const __m128i*)(data + 16)),
+                     low1, high1, zero) << 16) |
+            (inRange(_mm_loadu_si128((const __m128i*)(data + 32)),
+                     low2, high2, zero) << 32);
+
+        // All the input is read first, so filtering in place is fine
+        writeRangeMask(bytesInRange, output + outputChannels * done,
+                       outputChannels, inverse);
+    }
+
+    return done;
+}
+
+#else // __SSE2__
+
+bool hasSSE2Kernel()
+{
+    return false;
+}
+
+size_t filterRangesSSE2(const unsigned char*, unsigned char*, size_t, int,
+                        const unsigned char*, const unsigned char*, bool)
+{
+    return 0;
+}
+
+#endif // __SSE2__
+
+} // namespace detail
+} // namespace vision
+} // namespace ram
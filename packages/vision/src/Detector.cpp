@@ -12,6 +12,7 @@
 // Project Includes
 #include "vision/include/Detector.h"
 #include "vision/include/Image.h"
+#include "vision/include/Frame.h"
 
 #include "core/include/PropertySet.h"
 
@@ -20,7 +21,8 @@ namespace vision {
 
 Detector::Detector(core::EventHubPtr eventHub) :
     core::EventPublisher(eventHub),
-    m_propertySet(new core::PropertySet())
+    m_propertySet(new core::PropertySet()),
+    m_inputImage(0)
 {
 }
 
@@ -29,6 +31,27 @@ core::PropertySetPtr Detector::getPropertySet()
     return m_propertySet;
 }
 
+void Detector::setInputFrame(FramePtr frame, Image* input)
+{
+    m_inputFrame = frame;
+    m_inputImage = frame ? input : 0;
+}
+
+Image* Detector::getConvertedInput(Image* input, Image::PixelFormat format,
+                                   Image* scratch)
+{
+    // Only the image we were told holds the frame can be trusted, any other
+    // could be a copy someone has since changed
+    if (m_inputFrame && (input == m_inputImage))
+        return m_inputFrame->getImage(format);
+
+    scratch->copyFrom(input);
+    if (Image::PF_LCHUV_8 == format)
+        scratch->setPixelFormat(Image::PF_RGB_8);
+    scratch->setPixelFormat(format);
+    return scratch;
+}
+
 void Detector::imageToAICoordinates(const Image* image, 
                                     const int& imageX, const int& imageY,
                                     double& outX, double& outY)
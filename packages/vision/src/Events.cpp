@@ -143,7 +143,10 @@ core::EventPtr ImageEvent::clone()
 {
     ImageEventPtr event = ImageEventPtr(new ImageEvent());
     copyInto(event);
-    // Not yet implemetned
+
+    // Frames never change, so the clone shares it
+    event->image = image;
+    event->frame = frame;
     return event;
 }
 
@@ -45,7 +45,9 @@ FileRecorder::~FileRecorder()
 
 void FileRecorder::recordFrame(Image* image)
 {
-    image->setPixelFormat(Image::PF_BGR_8);
+    // Converting in place would change the shared camera frame
+    assert(Image::PF_BGR_8 == image->getPixelFormat() &&
+           "Recorder must hand over BGR images");
     m_writer << image->asIplImage();
 }
 
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/vision/src/Frame.cpp
+ */
+
+// Library Includes
+#include <boost/bind.hpp>
+
+// Project Includes
+#include "vision/include/Frame.h"
+#include "vision/include/OpenCVImage.h"
+
+#include "core/include/EventPool.h"
+
+namespace ram {
+namespace vision {
+
+Frame::Conversion::Conversion() :
+    image(0),
+    valid(false)
+{
+}
+
+Frame::Conversion::~Conversion()
+{
+    delete image;
+}
+
+Frame::Frame(Image* image, FramePool* pool) :
+    m_image(image),
+    m_sequence(0),
+    m_timeStamp(0),
+    m_pool(pool)
+{
+}
+
+Frame::~Frame()
+{
+    delete m_image;
+}
+
+Image* Frame::getImage(Image::PixelFormat format) const
+{
+    if (m_image->getPixelFormat() == format)
+        return m_image;
+
+    // Each format has its own lock, so different conversions can be made at
+    // the same time
+    Conversion& conversion = m_conversions[format];
+    boost::mutex::scoped_lock lock(conversion.mutex);
+    if (conversion.valid)
+    {
+        m_pool->m_conversionHits.increment();
+        return conversion.image;
+    }
+
+    m_pool->m_conversionMisses.increment();
+    if (!conversion.image)
+        conversion.image = new OpenCVImage(640, 480);
+    conversion.image->copyFrom(m_image);
+
+    // LCh can only be reached from RGB
+    if (Image::PF_LCHUV_8 == format)
+        conversion.image->setPixelFormat(Image::PF_RGB_8);
+    conversion.image->setPixelFormat(format);
+
+    conversion.valid = true;
+    return conversion.image;
+}
+
+FramePool::FramePool(size_t maxFree) :
+    m_freeFrames(maxFree)
+{
+}
+
+FramePoolPtr FramePool::create(size_t maxFree)
+{
+    return FramePoolPtr(new FramePool(maxFree));
+}
+
+FramePool::~FramePool()
+{
+    Frame* frame = 0;
+    while (m_freeFrames.tryPop(frame))
+        delete frame;
+}
+
+Frame* FramePool::allocate()
+{
+    Frame* frame = 0;
+    if (m_freeFrames.tryPop(frame))
+    {
+        m_reuses.increment();
+        return frame;
+    }
+
+    // Copying into the image resizes it as needed
+    m_heapAllocations.increment();
+    return new Frame(new OpenCVImage(640, 480), this);
+}
+
+FramePtr FramePool::share(Frame* frame, boost::uint64_t sequence,
+                          double timeStamp)
+{
+    frame->m_sequence = sequence;
+    frame->m_timeStamp = timeStamp;
+
+    // Conversions of the last image the frame held are out of date, no one
+    // else can see the frame yet so there is no need to lock
+    for (int i = 0; i < Image::PF_END; ++i)
+        frame->m_conversions[i].valid = false;
+
+    // The reference count comes from a pool as well
+    return FramePtr(frame,
+                    boost::bind(&FramePool::release, shared_from_this(), _1),
+                    core::PoolAllocator<Frame>());
+}
+
+void FramePool::release(Frame* frame)
+{
+    // The free list is full, so the frame goes back to the heap
+    if (!m_freeFrames.tryPush(frame))
+        delete frame;
+}
+
+} // namespace vision
+} // namespace ram
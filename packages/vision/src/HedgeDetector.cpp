@@ -138,9 +138,8 @@ bool HedgeDetector::processColor(Image* input, Image* output,
                                  BlobDetector::Blob& rightBlob,
                                  BlobDetector::Blob& outBlob)
 {
-    output->copyFrom(input);
-    output->setPixelFormat(Image::PF_RGB_8);
-    output->setPixelFormat(Image::PF_LCHUV_8);
+    // Filtered in place, so the shared conversion is copied
+    output->copyFrom(getConvertedInput(input, Image::PF_LCHUV_8, output));
 
     filter.filterImage(output);
 
@@ -229,7 +228,7 @@ void HedgeDetector::processImage(Image* input, Image* output)
     BlobDetector::Blob hedgeBlob, leftBlob, rightBlob;
     bool found = false;
 
-    if((found = processColor(frame, greenFrame, *m_colorFilter,
+    if((found = processColor(input, greenFrame, *m_colorFilter,
                              leftBlob, rightBlob, hedgeBlob))) {
         publishFoundEvent(hedgeBlob, leftBlob, rightBlob);
 
@@ -186,9 +186,8 @@ bool LoversLaneDetector::processColor(Image* input, Image* output,
                                       BlobDetector::Blob& rightBlob,
                                       BlobDetector::Blob& outBlob)
 {
-    output->copyFrom(input);
-    output->setPixelFormat(Image::PF_RGB_8);
-    output->setPixelFormat(Image::PF_LCHUV_8);
+    // Filtered in place, so the shared conversion is copied
+    output->copyFrom(getConvertedInput(input, Image::PF_LCHUV_8, output));
 
     if ( m_colorFilterLookupTable )
         filter.filterImage(input, output);
@@ -297,10 +296,10 @@ void LoversLaneDetector::processImage(Image* input, Image* output)
     bool found = false;
     
     if ( m_colorFilterLookupTable ) {
-        found = processColor(frame, greenFrame, *m_tableColorFilter,
+        found = processColor(input, greenFrame, *m_tableColorFilter,
                              leftBlob, rightBlob, loversLaneBlob);
     } else {
-        found = processColor(frame, greenFrame, *m_colorFilter,
+        found = processColor(input, greenFrame, *m_colorFilter,
                              leftBlob, rightBlob, loversLaneBlob);
     }
 
@@ -83,7 +83,9 @@ RawFileRecorder::~RawFileRecorder()
 
 void RawFileRecorder::recordFrame(Image* image)
 {
-    image->setPixelFormat(Image::PF_BGR_8);
+    // Converting in place would change the shared camera frame
+    assert(Image::PF_BGR_8 == image->getPixelFormat() &&
+           "Recorder must hand over BGR images");
 
     // Pack up the header
     Packet packet;
@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <sstream>
 #include <iostream>
+#include <typeinfo>
 
 // Library Includes
 #include <boost/bind.hpp>
@@ -25,6 +26,7 @@
 #include "vision/include/main.h"
 #include "vision/include/Recorder.h"
 #include "vision/include/OpenCVImage.h"
+#include "vision/include/Frame.h"
 #include "vision/include/Camera.h"
 #include "vision/include/Events.h"
 
@@ -33,6 +35,7 @@
 #include "vision/include/NetworkRecorder.h"
 
 #include "core/include/TimeVal.h"
+#include "core/include/Tracer.h"
 #include "core/include/EventConnection.h"
 
 namespace ba = boost::algorithm;
@@ -49,7 +52,7 @@ Recorder::Recorder(Camera* camera, Recorder::RecordingPolicy policy,
     m_height(recordHeight),
     m_newFrame(false),
     m_camera(camera),
-    m_frameFromCamera(new OpenCVImage(camera->width(), camera->height())),
+    m_frameTraceId(0),
     m_frameResized(new OpenCVImage(recordWidth, recordHeight)),
     m_currentTime(0),
     m_nextRecordTime(0)
@@ -70,7 +73,6 @@ Recorder::~Recorder()
            "Recorder::cleanUp() not called by subclass");
     
     delete m_frameResized;
-    delete m_frameFromCamera;
 }
 
 void Recorder::update(double timeSinceLastUpdate)
@@ -99,14 +101,42 @@ void Recorder::update(double timeSinceLastUpdate)
             // Check to see if we have a new frame waiting
             if (m_newFrame)
             {
-                // Get a working copy of new frame from the camera
-                m_camera->getImage(m_frameFromCamera);
-                m_frameFromCamera->setSize(m_width, m_height);
-                recordFrame(m_frameFromCamera);
+                // Take the frame, any newer one waits for the next update
+                FramePtr frame;
+                boost::uint64_t traceId = 0;
                 {
                     boost::mutex::scoped_lock lock(m_mutex);
+                    frame.swap(m_frame);
+                    traceId = m_frameTraceId;
                     m_newFrame = false;
                 }
+
+                // Not sent by the camera, so just take its latest
+                if (!frame)
+                {
+                    frame = m_camera->getFrame();
+                    traceId = m_camera->getImageTraceId();
+                }
+
+                // Record the shared image in place when we can, only resizes
+                // and conversions need a copy of our own
+                Image* image = frame->getImage();
+                if ((m_width != image->getWidth()) ||
+                    (m_height != image->getHeight()) ||
+                    (Image::PF_BGR_8 != image->getPixelFormat()))
+                {
+                    m_frameResized->copyFrom(image);
+                    m_frameResized->setSize(m_width, m_height);
+                    m_frameResized->setPixelFormat(Image::PF_BGR_8);
+                    image = m_frameResized;
+                }
+
+                // What the frame causes traces back to the camera
+                core::Tracer::ScopedContext context(traceId);
+                if (image == frame->getImage())
+                    m_recordingFrame = frame;
+                recordFrame(image);
+                m_recordingFrame.reset();
             }
             else
             {
@@ -130,6 +160,7 @@ void Recorder::background(int interval)
     {
         boost::mutex::scoped_lock lock(m_mutex);
         m_newFrame = false;
+        m_frame.reset();
     }
     Updatable::background(interval);
 }
@@ -245,8 +276,24 @@ void Recorder::newImageCapture(core::EventPtr event)
 {
     // Do as little as possible here.  Let the recorder know a
     // new frame is available.
+    ImageEventPtr imageEvent = boost::dynamic_pointer_cast<ImageEvent>(event);
     boost::mutex::scoped_lock lock(m_mutex);
+
+    // Recording as fast as possible, but the last frame is still waiting
+    if (m_newFrame && (NEXT_FRAME == m_policy))
+    {
+        if (!m_droppedFrames)
+        {
+            m_droppedFrames = core::MetricsRegistry::counter(
+                m_camera->getMetricsName(),
+                core::MetricsRegistry::typeName(typeid(*this)) +
+                ".droppedFrames");
+        }
+        m_droppedFrames->increment();
+    }
     m_newFrame = true;
+    m_frame = imageEvent ? imageEvent->frame : FramePtr();
+    m_frameTraceId = event->traceId;
 }
 
 } // namespace vision
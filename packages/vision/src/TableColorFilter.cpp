@@ -90,6 +90,13 @@ void TableColorFilter::createLookupTable(std::string filepath,
     saveLookupTable(filepath, bf);
 }
 
+bool TableColorFilter::inTable(unsigned char channel1,
+                               unsigned char channel2,
+                               unsigned char channel3) const
+{
+    return m_filterTable(channel1, channel2, channel3);
+}
+
 void TableColorFilter::filterImage(Image* input, Image* output)
 {
     int numPixels = input->getWidth() * input->getHeight();
@@ -10,21 +10,35 @@
 // STD Includes
 #include <utility>
 #include <iostream>
+#include <typeinfo>
 
 // Project Includes
 #include <boost/foreach.hpp>
+#include <boost/bind.hpp>
 
 // Project Includes
 #include "vision/include/VisionRunner.h"
 #include "vision/include/Camera.h"
 #include "vision/include/Detector.h"
+#include "vision/include/OpenCVImage.h"
+
+#include "core/include/EventProfiler.h"
+#include "core/include/Tracer.h"
 
 namespace ram {
 namespace vision {
 
 VisionRunner::VisionRunner(Camera* camera, Recorder::RecordingPolicy policy,
-                           int policyArg) :
-    Recorder(camera, policy, policyArg)
+                           int policyArg, core::WorkerPoolPtr workers) :
+    Recorder(camera, policy, policyArg),
+    m_image(new OpenCVImage(camera->width(), camera->height())),
+    m_workers(workers),
+    m_metricsName(camera->getMetricsName()),
+    m_frameTimes(core::MetricsRegistry::histogram(m_metricsName,
+                                                  "VisionRunner.frameUsec")),
+    m_fps(core::MetricsRegistry::gauge(m_metricsName, "VisionRunner.fps")),
+    m_averageFps(0),
+    m_lastFrame(0)
 {
 }
 
@@ -34,6 +48,15 @@ VisionRunner::~VisionRunner()
     
     // stop background thread, and wait till it joins
     Updatable::unbackground(true);
+
+    delete m_image;
+
+    typedef std::map<DetectorPtr, Image*>::iterator ImageIter;
+    for (ImageIter iter = m_detectorImages.begin();
+         iter != m_detectorImages.end(); ++iter)
+    {
+        delete iter->second;
+    }
 }
     
 void VisionRunner::update(double timestep)
@@ -87,11 +110,130 @@ void VisionRunner::recordFrame(Image* image)
     if(processDetectorChanges() || (m_detectors.size() == 0))
         return;
 
-    // Have each detector process the image
+    // The frame is null if the image is a copy, detectors then convert it
+    // themselves
+    FramePtr frame = getRecordingFrame();
+
+    boost::int64_t start = core::EventProfiler::now();
+    if (m_workers)
+        processParallel(image, frame);
+    else
+        processSerial(image, frame);
+    recordFrameMetrics(start);
+}
+
+void VisionRunner::processSerial(Image* image, FramePtr frame)
+{
+    // The image is shared with the other users of the camera frame, so the
+    // detectors which change it share a copy.  Only the first of them gets
+    // the copy unchanged, the rest can't use the frame's conversions.
+    bool copied = false;
+    BOOST_FOREACH(DetectorPtr detector, m_detectors)
+    {
+        if (detector->changesInput())
+        {
+            FramePtr copyFrame;
+            if (!copied)
+            {
+                m_image->copyFrom(image);
+                copyFrame = frame;
+                copied = true;
+            }
+            runDetector(detector, m_image, copyFrame);
+        }
+        else
+        {
+            runDetector(detector, image, frame);
+        }
+    }
+}
+
+void VisionRunner::processParallel(Image* image, FramePtr frame)
+{
+    // Carry the frame's trace ID over to the workers
+    boost::uint64_t traceId = core::Tracer::currentContext();
+    core::CountDownLatch done(m_detectors.size());
+
     BOOST_FOREACH(DetectorPtr detector, m_detectors)
     {
-        detector->processImage(image);
+        // Each detector which changes the image needs its own copy, made on
+        // the worker
+        Image* copy = 0;
+        if (detector->changesInput())
+        {
+            Image*& detectorImage = m_detectorImages[detector];
+            if (!detectorImage)
+            {
+                detectorImage = new OpenCVImage(image->getWidth(),
+                                                image->getHeight());
+            }
+            copy = detectorImage;
+        }
+
+        m_workers->submit(boost::bind(&VisionRunner::processTask, this,
+                                      detector, image, copy, frame,
+                                      traceId, &done));
+    }
+
+    done.await();
+}
+
+void VisionRunner::processTask(DetectorPtr detector, Image* image,
+                               Image* copy, FramePtr frame,
+                               boost::uint64_t traceId,
+                               core::CountDownLatch* done)
+{
+    core::Tracer::ScopedContext context(traceId);
+    if (copy)
+    {
+        copy->copyFrom(image);
+        image = copy;
+    }
+
+    runDetector(detector, image, frame);
+    done->countDown();
+}
+
+void VisionRunner::runDetector(DetectorPtr detector, Image* image,
+                               FramePtr frame)
+{
+    boost::int64_t start = core::EventProfiler::now();
+    detector->setInputFrame(frame, image);
+    detector->processImage(image);
+    detector->setInputFrame(FramePtr());
+
+    // Only looked up, the workers may be sharing the map
+    m_detectorTimes.find(detector)->second->record(
+        (core::EventProfiler::now() - start) / 1000);
+}
+
+void VisionRunner::removeDetectorImage(DetectorPtr detector)
+{
+    std::map<DetectorPtr, Image*>::iterator iter =
+        m_detectorImages.find(detector);
+    if (m_detectorImages.end() != iter)
+    {
+        delete iter->second;
+        m_detectorImages.erase(iter);
+    }
+}
+
+void VisionRunner::recordFrameMetrics(boost::int64_t start)
+{
+    boost::int64_t now = core::EventProfiler::now();
+    m_frameTimes->record((now - start) / 1000);
+
+    // The rate is smoothed over roughly the last ten frames
+    if ((0 != m_lastFrame) && (now > m_lastFrame))
+    {
+        double fps = 1e9 / (now - m_lastFrame);
+        if (0 == m_averageFps)
+            m_averageFps = fps;
+        else
+            m_averageFps = 0.9 * m_averageFps + 0.1 * fps;
+        m_fps->set(m_averageFps);
     }
+    m_lastFrame = now;
 }
     
 void VisionRunner::waitForImage(Camera* camera)
@@ -117,7 +259,14 @@ bool VisionRunner::processDetectorChanges(bool canBackground)
                     m_detectors.find(change.second);
                 
                 if (m_detectors.end() == iter)
+                {
                     m_detectors.insert(change.second);
+                    m_detectorTimes[change.second] =
+                        core::MetricsRegistry::histogram(
+                            m_metricsName,
+                            core::MetricsRegistry::typeName(
+                                typeid(*change.second)) + ".processUsec");
+                }
             }
             break;
 
@@ -127,13 +276,20 @@ bool VisionRunner::processDetectorChanges(bool canBackground)
                     m_detectors.find(change.second);
                 
                 if (m_detectors.end() != iter)
+                {
                     m_detectors.erase(iter);
+                    m_detectorTimes.erase(change.second);
+                    removeDetectorImage(change.second);
+                }
             }
             break;
             
             case REMOVE_ALL:
             {
+                BOOST_FOREACH(DetectorPtr detector, m_detectors)
+                    removeDetectorImage(detector);
                 m_detectors.clear();
+                m_detectorTimes.clear();
             }
             break;
         }
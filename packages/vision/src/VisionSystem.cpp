@@ -119,6 +119,11 @@ void VisionSystem::init(core::ConfigNode config, core::EventHubPtr eventHub)
                                                           eventHub));
     }
 
+    // The metrics of each camera, and what is done with its images, go under
+    // its name
+    m_forwardCamera->setMetricsName("ForwardCamera");
+    m_downwardCamera->setMetricsName("DownwardCamera");
+
     // Read int as bool
     m_testing = config["testing"].asInt(0) != 0;
 
@@ -135,9 +140,23 @@ void VisionSystem::init(core::ConfigNode config, core::EventHubPtr eventHub)
     if (config.exists("DownwardRecorders"))
         createRecordersFromConfig(config["DownwardRecorders"], m_downwardCamera);
     
+    // The detectors of each camera can run at once, on a pool of threads
+    // shared by both cameras
+    bool parallelForward = config["parallelForwardDetectors"].asInt(0) != 0;
+    bool parallelDownward = config["parallelDownwardDetectors"].asInt(0) != 0;
+    if (parallelForward || parallelDownward)
+    {
+        m_detectorWorkers = core::WorkerPoolPtr(
+            new core::WorkerPool(config["detectorThreads"].asInt(0)));
+    }
+
     // Detector runners (go as fast as possible)
-    m_forward = new VisionRunner(m_forwardCamera.get(), Recorder::NEXT_FRAME);
-    m_downward = new VisionRunner(m_downwardCamera.get(), Recorder::NEXT_FRAME);
+    m_forward = new VisionRunner(
+        m_forwardCamera.get(), Recorder::NEXT_FRAME, 0,
+        parallelForward ? m_detectorWorkers : core::WorkerPoolPtr());
+    m_downward = new VisionRunner(
+        m_downwardCamera.get(), Recorder::NEXT_FRAME, 0,
+        parallelDownward ? m_detectorWorkers : core::WorkerPoolPtr());
 
     // Detectors
     m_buoyDetector = DetectorPtr(
@@ -401,6 +420,23 @@ void VisionSystem::setPriority(core::IUpdatable::Priority priority)
         pair.second->setPriority(priority);
 }
     
+void VisionSystem::setAffinity(size_t affinity)
+{
+    m_forwardCamera->setAffinity(affinity);
+    m_downwardCamera->setAffinity(affinity);
+
+    m_forward->setAffinity(affinity);
+    m_downward->setAffinity(affinity);
+
+    BOOST_FOREACH(StrRecorderMapPair pair, m_recorders)
+        pair.second->setAffinity(affinity);
+}
+
+int VisionSystem::getAffinity()
+{
+    return m_forward->getAffinity();
+}
+
 void VisionSystem::background(int interval)
 {
     assert(m_testing && "Can't background when not testing");
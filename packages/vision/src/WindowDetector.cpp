@@ -71,6 +71,7 @@ WindowDetector::~WindowDetector()
     delete greenFrame;
     delete yellowFrame;
     delete blueFrame;
+    delete m_labels;
 }
 
 void WindowDetector::init(core::ConfigNode config)
@@ -160,6 +161,11 @@ void WindowDetector::init(core::ConfigNode config)
                                      "BlueH", "Blue Hue",
                                      0, 255, 0, 255, 0, 255);
 
+    m_redClass = m_classifier.addClass(m_redFilter);
+    m_greenClass = m_classifier.addClass(m_greenFilter);
+    m_yellowClass = m_classifier.addClass(m_yellowFilter);
+    m_blueClass = m_classifier.addClass(m_blueFilter);
+
     // Make sure the configuration is valid
     propSet->verifyConfig(config, true);
     
@@ -170,6 +176,7 @@ void WindowDetector::init(core::ConfigNode config)
     greenFrame = new OpenCVImage(640, 480, Image::PF_BGR_8);
     yellowFrame = new OpenCVImage(640, 480, Image::PF_BGR_8);
     blueFrame = new OpenCVImage(640, 480, Image::PF_BGR_8);
+    m_labels = new OpenCVImage(640, 480, Image::PF_GRAY_8);
 
 }
 
@@ -181,14 +188,11 @@ void WindowDetector::update()
 
 bool WindowDetector::processColor(Image* input, Image* output,
                                   ColorFilter& filter,
+                                  unsigned char colorClass,
                                   BlobDetector::Blob& outerBlob,
                                   BlobDetector::Blob& innerBlob)
 {
-    tempFrame->copyFrom(input);
-    tempFrame->setPixelFormat(Image::PF_RGB_8);
-    tempFrame->setPixelFormat(Image::PF_LCHUV_8);
-
-    filter.filterImage(tempFrame, output);
+    ColorClassifier::extractMask(m_labels, colorClass, output);
 
     // Erode the image (only if necessary)
     IplImage* img = output->asIplImage();
@@ -218,7 +222,7 @@ bool WindowDetector::processColor(Image* input, Image* output,
             m_minWidth <= blob.getWidth() &&
             m_minPixelPercentage <= pixelPercentage &&
             m_maxPixelPercentage >= pixelPercentage &&
-            processBackground(tempFrame, filter, blob, innerBlob))
+            processBackground(input, filter, blob, innerBlob))
         {
             int outerCenterX = (blob.getMaxX() - blob.getMinX()) / 2 + blob.getMinX();
             int innerCenterX = (innerBlob.getMaxX() - innerBlob.getMinX()) /
@@ -294,12 +298,25 @@ void WindowDetector::processImage(Image* input, Image* output)
 
     frame->copyFrom(input);
 
+    // The labels, and the masks picked out of them, must match the input
+    int width = frame->getWidth();
+    int height = frame->getHeight();
+    m_labels->setSize(width, height);
+    redFrame->setSize(width, height);
+    greenFrame->setSize(width, height);
+    yellowFrame->setSize(width, height);
+    blueFrame->setSize(width, height);
+
+    // Label every color at once, each color then just picks out its mask
+    Image* lch = getConvertedInput(input, Image::PF_LCHUV_8, tempFrame);
+    m_classifier.classify(lch, m_labels);
+
     BlobDetector::Blob redBlob, greenBlob, yellowBlob, blueBlob;
     BlobDetector::Blob innerRedBlob, innerGreenBlob, innerYellowBlob, innerBlueBlob;
     bool redFound = false, greenFound = false,
         yellowFound = false, blueFound = false;
 
-    if ((redFound = processColor(frame, redFrame, *m_redFilter,
+    if ((redFound = processColor(lch, redFrame, *m_redFilter, m_redClass,
                                  redBlob, innerRedBlob))) {
         publishFoundEvent(redBlob, Color::RED);
     } else {
@@ -310,8 +327,8 @@ void WindowDetector::processImage(Image* input, Image* output)
     }
     m_redFound = redFound;
 
-    if ((greenFound = processColor(frame, greenFrame, *m_greenFilter,
-                                  greenBlob, innerGreenBlob))) {
+    if ((greenFound = processColor(lch, greenFrame, *m_greenFilter,
+                                  m_greenClass, greenBlob, innerGreenBlob))) {
         publishFoundEvent(greenBlob, Color::GREEN);
     } else {
         // Publish lost event if this was found previously
@@ -321,8 +338,9 @@ void WindowDetector::processImage(Image* input, Image* output)
     }
     m_greenFound = greenFound;
 
-    if ((yellowFound = processColor(frame, yellowFrame, *m_yellowFilter,
-                                    yellowBlob, innerYellowBlob))) {
+    if ((yellowFound = processColor(lch, yellowFrame, *m_yellowFilter,
+                                    m_yellowClass, yellowBlob,
+                                    innerYellowBlob))) {
         publishFoundEvent(yellowBlob, Color::YELLOW);
     } else {
         // Publish lost event if this was found previously
@@ -332,8 +350,8 @@ void WindowDetector::processImage(Image* input, Image* output)
     }
     m_yellowFound = yellowFound;
 
-    if ((blueFound = processColor(frame, blueFrame, *m_blueFilter,
-                                  blueBlob, innerBlueBlob))) {
+    if ((blueFound = processColor(lch, blueFrame, *m_blueFilter,
+                                  m_blueClass, blueBlob, innerBlueBlob))) {
         publishFoundEvent(blueBlob, Color::BLUE);
     } else {
         // Publish lost event if this was found previously
@@ -27,8 +27,17 @@ public:
     virtual void processImage(ram::vision::Image* input,
                               ram::vision::Image* output = 0);
 
+    /** Returns changes */
+    virtual bool changesInput() const { return changes; }
+
     int processCount;
     ram::vision::Image* inputImage;
+
+    /** The image given to the last processImage call */
+    ram::vision::Image* lastInput;
+
+    /** Defaults to true, like all detectors */
+    bool changes;
 };
 
 #endif // RAM_VISION_TEST_MOCKDETECTOR_H_02_07_2008
@@ -55,6 +55,9 @@ void drawLine(vision::Image* image, int x1, int y1, int x2, int y2,
 
 /** Get the process ID of the current process */    
 int getPid();
+
+/** Shares a frame holding a black BGR image, like a camera would */
+FramePtr shareBGR(FramePoolPtr pool, int sequence = 1);
     
 } // namespace vision
 } // namespace ram
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/vision/test/src/ColorFilterBenchmark.cpp
+ */
+
+// STD Includes
+#include <iostream>
+#include <cstdlib>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+
+// Project Includes
+#include "vision/include/ColorFilter.h"
+#include "vision/include/OpenCVImage.h"
+
+#include "core/include/EventProfiler.h"
+
+using namespace ram;
+
+static const char* KERNEL_NAMES[] = {"scalar", "sse2", "avx2"};
+
+// Filters the image count times, returning the nanoseconds taken
+static boost::int64_t filterLoop(vision::ColorFilter& filter,
+                                 vision::Image* input, vision::Image* output,
+                                 int count)
+{
+    boost::int64_t start = core::EventProfiler::now();
+    for (int i = 0; i < count; ++i)
+        filter.filterImage(input, output);
+    return core::EventProfiler::now() - start;
+}
+
+/** Times ColorFilter::filterImage with each kernel the CPU supports
+ *
+ *  Usage: ColorFilterBenchmark [frames]
+ *
+ *  Filters a 640x480 image of random pixels, about half of which pass,
+ *  into both a three and a one channel mask.  Prints a line of CSV for each
+ *  kernel and mask, with the speedup over the scalar kernel.
+ */
+int main(int argc, char* argv[])
+{
+    int frames = 500;
+    if (argc > 1)
+        frames = atoi(argv[1]);
+
+    vision::OpenCVImage input(640, 480, vision::Image::PF_BGR_8);
+    unsigned char* data = input.getData();
+    size_t bytes = input.getWidth() * input.getHeight() * 3;
+    srand(42);
+    for (size_t i = 0; i < bytes; ++i)
+        data[i] = (unsigned char)(rand() % 256);
+
+    vision::OpenCVImage mask(640, 480, vision::Image::PF_BGR_8);
+    vision::OpenCVImage grayMask(640, 480, vision::Image::PF_GRAY_8);
+    vision::Image* outputs[] = {&mask, &grayMask};
+
+    // Wide enough ranges that the masks aren't all one value
+    vision::ColorFilter filter(0, 200, 50, 255, 20, 230);
+
+    std::cout << "kernel,output_channels,frames,seconds,mpixels_per_sec,"
+              << "speedup" << std::endl;
+
+    for (size_t out = 0; out < sizeof(outputs) / sizeof(outputs[0]); ++out)
+    {
+        double scalarSeconds = 0;
+        for (int kernel = vision::ColorFilter::SCALAR;
+             kernel <= vision::ColorFilter::AVX2; ++kernel)
+        {
+            if (!vision::ColorFilter::setKernel(
+                    (vision::ColorFilter::Kernel)kernel))
+            {
+                continue;
+            }
+
+            // Warm the caches first
+            filterLoop(filter, &input, outputs[out], 10);
+            double seconds =
+                filterLoop(filter, &input, outputs[out], frames) / 1e9;
+            if (vision::ColorFilter::SCALAR == kernel)
+                scalarSeconds = seconds;
+
+            double pixels = (double)frames * input.getWidth() *
+                input.getHeight();
+            std::cout << KERNEL_NAMES[kernel] << ","
+                      << outputs[out]->getNumChannels() << "," << frames
+                      << "," << seconds << ","
+                      << (seconds > 0 ? pixels / seconds / 1e6 : 0) << ","
+                      << (seconds > 0 ? scalarSeconds / seconds : 0)
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
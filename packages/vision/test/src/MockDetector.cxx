@@ -14,13 +14,17 @@
 MockDetector::MockDetector(ram::core::ConfigNode,
                            ram::core::EventHubPtr) :
     processCount(0),
-    inputImage(new ram::vision::OpenCVImage(10, 10))
+    inputImage(new ram::vision::OpenCVImage(10, 10)),
+    lastInput(0),
+    changes(true)
 {
 }
 
 MockDetector::MockDetector() :
     processCount(0),
-    inputImage(new ram::vision::OpenCVImage(10, 10))
+    inputImage(new ram::vision::OpenCVImage(10, 10)),
+    lastInput(0),
+    changes(true)
 {
 }
 
@@ -33,5 +37,6 @@ void MockDetector::processImage(ram::vision::Image* input,
                                 ram::vision::Image* output)
 {
     inputImage->copyFrom(input);
+    lastInput = input;
     processCount++;
 }
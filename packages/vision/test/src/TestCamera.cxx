@@ -19,6 +19,7 @@
 // Project Includes
 #include "vision/include/Camera.h"
 #include "vision/include/OpenCVImage.h"
+#include "vision/include/Frame.h"
 #include "vision/include/Events.h"
 
 #include "vision/test/include/UnitTestChecks.h"
@@ -71,6 +72,37 @@ TEST(copyToPublic)
     delete result;
 }
 
+TEST(getFrame)
+{
+    Image* imageA = new OpenCVImage((getImagesDir() / "A.jpg").string());
+    Image* imageB = new OpenCVImage((getImagesDir() / "B.jpg").string());
+
+    // Blank until the first capture
+    MockCamera camera(imageA);
+    CHECK_EQUAL(0u, camera.getFrame()->getSequence());
+
+    camera.update(0);
+    FramePtr first = camera.getFrame();
+    CHECK_EQUAL(1u, first->getSequence());
+    CHECK(first->getTimeStamp() > 0);
+    CHECK_CLOSE(*imageA, *first->getImage(), 0);
+
+    // Everyone gets the same frame, without a copy
+    CHECK(first == camera.getFrame());
+
+    // The frame we hold doesn't change with the next capture
+    camera.setPublicImage(imageB);
+    camera.update(0);
+    FramePtr second = camera.getFrame();
+    CHECK_EQUAL(2u, second->getSequence());
+    CHECK(first->getImage() != second->getImage());
+    CHECK_CLOSE(*imageA, *first->getImage(), 0);
+    CHECK_CLOSE(*imageB, *second->getImage(), 0);
+
+    delete imageA;
+    delete imageB;
+}
+
 struct CameraFixture
 {
     CameraFixture() :
@@ -92,12 +124,15 @@ struct CameraFixture
 
     void captureHandler(ram::core::EventPtr event)
     {
-        capturedImage->copyFrom(
-            boost::dynamic_pointer_cast<ImageEvent>(event)->image);
+        ImageEventPtr imageEvent =
+            boost::dynamic_pointer_cast<ImageEvent>(event);
+        capturedImage->copyFrom(imageEvent->image);
+        frame = imageEvent->frame;
     }
 
     Image* rawImage;
     Image* capturedImage;
+    FramePtr frame;
 };
 
 TEST_FIXTURE(CameraFixture, event_IMAGE_CAPTURED)
@@ -112,6 +147,10 @@ TEST_FIXTURE(CameraFixture, event_IMAGE_CAPTURED)
     camera.update(0);
     CHECK_CLOSE(*expectedCap, *capturedImage, 0);
 
+    // The event carries the frame
+    CHECK(frame);
+    CHECK(frame == camera.getFrame());
+
     delete expectedCap;
 }
 
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/vision/test/src/TestColorClassifier.cxx
+ */
+
+// STD Includes
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "vision/include/ColorClassifier.h"
+#include "vision/include/ColorFilter.h"
+#include "vision/include/TableColorFilter.h"
+#include "vision/include/OpenCVImage.h"
+#include "core/include/BitField3D.h"
+#include "core/include/Logging.h"
+
+#include "vision/test/include/Utility.h"
+#include "vision/test/include/UnitTestChecks.h"
+
+using namespace ram;
+
+SUITE(ColorClassifier) {
+
+TEST(Classify)
+{
+    vision::OpenCVImage input(640, 480, vision::Image::PF_BGR_8);
+    vision::makeColor(&input, 50, 50, 50);
+    vision::drawCircle(&input, 320, 240, 50, CV_RGB(180, 45, 230));
+    vision::drawCircle(&input, 80, 80, 50, CV_RGB(250, 100, 50));
+
+    // The first circle, the second one, and the background with the first
+    vision::ColorFilter first(100, 250, 40, 60, 150, 200);
+    vision::ColorFilter second(0, 100, 90, 110, 240, 255);
+    vision::ColorFilter dark(0, 230, 0, 60, 0, 255);
+
+    vision::ColorClassifier classifier;
+    CHECK_EQUAL(1, classifier.addClass(&first));
+    CHECK_EQUAL(2, classifier.addClass(&second));
+    CHECK_EQUAL(4, classifier.addClass(&dark));
+    CHECK_EQUAL(3u, classifier.getClassCount());
+
+    vision::OpenCVImage labels(640, 480, vision::Image::PF_GRAY_8);
+    classifier.classify(&input, &labels);
+
+    unsigned char* data = labels.getData();
+    CHECK_EQUAL(1 | 4, data[240 * 640 + 320]);
+    CHECK_EQUAL(2, data[80 * 640 + 80]);
+    CHECK_EQUAL(4, data[0]);
+
+    // Each class matches its filter
+    vision::ColorFilter* filters[] = {&first, &second, &dark};
+    for (int i = 0; i < 3; ++i)
+    {
+        vision::OpenCVImage expected(640, 480, vision::Image::PF_BGR_8);
+        filters[i]->filterImage(&input, &expected);
+
+        vision::OpenCVImage mask(640, 480, vision::Image::PF_BGR_8);
+        vision::ColorClassifier::extractMask(&labels, 1 << i, &mask);
+        CHECK_CLOSE(&expected, &mask, 0);
+    }
+}
+
+TEST(FilterChanges)
+{
+    vision::OpenCVImage input(64, 48, vision::Image::PF_BGR_8);
+    vision::makeColor(&input, 50, 60, 70);
+
+    vision::ColorFilter filter(0, 255, 0, 255, 0, 255);
+    vision::ColorClassifier classifier;
+    unsigned char bit = classifier.addClass(&filter);
+
+    vision::OpenCVImage labels(64, 48, vision::Image::PF_GRAY_8);
+    classifier.classify(&input, &labels);
+    CHECK_EQUAL(bit, labels.getData()[0]);
+
+    // Changing the filter, like through its properties, changes the class
+    filter.setChannel2High(55);
+    classifier.classify(&input, &labels);
+    CHECK_EQUAL(0, labels.getData()[0]);
+}
+
+TEST(TableClasses)
+{
+    vision::OpenCVImage input(640, 480, vision::Image::PF_BGR_8);
+    vision::makeColor(&input, 50, 50, 50);
+    vision::drawCircle(&input, 320, 240, 50, CV_RGB(180, 45, 230));
+
+    // A table around the circle's color, with a range class next to it
+    core::BitField3D table(256, 256, 256);
+    for (int c1 = 220; c1 <= 240; ++c1)
+        for (int c2 = 35; c2 <= 55; ++c2)
+            for (int c3 = 170; c3 <= 190; ++c3)
+                table(c1, c2, c3) = true;
+    std::stringstream ss;
+    ss << "TestColorClassifier_" << vision::getPid() << ".table";
+    std::string tablePath = (core::Logging::getLogDir() / ss.str()).string();
+    vision::TableColorFilter::saveLookupTable(tablePath, table);
+    vision::TableColorFilter tableFilter(tablePath);
+    std::remove(tablePath.c_str());
+    vision::ColorFilter dark(0, 230, 0, 60, 0, 255);
+
+    vision::ColorClassifier classifier;
+    CHECK_EQUAL(1, classifier.addClass(&dark));
+    CHECK_EQUAL(2, classifier.addClass(&tableFilter));
+
+    vision::OpenCVImage labels(640, 480, vision::Image::PF_GRAY_8);
+    classifier.classify(&input, &labels);
+    CHECK(labels.getData()[240 * 640 + 320] & 2);
+    CHECK_EQUAL(0, labels.getData()[0] & 2);
+
+    // The table class matches the table filter
+    vision::OpenCVImage expected(640, 480, vision::Image::PF_BGR_8);
+    tableFilter.filterImage(&input, &expected);
+
+    vision::OpenCVImage mask(640, 480, vision::Image::PF_BGR_8);
+    vision::ColorClassifier::extractMask(&labels, 2, &mask);
+    CHECK_CLOSE(&expected, &mask, 0);
+
+    // And the range class still matches its filter
+    dark.filterImage(&input, &expected);
+    vision::ColorClassifier::extractMask(&labels, 1, &mask);
+    CHECK_CLOSE(&expected, &mask, 0);
+}
+
+TEST(ExtractMask)
+{
+    vision::OpenCVImage labels(4, 1, vision::Image::PF_GRAY_8);
+    unsigned char* data = labels.getData();
+    data[0] = 0;
+    data[1] = 1;
+    data[2] = 2;
+    data[3] = 3;
+
+    // Pixels in any of the classes pass
+    vision::OpenCVImage mask(4, 1, vision::Image::PF_GRAY_8);
+    vision::ColorClassifier::extractMask(&labels, 2, &mask);
+    CHECK_EQUAL(0, mask.getData()[0]);
+    CHECK_EQUAL(0, mask.getData()[1]);
+    CHECK_EQUAL(255, mask.getData()[2]);
+    CHECK_EQUAL(255, mask.getData()[3]);
+
+    vision::ColorClassifier::extractMask(&labels, 1 | 2, &mask);
+    CHECK_EQUAL(0, mask.getData()[0]);
+    CHECK_EQUAL(255, mask.getData()[1]);
+}
+
+} // SUITE(ColorClassifier)
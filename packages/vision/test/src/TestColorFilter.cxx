@@ -7,6 +7,9 @@
  * File:  packages/vision/test/src/TestColorFilter.cxx
  */
 
+// STD Includes
+#include <cstdlib>
+
 // Library Includes
 #include <UnitTest++/UnitTest++.h>
 #include <boost/bind.hpp>
@@ -167,5 +170,98 @@ TEST_FIXTURE(ColorFilterFixture, testSingleChannel)
     CHECK_CLOSE(&expected, &output, 0);
 }
 
+// Filters with the kernel, returning false if the CPU doesn't support it
+static bool filterWith(vision::ColorFilter::Kernel kernel,
+                       vision::ColorFilter& filter, vision::Image* input,
+                       vision::Image* output, bool inverse)
+{
+    vision::ColorFilter::Kernel original = vision::ColorFilter::getKernel();
+    if (!vision::ColorFilter::setKernel(kernel))
+        return false;
+
+    if (inverse)
+        filter.inverseFilterImage(input, output);
+    else
+        filter.filterImage(input, output);
+
+    vision::ColorFilter::setKernel(original);
+    return true;
+}
+
+TEST_FIXTURE(ColorFilterFixture, KernelsMatchScalar)
+{
+    // An odd size leaves pixels over after the kernels' blocks
+    vision::OpenCVImage input(37, 11, vision::Image::PF_BGR_8);
+    unsigned char* data = input.getData();
+    srand(7);
+    for (size_t i = 0; i < 37 * 11 * 3; ++i)
+        data[i] = (unsigned char)(rand() % 256);
+
+    // Narrow, wide, edge of the range and wrapping filters
+    vision::ColorFilter filters[] = {
+        vision::ColorFilter(100, 250, 40, 60, 150, 200),
+        vision::ColorFilter(0, 255, 0, 255, 0, 255),
+        vision::ColorFilter(0, 127, 128, 255, 255, 255),
+        vision::ColorFilter(200, 50, 0, 255, 0, 255),
+    };
+
+    vision::ColorFilter::Kernel kernels[] = {
+        vision::ColorFilter::SSE2,
+        vision::ColorFilter::AVX2
+    };
+    vision::Image::PixelFormat formats[] = {
+        vision::Image::PF_BGR_8,
+        vision::Image::PF_GRAY_8
+    };
+
+    for (size_t f = 0; f < sizeof(filters) / sizeof(filters[0]); ++f)
+    {
+        for (size_t fmt = 0; fmt < 2; ++fmt)
+        {
+            for (int inverse = 0; inverse < 2; ++inverse)
+            {
+                vision::OpenCVImage expected(37, 11, formats[fmt]);
+                filterWith(vision::ColorFilter::SCALAR, filters[f], &input,
+                           &expected, inverse);
+
+                for (size_t k = 0; k < 2; ++k)
+                {
+                    vision::OpenCVImage output(37, 11, formats[fmt]);
+                    if (filterWith(kernels[k], filters[f], &input, &output,
+                                   inverse))
+                    {
+                        CHECK_CLOSE(&expected, &output, 0);
+                    }
+                }
+            }
+        }
+    }
+
+    // In place as well
+    vision::OpenCVImage expected(37, 11, vision::Image::PF_BGR_8);
+    filterWith(vision::ColorFilter::SCALAR, filters[0], &input, &expected,
+               false);
+    for (size_t k = 0; k < 2; ++k)
+    {
+        vision::OpenCVImage output(37, 11, vision::Image::PF_BGR_8);
+        output.copyFrom(&input);
+        if (filterWith(kernels[k], filters[0], &output, 0, false))
+            CHECK_CLOSE(&expected, &output, 0);
+    }
+}
+
+TEST_FIXTURE(ColorFilterFixture, Kernel)
+{
+    // The scalar kernel works everywhere
+    vision::ColorFilter::Kernel original = vision::ColorFilter::getKernel();
+    CHECK(vision::ColorFilter::isKernelSupported(
+              vision::ColorFilter::SCALAR));
+    CHECK(vision::ColorFilter::setKernel(vision::ColorFilter::SCALAR));
+    CHECK_EQUAL(vision::ColorFilter::SCALAR, vision::ColorFilter::getKernel());
+
+    // The fastest supported is the default
+    CHECK(vision::ColorFilter::isKernelSupported(original));
+    vision::ColorFilter::setKernel(original);
+}
 
 } // SUITE(ColorFilter)
@@ -15,11 +15,75 @@
 
 // Test Includes
 #include "vision/include/Detector.h"
+#include "vision/include/Frame.h"
 #include "vision/include/OpenCVImage.h"
+#include "vision/test/include/Utility.h"
 
 using namespace ram;
+
+// Remembers the RGB version of its input it was handed
+class ConvertingDetector : public vision::Detector
+{
+public:
+    ConvertingDetector() : scratch(640, 480), converted(0) {}
+
+    virtual void processImage(vision::Image* input, vision::Image* = 0)
+    {
+        converted = getConvertedInput(input, vision::Image::PF_RGB_8,
+                                      &scratch);
+    }
+
+    vision::OpenCVImage scratch;
+    vision::Image* converted;
+};
+
 SUITE(Detector) {
 
+TEST(getConvertedInputShared)
+{
+    vision::FramePoolPtr pool = vision::FramePool::create();
+    vision::FramePtr frame = vision::shareBGR(pool);
+    vision::Image* shared = frame->getImage(vision::Image::PF_RGB_8);
+    ConvertingDetector detector;
+
+    // The frame's own image
+    detector.setInputFrame(frame, frame->getImage());
+    detector.processImage(frame->getImage());
+    CHECK_EQUAL(shared, detector.converted);
+
+    // A fresh copy handed over with the frame
+    vision::OpenCVImage copy(640, 480);
+    copy.copyFrom(frame->getImage());
+    detector.setInputFrame(frame, &copy);
+    detector.processImage(&copy);
+    CHECK_EQUAL(shared, detector.converted);
+    CHECK_EQUAL(1u, pool->getConversionMisses());
+}
+
+TEST(getConvertedInputFallback)
+{
+    vision::FramePoolPtr pool = vision::FramePool::create();
+    vision::FramePtr frame = vision::shareBGR(pool);
+    ConvertingDetector detector;
+
+    // Looks just like the frame, but wasn't handed over with it
+    vision::OpenCVImage other(640, 480, vision::Image::PF_BGR_8);
+    other.copyFrom(frame->getImage());
+    detector.setInputFrame(frame, frame->getImage());
+    detector.processImage(&other);
+    CHECK_EQUAL(&detector.scratch, detector.converted);
+    CHECK_EQUAL(vision::Image::PF_RGB_8,
+                detector.scratch.getPixelFormat());
+
+    // No frame at all
+    detector.setInputFrame(vision::FramePtr());
+    detector.processImage(frame->getImage());
+    CHECK_EQUAL(&detector.scratch, detector.converted);
+
+    // The frame was never converted
+    CHECK_EQUAL(0u, pool->getConversionMisses());
+}
+
 TEST(imageToAICoordinates)
 {
     vision::OpenCVImage image(640, 480);
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/vision/test/src/TestFrame.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "vision/include/Frame.h"
+#include "vision/include/Image.h"
+#include "vision/include/OpenCVImage.h"
+#include "vision/test/include/Utility.h"
+
+using namespace ram::vision;
+
+SUITE(Frame) {
+
+TEST(Share)
+{
+    FramePoolPtr pool = FramePool::create();
+    Frame* buffer = pool->allocate();
+    CHECK_EQUAL(640u, buffer->getImage()->getWidth());
+
+    FramePtr frame = pool->share(buffer, 7, 12.5);
+    CHECK_EQUAL(buffer, frame.get());
+    CHECK_EQUAL(7u, frame->getSequence());
+    CHECK_EQUAL(12.5, frame->getTimeStamp());
+}
+
+TEST(Reuse)
+{
+    FramePoolPtr pool = FramePool::create();
+
+    FramePtr frame = pool->share(pool->allocate(), 1, 0);
+    const Frame* first = frame.get();
+    CHECK_EQUAL(1u, pool->getHeapAllocations());
+
+    // While held the frame can't be handed out again
+    FramePtr other = pool->share(pool->allocate(), 2, 0);
+    CHECK(first != other.get());
+    CHECK_EQUAL(2u, pool->getHeapAllocations());
+
+    // Released frames come back from the pool
+    frame.reset();
+    Frame* buffer = pool->allocate();
+    CHECK_EQUAL(first, buffer);
+    CHECK_EQUAL(1u, pool->getReuses());
+    pool->share(buffer, 3, 0);
+}
+
+TEST(OutlivesPool)
+{
+    FramePtr frame;
+    {
+        FramePoolPtr pool = FramePool::create();
+        frame = pool->share(pool->allocate(), 1, 0);
+    }
+
+    // The frame keeps the pool alive, so releasing it is safe
+    CHECK_EQUAL(1u, frame->getSequence());
+    frame.reset();
+}
+
+TEST(Conversion)
+{
+    FramePoolPtr pool = FramePool::create();
+    FramePtr frame = shareBGR(pool, 1);
+
+    // The image itself needs no conversion
+    CHECK_EQUAL(frame->getImage(), frame->getImage(Image::PF_BGR_8));
+    CHECK_EQUAL(0u, pool->getConversionMisses());
+
+    // Converted on the first call, then shared
+    Image* hsv = frame->getImage(Image::PF_HSV_8);
+    CHECK_EQUAL(Image::PF_HSV_8, hsv->getPixelFormat());
+    CHECK_EQUAL(640u, hsv->getWidth());
+    CHECK_EQUAL(1u, pool->getConversionMisses());
+    CHECK_EQUAL(0u, pool->getConversionHits());
+
+    CHECK_EQUAL(hsv, frame->getImage(Image::PF_HSV_8));
+    CHECK_EQUAL(1u, pool->getConversionMisses());
+    CHECK_EQUAL(1u, pool->getConversionHits());
+
+    Image* gray = frame->getImage(Image::PF_GRAY_8);
+    CHECK(hsv != gray);
+    CHECK_EQUAL(Image::PF_GRAY_8, gray->getPixelFormat());
+    CHECK_EQUAL(2u, pool->getConversionMisses());
+}
+
+TEST(ConversionReuse)
+{
+    FramePoolPtr pool = FramePool::create();
+    FramePtr frame = shareBGR(pool, 1);
+    Image* hsv = frame->getImage(Image::PF_HSV_8);
+    frame.reset();
+
+    // A new image in the frame is converted again, into the same buffer
+    frame = shareBGR(pool, 2);
+    CHECK_EQUAL(hsv, frame->getImage(Image::PF_HSV_8));
+    CHECK_EQUAL(2u, pool->getConversionMisses());
+    CHECK_EQUAL(0u, pool->getConversionHits());
+}
+
+} // SUITE(Frame)
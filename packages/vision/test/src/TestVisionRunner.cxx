@@ -17,6 +17,8 @@
 // Project Includes
 #include "vision/include/VisionRunner.h"
 #include "vision/include/OpenCVImage.h"
+#include "vision/include/Frame.h"
+#include "vision/include/HedgeDetector.h"
 
 #include "vision/test/include/MockCamera.h"
 #include "vision/test/include/MockDetector.h"
@@ -24,6 +26,9 @@
 #include "vision/test/include/Utility.h"
 
 #include "core/include/TimeVal.h"
+#include "core/include/WorkerPool.h"
+#include "core/include/EventHub.h"
+#include "core/include/Metrics.h"
 
 using namespace ram;
 
@@ -106,6 +111,68 @@ TEST_FIXTURE(VisionRunnerFixture, Update)
     camera->unbackground(true);
 
 }
+
+TEST_FIXTURE(VisionRunnerFixture, Parallel)
+{
+    core::WorkerPoolPtr workers(new core::WorkerPool(2));
+    vision::VisionRunner runner(camera, vision::Recorder::NEXT_FRAME, 0,
+                                workers);
+    camera->background(0);
+
+    // One detector only reads the image, the other changes it
+    MockDetector* reader = new MockDetector();
+    reader->changes = false;
+    MockDetector* changer = new MockDetector();
+    vision::DetectorPtr readerPtr(reader);
+    vision::DetectorPtr changerPtr(changer);
+    runner.addDetector(readerPtr);
+    runner.addDetector(changerPtr);
+    runner.unbackground(true);
+
+    camera->update(0);
+    runner.update(1.0/20);
+
+    CHECK_EQUAL(1, reader->processCount);
+    CHECK_EQUAL(1, changer->processCount);
+    CHECK_CLOSE(*image, *reader->inputImage, 0);
+    CHECK_CLOSE(*image, *changer->inputImage, 0);
+
+    // The reader shares the camera frame, the changer gets its own copy
+    vision::Image* frameImage = camera->getFrame()->getImage();
+    CHECK_EQUAL(frameImage, reader->lastInput);
+    CHECK(frameImage != changer->lastInput);
+
+    runner.removeAllDetectors(true);
+    camera->unbackground(true);
+}
+
+TEST_FIXTURE(VisionRunnerFixture, SharedConversion)
+{
+    camera->setMetricsName("SharedConversionCamera");
+    vision::VisionRunner runner(camera, vision::Recorder::NEXT_FRAME);
+    camera->background(0);
+
+    // Both filter in LCh, only the first should have to convert the frame
+    core::EventHubPtr eventHub(new core::EventHub());
+    vision::DetectorPtr first(new vision::HedgeDetector(
+        core::ConfigNode::fromString("{}"), eventHub));
+    vision::DetectorPtr second(new vision::HedgeDetector(
+        core::ConfigNode::fromString("{}"), eventHub));
+    runner.addDetector(first);
+    runner.addDetector(second);
+    runner.unbackground(true);
+
+    camera->update(0);
+    runner.update(1.0/20);
+
+    core::MetricsSnapshot snapshot = core::MetricsRegistry::snapshot();
+    CHECK_EQUAL(1.0,
+        snapshot.gauges["SharedConversionCamera.frameCache.misses"]);
+    CHECK(snapshot.gauges["SharedConversionCamera.frameCache.hits"] >= 1.0);
+
+    runner.removeAllDetectors(true);
+    camera->unbackground(true);
+}
 #endif
   
 } // SUITE(VisionRunner)
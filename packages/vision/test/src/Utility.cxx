@@ -19,6 +19,7 @@
 #include "vision/test/include/Utility.h"
 #include "vision/include/Image.h"
 #include "vision/include/OpenCVImage.h"
+#include "vision/include/Frame.h"
 
 #include "math/include/Matrix2.h"
 
@@ -255,6 +256,14 @@ int getPid()
 #endif
 }
 
+FramePtr shareBGR(FramePoolPtr pool, int sequence)
+{
+    OpenCVImage image(640, 480, Image::PF_BGR_8);
+    Frame* buffer = pool->allocate();
+    buffer->getImage()->copyFrom(&image);
+    return pool->share(buffer, sequence, 0);
+}
+
     
 } // namespace vision
 } // namespace ram
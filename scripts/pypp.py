@@ -85,6 +85,10 @@ def main(argv = None):
 
     # Now lets build the code
     mb.build_code_creator( module_name= module.replace("::","_"))
+
+    # Every module passes event types to python, so they all need to convert
+    # them the same way
+    mb.code_creator.add_include('wrappers/core/include/EventTypeConverter.h')
     for include in include_files:
         mb.code_creator.add_include(include)
 
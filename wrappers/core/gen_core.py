@@ -101,6 +101,11 @@ def generate(module_builder, local_ns, global_ns):
     
     classes.append(Application)
 
+    # Timing statistics, carried by the UpdatableStatsEvent
+    UpdatableStats = local_ns.class_('UpdatableStats')
+    UpdatableStats.include()
+    classes.append(UpdatableStats)
+
     # Wrap Events
     Event = local_ns.class_('Event')
     Event.include()
@@ -112,11 +117,13 @@ def generate(module_builder, local_ns, global_ns):
     classes += events
 
     # Add registrations functions for hand wrapped classes
+    module_builder.add_registration_code("registerEventTypeConverter();")
     module_builder.add_registration_code("registerSubsystemList();")
     module_builder.add_registration_code("registerSubsystemClass();")
     module_builder.add_registration_code("registerSubsystemMakerClass();")
     module_builder.add_registration_code("registerEventHubClass();")
     module_builder.add_registration_code("registerQueuedEventHubClass();")
+    module_builder.add_registration_code("registerTimerManagerClass();")
 
 
     # Do class wide items
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee jlisee@umd.edu>
+ * File:  wrappers/core/include/EventTypeConverter.h
+ */
+
+#ifndef RAM_CORE_WRAP_EVENTTYPECONVERTER_H_02_20_2010
+#define RAM_CORE_WRAP_EVENTTYPECONVERTER_H_02_20_2010
+
+// Library Includes
+#include <boost/python.hpp>
+
+// Project Includes
+#include "core/include/EventTypeName.h"
+
+// Event types go to python as plain strings, by value.  This has to be a
+// builtin style conversion, otherwise boost.python hands out references to
+// static event types and members like Event.type, which needs a wrapped
+// class.  It must be seen by every wrapper which touches an event type, so
+// pypp.py includes it in each generated module.
+namespace boost { namespace python {
+
+template <> struct to_python_value<ram::core::EventTypeName&>
+    : detail::builtin_to_python
+{
+    inline PyObject* operator()(ram::core::EventTypeName const& x) const
+    {
+        return ::PyString_FromStringAndSize(x.data(), x.size());
+    }
+    inline PyTypeObject const* get_pytype() const
+    {
+        return &PyString_Type;
+    }
+};
+
+template <> struct to_python_value<ram::core::EventTypeName const&>
+    : detail::builtin_to_python
+{
+    inline PyObject* operator()(ram::core::EventTypeName const& x) const
+    {
+        return ::PyString_FromStringAndSize(x.data(), x.size());
+    }
+    inline PyTypeObject const* get_pytype() const
+    {
+        return &PyString_Type;
+    }
+};
+
+namespace converter {
+
+template <> struct arg_to_python<ram::core::EventTypeName>
+    : handle<>
+{
+    arg_to_python(ram::core::EventTypeName const& x)
+        : python::handle<>(::PyString_FromStringAndSize(x.data(), x.size()))
+    {
+    }
+};
+
+} // namespace converter
+} } // namespace boost::python
+
+#endif // RAM_CORE_WRAP_EVENTTYPECONVERTER_H_02_20_2010
@@ -15,5 +15,7 @@ void registerSubsystemList();
 void registerSubsystemMakerClass();
 void registerEventHubClass();
 void registerQueuedEventHubClass();
+void registerTimerManagerClass();
+void registerEventTypeConverter();
 
 #endif // RAM_CORE_WRAP_REGISTERFUNCTIONS_H_12_11_2007
@@ -15,6 +15,7 @@
 
 // Project Includes
 #include "core/include/EventConverter.h"
+#include "core/include/GILock.h"
 #include "wrappers/core/include/EventFunctor.h"
 
 namespace bp = boost::python;
@@ -95,5 +96,7 @@ EventFunctor::EventFunctor(bp::object pyObject) :
     
 void EventFunctor::operator()(ram::core::EventPtr event)
 {
+    // Events can be published from any thread, like the TimerManager's
+    ram::core::ScopedGILock lock;
     pyFunction(ram::core::EventConverter::convertEvent(event));
 }
@@ -0,0 +1,22 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee jlisee@umd.edu>
+ * File:  wrappers/core/src/EventTypeConverter.cpp
+ */
+
+// Library Includes
+#include <boost/python.hpp>
+
+// Project Includes
+#include "wrappers/core/include/EventTypeConverter.h"
+
+namespace bp = boost::python;
+
+void registerEventTypeConverter()
+{
+    // Python strings are interned as they are passed in as event types
+    bp::implicitly_convertible<std::string, ram::core::EventTypeName>();
+}
@@ -35,7 +35,14 @@ void registerQueuedEventHubClass()
         .def("publishEvents",
              &ram::core::QueuedEventHub::publishEvents)
         .def("waitAndPublishEvents",
-             &ram::core::QueuedEventHub::waitAndPublishEvents);
+             &ram::core::QueuedEventHub::waitAndPublishEvents)
+        .def("setCoalescing",
+             &ram::core::QueuedEventHub::setCoalescing,
+             (bp::arg("type"), bp::arg("coalesce") = true))
+        .def("getCoalescing",
+             &ram::core::QueuedEventHub::getCoalescing)
+        .def("getCoalescedCount",
+             &ram::core::QueuedEventHub::getCoalescedCount);
 
     bp::register_ptr_to_python<boost::shared_ptr<ram::core::QueuedEventHub> >();
     bp::implicitly_convertible<boost::shared_ptr<ram::core::QueuedEventHub>,
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2010 Robotics at Maryland
+ * Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee jlisee@umd.edu>
+ * File:  wrappers/core/src/TimerManager.cpp
+ */
+
+// Library Includes
+#include <boost/python.hpp>
+
+// Project Includes
+#include "core/include/TimerManager.h"
+#include "core/include/EventPublisher.h"
+#include "core/include/SubsystemConverter.h"
+#include "core/include/GILock.h"
+#include "wrappers/core/include/EventTypeConverter.h"
+
+namespace bp = boost::python;
+
+static ram::core::SpecificSubsystemConverter<ram::core::TimerManager>
+REGISTER_TIMERMANAGER_CONVERTER;
+
+// Lets python pass None for the publisher
+ram::core::TimerPtr newTimer(ram::core::TimerManager& manager,
+                             std::string eventType, double seconds,
+                             bool repeat, bp::object pyPublisher)
+{
+    ram::core::EventPublisher* publisher = 0;
+    if (!pyPublisher.is_none())
+        publisher = bp::extract<ram::core::EventPublisher*>(pyPublisher);
+
+    return manager.newTimer(eventType, seconds, repeat, publisher);
+}
+
+// The timer thread could be waiting for the GIL in a python handler, so
+// give it up while we wait for the thread
+void unbackground(ram::core::TimerManager& manager, bool join)
+{
+    ram::core::ScopedGILRelease release;
+    manager.unbackground(join);
+}
+
+// Python usually drops the last reference, so the destructor's join needs
+// the GIL released too
+void deleteTimerManager(ram::core::TimerManager* manager)
+{
+    {
+        ram::core::ScopedGILRelease release;
+        manager->unbackground(true);
+    }
+    delete manager;
+}
+
+ram::core::TimerManagerPtr newTimerManager(ram::core::ConfigNode config,
+                                           ram::core::SubsystemList deps)
+{
+    return ram::core::TimerManagerPtr(
+        new ram::core::TimerManager(config, deps), &::deleteTimerManager);
+}
+
+void registerTimerManagerClass()
+{
+    bp::class_<ram::core::Timer, ram::core::TimerPtr, boost::noncopyable>(
+        "Timer", bp::no_init)
+        .def("cancel", &ram::core::Timer::cancel)
+        .def("active", &ram::core::Timer::active)
+        .def("getFireCount", &ram::core::Timer::getFireCount)
+        .def("getEventType", &ram::core::Timer::getEventType)
+        .def("getPeriod", &ram::core::Timer::getPeriod)
+        .def("getRepeat", &ram::core::Timer::getRepeat);
+
+    bp::class_<ram::core::TimerManager, ram::core::TimerManagerPtr,
+        bp::bases<ram::core::Subsystem>, boost::noncopyable>("TimerManager",
+            bp::no_init)
+        .def("__init__", bp::make_constructor(
+                 &::newTimerManager, bp::default_call_policies(),
+                 (bp::arg("config"),
+                  bp::arg("deps") = ram::core::SubsystemList())))
+        .def("newTimer", &::newTimer,
+             (bp::arg("eventType"), bp::arg("seconds"),
+              bp::arg("repeat") = false, bp::arg("publisher") = bp::object()))
+        .def("getTimerCount", &ram::core::TimerManager::getTimerCount)
+        .def("getResolution", &ram::core::TimerManager::getResolution)
+        .def("unbackground", &::unbackground, (bp::arg("join") = false));
+
+    bp::implicitly_convertible<ram::core::TimerManagerPtr,
+        ram::core::SubsystemPtr >();
+}
@@ -0,0 +1,63 @@
+# Copyright (C) 2010 Maryland Robotics Club
+# Copyright (C) 2010 Joseph Lisee <jlisee@umd.edu>
+# All rights reserved.
+#
+# Author: Joseph Lisee <jlisee@umd.edu>
+# File: wrapper/core/test/src/TestTimerManager.py
+
+# STD Imports
+import unittest
+import time
+
+# Project Imports
+import ext.core as core
+
+class TestTimerManager(unittest.TestCase):
+
+    def setUp(self):
+        self.ehub = core.EventHub()
+        self.qehub = core.QueuedEventHub(self.ehub)
+        deps = core.SubsystemList()
+        deps.append(self.ehub)
+        cfg = core.ConfigNode.fromString(str({'resolution' : 1}))
+        self.timerManager = core.TimerManager(cfg, deps)
+        self.events = []
+
+    def tearDown(self):
+        self.timerManager.unbackground(True)
+
+    def handler(self, event):
+        self.events.append(event)
+
+    def testOneShot(self):
+        self.qehub.subscribeToType('Timer', self.handler)
+        timer = self.timerManager.newTimer('Timer', 0.05)
+        self.assert_(timer.active())
+
+        time.sleep(0.1)
+        self.qehub.publishEvents()
+        self.assertEquals(1, len(self.events))
+        self.assertEquals('Timer', self.events[0].type)
+        self.assertFalse(timer.active())
+
+    def testCancel(self):
+        self.qehub.subscribeToType('Timer', self.handler)
+        timer = self.timerManager.newTimer('Timer', 0.05, repeat = True)
+        timer.cancel()
+
+        time.sleep(0.1)
+        self.qehub.publishEvents()
+        self.assertEquals(0, len(self.events))
+        self.assertEquals(0, timer.getFireCount())
+
+    def testPublisher(self):
+        epub = core.EventPublisher(self.ehub)
+        self.ehub.subscribe('Timer', epub, self.handler)
+        self.timerManager.newTimer('Timer', 0.01, publisher = epub)
+
+        time.sleep(0.05)
+        self.assertEquals(1, len(self.events))
+
+
+if __name__ == '__main__':
+    unittest.main()